@@ -10,7 +10,7 @@ public class GalacticArmada : ModuleRules
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "AIModule" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "Niagara", "EnhancedInput" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "Niagara", "EnhancedInput", "RenderCore", "PhysicsCore", "Chaos", "MassEntity", "MassCommon", "StructUtils" });
 
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
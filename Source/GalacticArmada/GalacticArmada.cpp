@@ -1,6 +1,45 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "GalacticArmada.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, GalacticArmada, "GalacticArmada" );
+
+DEFINE_LOG_CATEGORY(LogGalacticArmada);
+
+CSV_DEFINE_CATEGORY_MODULE(GALACTICARMADA_API, GalacticArmada, true);
+
+LLM_DEFINE_TAG(GalacticArmada);
+LLM_DEFINE_TAG(GalacticArmada_Ships, TEXT("Ships"), TEXT("GalacticArmada"));
+LLM_DEFINE_TAG(GalacticArmada_Cannons, TEXT("Cannons"), TEXT("GalacticArmada"));
+LLM_DEFINE_TAG(GalacticArmada_Projectiles, TEXT("Projectiles"), TEXT("GalacticArmada"));
+LLM_DEFINE_TAG(GalacticArmada_FX, TEXT("FX"), TEXT("GalacticArmada"));
+LLM_DEFINE_TAG(GalacticArmada_AI, TEXT("AI"), TEXT("GalacticArmada"));
+LLM_DEFINE_TAG(GalacticArmada_Health, TEXT("Health"), TEXT("GalacticArmada"));
+
+bool GalacticArmada::IsBattleSimulation()
+{
+	static const bool bIsBattleSimulation = FParse::Param(FCommandLine::Get(), TEXT("BattleSim"));
+	return bIsBattleSimulation;
+}
+
+#if GA_WITH_COSMETICS
+bool GalacticArmada::ShouldPlayCosmetics(const UObject* WorldContextObject)
+{
+	if (IsBattleSimulation() || IsRunningDedicatedServer() || FApp::ShouldUseNullRHI() || !FApp::CanEverRender())
+	{
+		return false;
+	}
+
+	if (const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr)
+	{
+		return World->GetNetMode() != NM_DedicatedServer;
+	}
+
+	return true;
+}
+#endif
@@ -3,4 +3,42 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogGalacticArmada, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("GalacticArmada"), STATGROUP_GalacticArmada, STATCAT_Advanced);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GALACTICARMADA_API, GalacticArmada);
+
+// Low level memory tracker tags, visible with -llm in stat LLM, LLM csv captures and ga.Memory.Dump
+LLM_DECLARE_TAG_API(GalacticArmada, GALACTICARMADA_API);
+LLM_DECLARE_TAG_API(GalacticArmada_Ships, GALACTICARMADA_API);
+LLM_DECLARE_TAG_API(GalacticArmada_Cannons, GALACTICARMADA_API);
+LLM_DECLARE_TAG_API(GalacticArmada_Projectiles, GALACTICARMADA_API);
+LLM_DECLARE_TAG_API(GalacticArmada_FX, GALACTICARMADA_API);
+LLM_DECLARE_TAG_API(GalacticArmada_AI, GALACTICARMADA_API);
+LLM_DECLARE_TAG_API(GalacticArmada_Health, GALACTICARMADA_API);
+
+// Camera, thruster, effect and camera shake paths, compiled out of the dedicated server target
+#ifndef GA_WITH_COSMETICS
+#define GA_WITH_COSMETICS !UE_SERVER
+#endif
+
+namespace GalacticArmada
+{
+	// True when the process was launched as a headless battle simulation (-BattleSim)
+	GALACTICARMADA_API bool IsBattleSimulation();
+
+	// False when nobody can see or feel cosmetic work: dedicated servers, -nullrhi and battle simulation runs
+#if GA_WITH_COSMETICS
+	GALACTICARMADA_API bool ShouldPlayCosmetics(const UObject* WorldContextObject);
+#else
+	FORCEINLINE constexpr bool ShouldPlayCosmetics(const UObject* WorldContextObject) { return false; }
+#endif
+
+	// Labels reports so runs of the game and dedicated server targets can be compared
+	FORCEINLINE constexpr const TCHAR* GetTargetName() { return GA_WITH_COSMETICS ? TEXT("Game") : TEXT("Server"); }
+}
@@ -0,0 +1,63 @@
+#include "Actors/ExplosiveProjectile.h"
+#include "GalacticArmada.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Subsystems/ShipExplosionSubsystem.h"
+#include "TimerManager.h"
+
+void AExplosiveProjectile::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (FuseTime > 0.0f)
+    {
+        GetWorld()->GetTimerManager().SetTimer(FuseTimerHandle, this, &AExplosiveProjectile::Detonate, FuseTime);
+    }
+}
+
+void AExplosiveProjectile::HandleImpact(AActor* OtherActor, const FHitResult& SweepResult)
+{
+    Detonate();
+}
+
+void AExplosiveProjectile::Detonate()
+{
+    if (bDetonated) return;
+    bDetonated = true;
+
+    GetWorld()->GetTimerManager().ClearTimer(FuseTimerHandle);
+
+    // Resolved with every other explosion of the frame, the ship that fired is never caught in its own blast
+    if (UShipExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UShipExplosionSubsystem>())
+    {
+        FShipExplosion Explosion;
+        Explosion.Origin = GetActorLocation();
+        Explosion.BaseDamage = Damage;
+        Explosion.MinimumDamage = MinimumDamage;
+        Explosion.InnerRadius = ExplosionInnerRadius;
+        Explosion.OuterRadius = ExplosionRadius;
+        Explosion.DamageTypeClass = ExplosionDamageType;
+        Explosion.DamageCauser = this;
+        Explosion.InstigatedBy = GetInstigatorController();
+        Explosion.IgnoreActor = GetOwner();
+        ExplosionSubsystem->QueueExplosion(Explosion);
+    }
+
+    PlayImpactEffects();
+
+    // Stay around invisible until the blast is resolved, so damage is credited to this projectile
+    ProjectileMovementComponent->StopMovementImmediately();
+    SetActorEnableCollision(false);
+    SetActorHiddenInGame(true);
+    GetWorld()->GetTimerManager().SetTimer(DestroyTimerHandle, this, &AProjectileBase::DestroyProjectile, DestroyDelay);
+}
+
+void AExplosiveProjectile::RestoreFlightAge(float Age)
+{
+    Super::RestoreFlightAge(Age);
+
+    if (FuseTime > 0.0f && !bDetonated)
+    {
+        GetWorld()->GetTimerManager().SetTimer(FuseTimerHandle, this, &AExplosiveProjectile::Detonate, FMath::Max(FuseTime - Age, UE_KINDA_SMALL_NUMBER));
+    }
+}
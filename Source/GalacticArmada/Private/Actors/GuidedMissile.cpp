@@ -0,0 +1,51 @@
+#include "Actors/GuidedMissile.h"
+#include "GalacticArmada.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Subsystems/ShipMissileSubsystem.h"
+#include "Telemetry/ShipTelemetry.h"
+#include "TimerManager.h"
+
+AGuidedMissile::AGuidedMissile()
+{
+    // Moved by its movement component and steered by the missile subsystem
+    PrimaryActorTick.bCanEverTick = false;
+
+    ProjectileMovementComponent->InitialSpeed = 60000.0f;
+    ProjectileMovementComponent->MaxSpeed = 60000.0f;
+    ProjectileMovementComponent->bRotationFollowsVelocity = true;
+}
+
+void AGuidedMissile::HandleImpact(AActor* OtherActor, const FHitResult& SweepResult)
+{
+    // Missiles fly through other projectiles, and a missile already back in the pool hits nothing
+    if (OtherActor->IsA<AProjectileBase>() || IsHidden()) return;
+
+    FShipTelemetry::Record(EShipTelemetryEventType::Hit, OtherActor, GetInstigator(), Damage);
+
+    UGameplayStatics::ApplyPointDamage(OtherActor, Damage, GetActorLocation(), SweepResult, GetInstigatorController(), this, nullptr);
+
+    PlayImpactEffects();
+
+    if (UShipMissileSubsystem* MissileSubsystem = GetWorld()->GetSubsystem<UShipMissileSubsystem>())
+    {
+        MissileSubsystem->ReleaseMissile(this);
+    }
+    else
+    {
+        GetWorld()->GetTimerManager().SetTimer(DestroyTimerHandle, this, &AProjectileBase::DestroyProjectile, DestroyDelay);
+    }
+}
+
+float AGuidedMissile::GetFlightAge() const
+{
+    // Pooled missiles are older than their current flight
+    return FlightAge;
+}
+
+void AGuidedMissile::RestoreFlightAge(float Age)
+{
+    Super::RestoreFlightAge(Age);
+    FlightAge = Age;
+}
@@ -1,9 +1,14 @@
 #include "Actors/ProjectileBase.h"
+#include "GalacticArmada.h"
 #include "NiagaraFunctionLibrary.h"
+#include "Data/ShipAssetBundles.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Camera/CameraShakeBase.h"
+#include "Subsystems/ShipCameraFeedbackSubsystem.h"
+#include "Subsystems/ShipFidelitySubsystem.h"
+#include "Telemetry/ShipTelemetry.h"
 #include "GameFramework/PlayerController.h"
 
 AProjectileBase::AProjectileBase()
@@ -24,22 +29,51 @@ AProjectileBase::AProjectileBase()
     ProjectileMovementComponent->ProjectileGravityScale = 0.0f;
 }
 
+void AProjectileBase::BeginPlay()
+{
+    Super::BeginPlay();
+
+    LaunchTime = GetWorld()->GetTimeSeconds();
+}
+
 void AProjectileBase::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
     // Check Null and Ignore Self
     if (!OtherActor || !OtherComp || OtherActor == GetOwner()) return;
 
+    HandleImpact(OtherActor, SweepResult);
+}
+
+void AProjectileBase::HandleImpact(AActor* OtherActor, const FHitResult& SweepResult)
+{
+    FShipTelemetry::Record(EShipTelemetryEventType::Hit, OtherActor, GetInstigator(), Damage);
+
     // Add Damage
     UGameplayStatics::ApplyPointDamage(OtherActor, Damage, GetActorLocation(), SweepResult, GetInstigatorController(), this, nullptr);
 
-    // Spawn Impact Effects
-    if (ImpactEffect)
+    PlayImpactEffects();
+
+    // Set a timer to destroy the projectile after a delay
+    GetWorld()->GetTimerManager().SetTimer(DestroyTimerHandle, this, &AProjectileBase::DestroyProjectile, DestroyDelay);
+}
+
+void AProjectileBase::PlayImpactEffects() const
+{
+    const bool bPlayCosmetics = GalacticArmada::ShouldPlayCosmetics(this);
+
+    // Spawn Impact Effects, the player's hits always show and everyone else's share the frame's effect budget
+    UShipFidelitySubsystem* FidelitySubsystem = GetWorld()->GetSubsystem<UShipFidelitySubsystem>();
+    const bool bPlayerInstigated = GetInstigator() && GetInstigator()->IsPlayerControlled();
+    if (bPlayCosmetics && ImpactEffect.Get() && (bPlayerInstigated || !FidelitySubsystem || FidelitySubsystem->ConsumeFXSpawn()))
     {
-        UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), ImpactEffect, GetActorLocation());
+        LLM_SCOPE_BYTAG(GalacticArmada_FX);
+        UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), ImpactEffect.Get(), GetActorLocation());
     }
 
+#if GA_WITH_COSMETICS
     // Play Camera Shake
-    if (ImpactCameraShake)
+    UShipCameraFeedbackSubsystem* CameraFeedbackSubsystem = GetWorld()->GetSubsystem<UShipCameraFeedbackSubsystem>();
+    if (CameraFeedbackSubsystem && ImpactCameraShake.Get())
     {
         APawn* InstigatingPawn = GetInstigator();
         if (InstigatingPawn)
@@ -47,16 +81,41 @@ void AProjectileBase::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor
             APlayerController* PlayerController = Cast<APlayerController>(InstigatingPawn->GetController());
             if (PlayerController)
             {
-                PlayerController->ClientStartCameraShake(ImpactCameraShake);
+                CameraFeedbackSubsystem->AddPlayerShake(EShipCameraShakeCategory::Impact, ImpactCameraShake.Get(), PlayerController);
             }
         }
     }
-
-    // Set a timer to destroy the projectile after a delay
-    GetWorld()->GetTimerManager().SetTimer(DestroyTimerHandle, this, &AProjectileBase::DestroyProjectile, DestroyDelay);
+#endif
 }
 
 void AProjectileBase::DestroyProjectile()
 {
     Destroy();
-}
\ No newline at end of file
+}
+
+float AProjectileBase::GetInitialSpeed() const
+{
+    return ProjectileMovementComponent ? ProjectileMovementComponent->InitialSpeed : 0.0f;
+}
+
+void AProjectileBase::GatherAssetBundles(FShipAssetBundles& OutBundles) const
+{
+    OutBundles.AddCosmetic(ImpactEffect);
+    OutBundles.AddCosmetic(ImpactCameraShake);
+}
+
+float AProjectileBase::GetFlightAge() const
+{
+    // Not the time since creation, snapshots reuse bolts for flights launched after they were spawned
+    return GetWorld()->GetTimeSeconds() - LaunchTime;
+}
+
+void AProjectileBase::RestoreFlightAge(float Age)
+{
+    LaunchTime = GetWorld()->GetTimeSeconds() - Age;
+
+    if (InitialLifeSpan > 0.0f)
+    {
+        SetLifeSpan(FMath::Max(InitialLifeSpan - Age, UE_KINDA_SMALL_NUMBER));
+    }
+}
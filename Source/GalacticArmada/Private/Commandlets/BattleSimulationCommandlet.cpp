@@ -0,0 +1,133 @@
+#include "Commandlets/BattleSimulationCommandlet.h"
+#include "GameModes/BattleSimulationGameMode.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBattleSimulationCommandlet, Log, All)
+
+UBattleSimulationCommandlet::UBattleSimulationCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UBattleSimulationCommandlet::Main(const FString& Params)
+{
+	FString MapName = TEXT("/Game/GalacticArmada/Maps/TestLevel");
+	int32 ProcessCount = FPlatformMisc::NumberOfCores();
+	int32 MatchCount = 1000;
+	int32 Seed = 0;
+	FString ForwardedArgs;
+
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Processes="), ProcessCount);
+	FParse::Value(*Params, TEXT("Matches="), MatchCount);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	ProcessCount = FMath::Clamp(ProcessCount, 1, FMath::Max(MatchCount, 1));
+
+	// Forward match setup to every child process
+	const TCHAR* ForwardedParams[] = { TEXT("ShipsPerTeam="), TEXT("Parallel="), TEXT("TimeStep="), TEXT("TimeLimit="), TEXT("ShipA="), TEXT("ShipB=") };
+	for (const TCHAR* ForwardedParam : ForwardedParams)
+	{
+		FString Value;
+		if (FParse::Value(*Params, ForwardedParam, Value))
+		{
+			ForwardedArgs += FString::Printf(TEXT(" -BattleSim%s\"%s\""), ForwardedParam, *Value);
+		}
+	}
+	if (FParse::Param(*Params, TEXT("FleetBenchmark")))
+	{
+		ForwardedArgs += TEXT(" -FleetBenchmark");
+	}
+
+	// Memory tracking for the per tag peaks and budget warnings each process logs when it finishes
+	if (FParse::Param(*Params, TEXT("LLM")))
+	{
+		ForwardedArgs += TEXT(" -llm");
+	}
+
+	// Each process writes its own telemetry file, read them together with -run=TelemetryAnalyzer
+	if (FParse::Param(*Params, TEXT("Telemetry")))
+	{
+		ForwardedArgs += TEXT(" -Telemetry");
+	}
+
+	const FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BattleSim"));
+	const FString GameModePath = ABattleSimulationGameMode::StaticClass()->GetPathName();
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Launch Child Processes
+	TArray<FProcHandle> Processes;
+	TArray<TPair<FString, int32>> OutputFiles;
+	int32 FirstProcessMatch = 0;
+	for (int32 ProcessIndex = 0; ProcessIndex < ProcessCount; ++ProcessIndex)
+	{
+		const int32 ProcessMatches = MatchCount / ProcessCount + (ProcessIndex < MatchCount % ProcessCount ? 1 : 0);
+		const int32 MatchOffset = FirstProcessMatch;
+		FirstProcessMatch += ProcessMatches;
+		const FString OutputFile = FString::Printf(TEXT("BattleSimResults_%d.csv"), ProcessIndex);
+		IFileManager::Get().Delete(*FPaths::Combine(OutputDir, OutputFile));
+
+		const FString Args = FString::Printf(TEXT("\"%s\" %s?game=%s -game -nullrhi -nosound -unattended -nosplash -BattleSim -BattleSimMatches=%d -BattleSimSeed=%d -BattleSimOutput=%s%s"),
+			*ProjectPath, *MapName, *GameModePath, ProcessMatches, Seed + ProcessIndex * MatchCount, *OutputFile, *ForwardedArgs);
+
+		FProcHandle ProcessHandle = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Args, false, true, true, nullptr, 0, nullptr, nullptr);
+		if (!ProcessHandle.IsValid())
+		{
+			UE_LOG(LogBattleSimulationCommandlet, Error, TEXT("BattleSimulationCommandlet: Failed to launch process %d"), ProcessIndex);
+			continue;
+		}
+
+		Processes.Add(ProcessHandle);
+		OutputFiles.Emplace(FPaths::Combine(OutputDir, OutputFile), MatchOffset);
+	}
+
+	// Wait For All Processes
+	for (FProcHandle& ProcessHandle : Processes)
+	{
+		FPlatformProcess::WaitForProc(ProcessHandle);
+		FPlatformProcess::CloseProc(ProcessHandle);
+	}
+
+	// Merge Results
+	FString MergedResults;
+	int32 MergedRows = 0;
+	for (const TPair<FString, int32>& OutputFile : OutputFiles)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *OutputFile.Key)) continue;
+
+		for (int32 LineIndex = 0; LineIndex < Lines.Num(); ++LineIndex)
+		{
+			if (LineIndex == 0)
+			{
+				if (MergedResults.IsEmpty())
+				{
+					MergedResults += Lines[LineIndex] + TEXT("\n");
+				}
+				continue;
+			}
+
+			// Every process counts its matches from 0, the merged file numbers them across processes
+			FString MatchIndex;
+			FString Columns;
+			if (!Lines[LineIndex].Split(TEXT(","), &MatchIndex, &Columns)) continue;
+			MergedResults += FString::Printf(TEXT("%d,%s\n"), FCString::Atoi(*MatchIndex) + OutputFile.Value, *Columns);
+			++MergedRows;
+		}
+	}
+
+	const FString MergedFile = FPaths::Combine(OutputDir, TEXT("BattleSimResults.csv"));
+	FFileHelper::SaveStringToFile(MergedResults, *MergedFile);
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogBattleSimulationCommandlet, Display, TEXT("BattleSimulationCommandlet: %d matches over %d processes in %.1fs (%.0f matches/hour), merged into %s"),
+		MergedRows, Processes.Num(), ElapsedSeconds, ElapsedSeconds > 0.0 ? MergedRows * 3600.0 / ElapsedSeconds : 0.0, *MergedFile);
+
+	return MergedRows > 0 ? 0 : 1;
+}
@@ -0,0 +1,301 @@
+#include "Commandlets/TelemetryAnalyzerCommandlet.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Telemetry/ShipTelemetry.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTelemetryAnalyzerCommandlet, Log, All)
+
+namespace TelemetryAnalyzer
+{
+	static constexpr int32 NumDamageSources = 3;
+	static constexpr int32 NumCannonGroups = 2;
+
+	struct FShipLife
+	{
+		// Ship ids are reused when matches restart in one process, the serial tells their lives apart
+		int64 Serial = INDEX_NONE;
+		int32 Match = INDEX_NONE;
+		uint8 Team = 0;
+		double SpawnTime = 0.0;
+		double FirstDamageTime = -1.0;
+	};
+
+	struct FMatchStats
+	{
+		int32 Winner = INDEX_NONE;
+		float Duration = 0.0f;
+		int64 Shots = 0;
+		int64 Hits = 0;
+		double Damage[NumDamageSources] = {};
+		int32 Kills = 0;
+		double TimeAlive = 0.0;
+		double TimeToKill = 0.0;
+		int32 TimedKills = 0;
+		int32 Engagements[NumCannonGroups] = {};
+		double EngagementRange[NumCannonGroups] = {};
+
+		void Add(const FMatchStats& Other)
+		{
+			Shots += Other.Shots;
+			Hits += Other.Hits;
+			for (int32 Source = 0; Source < NumDamageSources; ++Source)
+			{
+				Damage[Source] += Other.Damage[Source];
+			}
+			Kills += Other.Kills;
+			TimeAlive += Other.TimeAlive;
+			TimeToKill += Other.TimeToKill;
+			TimedKills += Other.TimedKills;
+			for (int32 Group = 0; Group < NumCannonGroups; ++Group)
+			{
+				Engagements[Group] += Other.Engagements[Group];
+				EngagementRange[Group] += Other.EngagementRange[Group];
+			}
+		}
+
+		FORCEINLINE double GetAccuracy() const { return Shots > 0 ? (double)Hits / Shots : 0.0; }
+		FORCEINLINE double GetMeanTimeAlive() const { return Kills > 0 ? TimeAlive / Kills : 0.0; }
+		FORCEINLINE double GetMeanTimeToKill() const { return TimedKills > 0 ? TimeToKill / TimedKills : 0.0; }
+		FORCEINLINE double GetMeanRange(int32 Group) const { return Engagements[Group] > 0 ? EngagementRange[Group] / Engagements[Group] : 0.0; }
+	};
+
+	struct FPairStats
+	{
+		int32 Match = INDEX_NONE;
+		uint32 AttackerId = 0;
+		uint32 VictimId = 0;
+		uint8 AttackerTeam = 0;
+		uint8 VictimTeam = 0;
+		int32 Hits = 0;
+		double Damage = 0.0;
+		bool bKilled = false;
+	};
+
+	// Ids are object indices of one process, so every file is analysed on its own
+	struct FFileAnalysis
+	{
+		TMap<uint32, FShipLife> Lives;
+		TMap<int32, FMatchStats> Matches;
+		TMap<TPair<int64, int64>, FPairStats> Pairs;
+		int64 NextLifeSerial = 0;
+
+		int32 GetMatch(uint32 ShipId) const
+		{
+			const FShipLife* Life = Lives.Find(ShipId);
+			return Life ? Life->Match : INDEX_NONE;
+		}
+
+		// Ships never seen spawning keep their raw id, negated so it cannot meet a serial
+		int64 GetLifeKey(uint32 ShipId) const
+		{
+			const FShipLife* Life = Lives.Find(ShipId);
+			return Life ? Life->Serial : -(int64)ShipId - 1;
+		}
+
+		FPairStats& GetPair(uint32 Attacker, uint32 Victim)
+		{
+			const TPair<int64, int64> PairKey(GetLifeKey(Attacker), GetLifeKey(Victim));
+			FPairStats* Pair = Pairs.Find(PairKey);
+			if (!Pair)
+			{
+				Pair = &Pairs.Add(PairKey);
+				Pair->AttackerId = Attacker;
+				Pair->VictimId = Victim;
+				const FShipLife* AttackerLife = Lives.Find(Attacker);
+				const FShipLife* VictimLife = Lives.Find(Victim);
+				Pair->Match = VictimLife ? VictimLife->Match : AttackerLife ? AttackerLife->Match : INDEX_NONE;
+				Pair->AttackerTeam = AttackerLife ? AttackerLife->Team : 0;
+				Pair->VictimTeam = VictimLife ? VictimLife->Team : 0;
+			}
+			return *Pair;
+		}
+
+		void Process(const FShipTelemetryEvent& Event)
+		{
+			switch (Event.Type)
+			{
+			case EShipTelemetryEventType::Spawn:
+			{
+				FShipLife& Life = Lives.Add(Event.Subject);
+				Life.Serial = NextLifeSerial++;
+				Life.Team = Event.Detail;
+				Life.SpawnTime = Event.Time;
+				break;
+			}
+			case EShipTelemetryEventType::MatchJoin:
+			{
+				FShipLife& Life = Lives.FindOrAdd(Event.Subject);
+				if (Life.Serial == INDEX_NONE)
+				{
+					Life.Serial = NextLifeSerial++;
+				}
+				Life.Match = Event.Match;
+				break;
+			}
+			case EShipTelemetryEventType::MatchStart:
+				Matches.FindOrAdd(Event.Match);
+				break;
+			case EShipTelemetryEventType::MatchEnd:
+			{
+				FMatchStats& Stats = Matches.FindOrAdd(Event.Match);
+				Stats.Winner = Event.Detail;
+				Stats.Duration = Event.Value;
+				break;
+			}
+			case EShipTelemetryEventType::Shot:
+				++Matches.FindOrAdd(GetMatch(Event.Subject)).Shots;
+				break;
+			case EShipTelemetryEventType::Hit:
+				++Matches.FindOrAdd(Lives.Contains(Event.Subject) ? GetMatch(Event.Subject) : GetMatch(Event.Other)).Hits;
+				++GetPair(Event.Other, Event.Subject).Hits;
+				break;
+			case EShipTelemetryEventType::Damage:
+			{
+				Matches.FindOrAdd(GetMatch(Event.Subject)).Damage[FMath::Min<int32>(Event.Detail, NumDamageSources - 1)] += Event.Value;
+				if (FShipLife* Life = Lives.Find(Event.Subject); Life && Life->FirstDamageTime < 0.0)
+				{
+					Life->FirstDamageTime = Event.Time;
+				}
+				if (Event.Other != 0 && Event.Other != Event.Subject)
+				{
+					GetPair(Event.Other, Event.Subject).Damage += Event.Value;
+				}
+				break;
+			}
+			case EShipTelemetryEventType::Kill:
+			{
+				FMatchStats& Stats = Matches.FindOrAdd(GetMatch(Event.Subject));
+				++Stats.Kills;
+				if (const FShipLife* Life = Lives.Find(Event.Subject))
+				{
+					Stats.TimeAlive += Event.Time - Life->SpawnTime;
+					if (Life->FirstDamageTime >= 0.0)
+					{
+						Stats.TimeToKill += Event.Time - Life->FirstDamageTime;
+						++Stats.TimedKills;
+					}
+				}
+				if (Event.Other != 0 && Event.Other != Event.Subject)
+				{
+					GetPair(Event.Other, Event.Subject).bKilled = true;
+				}
+				break;
+			}
+			case EShipTelemetryEventType::Engage:
+			{
+				FMatchStats& Stats = Matches.FindOrAdd(GetMatch(Event.Subject));
+				const int32 Group = FMath::Min<int32>(Event.Detail, NumCannonGroups - 1);
+				++Stats.Engagements[Group];
+				Stats.EngagementRange[Group] += Event.Value;
+				break;
+			}
+			default:
+				break;
+			}
+		}
+	};
+}
+
+UTelemetryAnalyzerCommandlet::UTelemetryAnalyzerCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UTelemetryAnalyzerCommandlet::Main(const FString& Params)
+{
+	using namespace TelemetryAnalyzer;
+
+	FString InputPath = FShipTelemetry::GetTelemetryDir();
+	FParse::Value(*Params, TEXT("Input="), InputPath);
+
+	TArray<FString> InputFiles;
+	FString OutputDir;
+	if (IFileManager::Get().DirectoryExists(*InputPath))
+	{
+		IFileManager::Get().FindFiles(InputFiles, *(InputPath / TEXT("*.gatl")), true, false);
+		for (FString& InputFile : InputFiles)
+		{
+			InputFile = InputPath / InputFile;
+		}
+		OutputDir = InputPath;
+	}
+	else
+	{
+		InputFiles.Add(InputPath);
+		OutputDir = FPaths::GetPath(InputPath);
+	}
+	FParse::Value(*Params, TEXT("Output="), OutputDir);
+	InputFiles.Sort();
+
+	const double StartTime = FPlatformTime::Seconds();
+	FString Summary = TEXT("File,Match,Winner,Duration,Shots,Hits,Accuracy,ProjectileDamage,CollisionDamage,OtherDamage,Kills,MeanTimeToKill,MeanTimeAlive,PrimaryEngagements,MeanPrimaryRange,SecondaryEngagements,MeanSecondaryRange\n");
+	FString PairTable = TEXT("File,Match,Attacker,AttackerTeam,Victim,VictimTeam,Hits,Damage,Killed\n");
+	FMatchStats Totals;
+	int64 TotalEvents = 0;
+	int32 TotalMatches = 0;
+	int32 FilesRead = 0;
+
+	TArray<FShipTelemetryEvent> Events;
+	for (const FString& InputFile : InputFiles)
+	{
+		Events.Reset();
+		if (!FShipTelemetry::ReadFile(InputFile, Events))
+		{
+			UE_LOG(LogTelemetryAnalyzerCommandlet, Warning, TEXT("TelemetryAnalyzerCommandlet: %s is not a telemetry file"), *InputFile);
+			continue;
+		}
+
+		// Rings of different threads are flushed side by side, bring their events back into time order
+		Events.StableSort([](const FShipTelemetryEvent& A, const FShipTelemetryEvent& B) { return A.Time < B.Time; });
+
+		FFileAnalysis Analysis;
+		for (const FShipTelemetryEvent& Event : Events)
+		{
+			Analysis.Process(Event);
+		}
+
+		const FString FileName = FPaths::GetCleanFilename(InputFile);
+		Analysis.Matches.KeySort(TLess<int32>());
+		for (const TPair<int32, FMatchStats>& MatchPair : Analysis.Matches)
+		{
+			const FMatchStats& Stats = MatchPair.Value;
+			Summary += FString::Printf(TEXT("%s,%d,%d,%.2f,%lld,%lld,%.4f,%.1f,%.1f,%.1f,%d,%.2f,%.2f,%d,%.0f,%d,%.0f\n"),
+				*FileName, MatchPair.Key, Stats.Winner, Stats.Duration, Stats.Shots, Stats.Hits, Stats.GetAccuracy(),
+				Stats.Damage[(int32)EShipTelemetryDamageSource::Projectile], Stats.Damage[(int32)EShipTelemetryDamageSource::Collision], Stats.Damage[(int32)EShipTelemetryDamageSource::Other],
+				Stats.Kills, Stats.GetMeanTimeToKill(), Stats.GetMeanTimeAlive(),
+				Stats.Engagements[0], Stats.GetMeanRange(0), Stats.Engagements[1], Stats.GetMeanRange(1));
+
+			Totals.Add(Stats);
+			TotalMatches += MatchPair.Key != INDEX_NONE ? 1 : 0;
+		}
+
+		for (const TPair<TPair<int64, int64>, FPairStats>& PairEntry : Analysis.Pairs)
+		{
+			const FPairStats& Pair = PairEntry.Value;
+			PairTable += FString::Printf(TEXT("%s,%d,%u,%d,%u,%d,%d,%.1f,%d\n"),
+				*FileName, Pair.Match, Pair.AttackerId, Pair.AttackerTeam, Pair.VictimId, Pair.VictimTeam, Pair.Hits, Pair.Damage, Pair.bKilled ? 1 : 0);
+		}
+
+		TotalEvents += Events.Num();
+		++FilesRead;
+	}
+
+	const FString SummaryFile = FPaths::Combine(OutputDir, TEXT("TelemetrySummary.csv"));
+	const FString PairsFile = FPaths::Combine(OutputDir, TEXT("TelemetryPairs.csv"));
+	FFileHelper::SaveStringToFile(Summary, *SummaryFile);
+	FFileHelper::SaveStringToFile(PairTable, *PairsFile);
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	const double TotalDamage = Totals.Damage[0] + Totals.Damage[1] + Totals.Damage[2];
+	UE_LOG(LogTelemetryAnalyzerCommandlet, Display, TEXT("TelemetryAnalyzerCommandlet: %lld events from %d files (%d matches) in %.2fs. Accuracy %.1f%%, damage %.0f (%.1f%% projectiles, %.1f%% collisions), %d kills, mean time to kill %.2fs, mean engagement range %.0f primary / %.0f secondary. Written to %s and %s"),
+		TotalEvents, FilesRead, TotalMatches, ElapsedSeconds, Totals.GetAccuracy() * 100.0, TotalDamage,
+		TotalDamage > 0.0 ? Totals.Damage[(int32)EShipTelemetryDamageSource::Projectile] * 100.0 / TotalDamage : 0.0,
+		TotalDamage > 0.0 ? Totals.Damage[(int32)EShipTelemetryDamageSource::Collision] * 100.0 / TotalDamage : 0.0,
+		Totals.Kills, Totals.GetMeanTimeToKill(), Totals.GetMeanRange(0), Totals.GetMeanRange(1), *SummaryFile, *PairsFile);
+
+	return FilesRead > 0 ? 0 : 1;
+}
@@ -1,14 +1,95 @@
 #include "Components/CannonComponent.h"
+#include "GalacticArmada.h"
 #include "NiagaraFunctionLibrary.h"
-#include "TimerManager.h"
+#include "Actors/GuidedMissile.h"
 #include "Actors/ProjectileBase.h"
+#include "Data/ShipAssetBundles.h"
+#include "Data/ShipLoadoutDataAsset.h"
+#include "Engine/SkeletalMesh.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "GameFramework/Actor.h"
-#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipCameraFeedbackSubsystem.h"
+#include "Subsystems/ShipEventSubsystem.h"
+#include "Subsystems/ShipFidelitySubsystem.h"
+#include "Subsystems/ShipGunnerySubsystem.h"
+#include "Subsystems/ShipMissileSubsystem.h"
+#include "Subsystems/ShipVisibilitySubsystem.h"
+#include "Telemetry/ShipTelemetry.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCannonComponent, Log, All)
+
+namespace CannonLoadout
+{
+	// Shots an automatic cannon may fire in one tick to catch up, more were missed while the ship was dormant
+	static constexpr int32 MaxCatchUpShots = 4;
+
+	// Transient loadouts built from cannon arrays, keyed by the archetype whose array they copy
+	static TMap<TWeakObjectPtr<const UObject>, TWeakObjectPtr<UShipLoadoutDataAsset>> LegacyLoadouts;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs LoadoutBenchmarkCommand(
+	TEXT("ga.Loadout.Benchmark"),
+	TEXT("Spawns ships without starting them, resolves their cannon loadouts and logs per ship memory and time: ga.Loadout.Benchmark [Count] [ShipClassPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Count = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+
+		FString ShipClassPath = Args.IsValidIndex(1) ? Args[1] : FString();
+		if (ShipClassPath.IsEmpty())
+		{
+			const IConsoleVariable* DefaultShipClass = IConsoleManager::Get().FindConsoleVariable(TEXT("ga.Wave.DefaultShipClass"));
+			ShipClassPath = DefaultShipClass ? DefaultShipClass->GetString() : FString();
+		}
+
+		UClass* ShipClass = TSoftClassPtr<AShipPawn>(FSoftObjectPath(ShipClassPath)).LoadSynchronous();
+		const UCannonComponent* Archetype = ShipClass ? ShipClass->GetDefaultObject<AShipPawn>()->GetCannonComponent() : nullptr;
+		if (!World || !Archetype)
+		{
+			UE_LOG(LogCannonComponent, Warning, TEXT("CannonComponent: No cannon component on %s"), *ShipClassPath);
+			return;
+		}
+
+		// Deferred spawns get their components from the class archetypes like real ships, without begin play or AI
+		TArray<AShipPawn*> ShipPawns;
+		ShipPawns.Reserve(Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			if (AShipPawn* ShipPawn = World->SpawnActorDeferred<AShipPawn>(ShipClass, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn))
+			{
+				ShipPawns.Add(ShipPawn);
+			}
+		}
+
+		const int32 LegacyLoadoutsBefore = CannonLoadout::LegacyLoadouts.Num();
+		const double StartTime = FPlatformTime::Seconds();
+		for (AShipPawn* ShipPawn : ShipPawns)
+		{
+			ShipPawn->GetCannonComponent()->InitializeLoadout();
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		const int32 NewLegacyLoadouts = CannonLoadout::LegacyLoadouts.Num() - LegacyLoadoutsBefore;
+
+		SIZE_T TotalBytes = 0;
+		for (AShipPawn* ShipPawn : ShipPawns)
+		{
+			const UCannonComponent* CannonComponent = ShipPawn->GetCannonComponent();
+			TotalBytes += CannonComponent->GetClass()->GetStructureSize() + CannonComponent->GetAllocatedSize();
+			ShipPawn->Destroy();
+		}
+
+		const int32 NumShips = FMath::Max(ShipPawns.Num(), 1);
+		UE_LOG(LogCannonComponent, Log, TEXT("CannonComponent: %d ships of %s resolved %s in %.2fms, %.2fus and %llu bytes per ship, %d transient loadouts built"),
+			ShipPawns.Num(), *ShipClass->GetName(), Archetype->Loadout ? *Archetype->Loadout->GetName() : TEXT("a cannon array"),
+			Seconds * 1000.0, Seconds * 1000000.0 / NumShips, static_cast<uint64>(TotalBytes / NumShips), NewLegacyLoadouts);
+	}));
 
 UCannonComponent::UCannonComponent()
 {
+	// Only ticks while an automatic cannon is firing
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	if (GetOwner())
 	{
@@ -30,44 +111,158 @@ void UCannonComponent::BeginPlay()
 	{
 		OwnerSkeletalMeshComponent = Owner->FindComponentByClass<USkeletalMeshComponent>();
 	}
-	
-	// Initialize Sequential Cannon Mode
-	SequentialCannonIndices.SetNum(CannonFirePropertiesArray.Num());
-	for (int32 i = 0; i < SequentialCannonIndices.Num(); ++i)
-	{
-		SequentialCannonIndices[i] = 0;
-	}
 
-	// Initialize Automatic Fire Timers
-	AutomaticFireTimers.SetNum(CannonFirePropertiesArray.Num());
+	InitializeLoadout();
 }
 
 void UCannonComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	// Clear All Timers
-	for (FTimerHandle& TimerHandle : AutomaticFireTimers)
+	// Stop All Cannons
+	for (FCannonFireState& FireState : FireStates)
+	{
+		FireState.bFiring = false;
+	}
+}
+
+UShipLoadoutDataAsset* UCannonComponent::GetLoadout() const
+{
+	if (ActiveLoadout) return ActiveLoadout;
+	if (Loadout) return Loadout;
+	if (CannonFirePropertiesArray.Num() == 0) return nullptr;
+
+	// Ships spawned from the same class share one transient loadout, instances with edited cannons get their own
+	const UObject* SharingKey = this;
+	if (!IsTemplate())
+	{
+		const UCannonComponent* Archetype = Cast<UCannonComponent>(GetArchetype());
+		const FProperty* CannonsProperty = UCannonComponent::StaticClass()->FindPropertyByName(GET_MEMBER_NAME_CHECKED(UCannonComponent, CannonFirePropertiesArray));
+		if (Archetype && CannonsProperty && CannonsProperty->Identical_InContainer(this, Archetype) && FireCameraShake == Archetype->FireCameraShake)
+		{
+			SharingKey = Archetype;
+		}
+	}
+
+	if (const TWeakObjectPtr<UShipLoadoutDataAsset>* LegacyLoadout = CannonLoadout::LegacyLoadouts.Find(SharingKey))
 	{
-		GetWorld()->GetTimerManager().ClearTimer(TimerHandle);
+		if (LegacyLoadout->IsValid()) return LegacyLoadout->Get();
+	}
+
+	// Drop the entries of archetypes, edited instances and loadouts that are gone before adding another
+	for (auto LoadoutIterator = CannonLoadout::LegacyLoadouts.CreateIterator(); LoadoutIterator; ++LoadoutIterator)
+	{
+		if (!LoadoutIterator->Key.IsValid() || !LoadoutIterator->Value.IsValid())
+		{
+			LoadoutIterator.RemoveCurrent();
+		}
+	}
+
+	UShipLoadoutDataAsset* LegacyLoadout = UShipLoadoutDataAsset::CreateTransient(CannonFirePropertiesArray, FireCameraShake);
+	CannonLoadout::LegacyLoadouts.Add(SharingKey, LegacyLoadout);
+	return LegacyLoadout;
+}
+
+void UCannonComponent::InitializeLoadout()
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_Cannons);
+	// Pooled ships initialize again, so the loadout is resolved afresh
+	ActiveLoadout = nullptr;
+	FireStates.Reset();
+	CachedSocketTransforms.Reset();
+	bUseCachedSocketTransforms = false;
+
+	ActiveLoadout = GetLoadout();
+	if (ActiveLoadout)
+	{
+		// Projectiles are preloaded with the ship, anything still missing loads here rather than on the first shot
+		ActiveLoadout->ResolveProjectiles(true);
+		FireStates.SetNum(ActiveLoadout->GetNumCannons());
+	}
+}
+
+void UCannonComponent::RestoreFireStates(TConstArrayView<FCannonFireState> States)
+{
+	const int32 NumStates = FMath::Min(States.Num(), FireStates.Num());
+	FMemory::Memcpy(FireStates.GetData(), States.GetData(), NumStates * sizeof(FCannonFireState));
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	bool bAnyFiring = false;
+	for (int32 CannonIndex = 0; CannonIndex < NumStates; ++CannonIndex)
+	{
+		FireStates[CannonIndex].NextFireTime += WorldTime;
+		bAnyFiring |= FireStates[CannonIndex].bFiring;
+	}
+
+	SetComponentTickEnabled(bAnyFiring);
+}
+
+SIZE_T UCannonComponent::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = CannonFirePropertiesArray.GetAllocatedSize() + FireStates.GetAllocatedSize() + CachedSocketTransforms.GetAllocatedSize();
+	for (const FCannonFireProperties& CannonFireProps : CannonFirePropertiesArray)
+	{
+		AllocatedSize += CannonFireProps.FireLocationSocketNames.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
+
+void UCannonComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(GetAllocatedSize());
+}
+
+void UCannonComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	bool bAnyFiring = false;
+
+	for (int32 CannonIndex = 0; CannonIndex < FireStates.Num(); ++CannonIndex)
+	{
+		FCannonFireState& FireState = FireStates[CannonIndex];
+		if (!FireState.bFiring) continue;
+
+		// Catch up on shots a long frame skipped, like the looping timer did, unless a listener stops the cannon
+		const float FireInterval = ActiveLoadout->GetCannon(CannonIndex).FireInterval;
+		if (WorldTime - FireState.NextFireTime > FireInterval * CannonLoadout::MaxCatchUpShots)
+		{
+			FireState.NextFireTime = WorldTime;
+		}
+
+		while (FireState.bFiring && WorldTime >= FireState.NextFireTime)
+		{
+			FireState.NextFireTime += FireInterval;
+			FireCannon(CannonIndex);
+		}
+
+		bAnyFiring |= FireState.bFiring;
+	}
+
+	if (!bAnyFiring)
+	{
+		SetComponentTickEnabled(false);
 	}
 }
 
 void UCannonComponent::BeginCannonFire(int32 CannonIndex)
 {
-	if (!CannonFirePropertiesArray.IsValidIndex(CannonIndex))
+	if (!ActiveLoadout || !ActiveLoadout->IsValidCannon(CannonIndex))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("CannonComponent: Failed to fire, Invalid CannonIndex: %d"), CannonIndex);
+		UE_LOG(LogCannonComponent, Warning, TEXT("CannonComponent: Failed to fire, Invalid CannonIndex: %d"), CannonIndex);
 		return;
 	}
 
-	const FCannonFireProperties& CannonFireProps = CannonFirePropertiesArray[CannonIndex];
-	if (!CannonFireProps.Enabled || !OwnerSkeletalMeshComponent)
+	const FShipLoadoutCannon& Cannon = ActiveLoadout->GetCannon(CannonIndex);
+	if (!Cannon.bEnabled || !OwnerSkeletalMeshComponent)
 	{
 		return;
 	}
 
-	if (CannonFireProps.IsAutomaticFire)
+	if (Cannon.bAutomatic)
 	{
 		StartAutomaticFire(CannonIndex);
 	}
@@ -79,108 +274,185 @@ void UCannonComponent::BeginCannonFire(int32 CannonIndex)
 
 void UCannonComponent::EndCannonFire(int32 CannonIndex)
 {
-	if (CannonFirePropertiesArray.IsValidIndex(CannonIndex))
+	if (FireStates.IsValidIndex(CannonIndex))
 	{
 		StopAutomaticFire(CannonIndex);
 	}
 }
 
-void UCannonComponent::FireCannon(int32 CannonIndex)
+void UCannonComponent::EndAllCannonFire()
 {
-	if (!CannonFirePropertiesArray.IsValidIndex(CannonIndex)) return;
+	for (int32 CannonIndex = 0; CannonIndex < FireStates.Num(); ++CannonIndex)
+	{
+		StopAutomaticFire(CannonIndex);
+	}
+}
 
-	const FCannonFireProperties& CannonFireProps = CannonFirePropertiesArray[CannonIndex];
+void UCannonComponent::FireCannon(int32 CannonIndex)
+{
+	if (!ActiveLoadout || !ActiveLoadout->IsValidCannon(CannonIndex)) return;
 
-	switch (CannonFireProps.CannonFireMode)
+	switch (ActiveLoadout->GetCannon(CannonIndex).FireMode)
 	{
 	case ECannonFireMode::All:
-		FireAllCannons(CannonFireProps);
+		FireAllCannons(CannonIndex);
 		break;
 	case ECannonFireMode::Sequential:
-		FireSequentialCannon(CannonFireProps, SequentialCannonIndices[CannonIndex]);
+		FireSequentialCannon(CannonIndex);
 		break;
 	}
 
-	// Play Fire Camera Shake
-	if (FireCameraShake)
+#if GA_WITH_COSMETICS
+	// Play Fire Camera Shake, merged with every other shot of the frame
+	if (UClass* FireCameraShakeClass = ActiveLoadout->FireCameraShake.Get())
 	{
-		UGameplayStatics::PlayWorldCameraShake(this, FireCameraShake, GetOwner()->GetActorLocation(), 0.0f, 1000.0f);
+		if (UShipCameraFeedbackSubsystem* CameraFeedbackSubsystem = GetWorld()->GetSubsystem<UShipCameraFeedbackSubsystem>())
+		{
+			CameraFeedbackSubsystem->AddWorldShake(EShipCameraShakeCategory::Fire, FireCameraShakeClass, GetOwner()->GetActorLocation(), 0.0f, 1000.0f);
+		}
 	}
+#endif
 
-	// Broadcast Fire Event
-	OnCannonFired.Broadcast(CannonIndex);
+	// Broadcast Fire Event, natively in the frame's batch and to Blueprints while they listen
+	if (UShipEventSubsystem* EventSubsystem = UShipEventSubsystem::Get(this))
+	{
+		EventSubsystem->GetFireChannel().Publish({ this, CannonIndex });
+	}
+
+	if (OnCannonFired.IsBound())
+	{
+		OnCannonFired.Broadcast(CannonIndex);
+	}
 }
 
-void UCannonComponent::FireAllCannons(const FCannonFireProperties& CannonFireProps) const
+void UCannonComponent::FireAllCannons(int32 CannonIndex) const
 {
-	for (const FName& SocketName : CannonFireProps.FireLocationSocketNames)
+	for (int32 SocketIndex = 0; SocketIndex < ActiveLoadout->GetCannon(CannonIndex).NumSockets; ++SocketIndex)
 	{
-		const USkeletalMeshSocket* Socket = OwnerSkeletalMeshComponent->GetSocketByName(SocketName);
-		if (!Socket || !CannonFireProps.ProjectileClass) continue;
+		FireFromSocket(CannonIndex, SocketIndex);
+	}
+}
 
-		FTransform SocketTransform = Socket->GetSocketTransform(OwnerSkeletalMeshComponent);
-		if (UWorld* World = GetWorld())
-		{
-			// Spawn Projectile
-			World->SpawnActor<AProjectileBase>(CannonFireProps.ProjectileClass, SocketTransform.GetLocation(), SocketTransform.GetRotation().Rotator(), ProjectileSpawnParams);
+void UCannonComponent::FireSequentialCannon(int32 CannonIndex)
+{
+	const int32 NumSockets = ActiveLoadout->GetCannon(CannonIndex).NumSockets;
+	if (NumSockets == 0) return;
 
-			// Spawn Muzzle Effect
-			if (CannonFireProps.MuzzleParticleEffect)
-			{
-				UNiagaraFunctionLibrary::SpawnSystemAttached(CannonFireProps.MuzzleParticleEffect, OwnerSkeletalMeshComponent, SocketName, FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::KeepRelativeOffset, true);
-			}
-		}
-	}
+	FCannonFireState& FireState = FireStates[CannonIndex];
+	FireFromSocket(CannonIndex, FireState.NextSocket);
+
+	// Increment Index
+	FireState.NextSocket = static_cast<uint8>((FireState.NextSocket + 1) % NumSockets);
 }
 
-void UCannonComponent::FireSequentialCannon(const FCannonFireProperties& CannonFireProps, int32& CurrentCannonIndex) const
+void UCannonComponent::FireFromSocket(int32 CannonIndex, int32 SocketIndex) const
 {
-	if (CannonFireProps.FireLocationSocketNames.Num() == 0) return;
+	const FShipLoadoutCannon& Cannon = ActiveLoadout->GetCannon(CannonIndex);
+	if (!Cannon.ProjectileClass) return;
 
-	const FName& SocketName = CannonFireProps.FireLocationSocketNames[CurrentCannonIndex];
-	const USkeletalMeshSocket* Socket = OwnerSkeletalMeshComponent->GetSocketByName(SocketName);
+	UWorld* World = GetWorld();
+	if (!World) return;
 
-	if (Socket && CannonFireProps.ProjectileClass)
+	const int32 LoadoutSocketIndex = Cannon.FirstSocket + SocketIndex;
+
+	FTransform SocketTransform;
+	if (bUseCachedSocketTransforms)
 	{
-		const FTransform SocketTransform = Socket->GetSocketTransform(OwnerSkeletalMeshComponent);
-		if (UWorld* World = GetWorld())
-		{
-			// Spawn Projectile
-			World->SpawnActor<AProjectileBase>(CannonFireProps.ProjectileClass, SocketTransform.GetLocation(), SocketTransform.GetRotation().Rotator(), ProjectileSpawnParams);
+		SocketTransform = CachedSocketTransforms[LoadoutSocketIndex] * OwnerSkeletalMeshComponent->GetComponentTransform();
+	}
+	else
+	{
+		// Socket indices are resolved once per mesh and shared by every ship flying it
+		const USkeletalMesh* SkeletalMesh = OwnerSkeletalMeshComponent->GetSkeletalMeshAsset();
+		const int32 MeshSocketIndex = SkeletalMesh ? ActiveLoadout->GetMeshSocketIndices(SkeletalMesh)[LoadoutSocketIndex] : INDEX_NONE;
+		const USkeletalMeshSocket* Socket = MeshSocketIndex != INDEX_NONE ? SkeletalMesh->GetSocketByIndex(MeshSocketIndex) : nullptr;
+		if (!Socket) return;
+		SocketTransform = Socket->GetSocketTransform(OwnerSkeletalMeshComponent);
+	}
+
+	// Spawn Projectile, missiles come from the missile pool and lock on at launch
+	UShipMissileSubsystem* MissileSubsystem = Cannon.bGuided ? World->GetSubsystem<UShipMissileSubsystem>() : nullptr;
+	if (MissileSubsystem)
+	{
+		MissileSubsystem->LaunchMissile(Cannon.ProjectileClass, FTransform(SocketTransform.GetRotation(), SocketTransform.GetLocation()), ProjectileSpawnParams);
+	}
+	else
+	{
+		LLM_SCOPE_BYTAG(GalacticArmada_Projectiles);
+		World->SpawnActor<AProjectileBase>(Cannon.ProjectileClass, SocketTransform.GetLocation(), SocketTransform.GetRotation().Rotator(), ProjectileSpawnParams);
+	}
+
+	if (UShipGunnerySubsystem* GunnerySubsystem = World->GetSubsystem<UShipGunnerySubsystem>())
+	{
+		GunnerySubsystem->NotifyShotFired(PawnOwner);
+	}
+
+	if (UShipVisibilitySubsystem* VisibilitySubsystem = World->GetSubsystem<UShipVisibilitySubsystem>())
+	{
+		VisibilitySubsystem->NotifyShotFired(PawnOwner);
+	}
+
+	FShipTelemetry::Record(EShipTelemetryEventType::Shot, PawnOwner, nullptr, 0.0f, CannonIndex);
+
+	// Spawn Muzzle Effect, AI muzzle flashes share the fidelity governor's per frame budget
+	UNiagaraSystem* MuzzleParticleEffect = ActiveLoadout->Cannons[CannonIndex].MuzzleParticleEffect.Get();
+	UShipFidelitySubsystem* FidelitySubsystem = World->GetSubsystem<UShipFidelitySubsystem>();
+	if (MuzzleParticleEffect && !bUseCachedSocketTransforms && GalacticArmada::ShouldPlayCosmetics(this)
+		&& (PawnOwner->IsPlayerControlled() || !FidelitySubsystem || FidelitySubsystem->ConsumeFXSpawn()))
+	{
+		LLM_SCOPE_BYTAG(GalacticArmada_FX);
+		UNiagaraFunctionLibrary::SpawnSystemAttached(MuzzleParticleEffect, OwnerSkeletalMeshComponent, ActiveLoadout->GetSocketName(CannonIndex, SocketIndex), FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::KeepRelativeOffset, true);
+	}
+}
 
-			// Spawn Muzzle Effect
-			if (CannonFireProps.MuzzleParticleEffect)
+void UCannonComponent::SetUseCachedSocketTransforms(bool bUseCached)
+{
+	const int32 NumSockets = ActiveLoadout ? ActiveLoadout->GetNumSockets() : 0;
+	if (bUseCached && OwnerSkeletalMeshComponent && CachedSocketTransforms.Num() != NumSockets)
+	{
+		// Capture component space socket transforms once, the proxy ship never animates
+		CachedSocketTransforms.SetNum(NumSockets);
+		for (int32 CannonIndex = 0; CannonIndex < ActiveLoadout->GetNumCannons(); ++CannonIndex)
+		{
+			const FShipLoadoutCannon& Cannon = ActiveLoadout->GetCannon(CannonIndex);
+			for (int32 SocketIndex = 0; SocketIndex < Cannon.NumSockets; ++SocketIndex)
 			{
-				UNiagaraFunctionLibrary::SpawnSystemAttached(CannonFireProps.MuzzleParticleEffect, OwnerSkeletalMeshComponent, SocketName, FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::KeepRelativeOffset, true);
+				CachedSocketTransforms[Cannon.FirstSocket + SocketIndex] = OwnerSkeletalMeshComponent->GetSocketTransform(ActiveLoadout->GetSocketName(CannonIndex, SocketIndex), RTS_Component);
 			}
 		}
 	}
 
-	// Increment Index
-	CurrentCannonIndex = (CurrentCannonIndex + 1) % CannonFireProps.FireLocationSocketNames.Num();
+	bUseCachedSocketTransforms = bUseCached && OwnerSkeletalMeshComponent && CachedSocketTransforms.Num() == NumSockets;
 }
 
-void UCannonComponent::StartAutomaticFire(int32 CannonIndex)
+void UCannonComponent::GatherAssetBundles(FShipAssetBundles& OutBundles) const
 {
-	if (AutomaticFireTimers[CannonIndex].IsValid()) return;
+	if (Loadout)
+	{
+		Loadout->GatherAssetBundles(OutBundles);
+		return;
+	}
 
-	const FCannonFireProperties& CannonFireProps = CannonFirePropertiesArray[CannonIndex];
-	const float TimeBetweenShots = 60 / CannonFireProps.FireRate;
-	const float FirstDelay = FMath::Max(GetWorld()->GetTimeSeconds() + TimeBetweenShots - GetWorld()->TimeSeconds, 0.0f);
+	for (const FCannonFireProperties& CannonFireProps : CannonFirePropertiesArray)
+	{
+		OutBundles.AddGameplay(CannonFireProps.ProjectileClass);
+		OutBundles.AddCosmetic(CannonFireProps.MuzzleParticleEffect);
+	}
+	OutBundles.AddCosmetic(FireCameraShake);
+}
 
-	GetWorld()->GetTimerManager().SetTimer(
-		AutomaticFireTimers[CannonIndex],
-		FTimerDelegate::CreateUObject(this, &UCannonComponent::FireCannon, CannonIndex),
-		TimeBetweenShots,
-		true,
-		FirstDelay
-	);
+void UCannonComponent::StartAutomaticFire(int32 CannonIndex)
+{
+	FCannonFireState& FireState = FireStates[CannonIndex];
+	if (FireState.bFiring) return;
+
+	// First shot one interval after the trigger, as the looping timer fired
+	FireState.bFiring = true;
+	FireState.NextFireTime = GetWorld()->GetTimeSeconds() + ActiveLoadout->GetCannon(CannonIndex).FireInterval;
+	SetComponentTickEnabled(true);
 }
 
 void UCannonComponent::StopAutomaticFire(int32 CannonIndex)
 {
-	if (AutomaticFireTimers[CannonIndex].IsValid())
-	{
-		GetWorld()->GetTimerManager().ClearTimer(AutomaticFireTimers[CannonIndex]);
-	}
-}
\ No newline at end of file
+	FireStates[CannonIndex].bFiring = false;
+}
@@ -1,8 +1,13 @@
 #include "Components/HealthComponent.h"
+#include "GalacticArmada.h"
+#include "Actors/ProjectileBase.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/Controller.h"
 #include "Engine/World.h"
 #include "GameFramework/DamageType.h"
+#include "Subsystems/ShipEventSubsystem.h"
+#include "Subsystems/ShipExplosionSubsystem.h"
+#include "Telemetry/ShipTelemetry.h"
 
 UHealthComponent::UHealthComponent()
 {
@@ -10,6 +15,7 @@ UHealthComponent::UHealthComponent()
 
 void UHealthComponent::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(GalacticArmada_Health);
     Super::BeginPlay();
 
     Health = DefaultHealth;
@@ -17,9 +23,23 @@ void UHealthComponent::BeginPlay()
     if (AActor* Owner = GetOwner())
     {
         Owner->OnTakeAnyDamage.AddDynamic(this, &UHealthComponent::HandleTakeAnyDamage);
-        Owner->OnTakePointDamage.AddDynamic(this, &UHealthComponent::HandleTakePointDamage);
-        Owner->OnTakeRadialDamage.AddDynamic(this, &UHealthComponent::HandleTakeRadialDamage);
+
+        // Splash damage only reaches actors the explosion subsystem knows about
+        if (UShipExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UShipExplosionSubsystem>())
+        {
+            ExplosionSubsystem->RegisterDamageable(Owner);
+        }
+    }
+}
+
+void UHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UShipExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UShipExplosionSubsystem>())
+    {
+        ExplosionSubsystem->UnregisterDamageable(GetOwner());
     }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void UHealthComponent::HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
@@ -31,20 +51,32 @@ void UHealthComponent::HandleTakeAnyDamage(AActor* DamagedActor, float Damage, c
 
     Health = FMath::Clamp(Health - Damage, 0.0f, DefaultHealth);
 
-    OnHealthChanged.Broadcast(this, Health, Damage, DamageType, InstigatedBy, DamageCauser);
+    if (FShipTelemetry::IsEnabled())
+    {
+        // Ships hurt themselves in collisions
+        const EShipTelemetryDamageSource Source = DamageCauser == DamagedActor ? EShipTelemetryDamageSource::Collision
+            : DamageCauser && DamageCauser->IsA<AProjectileBase>() ? EShipTelemetryDamageSource::Projectile : EShipTelemetryDamageSource::Other;
+        const AActor* DamagingActor = InstigatedBy && InstigatedBy->GetPawn() ? InstigatedBy->GetPawn() : DamageCauser;
+        FShipTelemetry::Record(EShipTelemetryEventType::Damage, DamagedActor, DamagingActor, Damage, (uint8)Source);
+    }
 
-    if (Health <= 0.0f)
+    // Native subscribers get the events in the frame's batch, the dynamic delegates only serve Blueprints
+    if (UShipEventSubsystem* EventSubsystem = UShipEventSubsystem::Get(this))
     {
-        OnDeath.Broadcast(InstigatedBy, DamageCauser);
+        EventSubsystem->GetDamageChannel().Publish({ this, InstigatedBy, DamageCauser, DamageType, Health, Damage });
+        if (Health <= 0.0f)
+        {
+            EventSubsystem->GetDeathChannel().Publish({ this, InstigatedBy, DamageCauser });
+        }
     }
-}
 
-void UHealthComponent::HandleTakePointDamage(AActor* DamagedActor, float Damage, class AController* InstigatedBy, FVector HitLocation, class UPrimitiveComponent* FHitComponent, FName BoneName, FVector ShotFromDirection, const class UDamageType* DamageType, AActor* DamageCauser)
-{
-    HandleTakeAnyDamage(DamagedActor, Damage, DamageType, InstigatedBy, DamageCauser);
-}
+    if (OnHealthChanged.IsBound())
+    {
+        OnHealthChanged.Broadcast(this, Health, Damage, DamageType, InstigatedBy, DamageCauser);
+    }
 
-void UHealthComponent::HandleTakeRadialDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, class AController* InstigatedBy, AActor* DamageCauser)
-{
-    HandleTakeAnyDamage(DamagedActor, Damage, DamageType, InstigatedBy, DamageCauser);
+    if (Health <= 0.0f && OnDeath.IsBound())
+    {
+        OnDeath.Broadcast(InstigatedBy, DamageCauser);
+    }
 }
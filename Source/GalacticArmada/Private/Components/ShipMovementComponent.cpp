@@ -1,4 +1,33 @@
 #include "Components/ShipMovementComponent.h"
+#include "GalacticArmada.h"
+#include "Components/PrimitiveComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipMovement, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Movement Tick"), STAT_ShipMovementTick, STATGROUP_GalacticArmada);
+DECLARE_CYCLE_STAT(TEXT("Ship Movement Async Physics Tick"), STAT_ShipMovementAsyncPhysicsTick, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ship Transform Commits"), STAT_ShipTransformCommits, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<int32> CVarAsyncPhysicsFlight(
+	TEXT("ga.Ship.AsyncPhysicsFlight"),
+	-1,
+	TEXT("Overrides bUseAsyncPhysicsFlight on ships that begin play afterwards. -1: use the ship setting, 0: game thread movement, 1: async physics flight, needs bTickPhysicsAsync in the physics settings."));
+
+namespace ShipMovement
+{
+	static uint64 NumTransformCommits = 0;
+
+	FORCEINLINE void CountTransformCommit()
+	{
+		++NumTransformCommits;
+		INC_DWORD_STAT(STAT_ShipTransformCommits);
+		CSV_CUSTOM_STAT(GalacticArmada, ShipTransformCommits, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
 
 UShipMovementComponent::UShipMovementComponent()
 {
@@ -19,60 +48,239 @@ UShipMovementComponent::UShipMovementComponent()
 	Acceleration = 500.0f;
 	Deceleration = 300.0f;
 
-	CurrentYawInput = 0.0f;
-	CurrentPitchInput = 0.0f;
-	CurrentRollInput = 0.0f;
-	CurrentThrustInput = 0.0f;
+	bUseAsyncPhysicsFlight = false;
+	LinearResponse = 0.5f;
+	AngularResponse = 0.5f;
+
+	FlightParams = MakeFlightParams();
+}
+
+void UShipMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Pick up values edited in Blueprint defaults
+	FlightParams = MakeFlightParams();
+
+	// Hand flight over to the physics thread when the ship is simulated
+	const int32 AsyncPhysicsFlightOverride = CVarAsyncPhysicsFlight.GetValueOnGameThread();
+	if (AsyncPhysicsFlightOverride >= 0 ? AsyncPhysicsFlightOverride > 0 : bUseAsyncPhysicsFlight)
+	{
+		if (!StartAsyncPhysicsFlight())
+		{
+			UE_LOG(LogShipMovement, Warning, TEXT("ShipMovementComponent: Async physics flight needs bTickPhysicsAsync and a simulating root component on %s, falling back to game thread movement."), *GetNameSafe(GetOwner()));
+		}
+	}
+}
+
+bool UShipMovementComponent::StartAsyncPhysicsFlight()
+{
+	// Thrust and torque are applied from the async physics tick, which needs physics to tick asynchronously
+	if (!UPhysicsSettings::Get()->bTickPhysicsAsync) return false;
+
+	UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent());
+	if (!RootPrimitive || !RootPrimitive->IsSimulatingPhysics()) return false;
+
+	RootPrimitive->SetEnableGravity(false);
+	FlightBodyInstance = RootPrimitive->GetBodyInstance();
+	AsyncFlightState = FlightState;
+	PublishedFlightState = FlightState;
+	bAsyncFlightActive = true;
+	BufferFlightInput();
+	SetAsyncPhysicsTickEnabled(true);
+	return true;
+}
 
-	CurrentYaw = 0.0f;
-	CurrentPitch = 0.0f;
-	CurrentRoll = 0.0f;
-	CurrentSpeed = 0.0f;
+void UShipMovementComponent::StopAsyncPhysicsFlight()
+{
+	if (!bAsyncFlightActive) return;
+
+	SetAsyncPhysicsTickEnabled(false);
+	bAsyncFlightActive = false;
+
+	// Waits out a physics step already in flight, which holds the lock for its whole update
+	FScopeLock Lock(&AsyncFlightLock);
+	FlightBodyInstance = nullptr;
+	FlightState = PublishedFlightState;
+}
+
+void UShipMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopAsyncPhysicsFlight();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UShipMovementComponent::SetKinematicFlight(bool bEnable)
+{
+	if (bKinematicFlight == bEnable) return;
+	bKinematicFlight = bEnable;
+
+	if (bKinematicFlight)
+	{
+		bResumeAsyncFlight = bAsyncFlightActive;
+		StopAsyncPhysicsFlight();
+	}
+	else if (bResumeAsyncFlight)
+	{
+		bResumeAsyncFlight = false;
+		StartAsyncPhysicsFlight();
+	}
 }
 
 void UShipMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SCOPE_CYCLE_COUNTER(STAT_ShipMovementTick);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipMovement);
+
+	// Physics thread owns the flight state, just pick up its latest result
+	if (bAsyncFlightActive)
+	{
+		FScopeLock Lock(&AsyncFlightLock);
+		FlightState = PublishedFlightState;
+		return;
+	}
 
-	UpdateRotationMovement(DeltaTime, CurrentRoll, CurrentRollInput, FlapAngle, FlapSpeed, FRotator(0.0f, 0.0f, 1.0f));
-	UpdateRotationMovement(DeltaTime, CurrentPitch, -CurrentPitchInput, ElevatorAngle, ElevatorSpeed, FRotator(1.0f, 0.0f, 0.0f));
-	UpdateRotationMovement(DeltaTime, CurrentYaw, CurrentYawInput, RudderAngle, RudderSpeed, FRotator(0.0f, 1.0f, 0.0f));
-	UpdateThrustMovement(DeltaTime);
+	ShipFlight::UpdateState(FlightParams, FlightInput, DeltaTime, FlightState);
+
+	// Proxies have no physics body to sweep, move them in a single unswept update
+	if (bKinematicFlight)
+	{
+		UpdateKinematicMovement(DeltaTime);
+		return;
+	}
+
+	UpdateFlightMovement(DeltaTime);
 }
 
 void UShipMovementComponent::SetYawInput(float InputValue)
 {
-	CurrentYawInput = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	FlightInput.Yaw = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	BufferFlightInput();
 }
 
 void UShipMovementComponent::SetPitchInput(float InputValue)
 {
-	CurrentPitchInput = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	FlightInput.Pitch = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	BufferFlightInput();
 }
 
 void UShipMovementComponent::SetRollInput(float InputValue)
 {
-	CurrentRollInput = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	FlightInput.Roll = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	BufferFlightInput();
 }
 
 void UShipMovementComponent::SetThrustInput(float InputValue)
 {
-	CurrentThrustInput = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	FlightInput.Thrust = FMath::Clamp(InputValue, -1.0f, 1.0f);
+	BufferFlightInput();
 }
 
-void UShipMovementComponent::UpdateRotationMovement(float DeltaSeconds, float& CurrentValue, float InputValue, float MaxAngle,
-	float Speed, FRotator RotationAxis)
+void UShipMovementComponent::SetFlightInput(const FShipFlightInput& InputValue)
 {
-	const float TargetValue = InputValue * MaxAngle;
-	CurrentValue = FMath::FInterpTo(CurrentValue, TargetValue, DeltaSeconds, Speed);
-	FHitResult HitResult;
-	GetOwner()->AddActorLocalRotation(RotationAxis * CurrentValue * DeltaSeconds, true, &HitResult, ETeleportType::TeleportPhysics);
+	FlightInput.Roll = FMath::Clamp(InputValue.Roll, -1.0f, 1.0f);
+	FlightInput.Pitch = FMath::Clamp(InputValue.Pitch, -1.0f, 1.0f);
+	FlightInput.Yaw = FMath::Clamp(InputValue.Yaw, -1.0f, 1.0f);
+	FlightInput.Thrust = FMath::Clamp(InputValue.Thrust, -1.0f, 1.0f);
+	BufferFlightInput();
+}
+
+void UShipMovementComponent::SetFlightState(const FShipFlightState& StateValue)
+{
+	FlightState = StateValue;
+	if (!bAsyncFlightActive) return;
+
+	FScopeLock Lock(&AsyncFlightLock);
+	AsyncFlightState = StateValue;
+	PublishedFlightState = StateValue;
+}
+
+void UShipMovementComponent::BufferFlightInput()
+{
+	if (bAsyncFlightActive)
+	{
+		FScopeLock Lock(&AsyncFlightLock);
+		BufferedFlightInput = FlightInput;
+	}
+}
+
+void UShipMovementComponent::AsyncPhysicsTickComponent(float DeltaTime, float SimTime)
+{
+	Super::AsyncPhysicsTickComponent(DeltaTime, SimTime);
+	SCOPE_CYCLE_COUNTER(STAT_ShipMovementAsyncPhysicsTick);
+
+	// Held for the whole step so the game thread never sees a half updated state or clears the body mid step
+	FScopeLock Lock(&AsyncFlightLock);
+
+	const FPhysicsActorHandle& ActorHandle = FlightBodyInstance ? FlightBodyInstance->GetPhysicsActorHandle() : nullptr;
+	Chaos::FRigidBodyHandle_Internal* RigidHandle = ActorHandle ? ActorHandle->GetPhysicsThreadAPI() : nullptr;
+	if (!RigidHandle || DeltaTime <= 0.0f) return;
+
+	ShipFlight::UpdateState(FlightParams, BufferedFlightInput, DeltaTime, AsyncFlightState);
+
+	const FQuat Rotation = RigidHandle->R();
+
+	// Thrust: force that closes part of the gap to the target forward velocity this step
+	const FVector TargetVelocity = Rotation.GetForwardVector() * AsyncFlightState.Speed;
+	RigidHandle->AddForce((TargetVelocity - RigidHandle->V()) * (RigidHandle->M() * LinearResponse / DeltaTime));
+
+	// Steering: torque towards the angular velocity of this step's local rotation delta
+	FVector LocalAxis;
+	float Angle;
+	ShipFlight::GetRotationDelta(AsyncFlightState, DeltaTime).ToAxisAndAngle(LocalAxis, Angle);
+	const FVector TargetAngularVelocity = Rotation.RotateVector(LocalAxis * (Angle / DeltaTime));
+	const FVector LocalAngularAcceleration = Rotation.UnrotateVector(TargetAngularVelocity - RigidHandle->W()) * (AngularResponse / DeltaTime);
+	const FVector LocalInertia(RigidHandle->I());
+	RigidHandle->AddTorque(Rotation.RotateVector(LocalAngularAcceleration * LocalInertia));
+
+	PublishedFlightState = AsyncFlightState;
+}
+
+FShipFlightParams UShipMovementComponent::MakeFlightParams() const
+{
+	FShipFlightParams Params;
+	Params.FlapAngle = FlapAngle;
+	Params.ElevatorAngle = ElevatorAngle;
+	Params.RudderAngle = RudderAngle;
+	Params.MaxSpeed = MaxSpeed;
+	Params.FlapSpeed = FlapSpeed;
+	Params.ElevatorSpeed = ElevatorSpeed;
+	Params.RudderSpeed = RudderSpeed;
+	Params.Acceleration = Acceleration;
+	Params.Deceleration = Deceleration;
+	Params.MinSpeed = MinSpeed;
+	return Params;
 }
 
-void UShipMovementComponent::UpdateThrustMovement(float DeltaSeconds)
+void UShipMovementComponent::UpdateFlightMovement(float DeltaSeconds)
 {
-	const float TargetSpeed = FMath::Clamp(CurrentThrustInput * MaxSpeed, MinSpeed, MaxSpeed);
-	CurrentSpeed = FMath::FInterpTo(CurrentSpeed, TargetSpeed, DeltaSeconds, CurrentThrustInput > 0 ? Acceleration : Deceleration);
+	AActor* Owner = GetOwner();
+	FShipFlightPose Pose;
+	Pose.Rotation = Owner->GetActorQuat();
+	Pose.Location = Owner->GetActorLocation();
+	ShipFlight::IntegratePose(FlightState, DeltaSeconds, Pose);
+
+	// The frame's roll, pitch, yaw and thrust as one swept move. Attached components and overlaps are brought up
+	// to date once when the scope closes, together with any move a hit callback makes during the sweep.
+	FScopedMovementUpdate ScopedMovement(Owner->GetRootComponent(), EScopedUpdate::DeferredUpdates);
 	FHitResult HitResult;
-	GetOwner()->AddActorWorldOffset(GetOwner()->GetActorForwardVector() * CurrentSpeed * DeltaSeconds, true, &HitResult, ETeleportType::TeleportPhysics);
+	Owner->SetActorLocationAndRotation(Pose.Location, Pose.Rotation, true, &HitResult, ETeleportType::TeleportPhysics);
+	ShipMovement::CountTransformCommit();
+}
+
+void UShipMovementComponent::UpdateKinematicMovement(float DeltaSeconds)
+{
+	AActor* Owner = GetOwner();
+	FShipFlightPose Pose;
+	Pose.Rotation = Owner->GetActorQuat();
+	Pose.Location = Owner->GetActorLocation();
+	ShipFlight::IntegratePose(FlightState, DeltaSeconds, Pose);
+	Owner->SetActorLocationAndRotation(Pose.Location, Pose.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	ShipMovement::CountTransformCommit();
+}
+
+uint64 UShipMovementComponent::GetNumTransformCommits()
+{
+	return ShipMovement::NumTransformCommits;
 }
@@ -1,113 +1,361 @@
 #include "Controllers/ShipAIController.h"
+#include "GalacticArmada.h"
 #include "Kismet/GameplayStatics.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Pawns/ShipPawn.h"
 #include "DrawDebugHelpers.h"
 #include "Components/CannonComponent.h"
 #include "Components/ShipMovementComponent.h"
+#include "Flight/ShipSteering.h"
+#include "Subsystems/ShipAvoidanceFieldSubsystem.h"
+#include "Subsystems/ShipFidelitySubsystem.h"
+#include "Subsystems/ShipGunnerySubsystem.h"
+#include "Subsystems/ShipInfluenceSubsystem.h"
+#include "Subsystems/ShipNavigationSubsystem.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+#include "Subsystems/ShipSquadSubsystem.h"
+#include "Subsystems/ShipVisibilitySubsystem.h"
+#include "Telemetry/ShipTelemetry.h"
+
+DECLARE_CYCLE_STAT(TEXT("Ship AI Tick"), STAT_ShipAITick, STATGROUP_GalacticArmada);
 
 void AShipAIController::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(GalacticArmada_AI);
     Super::BeginPlay();
     ControlledShipPawn = Cast<AShipPawn>(GetPawn());
+    AcquireTarget();
 
-    TArray<AActor*> FoundActors;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AShipPawn::StaticClass(), FoundActors);
-    for (AActor* Actor : FoundActors)
-    {
-        if (AShipPawn* ShipPawn = Cast<AShipPawn>(Actor))
-        {
-            if (!ShipPawn->Controller->IsPlayerController()) continue;
-            TargetShipPawn = ShipPawn;
-            break;
-        }
-    }
+    // Spread tactical decisions of ships spawned together over the interval
+    TimeSinceTacticsUpdate = FMath::FRand() * TacticsInterval;
+}
+
+void AShipAIController::OnPossess(APawn* InPawn)
+{
+    Super::OnPossess(InPawn);
+    ControlledShipPawn = Cast<AShipPawn>(InPawn);
 }
 
 void AShipAIController::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
-    if (!IsValid(TargetShipPawn) || !IsValid(ControlledShipPawn)) return;
+    LLM_SCOPE_BYTAG(GalacticArmada_AI);
+    SCOPE_CYCLE_COUNTER(STAT_ShipAITick);
+    CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipAI);
+    if (!IsValid(ControlledShipPawn)) return;
+
+    // Under load decisions are spread over several frames, flight input and firing hold in between
+    const float FidelityThinkInterval = UShipFidelitySubsystem::GetSettings(GetWorld()).AIThinkInterval;
+    if (FidelityThinkInterval != ThinkInterval)
+    {
+        ThinkInterval = FidelityThinkInterval;
+        TimeSinceThink = FMath::FRand() * ThinkInterval;
+    }
+
+    TimeSinceThink += DeltaSeconds;
+    if (TimeSinceThink < ThinkInterval) return;
+    const float ThinkDeltaSeconds = TimeSinceThink;
+    TimeSinceThink = 0.0f;
+
+    // Wingmen fly on their leader's target and obstacle queries
+    const UShipSquadSubsystem* SquadSubsystem = GetWorld()->GetSubsystem<UShipSquadSubsystem>();
+    if (const FShipSquadOrders* Orders = SquadSubsystem ? SquadSubsystem->FindOrders(ControlledShipPawn) : nullptr)
+    {
+        if (!Orders->bIsLeader)
+        {
+            SquadOrders = *Orders;
+            TickSquadMember();
+            return;
+        }
+    }
+
+    // Reacquire a target when the current one is gone
+    if (!IsValid(TargetShipPawn) && !AcquireTarget())
+    {
+        ControlledShipPawn->GetCannonComponent()->EndCannonFire(0);
+        ControlledShipPawn->GetCannonComponent()->EndCannonFire(1);
+        return;
+    }
 
+    UpdateTactics(ThinkDeltaSeconds);
+    UpdatePathFollowing(ThinkDeltaSeconds);
     TargetRotation = GetTargetShipRotation();
-    UpdateCollisionAvoidance();
-    UpdateMovement(DeltaSeconds);
+    UpdateCollisionAvoidance(ThinkDeltaSeconds);
+    UpdateMovement(ThinkDeltaSeconds);
     UpdateFiring();
 }
 
+bool AShipAIController::AcquireTarget()
+{
+    TargetShipPawn = nullptr;
+    GunnerySolution = FInterceptSolution();
+
+    const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+    if (!ShipRegistry || !IsValid(ControlledShipPawn)) return false;
+
+    if (UShipSquadSubsystem* SquadSubsystem = GetWorld()->GetSubsystem<UShipSquadSubsystem>())
+    {
+        SquadSubsystem->RecordTargetSearch(ControlledShipPawn);
+    }
+
+    // Engage the most exposed hostile ship on the influence map
+    const UShipInfluenceSubsystem* InfluenceSubsystem = GetWorld()->GetSubsystem<UShipInfluenceSubsystem>();
+    if (InfluenceSubsystem && InfluenceSubsystem->IsReady())
+    {
+        TargetShipPawn = InfluenceSubsystem->ChooseTarget(ControlledShipPawn);
+    }
+
+    // Until the map is ready prefer the player, otherwise engage the closest hostile ship
+    if (!TargetShipPawn)
+    {
+        TargetShipPawn = ShipRegistry->FindPlayerShip();
+    }
+    if (!TargetShipPawn || TargetShipPawn == ControlledShipPawn)
+    {
+        TargetShipPawn = ShipRegistry->FindClosestHostileShip(ControlledShipPawn);
+    }
+
+    return TargetShipPawn != nullptr;
+}
+
+void AShipAIController::TickSquadMember()
+{
+    if (TargetShipPawn != SquadOrders.Target.Get())
+    {
+        TargetShipPawn = SquadOrders.Target.Get();
+        GunnerySolution = FInterceptSolution();
+    }
+    PathWaypoints.Reset();
+    bRetreating = false;
+    bFlanking = false;
+
+    // Hold the formation slot until the target is close enough to engage
+    const FVector ShipLocation = ControlledShipPawn->GetActorLocation();
+    const bool bEngage = IsValid(TargetShipPawn) && FVector::DistSquared(ShipLocation, TargetShipPawn->GetActorLocation()) <= FMath::Square(SquadOrders.EngageRange);
+    const FVector SteeringLocation = (bEngage ? GetSteeringLocation() : SquadOrders.SlotLocation) + SquadOrders.Separation;
+
+    TargetRotation = ShipSteering::GetTargetDeltaRotation(ShipLocation, ControlledShipPawn->GetActorRotation(), SteeringLocation);
+    ShipSteering::ApplyAvoidance(ControlledShipPawn->GetSteeringParams(), ShipLocation, SquadOrders.CollisionLocation, TargetRotation);
+
+    const bool bApproach = bEngage
+        ? ShipSteering::ShouldApproach(ControlledShipPawn->GetSteeringParams(), ShipLocation, TargetShipPawn->GetActorLocation())
+        : FVector::DotProduct(SteeringLocation - ShipLocation, ControlledShipPawn->GetActorForwardVector()) > 0.0f;
+    ControlledShipPawn->GetShipMovementComponent()->SetFlightInput(ShipSteering::ComputeInput(TargetRotation, bApproach));
+
+    if (IsValid(TargetShipPawn))
+    {
+        UpdateFiring();
+    }
+    else
+    {
+        ControlledShipPawn->GetCannonComponent()->EndCannonFire(0);
+        ControlledShipPawn->GetCannonComponent()->EndCannonFire(1);
+    }
+}
+
+void AShipAIController::UpdateTactics(float DeltaSeconds)
+{
+    const UShipInfluenceSubsystem* InfluenceSubsystem = GetWorld()->GetSubsystem<UShipInfluenceSubsystem>();
+    if (!InfluenceSubsystem || !InfluenceSubsystem->IsReady())
+    {
+        bRetreating = false;
+        bFlanking = false;
+        return;
+    }
+
+    // Drop a flank point once it is reached
+    const FVector ShipLocation = ControlledShipPawn->GetActorLocation();
+    if (bFlanking && FVector::DistSquared(ShipLocation, FlankLocation) < FMath::Square(WaypointAcceptanceRadius))
+    {
+        bFlanking = false;
+    }
+
+    TimeSinceTacticsUpdate += DeltaSeconds;
+    if (TimeSinceTacticsUpdate < TacticsInterval) return;
+    TimeSinceTacticsUpdate = 0.0f;
+
+    // Re-evaluate the target, a better exposed one may have come into reach
+    if (UShipSquadSubsystem* SquadSubsystem = GetWorld()->GetSubsystem<UShipSquadSubsystem>())
+    {
+        SquadSubsystem->RecordTargetSearch(ControlledShipPawn);
+    }
+
+    AShipPawn* BestTargetShipPawn = InfluenceSubsystem->ChooseTarget(ControlledShipPawn);
+    if (BestTargetShipPawn && BestTargetShipPawn != TargetShipPawn)
+    {
+        TargetShipPawn = BestTargetShipPawn;
+        GunnerySolution = FInterceptSolution();
+        PathWaypoints.Reset();
+        TimeSincePathUpdate = RepathInterval;
+    }
+
+    bRetreating = InfluenceSubsystem->ShouldRetreat(ControlledShipPawn, RetreatLocation);
+    bFlanking = !bRetreating && InfluenceSubsystem->FindFlankLocation(ControlledShipPawn, TargetShipPawn->GetActorLocation(), FlankLocation);
+}
+
 FRotator AShipAIController::GetTargetShipRotation() const
 {
     if (!ControlledShipPawn) return FRotator().ZeroRotator;
-    const FVector Direction = TargetShipPawn->GetActorLocation() - ControlledShipPawn->GetActorLocation();
-    const FVector NormalizedDirection = Direction.GetSafeNormal();
-    const FRotator DirectionRotation = UKismetMathLibrary::MakeRotFromX(NormalizedDirection);
-    return UKismetMathLibrary::NormalizedDeltaRotator(DirectionRotation, GetPawn()->GetActorRotation());
+    return ShipSteering::GetTargetDeltaRotation(ControlledShipPawn->GetActorLocation(), ControlledShipPawn->GetActorRotation(), GetSteeringLocation());
 }
 
-void AShipAIController::UpdateCollisionAvoidance()
+void AShipAIController::UpdatePathFollowing(float DeltaSeconds)
 {
-    if (!IsValid(ControlledShipPawn)) return;
-    const FVector CollisionLocation = ControlledShipPawn->GetClosestCollisionLocation();
-    if (CollisionLocation == FVector::ZeroVector) return;
+    UShipNavigationSubsystem* NavigationSubsystem = GetWorld()->GetSubsystem<UShipNavigationSubsystem>();
+    if (!NavigationSubsystem || !NavigationSubsystem->IsReady())
+    {
+        PathWaypoints.Reset();
+        return;
+    }
 
-    const FVector PawnLocation = ControlledShipPawn->GetActorLocation();
-    const float DistanceToCollision = FVector::Distance(PawnLocation, CollisionLocation);
+    const FVector ShipLocation = ControlledShipPawn->GetActorLocation();
 
-    if (DistanceToCollision < ControlledShipPawn->ObstacleAvoidanceDistance)
+    // Advance Along The Current Path
+    while (IsFollowingPath() && FVector::DistSquared(ShipLocation, PathWaypoints[PathWaypointIndex]) < FMath::Square(WaypointAcceptanceRadius))
     {
-        // Calculate Avoidance Direction
-        const FVector AwayFromCollisionDirection = (PawnLocation - CollisionLocation).GetSafeNormal();
+        ++PathWaypointIndex;
+    }
 
-        // Calculate the strength of the avoidance based on distance to collision
-        const float AvoidanceStrength = UKismetMathLibrary::MapRangeClamped(DistanceToCollision, 0.0f, ControlledShipPawn->ObstacleAvoidanceDistance, ControlledShipPawn->MaxAvoidanceStrength, ControlledShipPawn->MinAvoidanceStrength);
+    TimeSincePathUpdate += DeltaSeconds;
+    // Even the straight line check marches the octree, so it shares the repath interval
+    if (bPathRequestPending || TimeSincePathUpdate < RepathInterval) return;
+    TimeSincePathUpdate = 0.0f;
 
-        // Adjust the target rotation by blending it with the avoidance direction
-        const FRotator AvoidanceRotation = UKismetMathLibrary::MakeRotFromX(AwayFromCollisionDirection) * AvoidanceStrength;
-        TargetRotation = FMath::Lerp(TargetRotation, TargetRotation + AvoidanceRotation, AvoidanceStrength);
+    // Straight shot, steer at the destination as usual
+    const FVector TargetLocation = GetDestination();
+    if (NavigationSubsystem->IsSegmentFree(ShipLocation, TargetLocation))
+    {
+        PathWaypoints.Reset();
+        return;
+    }
 
-        if (bEnableAvoidanceDebug)
+    bPathRequestPending = true;
+    TWeakObjectPtr<AShipAIController> WeakThis(this);
+    NavigationSubsystem->RequestPath(ShipLocation, TargetLocation, [WeakThis](const TArray<FVector>& Waypoints)
+    {
+        if (AShipAIController* ShipAIController = WeakThis.Get())
         {
-            DrawDebugLine(GetWorld(), ControlledShipPawn->GetActorLocation(), CollisionLocation, FColor::Red, false, 0.0f, 0, 60);
-            DrawDebugSphere(GetWorld(), CollisionLocation, 300, 12, FColor::Red, false, 0.0f, 0, 30);
+            ShipAIController->bPathRequestPending = false;
+            ShipAIController->PathWaypoints = Waypoints;
+            ShipAIController->PathWaypointIndex = 0;
         }
-    }
+    });
 }
 
-void AShipAIController::UpdateMovement(float DeltaSeconds) const
+bool AShipAIController::IsFollowingPath() const
 {
-    if (!ControlledShipPawn) return;
+    return PathWaypoints.IsValidIndex(PathWaypointIndex);
+}
 
-    // Apply Target Rotation
-    ControlledShipPawn->GetShipMovementComponent()->SetRollInput(RotationToInputAxis(TargetRotation.Roll, 180.0f));
-    ControlledShipPawn->GetShipMovementComponent()->SetPitchInput(-RotationToInputAxis(TargetRotation.Pitch, 90.0f));
-    ControlledShipPawn->GetShipMovementComponent()->SetYawInput(RotationToInputAxis(TargetRotation.Yaw, 180.0f));
-    ControlledShipPawn->GetShipMovementComponent()->SetThrustInput(IsInRange() ? 1.0f : -1.0f);
+FVector AShipAIController::GetDestination() const
+{
+    if (bRetreating) return RetreatLocation;
+    if (bFlanking) return FlankLocation;
+    return TargetShipPawn->GetActorLocation();
 }
 
-float AShipAIController::RotationToInputAxis(float Value, float RotVal)
+FVector AShipAIController::GetSteeringLocation() const
 {
-    return UKismetMathLibrary::MapRangeClamped(Value, -RotVal, RotVal, -1.0f, 1.0f);
+    if (IsFollowingPath()) return PathWaypoints[PathWaypointIndex];
+    if (bRetreating || bFlanking) return GetDestination();
+
+    // Point the nose at the intercept point so the cannons fire where the target will be
+    if (UShipGunnerySubsystem::IsLeadTargetingEnabled() && GunnerySolution.bValid) return GunnerySolution.AimLocation;
+
+    return TargetShipPawn->GetActorLocation();
 }
 
-bool AShipAIController::IsInRange() const
+void AShipAIController::UpdateCollisionAvoidance(float DeltaSeconds)
 {
-    const float Distance = FVector::Distance(ControlledShipPawn->GetActorLocation(), TargetShipPawn->GetActorLocation());
-    return Distance > ControlledShipPawn->StoppingDistance;
+    if (!IsValid(ControlledShipPawn)) return;
+
+    const FShipFidelitySettings& Fidelity = UShipFidelitySubsystem::GetSettings(GetWorld());
+    const FVector ShipLocation = ControlledShipPawn->GetActorLocation();
+
+    // Between queries steer around the obstacle found last time
+    TimeSinceAvoidanceUpdate += DeltaSeconds;
+    if (TimeSinceAvoidanceUpdate >= Fidelity.AvoidanceInterval)
+    {
+        TimeSinceAvoidanceUpdate = 0.0f;
+
+        // Static geometry is a single field sample, only other ships still need traces
+        const UShipAvoidanceFieldSubsystem* AvoidanceField = GetWorld()->GetSubsystem<UShipAvoidanceFieldSubsystem>();
+        const bool bUseAvoidanceField = AvoidanceField && AvoidanceField->IsReady();
+        int32 NumTraces = 0;
+        FVector CollisionLocation = ControlledShipPawn->GetClosestCollisionLocation(bUseAvoidanceField, Fidelity.AvoidanceTraceBudget, &NumTraces);
+
+        FVector StaticCollisionLocation;
+        if (bUseAvoidanceField && AvoidanceField->FindClosestSurface(ShipLocation, StaticCollisionLocation))
+        {
+            if (CollisionLocation.IsZero() || FVector::DistSquared(ShipLocation, StaticCollisionLocation) < FVector::DistSquared(ShipLocation, CollisionLocation))
+            {
+                CollisionLocation = StaticCollisionLocation;
+            }
+        }
+
+        LastCollisionLocation = CollisionLocation;
+        if (UShipSquadSubsystem* SquadSubsystem = GetWorld()->GetSubsystem<UShipSquadSubsystem>())
+        {
+            SquadSubsystem->RecordAvoidanceQuery(ControlledShipPawn, NumTraces);
+        }
+    }
+
+    if (ShipSteering::ApplyAvoidance(ControlledShipPawn->GetSteeringParams(), ShipLocation, LastCollisionLocation, TargetRotation))
+    {
+        if (bEnableAvoidanceDebug)
+        {
+            DrawDebugLine(GetWorld(), ShipLocation, LastCollisionLocation, FColor::Red, false, 0.0f, 0, 60);
+            DrawDebugSphere(GetWorld(), LastCollisionLocation, 300, 12, FColor::Red, false, 0.0f, 0, 30);
+        }
+    }
 }
 
-void AShipAIController::UpdateFiring() const
+void AShipAIController::UpdateMovement(float DeltaSeconds) const
+{
+    if (!ControlledShipPawn) return;
+
+    // Apply Target Rotation
+    const bool bApproach = IsFollowingPath() || bRetreating || bFlanking || ShipSteering::ShouldApproach(ControlledShipPawn->GetSteeringParams(), ControlledShipPawn->GetActorLocation(), TargetShipPawn->GetActorLocation());
+    ControlledShipPawn->GetShipMovementComponent()->SetFlightInput(ShipSteering::ComputeInput(TargetRotation, bApproach));
+}
+
+void AShipAIController::UpdateFiring()
 {
     if (!ControlledShipPawn || !TargetShipPawn) return;
 
     const float DistanceToTarget = FVector::Distance(ControlledShipPawn->GetActorLocation(), TargetShipPawn->GetActorLocation());
 
-    if (DistanceToTarget <= ControlledShipPawn->PrimaryFireRange)
+    // Hold fire until the predicted hit probability is worth the shot
+    const bool bHasFiringSolution = !UShipGunnerySubsystem::IsLeadTargetingEnabled()
+        || (GunnerySolution.bValid && GunnerySolution.HitProbability >= UShipGunnerySubsystem::GetMinHitProbability());
+
+    // Cannon group the range calls for
+    int32 FiringCannonIndex = INDEX_NONE;
+    if (bHasFiringSolution && DistanceToTarget <= ControlledShipPawn->PrimaryFireRange)
+    {
+        FiringCannonIndex = 0;
+    }
+    else if (bHasFiringSolution && DistanceToTarget <= ControlledShipPawn->SecondaryFireRange)
+    {
+        FiringCannonIndex = 1;
+    }
+
+    // Hold fire while a station or an ally is in the way, the answer is cached and traced in the background
+    UShipVisibilitySubsystem* VisibilitySubsystem = GetWorld()->GetSubsystem<UShipVisibilitySubsystem>();
+    if (FiringCannonIndex != INDEX_NONE && VisibilitySubsystem
+        && VisibilitySubsystem->RequestLineOfSight(ControlledShipPawn, TargetShipPawn) == EShipLineOfSight::Blocked
+        && UShipVisibilitySubsystem::IsFireGateEnabled())
+    {
+        VisibilitySubsystem->NotifyFireHeld();
+        FiringCannonIndex = INDEX_NONE;
+    }
+
+    if (FiringCannonIndex == 0)
     {
         // Fire Primary Cannons
         ControlledShipPawn->GetCannonComponent()->BeginCannonFire(0);
         ControlledShipPawn->GetCannonComponent()->EndCannonFire(1);
     }
-    else if (DistanceToTarget <= ControlledShipPawn->SecondaryFireRange)
+    else if (FiringCannonIndex == 1)
     {
         // Fire Secondary Cannons
         ControlledShipPawn->GetCannonComponent()->BeginCannonFire(1);
@@ -119,4 +367,15 @@ void AShipAIController::UpdateFiring() const
         ControlledShipPawn->GetCannonComponent()->EndCannonFire(0);
         ControlledShipPawn->GetCannonComponent()->EndCannonFire(1);
     }
+
+    // Record the range each engagement opens at
+    if (FiringCannonIndex != EngagedCannonIndex || (FiringCannonIndex != INDEX_NONE && EngagedTarget.Get() != TargetShipPawn))
+    {
+        if (FiringCannonIndex != INDEX_NONE)
+        {
+            FShipTelemetry::Record(EShipTelemetryEventType::Engage, ControlledShipPawn, TargetShipPawn, DistanceToTarget, FiringCannonIndex);
+        }
+        EngagedCannonIndex = FiringCannonIndex;
+        EngagedTarget = TargetShipPawn;
+    }
 }
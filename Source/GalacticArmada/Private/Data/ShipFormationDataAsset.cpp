@@ -0,0 +1,12 @@
+#include "Data/ShipFormationDataAsset.h"
+
+UShipFormationDataAsset::UShipFormationDataAsset()
+{
+	// Default to a wedge of four wingmen
+	SlotOffsets = {
+		FVector(-4000.0f, -4000.0f, 0.0f),
+		FVector(-4000.0f, 4000.0f, 0.0f),
+		FVector(-8000.0f, -8000.0f, 0.0f),
+		FVector(-8000.0f, 8000.0f, 0.0f)
+	};
+}
@@ -0,0 +1,117 @@
+#include "Data/ShipLoadoutDataAsset.h"
+#include "GalacticArmada.h"
+#include "Actors/GuidedMissile.h"
+#include "Actors/ProjectileBase.h"
+#include "Data/ShipAssetBundles.h"
+#include "Engine/SkeletalMesh.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipLoadout, Log, All)
+
+void UShipLoadoutDataAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	ResolveCannons();
+}
+
+#if WITH_EDITOR
+void UShipLoadoutDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	ResolveCannons();
+}
+#endif
+
+UShipLoadoutDataAsset* UShipLoadoutDataAsset::CreateTransient(const TArray<FCannonFireProperties>& InCannons, const TSoftClassPtr<UCameraShakeBase>& InFireCameraShake)
+{
+	UShipLoadoutDataAsset* Loadout = NewObject<UShipLoadoutDataAsset>(GetTransientPackage(), NAME_None, RF_Transient);
+	Loadout->Cannons = InCannons;
+	Loadout->FireCameraShake = InFireCameraShake;
+	Loadout->ResolveCannons();
+	return Loadout;
+}
+
+void UShipLoadoutDataAsset::ResolveCannons()
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_Cannons);
+	ResolvedCannons.Reset(Cannons.Num());
+	SocketNames.Reset();
+	MeshSocketIndices.Reset();
+	ProjectileClassReferences.Reset();
+
+	for (const FCannonFireProperties& CannonFireProps : Cannons)
+	{
+		FShipLoadoutCannon& Cannon = ResolvedCannons.AddDefaulted_GetRef();
+		Cannon.FireInterval = CannonFireProps.FireRate > 0.0f ? 60.0f / CannonFireProps.FireRate : BIG_NUMBER;
+		Cannon.FireMode = CannonFireProps.CannonFireMode;
+		Cannon.bEnabled = CannonFireProps.Enabled && CannonFireProps.FireRate > 0.0f;
+		Cannon.bAutomatic = CannonFireProps.IsAutomaticFire;
+		Cannon.FirstSocket = static_cast<int16>(SocketNames.Num());
+		Cannon.NumSockets = static_cast<int16>(CannonFireProps.FireLocationSocketNames.Num());
+		SocketNames.Append(CannonFireProps.FireLocationSocketNames);
+	}
+
+	ResolveProjectiles(false);
+}
+
+void UShipLoadoutDataAsset::ResolveProjectiles(bool bAllowLoad)
+{
+	for (int32 CannonIndex = 0; CannonIndex < ResolvedCannons.Num(); ++CannonIndex)
+	{
+		FShipLoadoutCannon& Cannon = ResolvedCannons[CannonIndex];
+		if (Cannon.bProjectileResolved) continue;
+
+		const TSoftClassPtr<AProjectileBase>& SoftProjectileClass = Cannons[CannonIndex].ProjectileClass;
+		UClass* ProjectileClass = SoftProjectileClass.Get();
+		if (!ProjectileClass && !SoftProjectileClass.IsNull())
+		{
+			if (!bAllowLoad) continue;
+
+			// Streamed in with the ship's assets before it can fire, a blocking load here means the preload was skipped
+			UE_LOG(LogShipLoadout, Warning, TEXT("ShipLoadout: %s was not preloaded for %s, loading it synchronously"), *SoftProjectileClass.ToString(), *GetName());
+			ProjectileClass = SoftProjectileClass.LoadSynchronous();
+		}
+
+		Cannon.bProjectileResolved = true;
+		Cannon.ProjectileClass = ProjectileClass;
+		if (!ProjectileClass) continue;
+
+		const AProjectileBase* ProjectileDefaults = ProjectileClass->GetDefaultObject<AProjectileBase>();
+		Cannon.ProjectileSpeed = ProjectileDefaults->GetInitialSpeed();
+		Cannon.DamagePerVolley = ProjectileDefaults->GetDamage() * Cannon.GetShotsPerVolley();
+		Cannon.bGuided = ProjectileClass->IsChildOf<AGuidedMissile>();
+		ProjectileClassReferences.AddUnique(ProjectileClass);
+	}
+}
+
+const TArray<int32>& UShipLoadoutDataAsset::GetMeshSocketIndices(const USkeletalMesh* Mesh)
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_Cannons);
+	if (const TArray<int32>* SocketIndices = MeshSocketIndices.Find(Mesh))
+	{
+		return *SocketIndices;
+	}
+
+	TArray<int32>& SocketIndices = MeshSocketIndices.Add(Mesh);
+	SocketIndices.Init(INDEX_NONE, SocketNames.Num());
+	for (int32 SocketIndex = 0; SocketIndex < SocketNames.Num(); ++SocketIndex)
+	{
+		if (Mesh)
+		{
+			Mesh->FindSocketAndIndex(SocketNames[SocketIndex], SocketIndices[SocketIndex]);
+		}
+	}
+	return SocketIndices;
+}
+
+void UShipLoadoutDataAsset::GatherAssetBundles(FShipAssetBundles& OutBundles) const
+{
+	for (const FCannonFireProperties& CannonFireProps : Cannons)
+	{
+		OutBundles.AddGameplay(CannonFireProps.ProjectileClass);
+		OutBundles.AddCosmetic(CannonFireProps.MuzzleParticleEffect);
+	}
+	OutBundles.AddCosmetic(FireCameraShake);
+}
@@ -0,0 +1,118 @@
+#include "Flight/ProjectileBallistics.h"
+#include "Flight/ShipFlightModel.h"
+#include "Flight/ShipSteering.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFlightBenchmark, Log, All)
+
+namespace FlightBenchmark
+{
+	// Runs Body Iterations times and returns nanoseconds per item
+	template <typename BodyType>
+	static double Measure(int32 NumItems, int32 Iterations, BodyType Body)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Body();
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1.0e9 / (double(NumItems) * Iterations);
+	}
+
+	static void Run(int32 NumShips, int32 Iterations)
+	{
+		constexpr float DeltaSeconds = 1.0f / 60.0f;
+		FRandomStream RandomStream(NumShips);
+
+		const FShipFlightParams FlightParams;
+		const FShipSteeringParams SteeringParams;
+		TArray<FShipFlightInput> Inputs;
+		TArray<FShipFlightState> States;
+		TArray<FShipFlightPose> Poses;
+		TArray<FShipSteeringRequest> SteeringRequests;
+		TArray<FInterceptRequest> InterceptRequests;
+		TArray<FInterceptSolution> InterceptSolutions;
+		Inputs.SetNum(NumShips);
+		States.SetNum(NumShips);
+		Poses.SetNum(NumShips);
+		SteeringRequests.SetNum(NumShips);
+		InterceptRequests.SetNum(NumShips);
+		InterceptSolutions.SetNum(NumShips);
+
+		for (int32 ShipIndex = 0; ShipIndex < NumShips; ++ShipIndex)
+		{
+			Inputs[ShipIndex] = { RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f) };
+			Poses[ShipIndex].Location = RandomStream.VRand() * RandomStream.FRandRange(0.0f, 100000.0f);
+			Poses[ShipIndex].Rotation = FRotator(RandomStream.FRandRange(-90.0f, 90.0f), RandomStream.FRandRange(-180.0f, 180.0f), 0.0f).Quaternion();
+
+			FShipSteeringRequest& SteeringRequest = SteeringRequests[ShipIndex];
+			SteeringRequest.ShipLocation = Poses[ShipIndex].Location;
+			SteeringRequest.ShipRotation = Poses[ShipIndex].Rotation.Rotator();
+			SteeringRequest.TargetLocation = RandomStream.VRand() * 100000.0f;
+			SteeringRequest.CollisionLocation = RandomStream.FRand() < 0.25f ? SteeringRequest.ShipLocation + RandomStream.VRand() * 20000.0f : FVector::ZeroVector;
+
+			FInterceptRequest& InterceptRequest = InterceptRequests[ShipIndex];
+			InterceptRequest.ShooterLocation = Poses[ShipIndex].Location;
+			InterceptRequest.ShooterForward = Poses[ShipIndex].Rotation.GetForwardVector();
+			InterceptRequest.TargetLocation = SteeringRequest.TargetLocation;
+			InterceptRequest.TargetVelocity = RandomStream.VRand() * 5000.0f;
+			InterceptRequest.ProjectileSpeed = 20000.0f;
+		}
+
+		const double ScalarFlightNs = Measure(NumShips, Iterations, [&]()
+		{
+			for (int32 ShipIndex = 0; ShipIndex < NumShips; ++ShipIndex)
+			{
+				ShipFlight::UpdateState(FlightParams, Inputs[ShipIndex], DeltaSeconds, States[ShipIndex]);
+				ShipFlight::IntegratePose(States[ShipIndex], DeltaSeconds, Poses[ShipIndex]);
+			}
+		});
+
+		const double ArrayFlightNs = Measure(NumShips, Iterations, [&]()
+		{
+			ShipFlight::Step(MakeArrayView(&FlightParams, 1), Inputs, DeltaSeconds, States, Poses);
+		});
+
+		const double SteeringNs = Measure(NumShips, Iterations, [&]()
+		{
+			ShipSteering::ComputeInputs(MakeArrayView(&SteeringParams, 1), SteeringRequests, Inputs);
+		});
+
+		const double ScalarInterceptNs = Measure(NumShips, Iterations, [&]()
+		{
+			for (int32 ShipIndex = 0; ShipIndex < NumShips; ++ShipIndex)
+			{
+				InterceptSolutions[ShipIndex] = ProjectileBallistics::SolveIntercept(InterceptRequests[ShipIndex]);
+			}
+		});
+
+		const double BatchInterceptNs = Measure(NumShips, Iterations, [&]()
+		{
+			ProjectileBallistics::SolveInterceptBatch(InterceptRequests, InterceptSolutions);
+		});
+
+		// Keeps the optimizer from discarding the results
+		double Checksum = 0.0;
+		for (int32 ShipIndex = 0; ShipIndex < NumShips; ++ShipIndex)
+		{
+			Checksum += Poses[ShipIndex].Location.X + Inputs[ShipIndex].Yaw + InterceptSolutions[ShipIndex].TimeToImpact;
+		}
+
+		UE_LOG(LogFlightBenchmark, Log, TEXT("FlightBenchmark: %d ships, %d iterations"), NumShips, Iterations);
+		UE_LOG(LogFlightBenchmark, Log, TEXT("FlightBenchmark: Flight step %.1fns per ship one by one, %.1fns through the array step"), ScalarFlightNs, ArrayFlightNs);
+		UE_LOG(LogFlightBenchmark, Log, TEXT("FlightBenchmark: Steering %.1fns per ship through the array step"), SteeringNs);
+		UE_LOG(LogFlightBenchmark, Log, TEXT("FlightBenchmark: Intercept %.1fns per request one by one, %.1fns batched, %.1fx faster (checksum %.1f)"),
+			ScalarInterceptNs, BatchInterceptNs, BatchInterceptNs > 0.0 ? ScalarInterceptNs / BatchInterceptNs : 0.0, Checksum);
+	}
+}
+
+static FAutoConsoleCommandWithArgs FlightBenchmarkCommand(
+	TEXT("ga.Flight.Benchmark"),
+	TEXT("Times the flight, steering and intercept core on synthetic ships, one by one and through the array entry points: ga.Flight.Benchmark [Ships] [Iterations]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumShips = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+		const int32 Iterations = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100;
+		FlightBenchmark::Run(NumShips, Iterations);
+	}));
@@ -0,0 +1,165 @@
+#include "Flight/ProjectileBallistics.h"
+
+namespace ProjectileBallistics
+{
+	// Four requests laid out one component per register, locations relative to each shooter so floats keep their precision
+	struct FInterceptLanes
+	{
+		alignas(16) float RelativeLocation[3][4];
+		alignas(16) float TargetVelocity[3][4];
+		alignas(16) float Acceleration[3][4];
+		alignas(16) float Forward[3][4];
+		alignas(16) float ProjectileSpeed[4];
+		alignas(16) float TargetRadius[4];
+		alignas(16) float TargetManeuver[4];
+	};
+
+	struct FInterceptLaneResults
+	{
+		alignas(16) float AimOffset[3][4];
+		alignas(16) float TimeToImpact[4];
+		alignas(16) float HitProbability[4];
+		alignas(16) float Valid[4];
+	};
+
+	FORCEINLINE VectorRegister4Float Dot3(const VectorRegister4Float A[3], const VectorRegister4Float B[3])
+	{
+		return VectorMultiplyAdd(A[0], B[0], VectorMultiplyAdd(A[1], B[1], VectorMultiply(A[2], B[2])));
+	}
+
+	static void SolveInterceptLanes(const FInterceptLanes& Lanes, FInterceptLaneResults& Results)
+	{
+		const VectorRegister4Float Zero = VectorZeroFloat();
+		const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+		const VectorRegister4Float SmallNumber = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+
+		VectorRegister4Float R[3], V[3], A[3], F[3];
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			R[Axis] = VectorLoadAligned(Lanes.RelativeLocation[Axis]);
+			V[Axis] = VectorLoadAligned(Lanes.TargetVelocity[Axis]);
+			A[Axis] = VectorLoadAligned(Lanes.Acceleration[Axis]);
+			F[Axis] = VectorLoadAligned(Lanes.Forward[Axis]);
+		}
+		const VectorRegister4Float Speed = VectorLoadAligned(Lanes.ProjectileSpeed);
+
+		// |R + V t| = Speed t, as Qa t^2 + Qb t + Qc = 0
+		const VectorRegister4Float Qa = VectorSubtract(Dot3(V, V), VectorMultiply(Speed, Speed));
+		const VectorRegister4Float Qb = VectorMultiply(VectorSetFloat1(2.0f), Dot3(R, V));
+		const VectorRegister4Float Qc = Dot3(R, R);
+		const VectorRegister4Float Discriminant = VectorSubtract(VectorMultiply(Qb, Qb), VectorMultiply(VectorSetFloat1(4.0f), VectorMultiply(Qa, Qc)));
+
+		// Only a bolt faster than the target closes in, then exactly one root is positive
+		const VectorRegister4Float ValidMask = VectorBitwiseAnd(
+			VectorBitwiseAnd(VectorCompareLT(Qa, VectorNegate(SmallNumber)), VectorCompareGE(Discriminant, Zero)),
+			VectorCompareGT(Speed, Zero));
+
+		const VectorRegister4Float SafeQa = VectorMin(Qa, VectorNegate(SmallNumber));
+		VectorRegister4Float Time = VectorDivide(
+			VectorSubtract(VectorNegate(Qb), VectorSqrt(VectorMax(Discriminant, Zero))),
+			VectorMultiply(VectorSetFloat1(2.0f), SafeQa));
+		Time = VectorMax(Time, Zero);
+
+		// Fold the target's acceleration in with two fixed point steps
+		const VectorRegister4Float SafeSpeed = VectorMax(Speed, SmallNumber);
+		VectorRegister4Float P[3];
+		for (int32 Iteration = 0; Iteration < 3; ++Iteration)
+		{
+			const VectorRegister4Float HalfTimeSquared = VectorMultiply(Half, VectorMultiply(Time, Time));
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				P[Axis] = VectorMultiplyAdd(A[Axis], HalfTimeSquared, VectorMultiplyAdd(V[Axis], Time, R[Axis]));
+			}
+			if (Iteration < 2)
+			{
+				Time = VectorDivide(VectorSqrt(Dot3(P, P)), SafeSpeed);
+			}
+		}
+
+		// Miss distance: aim misalignment across the flight plus what the target can still dodge
+		const VectorRegister4Float Distance = VectorMax(VectorSqrt(Dot3(P, P)), SmallNumber);
+		const VectorRegister4Float CosAngle = VectorDivide(Dot3(F, P), Distance);
+		const VectorRegister4Float SinAngle = VectorSqrt(VectorMax(VectorSubtract(VectorOneFloat(), VectorMultiply(CosAngle, CosAngle)), Zero));
+		const VectorRegister4Float MissDistance = VectorMultiplyAdd(
+			VectorMultiply(Half, VectorLoadAligned(Lanes.TargetManeuver)), VectorMultiply(Time, Time),
+			VectorMultiply(SinAngle, Distance));
+
+		const VectorRegister4Float TargetRadius = VectorLoadAligned(Lanes.TargetRadius);
+		const VectorRegister4Float HitRatio = VectorDivide(TargetRadius, VectorMax(VectorAdd(TargetRadius, MissDistance), SmallNumber));
+		const VectorRegister4Float FacingMask = VectorCompareGT(CosAngle, Zero);
+		const VectorRegister4Float HitProbability = VectorSelect(VectorBitwiseAnd(ValidMask, FacingMask), VectorMultiply(HitRatio, HitRatio), Zero);
+
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			VectorStoreAligned(P[Axis], Results.AimOffset[Axis]);
+		}
+		VectorStoreAligned(Time, Results.TimeToImpact);
+		VectorStoreAligned(HitProbability, Results.HitProbability);
+		VectorStoreAligned(VectorSelect(ValidMask, VectorOneFloat(), Zero), Results.Valid);
+	}
+}
+
+void ProjectileBallistics::Integrate(FVector& Location, const FVector& Velocity, float DeltaSeconds)
+{
+	Location += Velocity * DeltaSeconds;
+}
+
+void ProjectileBallistics::Integrate(TArrayView<FVector> Locations, TConstArrayView<FVector> Velocities, float DeltaSeconds)
+{
+	check(Locations.Num() == Velocities.Num());
+
+	for (int32 i = 0; i < Locations.Num(); ++i)
+	{
+		Locations[i] += Velocities[i] * DeltaSeconds;
+	}
+}
+
+FInterceptSolution ProjectileBallistics::SolveIntercept(const FInterceptRequest& Request)
+{
+	FInterceptSolution Solution;
+	SolveInterceptBatch(MakeArrayView(&Request, 1), MakeArrayView(&Solution, 1));
+	return Solution;
+}
+
+void ProjectileBallistics::SolveInterceptBatch(TConstArrayView<FInterceptRequest> Requests, TArrayView<FInterceptSolution> OutSolutions)
+{
+	check(Requests.Num() == OutSolutions.Num());
+
+	FInterceptLanes Lanes;
+	FInterceptLaneResults Results;
+
+	for (int32 BaseIndex = 0; BaseIndex < Requests.Num(); BaseIndex += 4)
+	{
+		const int32 NumLanes = FMath::Min(4, Requests.Num() - BaseIndex);
+
+		// Unused lanes get a harmless copy of the first request
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const FInterceptRequest& Request = Requests[BaseIndex + (Lane < NumLanes ? Lane : 0)];
+			const FVector RelativeLocation = Request.TargetLocation - Request.ShooterLocation;
+			const FVector Forward = Request.ShooterForward.GetSafeNormal();
+
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				Lanes.RelativeLocation[Axis][Lane] = RelativeLocation[Axis];
+				Lanes.TargetVelocity[Axis][Lane] = Request.TargetVelocity[Axis];
+				Lanes.Acceleration[Axis][Lane] = Request.TargetAcceleration[Axis];
+				Lanes.Forward[Axis][Lane] = Forward[Axis];
+			}
+			Lanes.ProjectileSpeed[Lane] = Request.ProjectileSpeed;
+			Lanes.TargetRadius[Lane] = Request.TargetRadius;
+			Lanes.TargetManeuver[Lane] = Request.TargetManeuver;
+		}
+
+		SolveInterceptLanes(Lanes, Results);
+
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			FInterceptSolution& Solution = OutSolutions[BaseIndex + Lane];
+			Solution.AimLocation = Requests[BaseIndex + Lane].ShooterLocation + FVector(Results.AimOffset[0][Lane], Results.AimOffset[1][Lane], Results.AimOffset[2][Lane]);
+			Solution.TimeToImpact = Results.TimeToImpact[Lane];
+			Solution.HitProbability = Results.HitProbability[Lane];
+			Solution.bValid = Results.Valid[Lane] > 0.0f;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#include "Flight/ShipFlightModel.h"
+
+namespace ShipFlight
+{
+	// FMath::FInterpTo on four lanes: no interp speed or a tiny gap snaps straight to the target
+	FORCEINLINE VectorRegister4Float VectorInterpTo(const VectorRegister4Float& Current, const VectorRegister4Float& Target, const VectorRegister4Float& DeltaSeconds, const VectorRegister4Float& InterpSpeed)
+	{
+		const VectorRegister4Float Dist = VectorSubtract(Target, Current);
+		const VectorRegister4Float Alpha = VectorMin(VectorMax(VectorMultiply(DeltaSeconds, InterpSpeed), VectorZeroFloat()), VectorOneFloat());
+		const VectorRegister4Float Result = VectorMultiplyAdd(Dist, Alpha, Current);
+		const VectorRegister4Float SnapMask = VectorBitwiseOr(
+			VectorCompareLE(InterpSpeed, VectorZeroFloat()),
+			VectorCompareLT(VectorMultiply(Dist, Dist), VectorSetFloat1(UE_SMALL_NUMBER)));
+		return VectorSelect(SnapMask, Target, Result);
+	}
+
+	FORCEINLINE void UpdateStateInternal(const FShipFlightParams& Params, const FShipFlightInput& Input, const VectorRegister4Float& DeltaSeconds, FShipFlightState& State)
+	{
+		// Pitch input is inverted so pulling back raises the nose
+		alignas(16) const float Targets[4] = {
+			Input.Roll * Params.FlapAngle,
+			-Input.Pitch * Params.ElevatorAngle,
+			Input.Yaw * Params.RudderAngle,
+			FMath::Clamp(Input.Thrust * Params.MaxSpeed, Params.MinSpeed, Params.MaxSpeed) };
+
+		alignas(16) const float InterpSpeeds[4] = {
+			Params.FlapSpeed,
+			Params.ElevatorSpeed,
+			Params.RudderSpeed,
+			Input.Thrust > 0.0f ? Params.Acceleration : Params.Deceleration };
+
+		const VectorRegister4Float NewState = VectorInterpTo(VectorLoadAligned(&State.Roll), VectorLoadAligned(Targets), DeltaSeconds, VectorLoadAligned(InterpSpeeds));
+		VectorStoreAligned(NewState, &State.Roll);
+	}
+}
+
+void ShipFlight::UpdateState(const FShipFlightParams& Params, const FShipFlightInput& Input, float DeltaSeconds, FShipFlightState& State)
+{
+	UpdateStateInternal(Params, Input, VectorSetFloat1(DeltaSeconds), State);
+}
+
+FRotator ShipFlight::GetRollDelta(const FShipFlightState& State, float DeltaSeconds)
+{
+	return FRotator(0.0f, 0.0f, State.Roll * DeltaSeconds);
+}
+
+FRotator ShipFlight::GetPitchDelta(const FShipFlightState& State, float DeltaSeconds)
+{
+	return FRotator(State.Pitch * DeltaSeconds, 0.0f, 0.0f);
+}
+
+FRotator ShipFlight::GetYawDelta(const FShipFlightState& State, float DeltaSeconds)
+{
+	return FRotator(0.0f, State.Yaw * DeltaSeconds, 0.0f);
+}
+
+FQuat ShipFlight::GetRotationDelta(const FShipFlightState& State, float DeltaSeconds)
+{
+	return GetRollDelta(State, DeltaSeconds).Quaternion() * GetPitchDelta(State, DeltaSeconds).Quaternion() * GetYawDelta(State, DeltaSeconds).Quaternion();
+}
+
+void ShipFlight::IntegratePose(const FShipFlightState& State, float DeltaSeconds, FShipFlightPose& Pose)
+{
+	Pose.Rotation = Pose.Rotation * GetRotationDelta(State, DeltaSeconds);
+	Pose.Rotation.Normalize();
+	Pose.Location += Pose.Rotation.GetForwardVector() * (State.Speed * DeltaSeconds);
+}
+
+void ShipFlight::UpdateStates(TConstArrayView<FShipFlightParams> Params, TConstArrayView<FShipFlightInput> Inputs, float DeltaSeconds, TArrayView<FShipFlightState> States)
+{
+	check(Inputs.Num() == States.Num());
+	check(Params.Num() == 1 || Params.Num() == States.Num());
+
+	const VectorRegister4Float DeltaSecondsVector = VectorSetFloat1(DeltaSeconds);
+	const int32 ParamsStride = Params.Num() == 1 ? 0 : 1;
+
+	for (int32 i = 0; i < States.Num(); ++i)
+	{
+		UpdateStateInternal(Params[i * ParamsStride], Inputs[i], DeltaSecondsVector, States[i]);
+	}
+}
+
+void ShipFlight::IntegratePoses(TConstArrayView<FShipFlightState> States, float DeltaSeconds, TArrayView<FShipFlightPose> Poses)
+{
+	check(States.Num() == Poses.Num());
+
+	for (int32 i = 0; i < Poses.Num(); ++i)
+	{
+		IntegratePose(States[i], DeltaSeconds, Poses[i]);
+	}
+}
+
+void ShipFlight::Step(TConstArrayView<FShipFlightParams> Params, TConstArrayView<FShipFlightInput> Inputs, float DeltaSeconds, TArrayView<FShipFlightState> States, TArrayView<FShipFlightPose> Poses)
+{
+	UpdateStates(Params, Inputs, DeltaSeconds, States);
+	IntegratePoses(States, DeltaSeconds, Poses);
+}
@@ -0,0 +1,67 @@
+#include "Flight/ShipSteering.h"
+
+FRotator ShipSteering::GetTargetDeltaRotation(const FVector& ShipLocation, const FRotator& ShipRotation, const FVector& TargetLocation)
+{
+	const FRotator DirectionRotation = (TargetLocation - ShipLocation).GetSafeNormal().Rotation();
+	return (DirectionRotation - ShipRotation).GetNormalized();
+}
+
+bool ShipSteering::ApplyAvoidance(const FShipSteeringParams& Params, const FVector& ShipLocation, const FVector& CollisionLocation, FRotator& InOutTargetRotation)
+{
+	if (CollisionLocation == FVector::ZeroVector) return false;
+
+	const float DistanceToCollision = FVector::Distance(ShipLocation, CollisionLocation);
+	if (DistanceToCollision >= Params.ObstacleAvoidanceDistance) return false;
+
+	// Calculate Avoidance Direction
+	const FVector AwayFromCollisionDirection = (ShipLocation - CollisionLocation).GetSafeNormal();
+
+	// Calculate the strength of the avoidance based on distance to collision
+	const float AvoidanceStrength = FMath::GetMappedRangeValueClamped(
+		FVector2f(0.0f, Params.ObstacleAvoidanceDistance),
+		FVector2f(Params.MaxAvoidanceStrength, Params.MinAvoidanceStrength),
+		DistanceToCollision);
+
+	// Adjust the target rotation by blending it with the avoidance direction
+	const FRotator AvoidanceRotation = AwayFromCollisionDirection.Rotation() * AvoidanceStrength;
+	InOutTargetRotation = FMath::Lerp(InOutTargetRotation, InOutTargetRotation + AvoidanceRotation, AvoidanceStrength);
+	return true;
+}
+
+float ShipSteering::RotationToInputAxis(float Value, float MaxRotation)
+{
+	return FMath::GetMappedRangeValueClamped(FVector2f(-MaxRotation, MaxRotation), FVector2f(-1.0f, 1.0f), Value);
+}
+
+bool ShipSteering::ShouldApproach(const FShipSteeringParams& Params, const FVector& ShipLocation, const FVector& TargetLocation)
+{
+	return FVector::DistSquared(ShipLocation, TargetLocation) > FMath::Square(Params.StoppingDistance);
+}
+
+FShipFlightInput ShipSteering::ComputeInput(const FRotator& TargetRotation, bool bApproach)
+{
+	FShipFlightInput Input;
+	Input.Roll = RotationToInputAxis(TargetRotation.Roll, 180.0f);
+	Input.Pitch = -RotationToInputAxis(TargetRotation.Pitch, 90.0f);
+	Input.Yaw = RotationToInputAxis(TargetRotation.Yaw, 180.0f);
+	Input.Thrust = bApproach ? 1.0f : -1.0f;
+	return Input;
+}
+
+void ShipSteering::ComputeInputs(TConstArrayView<FShipSteeringParams> Params, TConstArrayView<FShipSteeringRequest> Requests, TArrayView<FShipFlightInput> OutInputs)
+{
+	check(Requests.Num() == OutInputs.Num());
+	check(Params.Num() == 1 || Params.Num() == Requests.Num());
+
+	const int32 ParamsStride = Params.Num() == 1 ? 0 : 1;
+
+	for (int32 i = 0; i < Requests.Num(); ++i)
+	{
+		const FShipSteeringParams& SteeringParams = Params[i * ParamsStride];
+		const FShipSteeringRequest& Request = Requests[i];
+
+		FRotator TargetRotation = GetTargetDeltaRotation(Request.ShipLocation, Request.ShipRotation, Request.TargetLocation);
+		ApplyAvoidance(SteeringParams, Request.ShipLocation, Request.CollisionLocation, TargetRotation);
+		OutInputs[i] = ComputeInput(TargetRotation, ShouldApproach(SteeringParams, Request.ShipLocation, Request.TargetLocation));
+	}
+}
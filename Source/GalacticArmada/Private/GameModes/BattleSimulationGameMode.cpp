@@ -0,0 +1,491 @@
+#include "GameModes/BattleSimulationGameMode.h"
+#include "GalacticArmada.h"
+#include "Components/HealthComponent.h"
+#include "Data/ShipFormationDataAsset.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Memory/FrameArena.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipAssetPreloadSubsystem.h"
+#include "Subsystems/ShipDetectionSubsystem.h"
+#include "Subsystems/ShipEventSubsystem.h"
+#include "Subsystems/ShipExplosionSubsystem.h"
+#include "Subsystems/ShipFidelitySubsystem.h"
+#include "Subsystems/ShipFleetSubsystem.h"
+#include "Subsystems/ShipGunnerySubsystem.h"
+#include "Subsystems/ShipInfluenceSubsystem.h"
+#include "Subsystems/ShipMemoryBudgetSubsystem.h"
+#include "Subsystems/ShipMissileSubsystem.h"
+#include "Subsystems/ShipSquadSubsystem.h"
+#include "Subsystems/ShipVisibilitySubsystem.h"
+#include "Telemetry/ShipTelemetry.h"
+#include "UObject/ConstructorHelpers.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBattleSimulation, Log, All)
+
+ABattleSimulationGameMode::ABattleSimulationGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+
+	// Nobody flies in a simulation
+	DefaultPawnClass = nullptr;
+
+	// The native ship has no mesh or cannons, both teams default to the fighter blueprint
+	static ConstructorHelpers::FClassFinder<AShipPawn> DefaultShipClass(TEXT("/Game/GalacticArmada/Blueprints/Pawns/BP_SpaceFighter"));
+	TeamAShipClass = DefaultShipClass.Class;
+	TeamBShipClass = DefaultShipClass.Class;
+}
+
+void ABattleSimulationGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	ParseCommandLineOverrides();
+
+	// Step the world at a fixed large timestep without waiting on the wall clock
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(FixedTimeStep);
+}
+
+void ABattleSimulationGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UShipEventSubsystem* EventSubsystem = UShipEventSubsystem::Get(this))
+	{
+		EventSubsystem->GetDamageChannel().Subscribe<&ABattleSimulationGameMode::HandleDamageEvents>(this);
+	}
+
+	// A team without a ship class, or with the bare native ship, would simulate nothing
+	const TSubclassOf<AShipPawn> TeamShipClasses[] = { TeamAShipClass, TeamBShipClass };
+	for (const TSubclassOf<AShipPawn>& ShipClass : TeamShipClasses)
+	{
+		if (!ShipClass || ShipClass == AShipPawn::StaticClass())
+		{
+			UE_LOG(LogBattleSimulation, Error, TEXT("BattleSimulation: Both teams need a ship blueprint with a mesh and cannons, pass -BattleSimShipA= and -BattleSimShipB="));
+			if (bExitWhenFinished)
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+			return;
+		}
+	}
+
+	UE_LOG(LogBattleSimulation, Log, TEXT("BattleSimulation: Running %d matches of %dv%d, %d in parallel, timestep %.3fs"), MatchCount, ShipsPerTeam, ShipsPerTeam, ParallelMatches, FixedTimeStep);
+
+#if CSV_PROFILER
+	if (bFleetBenchmark)
+	{
+		FCsvProfiler::Get()->BeginCapture();
+	}
+#endif
+
+	// Stream both teams' weapons in before the first match, so no ship blocks on a load mid fight
+	if (UShipAssetPreloadSubsystem* AssetPreloader = UShipAssetPreloadSubsystem::Get(this))
+	{
+		const double PreloadStartTime = FPlatformTime::Seconds();
+		const TSubclassOf<AShipPawn> ShipClasses[] = { TeamAShipClass, TeamBShipClass };
+		AssetPreloader->PreloadShipClasses(ShipClasses, [WeakThis = TWeakObjectPtr<ABattleSimulationGameMode>(this), PreloadStartTime]()
+		{
+			if (ABattleSimulationGameMode* GameMode = WeakThis.Get())
+			{
+				UE_LOG(LogBattleSimulation, Log, TEXT("BattleSimulation: Preloaded ship assets in %.1fms"), (FPlatformTime::Seconds() - PreloadStartTime) * 1000.0);
+				GameMode->StartSimulation();
+			}
+		});
+	}
+	else
+	{
+		StartSimulation();
+	}
+}
+
+void ABattleSimulationGameMode::StartSimulation()
+{
+	RunStartTime = FPlatformTime::Seconds();
+	LastFrameTime = RunStartTime;
+
+	// Background fleets fight on their own, away from the match arenas
+	UShipFleetSubsystem* FleetSubsystem = GetWorld()->GetSubsystem<UShipFleetSubsystem>();
+	if (FleetSubsystem && BackgroundFleetShips > 0)
+	{
+		const FVector FleetCenter(-ArenaSpacing, 0.0f, 0.0f);
+		FleetSubsystem->SpawnFleet(TeamAShipClass, 0, BackgroundFleetShips / 2, FleetCenter - FVector(BackgroundFleetRadius, 0.0f, 0.0f), BackgroundFleetRadius);
+		FleetSubsystem->SpawnFleet(TeamBShipClass, 1, BackgroundFleetShips - BackgroundFleetShips / 2, FleetCenter + FVector(BackgroundFleetRadius, 0.0f, 0.0f), BackgroundFleetRadius);
+	}
+
+	Matches.SetNum(FMath::Max(ParallelMatches, 1));
+	for (int32 ArenaIndex = 0; ArenaIndex < Matches.Num(); ++ArenaIndex)
+	{
+		StartMatch(ArenaIndex);
+	}
+}
+
+void ABattleSimulationGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UShipEventSubsystem* EventSubsystem = UShipEventSubsystem::Get(this))
+	{
+		EventSubsystem->GetDamageChannel().Unsubscribe(this);
+	}
+
+#if CSV_PROFILER
+	if (bFleetBenchmark && FCsvProfiler::Get()->IsCapturing())
+	{
+		FCsvProfiler::Get()->EndCapture();
+	}
+#endif
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ABattleSimulationGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// Track Wall Clock Frame Time
+	const double CurrentFrameTime = FPlatformTime::Seconds();
+	const double FrameSeconds = CurrentFrameTime - LastFrameTime;
+	LastFrameTime = CurrentFrameTime;
+	TotalFrameSeconds += FrameSeconds;
+	WorstFrameSeconds = FMath::Max(WorstFrameSeconds, FrameSeconds);
+	++SimulatedFrames;
+
+	bool bAnyMatchActive = false;
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	for (FBattleSimulationMatch& Match : Matches)
+	{
+		if (!Match.IsActive()) continue;
+
+		const float Duration = WorldTime - Match.StartTime;
+		if (Match.ShipsAlive[0] <= 0 || Match.ShipsAlive[1] <= 0 || Duration >= MatchTimeLimit)
+		{
+			const int32 ArenaIndex = Match.ArenaIndex;
+			FinishMatch(Match, Duration);
+			StartMatch(ArenaIndex);
+		}
+
+		bAnyMatchActive |= Match.IsActive();
+	}
+
+	if (!bAnyMatchActive && CompletedMatches > 0)
+	{
+		FinishSimulation();
+	}
+}
+
+void ABattleSimulationGameMode::ParseCommandLineOverrides()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	FParse::Value(CommandLine, TEXT("BattleSimShipsPerTeam="), ShipsPerTeam);
+	FParse::Value(CommandLine, TEXT("BattleSimMatches="), MatchCount);
+	FParse::Value(CommandLine, TEXT("BattleSimParallel="), ParallelMatches);
+	FParse::Value(CommandLine, TEXT("BattleSimTimeStep="), FixedTimeStep);
+	FParse::Value(CommandLine, TEXT("BattleSimTimeLimit="), MatchTimeLimit);
+	FParse::Value(CommandLine, TEXT("BattleSimSeed="), RandomSeed);
+	FParse::Value(CommandLine, TEXT("BattleSimOutput="), OutputFileName);
+	FParse::Value(CommandLine, TEXT("BattleSimFleetShips="), BackgroundFleetShips);
+	bFleetBenchmark = FParse::Param(CommandLine, TEXT("FleetBenchmark"));
+
+	FString ShipClassPath;
+	if (FParse::Value(CommandLine, TEXT("BattleSimShipA="), ShipClassPath))
+	{
+		if (UClass* ShipClass = LoadClass<AShipPawn>(nullptr, *ShipClassPath))
+		{
+			TeamAShipClass = ShipClass;
+		}
+	}
+	if (FParse::Value(CommandLine, TEXT("BattleSimShipB="), ShipClassPath))
+	{
+		if (UClass* ShipClass = LoadClass<AShipPawn>(nullptr, *ShipClassPath))
+		{
+			TeamBShipClass = ShipClass;
+		}
+	}
+
+	FString FormationPath;
+	if (FParse::Value(CommandLine, TEXT("BattleSimFormation="), FormationPath))
+	{
+		SquadFormation = LoadObject<UShipFormationDataAsset>(nullptr, *FormationPath);
+	}
+	else if (FParse::Param(CommandLine, TEXT("BattleSimSquads")) && !SquadFormation)
+	{
+		SquadFormation = GetMutableDefault<UShipFormationDataAsset>();
+	}
+
+	FixedTimeStep = FMath::Max(FixedTimeStep, KINDA_SMALL_NUMBER);
+}
+
+void ABattleSimulationGameMode::StartMatch(int32 ArenaIndex)
+{
+	FBattleSimulationMatch& Match = Matches[ArenaIndex];
+	Match = FBattleSimulationMatch();
+
+	if (NextMatchIndex >= MatchCount) return;
+
+	Match.MatchIndex = NextMatchIndex++;
+	Match.ArenaIndex = ArenaIndex;
+	Match.StartTime = GetWorld()->GetTimeSeconds();
+	FShipTelemetry::RecordMatch(EShipTelemetryEventType::MatchStart, GetWorld(), Match.MatchIndex, nullptr, ShipsPerTeam);
+
+	FRandomStream RandomStream(RandomSeed + Match.MatchIndex);
+	const FVector ArenaCenter(ArenaIndex * ArenaSpacing, 0.0f, 0.0f);
+	const int32 RowLength = FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(ShipsPerTeam))), 1);
+
+	// Spawn Both Teams Facing Each Other
+	for (uint8 TeamId = 0; TeamId < 2; ++TeamId)
+	{
+		const float Side = TeamId == 0 ? -1.0f : 1.0f;
+		const FRotator Facing = TeamId == 0 ? FRotator::ZeroRotator : FRotator(0.0f, 180.0f, 0.0f);
+		const TSubclassOf<AShipPawn> ShipClass = TeamId == 0 ? TeamAShipClass : TeamBShipClass;
+		TArray<AShipPawn*> TeamShips;
+
+		for (int32 i = 0; i < ShipsPerTeam; ++i)
+		{
+			const FVector SlotOffset(
+				Side * TeamSeparation * 0.5f,
+				(i % RowLength - RowLength * 0.5f) * ShipSpacing,
+				(i / RowLength - RowLength * 0.5f) * ShipSpacing);
+			const FVector Jitter = RandomStream.VRand() * ShipSpacing * 0.25f;
+
+			if (AShipPawn* ShipPawn = SpawnShip(ShipClass, TeamId, FTransform(Facing, ArenaCenter + SlotOffset + Jitter)))
+			{
+				Match.Ships.Add(ShipPawn);
+				ShipToArena.Add(ShipPawn, ArenaIndex);
+				FShipTelemetry::RecordMatch(EShipTelemetryEventType::MatchJoin, GetWorld(), Match.MatchIndex, ShipPawn);
+				TeamShips.Add(ShipPawn);
+				++Match.ShipsAlive[TeamId];
+			}
+		}
+
+		UShipSquadSubsystem* SquadSubsystem = GetWorld()->GetSubsystem<UShipSquadSubsystem>();
+		if (SquadSubsystem && SquadFormation)
+		{
+			SquadSubsystem->FormSquads(SquadFormation, TeamShips);
+		}
+	}
+}
+
+AShipPawn* ABattleSimulationGameMode::SpawnShip(TSubclassOf<AShipPawn> ShipClass, uint8 TeamId, const FTransform& SpawnTransform)
+{
+	if (!ShipClass) return nullptr;
+
+	LLM_SCOPE_BYTAG(GalacticArmada_Ships);
+	AShipPawn* ShipPawn = GetWorld()->SpawnActorDeferred<AShipPawn>(ShipClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!ShipPawn) return nullptr;
+
+	ShipPawn->TeamId = TeamId;
+	ShipPawn->FinishSpawning(SpawnTransform);
+
+	if (!ShipPawn->GetController())
+	{
+		ShipPawn->SpawnDefaultController();
+	}
+
+	return ShipPawn;
+}
+
+void ABattleSimulationGameMode::FinishMatch(FBattleSimulationMatch& Match, float Duration)
+{
+	int32 WinningTeam = 2;
+	if (Match.ShipsAlive[0] > 0 && Match.ShipsAlive[1] <= 0)
+	{
+		WinningTeam = 0;
+	}
+	else if (Match.ShipsAlive[1] > 0 && Match.ShipsAlive[0] <= 0)
+	{
+		WinningTeam = 1;
+	}
+
+	++TeamWins[WinningTeam];
+	++CompletedMatches;
+	WriteResultRow(Match, WinningTeam, Duration);
+	FShipTelemetry::RecordMatch(EShipTelemetryEventType::MatchEnd, GetWorld(), Match.MatchIndex, nullptr, Duration, WinningTeam);
+
+	// Clear The Arena
+	for (const TWeakObjectPtr<AShipPawn>& Ship : Match.Ships)
+	{
+		ShipToArena.Remove(Ship.Get());
+		if (AShipPawn* ShipPawn = Ship.Get())
+		{
+			if (AController* ShipController = ShipPawn->GetController())
+			{
+				ShipController->Destroy();
+			}
+			ShipPawn->Destroy();
+		}
+	}
+
+	Match = FBattleSimulationMatch();
+}
+
+void ABattleSimulationGameMode::FinishSimulation()
+{
+	const double ElapsedSeconds = FPlatformTime::Seconds() - RunStartTime;
+	const double MatchesPerHour = ElapsedSeconds > 0.0 ? CompletedMatches * 3600.0 / ElapsedSeconds : 0.0;
+	const double AverageFrameMs = SimulatedFrames > 0 ? TotalFrameSeconds * 1000.0 / SimulatedFrames : 0.0;
+
+	UE_LOG(LogBattleSimulation, Log, TEXT("BattleSimulation: %d matches in %.1fs (%.0f matches/hour). Team A %d, Team B %d, Draws %d"),
+		CompletedMatches, ElapsedSeconds, MatchesPerHour, TeamWins[0], TeamWins[1], TeamWins[2]);
+	UE_LOG(LogBattleSimulation, Log, TEXT("BattleSimulation: %s target, %llu frames, average %.3fms, worst %.3fms. Results written to %s"),
+		GalacticArmada::GetTargetName(), SimulatedFrames, AverageFrameMs, WorstFrameSeconds * 1000.0, *GetOutputFilePath());
+
+	if (const UShipGunnerySubsystem* GunnerySubsystem = GetWorld()->GetSubsystem<UShipGunnerySubsystem>())
+	{
+		GunnerySubsystem->LogReport();
+	}
+
+	if (const UShipSquadSubsystem* SquadSubsystem = GetWorld()->GetSubsystem<UShipSquadSubsystem>())
+	{
+		SquadSubsystem->LogReport();
+	}
+
+	if (const UShipVisibilitySubsystem* VisibilitySubsystem = GetWorld()->GetSubsystem<UShipVisibilitySubsystem>())
+	{
+		VisibilitySubsystem->LogReport();
+	}
+
+	if (const UShipInfluenceSubsystem* InfluenceSubsystem = GetWorld()->GetSubsystem<UShipInfluenceSubsystem>())
+	{
+		InfluenceSubsystem->LogReport();
+	}
+
+	if (const UShipExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UShipExplosionSubsystem>())
+	{
+		ExplosionSubsystem->LogReport();
+	}
+
+	if (const UShipMissileSubsystem* MissileSubsystem = GetWorld()->GetSubsystem<UShipMissileSubsystem>())
+	{
+		MissileSubsystem->LogReport();
+	}
+
+	if (const UShipFidelitySubsystem* FidelitySubsystem = GetWorld()->GetSubsystem<UShipFidelitySubsystem>())
+	{
+		FidelitySubsystem->LogReport();
+	}
+
+	if (const UShipDetectionSubsystem* DetectionSubsystem = GetWorld()->GetSubsystem<UShipDetectionSubsystem>())
+	{
+		DetectionSubsystem->LogReport();
+	}
+
+	if (const UShipEventSubsystem* EventSubsystem = GetWorld()->GetSubsystem<UShipEventSubsystem>())
+	{
+		EventSubsystem->LogReport();
+	}
+
+	FFrameArena::LogReport();
+
+	if (const UShipMemoryBudgetSubsystem* MemoryBudgetSubsystem = GetWorld()->GetSubsystem<UShipMemoryBudgetSubsystem>())
+	{
+		MemoryBudgetSubsystem->LogReport();
+	}
+
+	CompletedMatches = 0;
+
+#if CSV_PROFILER
+	if (bFleetBenchmark && FCsvProfiler::Get()->IsCapturing())
+	{
+		FCsvProfiler::Get()->EndCapture();
+	}
+#endif
+
+	if (bExitWhenFinished)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void ABattleSimulationGameMode::WriteResultRow(const FBattleSimulationMatch& Match, int32 WinningTeam, float Duration) const
+{
+	const FString FilePath = GetOutputFilePath();
+
+	float MeanTimeToKill = 0.0f;
+	for (const float KillTime : Match.KillTimes)
+	{
+		MeanTimeToKill += KillTime;
+	}
+	MeanTimeToKill = Match.KillTimes.Num() > 0 ? MeanTimeToKill / Match.KillTimes.Num() : 0.0f;
+	const float FirstKillTime = Match.KillTimes.Num() > 0 ? Match.KillTimes[0] : 0.0f;
+
+	FString Row;
+	if (!IFileManager::Get().FileExists(*FilePath))
+	{
+		Row += TEXT("Match,Seed,ShipsPerTeam,Winner,Duration,TeamAKills,TeamBKills,TeamADamage,TeamBDamage,FirstKillTime,MeanTimeToKill\n");
+	}
+
+	const TCHAR* WinnerName = WinningTeam == 0 ? TEXT("A") : WinningTeam == 1 ? TEXT("B") : TEXT("Draw");
+	Row += FString::Printf(TEXT("%d,%d,%d,%s,%.2f,%d,%d,%.1f,%.1f,%.2f,%.2f\n"),
+		Match.MatchIndex, RandomSeed + Match.MatchIndex, ShipsPerTeam, WinnerName, Duration,
+		Match.Kills[0], Match.Kills[1], Match.DamageDealt[0], Match.DamageDealt[1], FirstKillTime, MeanTimeToKill);
+
+	FFileHelper::SaveStringToFile(Row, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+FString ABattleSimulationGameMode::GetOutputFilePath() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BattleSim"), OutputFileName);
+}
+
+void ABattleSimulationGameMode::HandleDamageEvents(TConstArrayView<FShipDamageEvent> Events)
+{
+	for (const FShipDamageEvent& Event : Events)
+	{
+		const UHealthComponent* HealthComponent = Event.HealthComponent.Get();
+		const AShipPawn* DamagedShip = HealthComponent ? Cast<AShipPawn>(HealthComponent->GetOwner()) : nullptr;
+		const int32* ArenaIndex = DamagedShip ? ShipToArena.Find(DamagedShip) : nullptr;
+		if (!ArenaIndex || !Matches.IsValidIndex(*ArenaIndex)) continue;
+
+		FBattleSimulationMatch& Match = Matches[*ArenaIndex];
+		const int32 DamagedTeam = DamagedShip->TeamId == 0 ? 0 : 1;
+
+		// Only hostile damage is credited, collisions and friendly fire count for nobody
+		const AShipPawn* AttackingShip = GetAttackingShip(Event);
+		const bool bCredited = AttackingShip && DamagedShip->IsHostileTo(AttackingShip);
+		const int32 AttackingTeam = bCredited ? (AttackingShip->TeamId == 0 ? 0 : 1) : INDEX_NONE;
+
+		if (bCredited)
+		{
+			Match.DamageDealt[AttackingTeam] += Event.Damage;
+		}
+
+		if (Event.Health <= 0.0f)
+		{
+			if (bCredited)
+			{
+				++Match.Kills[AttackingTeam];
+				Match.KillTimes.Add(GetWorld()->GetTimeSeconds() - Match.StartTime);
+			}
+			--Match.ShipsAlive[DamagedTeam];
+			ShipToArena.Remove(DamagedShip);
+		}
+	}
+}
+
+const AShipPawn* ABattleSimulationGameMode::GetAttackingShip(const FShipDamageEvent& Event)
+{
+	if (const AController* InstigatedBy = Event.InstigatedBy.Get())
+	{
+		if (const AShipPawn* InstigatorShip = Cast<AShipPawn>(InstigatedBy->GetPawn()))
+		{
+			return InstigatorShip;
+		}
+	}
+
+	// Bolts and missiles outlive their shooter's controller, they still know who fired them
+	const AActor* DamageCauser = Event.DamageCauser.Get();
+	if (!DamageCauser) return nullptr;
+
+	if (const AShipPawn* CauserShip = Cast<AShipPawn>(DamageCauser))
+	{
+		return CauserShip;
+	}
+	return Cast<AShipPawn>(DamageCauser->GetInstigator() ? DamageCauser->GetInstigator() : DamageCauser->GetOwner());
+}
@@ -0,0 +1,391 @@
+#include "Mass/ShipFleetProcessors.h"
+#include "GalacticArmada.h"
+#include "HAL/IConsoleManager.h"
+#include "Mass/ShipFleetFragments.h"
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "Memory/FrameArena.h"
+
+DECLARE_CYCLE_STAT(TEXT("Fleet Targeting"), STAT_ShipFleetTargeting, STATGROUP_GalacticArmada);
+DECLARE_CYCLE_STAT(TEXT("Fleet Steering"), STAT_ShipFleetSteering, STATGROUP_GalacticArmada);
+DECLARE_CYCLE_STAT(TEXT("Fleet Flight"), STAT_ShipFleetFlight, STATGROUP_GalacticArmada);
+DECLARE_CYCLE_STAT(TEXT("Fleet Cannons"), STAT_ShipFleetCannons, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fleet Shots"), STAT_FleetShots, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fleet Kills"), STAT_FleetKills, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<float> CVarFleetTargetCellSize(
+	TEXT("ga.Fleet.TargetCellSize"),
+	60000.0f,
+	TEXT("Cell size of the spatial hash used by fleet entities to find hostiles."));
+
+static TAutoConsoleVariable<float> CVarFleetRetargetInterval(
+	TEXT("ga.Fleet.RetargetInterval"),
+	1.0f,
+	TEXT("Seconds between target searches of a fleet entity."));
+
+static TAutoConsoleVariable<float> CVarFleetHitChance(
+	TEXT("ga.Fleet.HitChance"),
+	0.35f,
+	TEXT("Fraction of fleet entity shots that hit, applied as expected damage."));
+
+static TAutoConsoleVariable<float> CVarFleetFireCone(
+	TEXT("ga.Fleet.FireCone"),
+	15.0f,
+	TEXT("Half angle in degrees within which fleet entities open fire on their target."));
+
+namespace ShipFleet
+{
+	static FIntVector GetCell(const FVector& Location, float CellSize)
+	{
+		return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+	}
+}
+
+// Targeting
+
+UShipFleetTargetingProcessor::UShipFleetTargetingProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+}
+
+float UShipFleetTargetingProcessor::GetRetargetInterval()
+{
+	return CVarFleetRetargetInterval.GetValueOnAnyThread();
+}
+
+void UShipFleetTargetingProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FShipTeamFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FShipTargetFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddTagRequirement<FShipFleetTag>(EMassFragmentPresence::All);
+}
+
+void UShipFleetTargetingProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipFleetTargeting);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, FleetTargeting);
+
+	// Processors may run off the game thread, so console variables are read once up front and scratch stays local
+	const float CellSize = FMath::Max(CVarFleetTargetCellSize.GetValueOnAnyThread(), 1000.0f);
+	const float RetargetInterval = GetRetargetInterval();
+	const float DeltaTime = Context.GetDeltaTimeSeconds();
+
+	const int32 NumEntities = EntityQuery.GetNumMatchingEntities(EntityManager);
+	TFrameArray<FMassEntityHandle> Entities;
+	TFrameArray<FVector> Locations;
+	TFrameArray<uint8> Teams;
+	Entities.Reserve(NumEntities);
+	Locations.Reserve(NumEntities);
+	Teams.Reserve(NumEntities);
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	// Team centroids give ships without a hostile nearby somewhere to head
+	FVector TeamLocationSums[256];
+	int32 TeamCounts[256] = {};
+
+	// Gather Every Entity Into The Spatial Hash
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&Entities, &Locations, &Teams, &Cells, CellSize, &TeamLocationSums, &TeamCounts](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = ChunkContext.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FShipTeamFragment> TeamFragments = ChunkContext.GetFragmentView<FShipTeamFragment>();
+
+		for (int32 EntityIndex = 0; EntityIndex < ChunkContext.GetNumEntities(); ++EntityIndex)
+		{
+			const FVector Location = Transforms[EntityIndex].GetTransform().GetLocation();
+			const uint8 TeamId = TeamFragments[EntityIndex].TeamId;
+
+			const int32 Index = Entities.Add(ChunkContext.GetEntity(EntityIndex));
+			Locations.Add(Location);
+			Teams.Add(TeamId);
+			Cells.FindOrAdd(ShipFleet::GetCell(Location, CellSize)).Add(Index);
+
+			TeamLocationSums[TeamId] = TeamCounts[TeamId] > 0 ? TeamLocationSums[TeamId] + Location : Location;
+			++TeamCounts[TeamId];
+		}
+	});
+
+	// Retarget Or Track The Current Target
+	int32 EntityOffset = 0;
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FShipTargetFragment> Targets = ChunkContext.GetMutableFragmentView<FShipTargetFragment>();
+
+		for (int32 EntityIndex = 0; EntityIndex < ChunkContext.GetNumEntities(); ++EntityIndex)
+		{
+			const int32 Index = EntityOffset + EntityIndex;
+			FShipTargetFragment& Target = Targets[EntityIndex];
+			Target.RetargetCooldown -= DeltaTime;
+
+			const FTransformFragment* TargetTransform = Target.Target.IsSet() && EntityManager.IsEntityValid(Target.Target)
+				? EntityManager.GetFragmentDataPtr<FTransformFragment>(Target.Target)
+				: nullptr;
+
+			// Entities heading for a centroid keep it until the cooldown runs out, only a destroyed target forces an early search
+			const bool bTargetLost = Target.Target.IsSet() && !TargetTransform;
+			if (Target.RetargetCooldown > 0.0f && !bTargetLost)
+			{
+				if (TargetTransform)
+				{
+					Target.TargetLocation = TargetTransform->GetTransform().GetLocation();
+				}
+				continue;
+			}
+
+			// Stagger searches so they spread across frames
+			Target.RetargetCooldown = RetargetInterval * (1.0f + 0.25f * (Index % 4));
+			Target.Target.Reset();
+			Target.bHasTarget = false;
+
+			const FVector& Location = Locations[Index];
+			const FIntVector Cell = ShipFleet::GetCell(Location, CellSize);
+			double ClosestDistanceSquared = TNumericLimits<double>::Max();
+
+			for (int32 X = -1; X <= 1; ++X)
+			{
+				for (int32 Y = -1; Y <= 1; ++Y)
+				{
+					for (int32 Z = -1; Z <= 1; ++Z)
+					{
+						const TArray<int32>* CellEntities = Cells.Find(Cell + FIntVector(X, Y, Z));
+						if (!CellEntities) continue;
+
+						for (const int32 OtherIndex : *CellEntities)
+						{
+							if (Teams[OtherIndex] == Teams[Index]) continue;
+
+							const double DistanceSquared = FVector::DistSquared(Location, Locations[OtherIndex]);
+							if (DistanceSquared < ClosestDistanceSquared)
+							{
+								ClosestDistanceSquared = DistanceSquared;
+								Target.Target = Entities[OtherIndex];
+								Target.TargetLocation = Locations[OtherIndex];
+								Target.bHasTarget = true;
+							}
+						}
+					}
+				}
+			}
+
+			if (Target.bHasTarget) continue;
+
+			// Nothing close, head for the nearest hostile team's centroid
+			for (int32 TeamId = 0; TeamId < UE_ARRAY_COUNT(TeamCounts); ++TeamId)
+			{
+				if (TeamId == Teams[Index] || TeamCounts[TeamId] == 0) continue;
+
+				const FVector TeamCentroid = TeamLocationSums[TeamId] / TeamCounts[TeamId];
+				const double DistanceSquared = FVector::DistSquared(Location, TeamCentroid);
+				if (DistanceSquared < ClosestDistanceSquared)
+				{
+					ClosestDistanceSquared = DistanceSquared;
+					Target.TargetLocation = TeamCentroid;
+					Target.bHasTarget = true;
+				}
+			}
+		}
+
+		EntityOffset += ChunkContext.GetNumEntities();
+	});
+}
+
+// Steering
+
+UShipFleetSteeringProcessor::UShipFleetSteeringProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+	ExecutionOrder.ExecuteAfter.Add(UShipFleetTargetingProcessor::StaticClass()->GetFName());
+}
+
+void UShipFleetSteeringProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FShipTargetFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FShipFlightFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FShipArchetypeFragment>();
+	EntityQuery.AddTagRequirement<FShipFleetTag>(EMassFragmentPresence::All);
+}
+
+void UShipFleetSteeringProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipFleetSteering);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, FleetSteering);
+
+	// Chunks share their archetype, so each one goes through the array steering with a single params entry
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& ChunkContext)
+	{
+		const int32 NumEntities = ChunkContext.GetNumEntities();
+		const FShipArchetypeFragment& Archetype = ChunkContext.GetConstSharedFragment<FShipArchetypeFragment>();
+		const TConstArrayView<FTransformFragment> Transforms = ChunkContext.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FShipTargetFragment> Targets = ChunkContext.GetFragmentView<FShipTargetFragment>();
+		const TArrayView<FShipFlightFragment> Flights = ChunkContext.GetMutableFragmentView<FShipFlightFragment>();
+
+		TFrameArray<FShipSteeringRequest> Requests;
+		TFrameArray<FShipFlightInput> Inputs;
+		Requests.SetNum(NumEntities);
+		Inputs.SetNum(NumEntities);
+
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+			FShipSteeringRequest& Request = Requests[EntityIndex];
+			Request.ShipLocation = Transform.GetLocation();
+			Request.ShipRotation = Transform.Rotator();
+			Request.TargetLocation = Targets[EntityIndex].TargetLocation;
+		}
+
+		ShipSteering::ComputeInputs(MakeArrayView(&Archetype.SteeringParams, 1), Requests, Inputs);
+
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			Flights[EntityIndex].Input = Targets[EntityIndex].bHasTarget ? Inputs[EntityIndex] : ShipSteering::ComputeInput(FRotator::ZeroRotator, true);
+		}
+	});
+}
+
+// Flight
+
+UShipFleetFlightProcessor::UShipFleetFlightProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+	ExecutionOrder.ExecuteAfter.Add(UShipFleetSteeringProcessor::StaticClass()->GetFName());
+}
+
+void UShipFleetFlightProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FShipFlightFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FShipArchetypeFragment>();
+	EntityQuery.AddTagRequirement<FShipFleetTag>(EMassFragmentPresence::All);
+}
+
+void UShipFleetFlightProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipFleetFlight);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, FleetFlight);
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& ChunkContext)
+	{
+		const float DeltaTime = ChunkContext.GetDeltaTimeSeconds();
+		const FShipArchetypeFragment& Archetype = ChunkContext.GetConstSharedFragment<FShipArchetypeFragment>();
+		const TArrayView<FShipFlightFragment> Flights = ChunkContext.GetMutableFragmentView<FShipFlightFragment>();
+		const TArrayView<FTransformFragment> Transforms = ChunkContext.GetMutableFragmentView<FTransformFragment>();
+
+		// The flight core steps contiguous arrays, gather the chunk into them and write the poses back
+		const int32 NumEntities = ChunkContext.GetNumEntities();
+		TFrameArray<FShipFlightInput> Inputs;
+		TFrameArray<FShipFlightState> States;
+		TFrameArray<FShipFlightPose> Poses;
+		Inputs.SetNum(NumEntities);
+		States.SetNum(NumEntities);
+		Poses.SetNum(NumEntities);
+
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+			Inputs[EntityIndex] = Flights[EntityIndex].Input;
+			States[EntityIndex] = Flights[EntityIndex].State;
+			Poses[EntityIndex].Rotation = Transform.GetRotation();
+			Poses[EntityIndex].Location = Transform.GetLocation();
+		}
+
+		ShipFlight::Step(MakeArrayView(&Archetype.FlightParams, 1), Inputs, DeltaTime, States, Poses);
+
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			FTransform& Transform = Transforms[EntityIndex].GetMutableTransform();
+			Flights[EntityIndex].State = States[EntityIndex];
+			Transform.SetRotation(Poses[EntityIndex].Rotation);
+			Transform.SetLocation(Poses[EntityIndex].Location);
+		}
+	});
+}
+
+// Cannons
+
+UShipFleetCannonProcessor::UShipFleetCannonProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+	ExecutionOrder.ExecuteAfter.Add(UShipFleetFlightProcessor::StaticClass()->GetFName());
+}
+
+void UShipFleetCannonProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FShipTargetFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FShipCannonFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FShipHealthFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FShipArchetypeFragment>();
+	EntityQuery.AddTagRequirement<FShipFleetTag>(EMassFragmentPresence::All);
+}
+
+void UShipFleetCannonProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipFleetCannons);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, FleetCannons);
+
+	const float HitChance = CVarFleetHitChance.GetValueOnAnyThread();
+	const float FireConeCos = FMath::Cos(FMath::DegreesToRadians(CVarFleetFireCone.GetValueOnAnyThread()));
+	TFrameArray<TPair<FMassEntityHandle, float>> PendingDamage;
+
+	// Fire At Targets In Range, Damage Is Applied After Every Chunk Has Fired
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&PendingDamage, HitChance, FireConeCos](FMassExecutionContext& ChunkContext)
+	{
+		const float DeltaTime = ChunkContext.GetDeltaTimeSeconds();
+		const FShipArchetypeFragment& Archetype = ChunkContext.GetConstSharedFragment<FShipArchetypeFragment>();
+		const TConstArrayView<FTransformFragment> Transforms = ChunkContext.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FShipTargetFragment> Targets = ChunkContext.GetFragmentView<FShipTargetFragment>();
+		const TArrayView<FShipCannonFragment> Cannons = ChunkContext.GetMutableFragmentView<FShipCannonFragment>();
+
+		for (int32 EntityIndex = 0; EntityIndex < ChunkContext.GetNumEntities(); ++EntityIndex)
+		{
+			FShipCannonFragment& Cannon = Cannons[EntityIndex];
+			Cannon.Cooldown[0] = FMath::Max(Cannon.Cooldown[0] - DeltaTime, 0.0f);
+			Cannon.Cooldown[1] = FMath::Max(Cannon.Cooldown[1] - DeltaTime, 0.0f);
+
+			const FShipTargetFragment& Target = Targets[EntityIndex];
+			if (!Target.Target.IsSet()) continue;
+
+			const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+			const FVector ToTarget = Target.TargetLocation - Transform.GetLocation();
+			const double DistanceToTarget = ToTarget.Size();
+			if (DistanceToTarget > Archetype.SecondaryFireRange) continue;
+			if (FVector::DotProduct(Transform.GetRotation().GetForwardVector(), ToTarget / FMath::Max(DistanceToTarget, 1.0)) < FireConeCos) continue;
+
+			const int32 CannonIndex = DistanceToTarget <= Archetype.PrimaryFireRange ? 0 : 1;
+			if (Cannon.Cooldown[CannonIndex] > 0.0f) continue;
+
+			Cannon.Cooldown[CannonIndex] = Archetype.FireInterval[CannonIndex];
+			PendingDamage.Emplace(Target.Target, Archetype.DamagePerShot[CannonIndex] * HitChance);
+		}
+	});
+
+	// Apply Damage And Destroy The Dead
+	int32 Kills = 0;
+	for (const TPair<FMassEntityHandle, float>& Damage : PendingDamage)
+	{
+		if (!EntityManager.IsEntityValid(Damage.Key)) continue;
+
+		FShipHealthFragment* Health = EntityManager.GetFragmentDataPtr<FShipHealthFragment>(Damage.Key);
+		if (!Health || Health->Health <= 0.0f) continue;
+
+		Health->Health -= Damage.Value;
+		if (Health->Health <= 0.0f)
+		{
+			Context.Defer().DestroyEntity(Damage.Key);
+			++Kills;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_FleetShots, PendingDamage.Num());
+	INC_DWORD_STAT_BY(STAT_FleetKills, Kills);
+}
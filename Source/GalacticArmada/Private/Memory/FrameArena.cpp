@@ -0,0 +1,212 @@
+#include "Memory/FrameArena.h"
+#include "GalacticArmada.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFrameArena, Log, All)
+
+DECLARE_MEMORY_STAT(TEXT("Frame Arena Memory"), STAT_FrameArenaMemory, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame Arena Allocations"), STAT_FrameArenaAllocations, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame Scratch Heap Allocations"), STAT_FrameScratchHeapAllocations, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarFrameArenaEnable(
+	TEXT("ga.FrameArena.Enable"),
+	true,
+	TEXT("Frame arrays allocate from the frame arena. Off puts them on the heap, to compare heap allocations per frame in the fleet benchmark. Applies from the next frame."));
+
+static TAutoConsoleVariable<int32> CVarFrameArenaBlockSizeKB(
+	TEXT("ga.FrameArena.BlockSizeKB"),
+	256,
+	TEXT("Size of a frame arena block, arenas that overflow one grow to their peak frame usage on the next reset."));
+
+static FAutoConsoleCommand FrameArenaReportCommand(
+	TEXT("ga.FrameArena.Report"),
+	TEXT("Logs the peak frame usage and allocations of every thread's frame arena and the heap allocations per frame."),
+	FConsoleCommandDelegate::CreateStatic(&FFrameArena::LogReport));
+
+namespace FrameArena
+{
+	static FCriticalSection ArenasLock;
+	static TArray<FFrameArena*> Arenas;
+	static thread_local FFrameArena* ThreadArena = nullptr;
+
+	// Bumped at the end of every frame, arenas still on an older one release their memory on next use
+	static std::atomic<uint32> CurrentFrame = 0;
+	static std::atomic<bool> bEnabled = true;
+
+	// Usage of the frames arenas released since the last end of frame, worker arenas report theirs a frame late
+	static std::atomic<uint64> ReleasedBytes = 0;
+	static std::atomic<int32> ReleasedAllocations = 0;
+	static std::atomic<int32> HeapAllocations = 0;
+
+	// Game thread only
+	static int64 NumFrames = 0;
+	static int64 TotalHeapAllocations = 0;
+
+	static FDelayedAutoRegisterHelper EndFrameRegistration(EDelayedRegisterRunPhase::EndOfEngineInit, []()
+	{
+		FCoreDelegates::OnEndFrame.AddStatic(&FFrameArena::EndFrame);
+	});
+}
+
+FFrameArena::FFrameArena(uint32 InThreadId, uint32 InFrame)
+	: ThreadId(InThreadId)
+	, Frame(InFrame)
+{
+}
+
+FFrameArena& FFrameArena::Get()
+{
+	const uint32 ActiveFrame = FrameArena::CurrentFrame.load(std::memory_order_acquire);
+	if (!FrameArena::ThreadArena)
+	{
+		// Never freed, worker threads live as long as the process
+		FrameArena::ThreadArena = new FFrameArena(FPlatformTLS::GetCurrentThreadId(), ActiveFrame);
+
+		FScopeLock Lock(&FrameArena::ArenasLock);
+		FrameArena::Arenas.Add(FrameArena::ThreadArena);
+	}
+
+	// Only the owning thread releases its arena, so a frame ending never races with its allocations
+	FFrameArena& Arena = *FrameArena::ThreadArena;
+	if (Arena.Frame != ActiveFrame)
+	{
+		Arena.Reset();
+		Arena.Frame = ActiveFrame;
+	}
+	return Arena;
+}
+
+bool FFrameArena::IsEnabled()
+{
+	return FrameArena::bEnabled.load(std::memory_order_relaxed);
+}
+
+void FFrameArena::CountHeapAllocation()
+{
+	FrameArena::HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* FFrameArena::Allocate(SIZE_T Size, uint32 Alignment)
+{
+	uint8* Memory = Align(Top, Alignment);
+	if (!Top || Memory + Size > End)
+	{
+		AddBlock(Size + Alignment);
+		Memory = Align(Top, Alignment);
+	}
+
+	Top = Memory + Size;
+	FrameBytes += Size;
+	++FrameAllocations;
+	return Memory;
+}
+
+void* FFrameArena::Reallocate(void* Ptr, SIZE_T AllocatedSize, SIZE_T BytesToCopy, SIZE_T NewSize, uint32 Alignment)
+{
+	// The newest allocation just moves the top
+	uint8* Memory = static_cast<uint8*>(Ptr);
+	if (Memory && Memory + AllocatedSize == Top && Memory + NewSize <= End)
+	{
+		Top = Memory + NewSize;
+		FrameBytes = FrameBytes + NewSize - AllocatedSize;
+		return Memory;
+	}
+
+	void* NewMemory = Allocate(NewSize, Alignment);
+	if (Memory && BytesToCopy > 0)
+	{
+		FMemory::Memcpy(NewMemory, Memory, FMath::Min(BytesToCopy, NewSize));
+	}
+	return NewMemory;
+}
+
+void FFrameArena::AddBlock(SIZE_T MinSize)
+{
+	const SIZE_T BlockSize = FMath::Max<SIZE_T>(MinSize, FMath::Max(CVarFrameArenaBlockSizeKB.GetValueOnAnyThread(), 1) * 1024);
+	if (Blocks.Num() > 0)
+	{
+		NumOverflowBlocks.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	FBlock& Block = Blocks.AddDefaulted_GetRef();
+	Block.Memory = static_cast<uint8*>(FMemory::Malloc(BlockSize, DefaultAlignment));
+	Block.Size = BlockSize;
+	ReservedBytes.fetch_add(BlockSize, std::memory_order_relaxed);
+	CountHeapAllocation();
+	Top = Block.Memory;
+	End = Block.Memory + BlockSize;
+}
+
+void FFrameArena::Reset()
+{
+	PeakFrameBytes.store(FMath::Max(PeakFrameBytes.load(std::memory_order_relaxed), FrameBytes), std::memory_order_relaxed);
+	PeakFrameAllocations.store(FMath::Max(PeakFrameAllocations.load(std::memory_order_relaxed), FrameAllocations), std::memory_order_relaxed);
+	FrameArena::ReleasedBytes.fetch_add(FrameBytes, std::memory_order_relaxed);
+	FrameArena::ReleasedAllocations.fetch_add(FrameAllocations, std::memory_order_relaxed);
+	FrameBytes = 0;
+	FrameAllocations = 0;
+
+	if (Blocks.Num() == 0) return;
+
+	// A frame that needed several blocks gets them as one from now on, so the next frame stays in a single block
+	if (Blocks.Num() > 1)
+	{
+		SIZE_T TotalSize = 0;
+		for (const FBlock& Block : Blocks)
+		{
+			TotalSize += Block.Size;
+			FMemory::Free(Block.Memory);
+		}
+		Blocks.Reset();
+		ReservedBytes.store(0, std::memory_order_relaxed);
+		AddBlock(TotalSize);
+		return;
+	}
+
+	Top = Blocks[0].Memory;
+}
+
+void FFrameArena::EndFrame()
+{
+	check(IsInGameThread());
+
+	// The setting only changes between frames, arrays already allocated keep where they live
+	FrameArena::bEnabled.store(CVarFrameArenaEnable.GetValueOnGameThread(), std::memory_order_relaxed);
+	FrameArena::CurrentFrame.fetch_add(1, std::memory_order_release);
+
+	// Releases the game thread's arena now, the others release themselves on their next use
+	Get();
+
+	const uint64 TotalBytes = FrameArena::ReleasedBytes.exchange(0, std::memory_order_relaxed);
+	const int32 TotalAllocations = FrameArena::ReleasedAllocations.exchange(0, std::memory_order_relaxed);
+	const int32 NumHeapAllocations = FrameArena::HeapAllocations.exchange(0, std::memory_order_relaxed);
+	++FrameArena::NumFrames;
+	FrameArena::TotalHeapAllocations += NumHeapAllocations;
+
+	SET_MEMORY_STAT(STAT_FrameArenaMemory, TotalBytes);
+	SET_DWORD_STAT(STAT_FrameArenaAllocations, TotalAllocations);
+	SET_DWORD_STAT(STAT_FrameScratchHeapAllocations, NumHeapAllocations);
+	CSV_CUSTOM_STAT(GalacticArmada, FrameArenaKB, static_cast<float>(TotalBytes / 1024.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(GalacticArmada, FrameArenaAllocations, TotalAllocations, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(GalacticArmada, FrameScratchHeapAllocations, NumHeapAllocations, ECsvCustomStatOp::Set);
+}
+
+void FFrameArena::LogReport()
+{
+	check(IsInGameThread());
+
+	// Arena blocks with the arena on, every frame array (re)allocation with it off
+	UE_LOG(LogFrameArena, Log, TEXT("FrameArena: Arena %s, %.2f heap allocations per frame for frame scratch data over %lld frames"),
+		IsEnabled() ? TEXT("on") : TEXT("off"), FrameArena::TotalHeapAllocations / FMath::Max<double>(FrameArena::NumFrames, 1.0), FrameArena::NumFrames);
+
+	FScopeLock Lock(&FrameArena::ArenasLock);
+	for (const FFrameArena* Arena : FrameArena::Arenas)
+	{
+		UE_LOG(LogFrameArena, Log, TEXT("FrameArena: %s peaked at %.1fKB in %d allocations per frame, %.1fKB reserved, %d overflow blocks"),
+			*FThreadManager::GetThreadName(Arena->ThreadId), Arena->PeakFrameBytes.load(std::memory_order_relaxed) / 1024.0, Arena->PeakFrameAllocations.load(std::memory_order_relaxed),
+			Arena->ReservedBytes.load(std::memory_order_relaxed) / 1024.0, Arena->NumOverflowBlocks.load(std::memory_order_relaxed));
+	}
+}
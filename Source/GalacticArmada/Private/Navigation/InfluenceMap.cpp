@@ -0,0 +1,144 @@
+#include "Navigation/InfluenceMap.h"
+
+FInfluenceMap::FInfluenceMap(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+{
+}
+
+FIntVector FInfluenceMap::ToCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+int32 FInfluenceMap::ApplyStamp(const FStamp& Stamp, float Sign)
+{
+	const int32 RadiusCells = FMath::CeilToInt(Stamp.Radius / CellSize);
+	const float InvRadius = 1.0f / FMath::Max(Stamp.Radius, UE_KINDA_SMALL_NUMBER);
+
+	int32 NumWrites = 0;
+	for (int32 Z = -RadiusCells; Z <= RadiusCells; ++Z)
+	{
+		for (int32 Y = -RadiusCells; Y <= RadiusCells; ++Y)
+		{
+			for (int32 X = -RadiusCells; X <= RadiusCells; ++X)
+			{
+				const float Falloff = 1.0f - FMath::Sqrt(static_cast<float>(X * X + Y * Y + Z * Z)) * CellSize * InvRadius;
+				if (Falloff <= 0.0f) continue;
+
+				const FIntVector CellCoord = Stamp.Cell + FIntVector(X, Y, Z);
+				const float Value = Stamp.Strength * Falloff;
+				++NumWrites;
+
+				if (Sign > 0.0f)
+				{
+					FCell& Cell = Cells.FindOrAdd(CellCoord);
+					Cell.Influence[Stamp.TeamId] += Value;
+					++Cell.NumStamps;
+					continue;
+				}
+
+				// Takes back exactly what the stamp added, other stamps sharing the cell keep theirs
+				FCell* Cell = Cells.Find(CellCoord);
+				if (!Cell) continue;
+
+				Cell->Influence[Stamp.TeamId] -= Value;
+				if (--Cell->NumStamps <= 0)
+				{
+					Cells.Remove(CellCoord);
+				}
+			}
+		}
+	}
+
+	return NumWrites;
+}
+
+int32 FInfluenceMap::Update(TConstArrayView<FInfluenceSource> Sources, float StrengthTolerance)
+{
+	++Generation;
+	int32 NumWrites = 0;
+
+	for (const FInfluenceSource& Source : Sources)
+	{
+		if (!ensureMsgf(Source.TeamId >= 0 && Source.TeamId < MaxTeams, TEXT("Influence source %u is on team %d, the map only holds %d teams"), Source.Id, Source.TeamId, MaxTeams)) continue;
+
+		FStamp NewStamp;
+		NewStamp.Cell = ToCell(Source.Location);
+		NewStamp.TeamId = Source.TeamId;
+		NewStamp.Strength = Source.Strength;
+		NewStamp.Radius = Source.Radius;
+		NewStamp.Generation = Generation;
+
+		if (FStamp* ExistingStamp = Stamps.Find(Source.Id))
+		{
+			ExistingStamp->Generation = Generation;
+
+			// Still the same footprint, leave it
+			if (ExistingStamp->Cell == NewStamp.Cell && ExistingStamp->TeamId == NewStamp.TeamId && ExistingStamp->Radius == NewStamp.Radius
+				&& FMath::Abs(ExistingStamp->Strength - NewStamp.Strength) <= StrengthTolerance * FMath::Abs(ExistingStamp->Strength))
+			{
+				continue;
+			}
+
+			NumWrites += ApplyStamp(*ExistingStamp, -1.0f);
+		}
+
+		NumWrites += ApplyStamp(NewStamp, 1.0f);
+		Stamps.Add(Source.Id, NewStamp);
+	}
+
+	// Take Back Sources That Are Gone
+	for (auto StampIterator = Stamps.CreateIterator(); StampIterator; ++StampIterator)
+	{
+		if (StampIterator->Value.Generation != Generation)
+		{
+			NumWrites += ApplyStamp(StampIterator->Value, -1.0f);
+			StampIterator.RemoveCurrent();
+		}
+	}
+
+	return NumWrites;
+}
+
+int32 FInfluenceMap::Rebuild()
+{
+	Cells.Reset();
+
+	int32 NumWrites = 0;
+	for (const TPair<uint32, FStamp>& StampPair : Stamps)
+	{
+		NumWrites += ApplyStamp(StampPair.Value, 1.0f);
+	}
+
+	return NumWrites;
+}
+
+float FInfluenceMap::GetInfluence(const FVector& Location, int32 TeamId) const
+{
+	if (TeamId < 0 || TeamId >= MaxTeams) return 0.0f;
+
+	const FCell* Cell = Cells.Find(ToCell(Location));
+	return Cell ? Cell->Influence[TeamId] : 0.0f;
+}
+
+void FInfluenceMap::Sample(const FVector& Location, int32 TeamId, float& OutFriendly, float& OutHostile) const
+{
+	OutFriendly = 0.0f;
+	OutHostile = 0.0f;
+
+	const FCell* Cell = Cells.Find(ToCell(Location));
+	if (!Cell) return;
+
+	for (int32 CellTeamId = 0; CellTeamId < MaxTeams; ++CellTeamId)
+	{
+		(CellTeamId == TeamId ? OutFriendly : OutHostile) += FMath::Max(Cell->Influence[CellTeamId], 0.0f);
+	}
+}
+
+SIZE_T FInfluenceMap::GetAllocatedSize() const
+{
+	return Cells.GetAllocatedSize() + Stamps.GetAllocatedSize();
+}
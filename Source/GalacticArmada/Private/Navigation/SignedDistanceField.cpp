@@ -0,0 +1,237 @@
+#include "Navigation/SignedDistanceField.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace SignedDistanceField
+{
+	static const uint32 FileMagic = 0x46445347; // 'GSDF'
+	static const int32 FileVersion = 1;
+
+	static float GetSignedDistance(const FVector& Location, const FBox& Box)
+	{
+		const FVector Offset = (Location - Box.GetCenter()).GetAbs() - Box.GetExtent();
+		const double Outside = Offset.ComponentMax(FVector::ZeroVector).Size();
+		const double Inside = FMath::Min(Offset.GetMax(), 0.0);
+		return Outside + Inside;
+	}
+
+	FORCEINLINE uint8 Quantize(float Distance, float Band)
+	{
+		return (uint8)FMath::RoundToInt((FMath::Clamp(Distance / Band, -1.0f, 1.0f) * 0.5f + 0.5f) * 255.0f);
+	}
+
+	FORCEINLINE float Dequantize(uint8 Value, float Band)
+	{
+		return (Value / 255.0f * 2.0f - 1.0f) * Band;
+	}
+}
+
+FSignedDistanceField::FSignedDistanceField() = default;
+
+FSignedDistanceField::~FSignedDistanceField()
+{
+	Reset();
+}
+
+bool FSignedDistanceField::Bake(TConstArrayView<FBox> Obstacles, uint32 ObstacleHash, float VoxelSize, float Band, const FString& FilePath)
+{
+	VoxelSize = FMath::Max(VoxelSize, 1.0f);
+	Band = FMath::Max(Band, VoxelSize);
+
+	FBox Bounds(ForceInit);
+	for (const FBox& Obstacle : Obstacles)
+	{
+		Bounds += Obstacle.ExpandBy(Band);
+	}
+	if (!Bounds.IsValid) return false;
+
+	const float BrickWorldSize = VoxelSize * BrickCells;
+	FSignedDistanceFieldHeader FileHeader;
+	FileHeader.Magic = SignedDistanceField::FileMagic;
+	FileHeader.Version = SignedDistanceField::FileVersion;
+	FileHeader.ObstacleHash = ObstacleHash;
+	FileHeader.VoxelSize = VoxelSize;
+	FileHeader.Band = Band;
+	FileHeader.Origin = FVector3f(Bounds.Min);
+	FileHeader.BrickCountX = FMath::Max(FMath::CeilToInt(Bounds.GetSize().X / BrickWorldSize), 1);
+	FileHeader.BrickCountY = FMath::Max(FMath::CeilToInt(Bounds.GetSize().Y / BrickWorldSize), 1);
+	FileHeader.BrickCountZ = FMath::Max(FMath::CeilToInt(Bounds.GetSize().Z / BrickWorldSize), 1);
+
+	TArray<int32> Indices;
+	Indices.Init(INDEX_NONE, FileHeader.BrickCountX * FileHeader.BrickCountY * FileHeader.BrickCountZ);
+	TArray64<uint8> Bricks;
+	TArray<int32> Candidates;
+	uint8 Samples[BrickSize];
+
+	for (int32 BrickZ = 0; BrickZ < FileHeader.BrickCountZ; ++BrickZ)
+	{
+		for (int32 BrickY = 0; BrickY < FileHeader.BrickCountY; ++BrickY)
+		{
+			for (int32 BrickX = 0; BrickX < FileHeader.BrickCountX; ++BrickX)
+			{
+				const FVector BrickMin = Bounds.Min + FVector(BrickX, BrickY, BrickZ) * BrickWorldSize;
+				const FBox BrickBox(BrickMin, BrickMin + FVector(BrickWorldSize));
+
+				// Only obstacles within Band of this brick can change its samples
+				Candidates.Reset();
+				for (int32 ObstacleIndex = 0; ObstacleIndex < Obstacles.Num(); ++ObstacleIndex)
+				{
+					if (Obstacles[ObstacleIndex].ExpandBy(Band).Intersect(BrickBox))
+					{
+						Candidates.Add(ObstacleIndex);
+					}
+				}
+				if (Candidates.Num() == 0) continue;
+
+				float MinDistance = Band;
+				for (int32 SampleIndex = 0; SampleIndex < BrickSize; ++SampleIndex)
+				{
+					const FVector SampleLocation = BrickMin + FVector(SampleIndex % BrickSamples, (SampleIndex / BrickSamples) % BrickSamples, SampleIndex / (BrickSamples * BrickSamples)) * VoxelSize;
+
+					float Distance = Band;
+					for (const int32 ObstacleIndex : Candidates)
+					{
+						Distance = FMath::Min(Distance, SignedDistanceField::GetSignedDistance(SampleLocation, Obstacles[ObstacleIndex]));
+					}
+
+					MinDistance = FMath::Min(MinDistance, Distance);
+					Samples[SampleIndex] = SignedDistanceField::Quantize(Distance, Band);
+				}
+
+				// Nothing within band after all, leave the brick out
+				if (MinDistance >= Band) continue;
+
+				Indices[BrickX + FileHeader.BrickCountX * (BrickY + FileHeader.BrickCountY * BrickZ)] = FileHeader.NumBricks++;
+				Bricks.Append(Samples, BrickSize);
+			}
+		}
+	}
+
+	// Other processes may have the previous file mapped, so write a private copy and swap it in whole
+	const FString TempPath = FPaths::CreateTempFilename(*FPaths::GetPath(FilePath), *FPaths::GetBaseFilename(FilePath), TEXT(".tmp"));
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+	if (!Writer) return false;
+
+	Writer->Serialize(&FileHeader, sizeof(FileHeader));
+	Writer->Serialize(Indices.GetData(), Indices.Num() * sizeof(int32));
+	Writer->Serialize(Bricks.GetData(), Bricks.Num());
+	const bool bWritten = Writer->Close();
+	Writer.Reset();
+
+	if (!bWritten || !IFileManager::Get().Move(*FilePath, *TempPath))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+	return true;
+}
+
+bool FSignedDistanceField::Load(const FString& FilePath, uint32 ObstacleHash, float VoxelSize, float Band)
+{
+	Reset();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*FilePath)) return false;
+
+	// Map the file so bricks are paged in only when a ship samples near them
+	MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+	if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		if (SetData(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize(), ObstacleHash, VoxelSize, Band)) return true;
+	}
+	else if (FFileHelper::LoadFileToArray(LoadedData, *FilePath))
+	{
+		if (SetData(LoadedData.GetData(), LoadedData.Num(), ObstacleHash, VoxelSize, Band)) return true;
+	}
+
+	Reset();
+	return false;
+}
+
+bool FSignedDistanceField::SetData(const uint8* Data, int64 Size, uint32 ObstacleHash, float VoxelSize, float Band)
+{
+	if (!Data || Size < (int64)sizeof(FSignedDistanceFieldHeader)) return false;
+
+	const FSignedDistanceFieldHeader* FileHeader = reinterpret_cast<const FSignedDistanceFieldHeader*>(Data);
+	if (FileHeader->Magic != SignedDistanceField::FileMagic || FileHeader->Version != SignedDistanceField::FileVersion) return false;
+	if (FileHeader->ObstacleHash != ObstacleHash || FileHeader->VoxelSize != FMath::Max(VoxelSize, 1.0f) || FileHeader->Band != FMath::Max(Band, FileHeader->VoxelSize)) return false;
+
+	const int64 NumIndices = (int64)FileHeader->BrickCountX * FileHeader->BrickCountY * FileHeader->BrickCountZ;
+	const int64 ExpectedSize = sizeof(FSignedDistanceFieldHeader) + NumIndices * sizeof(int32) + (int64)FileHeader->NumBricks * BrickSize;
+	if (Size != ExpectedSize) return false;
+
+	Header = FileHeader;
+	BrickIndices = reinterpret_cast<const int32*>(Data + sizeof(FSignedDistanceFieldHeader));
+	BrickData = Data + sizeof(FSignedDistanceFieldHeader) + NumIndices * sizeof(int32);
+	DataSize = Size;
+	return true;
+}
+
+void FSignedDistanceField::Reset()
+{
+	Header = nullptr;
+	BrickIndices = nullptr;
+	BrickData = nullptr;
+	DataSize = 0;
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedData.Empty();
+}
+
+bool FSignedDistanceField::Sample(const FVector& Location, float& OutDistance, FVector& OutGradient) const
+{
+	if (!Header) return false;
+
+	const FVector3f Local = (FVector3f(Location) - Header->Origin) / Header->VoxelSize;
+	const int32 CellX = FMath::FloorToInt(Local.X);
+	const int32 CellY = FMath::FloorToInt(Local.Y);
+	const int32 CellZ = FMath::FloorToInt(Local.Z);
+	if (CellX < 0 || CellY < 0 || CellZ < 0) return false;
+	if (CellX >= Header->BrickCountX * BrickCells || CellY >= Header->BrickCountY * BrickCells || CellZ >= Header->BrickCountZ * BrickCells) return false;
+
+	const int32 BrickX = CellX / BrickCells;
+	const int32 BrickY = CellY / BrickCells;
+	const int32 BrickZ = CellZ / BrickCells;
+	const int32 BrickIndex = BrickIndices[BrickX + Header->BrickCountX * (BrickY + Header->BrickCountY * BrickZ)];
+	if (BrickIndex == INDEX_NONE) return false;
+
+	const uint8* Brick = BrickData + (int64)BrickIndex * BrickSize;
+	const int32 BaseSample = (CellX - BrickX * BrickCells) + (CellY - BrickY * BrickCells) * BrickSamples + (CellZ - BrickZ * BrickCells) * BrickSamples * BrickSamples;
+	auto GetSample = [this, Brick, BaseSample](int32 X, int32 Y, int32 Z)
+	{
+		return SignedDistanceField::Dequantize(Brick[BaseSample + X + Y * BrickSamples + Z * BrickSamples * BrickSamples], Header->Band);
+	};
+
+	const float C000 = GetSample(0, 0, 0), C100 = GetSample(1, 0, 0);
+	const float C010 = GetSample(0, 1, 0), C110 = GetSample(1, 1, 0);
+	const float C001 = GetSample(0, 0, 1), C101 = GetSample(1, 0, 1);
+	const float C011 = GetSample(0, 1, 1), C111 = GetSample(1, 1, 1);
+
+	const float FX = Local.X - CellX;
+	const float FY = Local.Y - CellY;
+	const float FZ = Local.Z - CellZ;
+
+	const float C00 = FMath::Lerp(C000, C100, FX);
+	const float C10 = FMath::Lerp(C010, C110, FX);
+	const float C01 = FMath::Lerp(C001, C101, FX);
+	const float C11 = FMath::Lerp(C011, C111, FX);
+	const float C0 = FMath::Lerp(C00, C10, FY);
+	const float C1 = FMath::Lerp(C01, C11, FY);
+	OutDistance = FMath::Lerp(C0, C1, FZ);
+	if (OutDistance >= Header->Band * 0.99f) return false;
+
+	// Analytic derivative of the trilinear blend
+	const float GradientX = FMath::Lerp(FMath::Lerp(C100 - C000, C110 - C010, FY), FMath::Lerp(C101 - C001, C111 - C011, FY), FZ);
+	const float GradientY = FMath::Lerp(C10 - C00, C11 - C01, FZ);
+	const float GradientZ = C1 - C0;
+	OutGradient = FVector(GradientX, GradientY, GradientZ) / Header->VoxelSize;
+	return true;
+}
@@ -0,0 +1,301 @@
+#include "Navigation/SparseVoxelOctree.h"
+#include "Algo/Reverse.h"
+
+namespace SparseVoxelOctree
+{
+	static const FVector FaceDirections[6] =
+	{
+		FVector(1, 0, 0), FVector(-1, 0, 0),
+		FVector(0, 1, 0), FVector(0, -1, 0),
+		FVector(0, 0, 1), FVector(0, 0, -1)
+	};
+
+	static FBox GetNodeBox(const FSparseVoxelOctreeNode& Node)
+	{
+		return FBox::BuildAABB(FVector(Node.Center), FVector(Node.HalfExtent));
+	}
+
+	struct FOpenNode
+	{
+		float Cost;
+		int32 FreeIndex;
+
+		FORCEINLINE bool operator<(const FOpenNode& Other) const { return Cost < Other.Cost; }
+	};
+}
+
+void FSparseVoxelOctree::Build(TConstArrayView<FBox> Obstacles, const FSparseVoxelOctreeSettings& InSettings)
+{
+	Settings = InSettings;
+	Nodes.Reset();
+	FreeLeafNodes.Reset();
+	EdgeOffsets.Reset();
+	Edges.Reset();
+
+	// Inflate Obstacles By The Agent Radius
+	TArray<FBox> InflatedObstacles;
+	InflatedObstacles.Reserve(Obstacles.Num());
+	FBox ObstacleBounds(ForceInit);
+	for (const FBox& Obstacle : Obstacles)
+	{
+		InflatedObstacles.Add(Obstacle.ExpandBy(Settings.AgentRadius));
+		ObstacleBounds += InflatedObstacles.Last();
+	}
+	if (!ObstacleBounds.IsValid) return;
+
+	// Root cube is rounded to a power of two voxels so leaves line up with the voxel size, unless MaxDepth caps it
+	const FVector Extent = ObstacleBounds.ExpandBy(Settings.BoundsPadding).GetExtent();
+	const float VoxelSize = FMath::Max(Settings.VoxelSize, 1.0f);
+	const int32 Depth = FMath::Clamp(FMath::CeilLogTwo(FMath::CeilToInt(Extent.GetMax() * 2.0 / VoxelSize)), 0, Settings.MaxDepth);
+
+	FSparseVoxelOctreeNode& Root = Nodes.AddDefaulted_GetRef();
+	Root.Center = FVector3f(ObstacleBounds.GetCenter());
+	Root.HalfExtent = FMath::Max(VoxelSize * (1 << Depth) * 0.5f, (float)Extent.GetMax());
+
+	TArray<int32> Candidates;
+	Candidates.Reserve(InflatedObstacles.Num());
+	for (int32 ObstacleIndex = 0; ObstacleIndex < InflatedObstacles.Num(); ++ObstacleIndex)
+	{
+		Candidates.Add(ObstacleIndex);
+	}
+
+	BuildNode(0, Depth, InflatedObstacles, Candidates);
+	BuildFreeSpaceGraph();
+
+	Nodes.Shrink();
+}
+
+void FSparseVoxelOctree::BuildNode(int32 NodeIndex, int32 Depth, TConstArrayView<FBox> Obstacles, const TArray<int32>& Candidates)
+{
+	const FBox NodeBox = SparseVoxelOctree::GetNodeBox(Nodes[NodeIndex]);
+
+	TArray<int32> Overlapping;
+	for (const int32 ObstacleIndex : Candidates)
+	{
+		const FBox& Obstacle = Obstacles[ObstacleIndex];
+		if (!Obstacle.Intersect(NodeBox)) continue;
+
+		// Fully inside an obstacle, no need to look any closer
+		if (Obstacle.IsInsideOrOn(NodeBox.Min) && Obstacle.IsInsideOrOn(NodeBox.Max)) return;
+
+		Overlapping.Add(ObstacleIndex);
+	}
+
+	if (Overlapping.Num() == 0)
+	{
+		Nodes[NodeIndex].FreeIndex = FreeLeafNodes.Add(NodeIndex);
+		return;
+	}
+
+	// Smallest voxels touching an obstacle stay blocked
+	if (Depth == 0) return;
+
+	const FVector3f ParentCenter = Nodes[NodeIndex].Center;
+	const float ChildHalfExtent = Nodes[NodeIndex].HalfExtent * 0.5f;
+	const int32 FirstChild = Nodes.AddDefaulted(8);
+	Nodes[NodeIndex].FirstChild = FirstChild;
+
+	for (int32 ChildIndex = 0; ChildIndex < 8; ++ChildIndex)
+	{
+		FSparseVoxelOctreeNode& Child = Nodes[FirstChild + ChildIndex];
+		Child.HalfExtent = ChildHalfExtent;
+		Child.Center = ParentCenter + FVector3f(
+			(ChildIndex & 1) ? ChildHalfExtent : -ChildHalfExtent,
+			(ChildIndex & 2) ? ChildHalfExtent : -ChildHalfExtent,
+			(ChildIndex & 4) ? ChildHalfExtent : -ChildHalfExtent);
+	}
+
+	for (int32 ChildIndex = 0; ChildIndex < 8; ++ChildIndex)
+	{
+		BuildNode(FirstChild + ChildIndex, Depth - 1, Obstacles, Overlapping);
+	}
+}
+
+void FSparseVoxelOctree::BuildFreeSpaceGraph()
+{
+	// Probing just past each face centre finds the neighbour when it is as large or larger,
+	// smaller neighbours find this leaf from their side, so linking both ways covers every pair
+	TArray<TArray<int32, TInlineAllocator<8>>> Neighbours;
+	Neighbours.SetNum(FreeLeafNodes.Num());
+
+	for (int32 FreeIndex = 0; FreeIndex < FreeLeafNodes.Num(); ++FreeIndex)
+	{
+		const FSparseVoxelOctreeNode& Node = Nodes[FreeLeafNodes[FreeIndex]];
+		for (const FVector& FaceDirection : SparseVoxelOctree::FaceDirections)
+		{
+			const int32 NeighbourFreeIndex = FindFreeIndex(FVector(Node.Center) + FaceDirection * (Node.HalfExtent + 1.0f));
+			if (NeighbourFreeIndex == INDEX_NONE) continue;
+
+			Neighbours[FreeIndex].AddUnique(NeighbourFreeIndex);
+			Neighbours[NeighbourFreeIndex].AddUnique(FreeIndex);
+		}
+	}
+
+	EdgeOffsets.SetNumUninitialized(FreeLeafNodes.Num() + 1);
+	for (int32 FreeIndex = 0; FreeIndex < FreeLeafNodes.Num(); ++FreeIndex)
+	{
+		EdgeOffsets[FreeIndex] = Edges.Num();
+		Edges.Append(Neighbours[FreeIndex]);
+	}
+	EdgeOffsets[FreeLeafNodes.Num()] = Edges.Num();
+}
+
+void FSparseVoxelOctree::Serialize(FArchive& Ar)
+{
+	Ar << Settings;
+	Ar << Nodes;
+	Ar << FreeLeafNodes;
+	Ar << EdgeOffsets;
+	Ar << Edges;
+}
+
+int32 FSparseVoxelOctree::FindLeaf(const FVector& Location) const
+{
+	if (Nodes.Num() == 0) return INDEX_NONE;
+
+	const FVector3f Point(Location);
+	const FSparseVoxelOctreeNode& Root = Nodes[0];
+	if (FMath::Abs(Point.X - Root.Center.X) > Root.HalfExtent || FMath::Abs(Point.Y - Root.Center.Y) > Root.HalfExtent || FMath::Abs(Point.Z - Root.Center.Z) > Root.HalfExtent)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 NodeIndex = 0;
+	while (!Nodes[NodeIndex].IsLeaf())
+	{
+		const FSparseVoxelOctreeNode& Node = Nodes[NodeIndex];
+		const int32 ChildIndex = (Point.X >= Node.Center.X ? 1 : 0) | (Point.Y >= Node.Center.Y ? 2 : 0) | (Point.Z >= Node.Center.Z ? 4 : 0);
+		NodeIndex = Node.FirstChild + ChildIndex;
+	}
+	return NodeIndex;
+}
+
+int32 FSparseVoxelOctree::FindFreeIndex(const FVector& Location) const
+{
+	const int32 NodeIndex = FindLeaf(Location);
+	return NodeIndex != INDEX_NONE ? Nodes[NodeIndex].FreeIndex : INDEX_NONE;
+}
+
+FVector FSparseVoxelOctree::ClampToBounds(const FVector& Location) const
+{
+	if (Nodes.Num() == 0) return Location;
+
+	const FVector Center(Nodes[0].Center);
+	const FVector Extent(Nodes[0].HalfExtent - 1.0f);
+	return FVector(
+		FMath::Clamp(Location.X, Center.X - Extent.X, Center.X + Extent.X),
+		FMath::Clamp(Location.Y, Center.Y - Extent.Y, Center.Y + Extent.Y),
+		FMath::Clamp(Location.Z, Center.Z - Extent.Z, Center.Z + Extent.Z));
+}
+
+bool FSparseVoxelOctree::IsBlocked(const FVector& Location) const
+{
+	const int32 NodeIndex = FindLeaf(Location);
+	return NodeIndex != INDEX_NONE && Nodes[NodeIndex].IsBlocked();
+}
+
+bool FSparseVoxelOctree::IsSegmentFree(const FVector& Start, const FVector& End) const
+{
+	const double Length = FVector::Distance(Start, End);
+	const double StepLength = FMath::Max(Settings.VoxelSize * 0.5, 1.0);
+	const int32 NumSteps = FMath::CeilToInt(Length / StepLength);
+
+	for (int32 Step = 0; Step <= NumSteps; ++Step)
+	{
+		if (IsBlocked(FMath::Lerp(Start, End, NumSteps > 0 ? (double)Step / NumSteps : 0.0)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FSparseVoxelOctree::FindPath(int32 StartFreeIndex, int32 GoalFreeIndex, TArray<FVector>& OutPath) const
+{
+	OutPath.Reset();
+	if (!FreeLeafNodes.IsValidIndex(StartFreeIndex) || !FreeLeafNodes.IsValidIndex(GoalFreeIndex)) return false;
+
+	auto GetLocation = [this](int32 FreeIndex) { return FVector(Nodes[FreeLeafNodes[FreeIndex]].Center); };
+	const FVector GoalLocation = GetLocation(GoalFreeIndex);
+
+	TArray<float> CostSoFar;
+	TArray<int32> CameFrom;
+	TBitArray<> Closed(false, FreeLeafNodes.Num());
+	CostSoFar.Init(TNumericLimits<float>::Max(), FreeLeafNodes.Num());
+	CameFrom.Init(INDEX_NONE, FreeLeafNodes.Num());
+
+	TArray<SparseVoxelOctree::FOpenNode> OpenSet;
+	CostSoFar[StartFreeIndex] = 0.0f;
+	OpenSet.HeapPush({ (float)FVector::Distance(GetLocation(StartFreeIndex), GoalLocation), StartFreeIndex });
+
+	int32 NumExpanded = 0;
+	bool bFoundGoal = false;
+	while (OpenSet.Num() > 0 && NumExpanded < Settings.MaxSearchNodes)
+	{
+		SparseVoxelOctree::FOpenNode Current;
+		OpenSet.HeapPop(Current, false);
+
+		// Cheaper routes push a leaf again rather than updating it in the heap, the stale entries are skipped here
+		if (Closed[Current.FreeIndex]) continue;
+		Closed[Current.FreeIndex] = true;
+		++NumExpanded;
+
+		if (Current.FreeIndex == GoalFreeIndex)
+		{
+			bFoundGoal = true;
+			break;
+		}
+
+		const FVector CurrentLocation = GetLocation(Current.FreeIndex);
+		for (int32 EdgeIndex = EdgeOffsets[Current.FreeIndex]; EdgeIndex < EdgeOffsets[Current.FreeIndex + 1]; ++EdgeIndex)
+		{
+			const int32 NeighbourFreeIndex = Edges[EdgeIndex];
+			if (Closed[NeighbourFreeIndex]) continue;
+
+			const FVector NeighbourLocation = GetLocation(NeighbourFreeIndex);
+			const float NewCost = CostSoFar[Current.FreeIndex] + FVector::Distance(CurrentLocation, NeighbourLocation);
+			if (NewCost >= CostSoFar[NeighbourFreeIndex]) continue;
+
+			CostSoFar[NeighbourFreeIndex] = NewCost;
+			CameFrom[NeighbourFreeIndex] = Current.FreeIndex;
+			OpenSet.HeapPush({ NewCost + (float)FVector::Distance(NeighbourLocation, GoalLocation), NeighbourFreeIndex });
+		}
+	}
+
+	if (!bFoundGoal) return false;
+
+	for (int32 FreeIndex = GoalFreeIndex; FreeIndex != INDEX_NONE; FreeIndex = CameFrom[FreeIndex])
+	{
+		OutPath.Add(GetLocation(FreeIndex));
+	}
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+void FSparseVoxelOctree::SmoothPath(TArray<FVector>& InOutPath) const
+{
+	if (InOutPath.Num() <= 2) return;
+
+	TArray<FVector> SmoothedPath;
+	SmoothedPath.Add(InOutPath[0]);
+
+	int32 AnchorIndex = 0;
+	while (AnchorIndex < InOutPath.Num() - 1)
+	{
+		int32 NextIndex = InOutPath.Num() - 1;
+		while (NextIndex > AnchorIndex + 1 && !IsSegmentFree(InOutPath[AnchorIndex], InOutPath[NextIndex]))
+		{
+			--NextIndex;
+		}
+
+		SmoothedPath.Add(InOutPath[NextIndex]);
+		AnchorIndex = NextIndex;
+	}
+
+	InOutPath = MoveTemp(SmoothedPath);
+}
+
+SIZE_T FSparseVoxelOctree::GetAllocatedSize() const
+{
+	return Nodes.GetAllocatedSize() + FreeLeafNodes.GetAllocatedSize() + EdgeOffsets.GetAllocatedSize() + Edges.GetAllocatedSize();
+}
@@ -0,0 +1,72 @@
+#include "Navigation/StaticObstacleGatherer.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "PhysicsEngine/BodySetup.h"
+
+const FName StaticObstacles::StaticObstacleTag(TEXT("StaticObstacle"));
+
+namespace StaticObstacles
+{
+	static bool IsStaticObstacle(const AActor* Actor, const UPrimitiveComponent* Primitive)
+	{
+		if (!Primitive->IsRegistered() || !Primitive->IsCollisionEnabled() || Primitive->IsSimulatingPhysics()) return false;
+		if (Primitive->GetCollisionResponseToChannel(ECC_Vehicle) != ECR_Block) return false;
+		return Primitive->Mobility != EComponentMobility::Movable || Actor->ActorHasTag(StaticObstacleTag);
+	}
+
+	static void AddPrimitiveBoxes(const UPrimitiveComponent* Primitive, TArray<FBox>& OutBoxes)
+	{
+		const FTransform& ComponentTransform = Primitive->GetComponentTransform();
+		const UBodySetup* BodySetup = Primitive->GetBodySetup();
+
+		// Simple collision hugs stations far tighter than one box around the whole mesh
+		if (BodySetup && BodySetup->AggGeom.GetElementCount() > 0)
+		{
+			const FKAggregateGeom& AggGeom = BodySetup->AggGeom;
+			const FVector Scale3D = ComponentTransform.GetScale3D();
+			const float UniformScale = Scale3D.GetAbsMax();
+			FTransform ElementTransform = ComponentTransform;
+			ElementTransform.RemoveScaling();
+
+			for (const FKSphereElem& SphereElem : AggGeom.SphereElems) OutBoxes.Add(SphereElem.CalcAABB(ElementTransform, UniformScale));
+			for (const FKBoxElem& BoxElem : AggGeom.BoxElems) OutBoxes.Add(BoxElem.CalcAABB(ElementTransform, UniformScale));
+			for (const FKSphylElem& SphylElem : AggGeom.SphylElems) OutBoxes.Add(SphylElem.CalcAABB(ElementTransform, UniformScale));
+			for (const FKConvexElem& ConvexElem : AggGeom.ConvexElems) OutBoxes.Add(ConvexElem.CalcAABB(ElementTransform, Scale3D));
+			return;
+		}
+
+		OutBoxes.Add(Primitive->Bounds.GetBox());
+	}
+}
+
+void StaticObstacles::Gather(const UWorld* World, FStaticObstacleSet& OutObstacles)
+{
+	check(IsInGameThread());
+
+	OutObstacles = FStaticObstacleSet();
+	if (!World) return;
+
+	for (TActorIterator<AActor> ActorIterator(World); ActorIterator; ++ActorIterator)
+	{
+		const AActor* Actor = *ActorIterator;
+		if (!IsValid(Actor) || Actor->IsA<APawn>()) continue;
+
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(Actor);
+		for (const UPrimitiveComponent* Primitive : Primitives)
+		{
+			if (IsStaticObstacle(Actor, Primitive))
+			{
+				AddPrimitiveBoxes(Primitive, OutObstacles.Boxes);
+			}
+		}
+	}
+
+	for (const FBox& Box : OutObstacles.Boxes)
+	{
+		OutObstacles.Bounds += Box;
+		OutObstacles.Hash = FCrc::MemCrc32(&Box.Min, sizeof(FVector), OutObstacles.Hash);
+		OutObstacles.Hash = FCrc::MemCrc32(&Box.Max, sizeof(FVector), OutObstacles.Hash);
+	}
+}
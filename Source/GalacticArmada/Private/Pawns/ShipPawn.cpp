@@ -1,4 +1,5 @@
 #include "Pawns/ShipPawn.h"
+#include "GalacticArmada.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "NiagaraFunctionLibrary.h"
@@ -7,16 +8,32 @@
 #include "Components/HealthComponent.h"
 #include "Components/ShipMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "Data/ShipAssetBundles.h"
+#include "Engine/CollisionProfile.h"
 #include "Controllers/ShipAIController.h"
 #include "NiagaraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Memory/FrameArena.h"
+#include "Subsystems/ShipAssetPreloadSubsystem.h"
+#include "Subsystems/ShipCameraFeedbackSubsystem.h"
+#include "Subsystems/ShipDetectionSubsystem.h"
+#include "Subsystems/ShipEventSubsystem.h"
+#include "Subsystems/ShipExplosionSubsystem.h"
+#include "Subsystems/ShipFidelitySubsystem.h"
+#include "Subsystems/ShipGunnerySubsystem.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+#include "Telemetry/ShipTelemetry.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogShipPawn, Log, All)
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Avoidance Traces"), STAT_AvoidanceTraces, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Avoidance Traces Skipped"), STAT_AvoidanceTracesSkipped, STATGROUP_GalacticArmada);
+
 AShipPawn::AShipPawn()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Actor tick only drives thruster effects, which the server target never spawns
+	PrimaryActorTick.bCanEverTick = GA_WITH_COSMETICS;
 
 	// Set AI Controller
 	AIControllerClass = AShipAIController::StaticClass();
@@ -27,7 +44,6 @@ AShipPawn::AShipPawn()
 	ShipMesh->SetSimulatePhysics(true);
 	ShipMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 	ShipMesh->SetCollisionObjectType(ECC_Vehicle);
-	ShipMesh->OnComponentHit.AddDynamic(this, &AShipPawn::OnShipCollision);
 	
 	// Initialize Detection Sphere Collision
 	DetectionSphereCollision = CreateDefaultSubobject<USphereComponent>(TEXT("DetectionCollision"));
@@ -35,7 +51,15 @@ AShipPawn::AShipPawn()
 	DetectionSphereCollision->SetSphereRadius(40000.0f);
 	DetectionSphereCollision->OnComponentBeginOverlap.AddDynamic(this, &AShipPawn::OnDetectionOverlapBegin);
 	DetectionSphereCollision->OnComponentEndOverlap.AddDynamic(this, &AShipPawn::OnDetectionOverlapEnd);
+
+	// Initialize Proxy Collision, only enabled while the ship is represented by a proxy
+	ProxyCollision = CreateDefaultSubobject<USphereComponent>(TEXT("ProxyCollision"));
+	ProxyCollision->SetupAttachment(ShipMesh);
+	ProxyCollision->SetSphereRadius(500.0f);
+	ProxyCollision->SetCollisionProfileName(UCollisionProfile::Vehicle_ProfileName);
+	ProxyCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	
+#if GA_WITH_COSMETICS
 	// Initialize Spring Arm
 	SpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArm"));
 	SpringArm->SetupAttachment(RootComponent);
@@ -48,6 +72,7 @@ AShipPawn::AShipPawn()
 	// Initialize Camera
 	Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"));
 	Camera->SetupAttachment(SpringArm);
+#endif
 
 	// Initialize Ship Movement
 	ShipMovementComponent = CreateDefaultSubobject<UShipMovementComponent>(TEXT("ShipMovement"));
@@ -58,13 +83,15 @@ AShipPawn::AShipPawn()
 	// Initialize Health
 	HealthComponent = CreateDefaultSubobject<UHealthComponent>(TEXT("Health"));
 	HealthComponent->SetDefaultHealth(100.0f);
-	HealthComponent->OnDeath.AddDynamic(this, &AShipPawn::OnPawnDied);
 }
 
 void AShipPawn::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(GalacticArmada_Ships);
 	Super::BeginPlay();
 
+	AvoidanceQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ShipAvoidance), false, this);
+
 	// Setup player input if controlled by player
 	if (const APlayerController* PlayerController = Cast<APlayerController>(Controller))
 	{
@@ -74,14 +101,82 @@ void AShipPawn::BeginPlay()
 		}
 	}
 
-	InitializeThrusterEffects();
+	DetectionCollisionEnabled = DetectionSphereCollision->GetCollisionEnabled();
+
+	// Keep the detection sphere out of the physics scene, its overlaps come from the batched detection pass
+	if (UShipDetectionSubsystem::IsDeferredDetectionEnabled() && GetWorld()->GetSubsystem<UShipDetectionSubsystem>())
+	{
+		bDeferredDetection = true;
+		DetectionSphereCollision->SetGenerateOverlapEvents(false);
+		UpdateDetectionCollision();
+	}
+
+	// Register Ship
+	if (UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>())
+	{
+		ShipRegistry->RegisterShip(this);
+	}
+	if (UShipGunnerySubsystem* GunnerySubsystem = GetWorld()->GetSubsystem<UShipGunnerySubsystem>())
+	{
+		GunnerySubsystem->ResetShipMotion(this);
+	}
+
+	FShipTelemetry::Record(EShipTelemetryEventType::Spawn, this, nullptr, 0.0f, TeamId);
+
+	// Thrusters attach once the class's streamed effects are resident, immediately when preloaded
+	if (UShipAssetPreloadSubsystem* AssetPreloader = UShipAssetPreloadSubsystem::Get(this))
+	{
+		TWeakObjectPtr<AShipPawn> WeakThis(this);
+		AssetPreloader->LoadShipClassAssets(GetClass(), [WeakThis]()
+		{
+			AShipPawn* Ship = WeakThis.Get();
+			if (Ship && GalacticArmada::ShouldPlayCosmetics(Ship))
+			{
+				Ship->InitializeThrusterEffects();
+			}
+		});
+	}
+	else if (GalacticArmada::ShouldPlayCosmetics(this))
+	{
+		InitializeThrusterEffects();
+	}
+}
+
+void AShipPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>())
+	{
+		ShipRegistry->UnregisterShip(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AShipPawn::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
-	UpdateThrusterEffects();
+	if (Representation == EShipRepresentation::Full)
+	{
+		// The player's own thrusters stay smooth, the fidelity governor thins out everyone else's updates
+		TimeSinceThrusterUpdate += DeltaSeconds;
+		if (IsPlayerControlled() || TimeSinceThrusterUpdate >= UShipFidelitySubsystem::GetSettings(GetWorld()).ThrusterUpdateInterval)
+		{
+			TimeSinceThrusterUpdate = 0.0f;
+			UpdateThrusterEffects();
+		}
+	}
+}
+
+void AShipPawn::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	// Level placed AI keeps the default team, so the player needs its own to be hostile to them
+	if (NewController && NewController->IsPlayerController())
+	{
+		TeamId = PlayerTeamId;
+	}
 }
 
 void AShipPawn::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -112,21 +207,34 @@ void AShipPawn::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 
 void AShipPawn::InitializeThrusterEffects()
 {
+#if GA_WITH_COSMETICS
+	if (ThrusterParticleEffects.Num() > 0) return;
+
+	// Streamed in after the ship may already be a proxy or parked in the pool
+	const bool bHideThrusters = Representation == EShipRepresentation::Proxy || bIsDormant;
+
+	LLM_SCOPE_BYTAG(GalacticArmada_FX);
 	for (const FThrusterEffect& ThrusterEffect : ThrusterEffects)
 	{
-		if (ThrusterEffect.ThrusterParticleEffect)
+		if (UNiagaraSystem* ThrusterSystem = ThrusterEffect.ThrusterParticleEffect.Get())
 		{
 			UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(
-				ThrusterEffect.ThrusterParticleEffect,
+				ThrusterSystem,
 				ShipMesh,
 				ThrusterEffect.SocketName,
 				FVector::ZeroVector,
 				FRotator::ZeroRotator,
 				EAttachLocation::SnapToTarget,
 				false);
+			if (NiagaraComponent && bHideThrusters)
+			{
+				NiagaraComponent->SetVisibility(false);
+				NiagaraComponent->SetPaused(true);
+			}
 			ThrusterParticleEffects.Add(NiagaraComponent);
 		}
 	}
+#endif
 }
 
 void AShipPawn::UpdateThrusterEffects()
@@ -202,6 +310,16 @@ void AShipPawn::ClearCollisionCooldown()
 	bIsCollisionCooldown = false;
 }
 
+void AShipPawn::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit)
+{
+	Super::NotifyHit(MyComp, Other, OtherComp, bSelfMoved, HitLocation, HitNormal, NormalImpulse, Hit);
+
+	if (MyComp == ShipMesh)
+	{
+		OnShipCollision(MyComp, Other, OtherComp, NormalImpulse, Hit);
+	}
+}
+
 void AShipPawn::OnShipCollision(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
 	if (bIsCollisionCooldown) return;
@@ -226,20 +344,26 @@ void AShipPawn::OnShipCollision(UPrimitiveComponent* HitComponent, AActor* Other
 			AddActorLocalRotation(NewRotation, true, &HitResult, ETeleportType::TeleportPhysics);
 		}
 
+		const bool bPlayCosmetics = GalacticArmada::ShouldPlayCosmetics(this);
+
 		// Spawn Impact Particle Effects
-		if (CollisionImpactParticleEffect)
+		if (bPlayCosmetics && CollisionImpactParticleEffect.Get())
 		{
-			if (UNiagaraComponent* SpawnedImpactEffect = UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, CollisionImpactParticleEffect, Hit.ImpactPoint, Hit.ImpactNormal.Rotation()))
+			LLM_SCOPE_BYTAG(GalacticArmada_FX);
+			if (UNiagaraComponent* SpawnedImpactEffect = UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, CollisionImpactParticleEffect.Get(), Hit.ImpactPoint, Hit.ImpactNormal.Rotation()))
 			{
 				SpawnedImpactEffect->SetAutoDestroy(true);
 			}
 		}
 
+#if GA_WITH_COSMETICS
 		// Play Camera Shake
-		if (ImpactCameraShake)
+		UShipCameraFeedbackSubsystem* CameraFeedbackSubsystem = GetWorld()->GetSubsystem<UShipCameraFeedbackSubsystem>();
+		if (CameraFeedbackSubsystem && ImpactCameraShake.Get())
 		{
-			 UGameplayStatics::PlayWorldCameraShake(this, ImpactCameraShake, Hit.ImpactPoint, 0.0f, 5000.0f);
+			CameraFeedbackSubsystem->AddWorldShake(EShipCameraShakeCategory::Collision, ImpactCameraShake.Get(), Hit.ImpactPoint, 0.0f, 5000.0f);
 		}
+#endif
 
 		// Begin Cooldown
 		bIsCollisionCooldown = true;
@@ -249,9 +373,32 @@ void AShipPawn::OnShipCollision(UPrimitiveComponent* HitComponent, AActor* Other
 
 void AShipPawn::OnPawnDied(AController* InstigatedBy, AActor* DamageCauser)
 {
-	if (ExplosionParticleEffect)
+	FShipTelemetry::Record(EShipTelemetryEventType::Kill, this, InstigatedBy && InstigatedBy->GetPawn() ? InstigatedBy->GetPawn() : DamageCauser, 0.0f, TeamId);
+
+	if (UShipGunnerySubsystem* GunnerySubsystem = GetWorld()->GetSubsystem<UShipGunnerySubsystem>())
+	{
+		GunnerySubsystem->NotifyShipKilled(InstigatedBy);
+	}
+
+	// Kills caused by the blast are credited to whoever destroyed this ship
+	UShipExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UShipExplosionSubsystem>();
+	if (ExplosionSubsystem && DeathExplosionDamage > 0.0f)
 	{
-		if (UNiagaraComponent* SpawnedExplosionEffect = UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, ExplosionParticleEffect, GetActorLocation(), GetActorRotation()))
+		FShipExplosion Explosion;
+		Explosion.Origin = GetActorLocation();
+		Explosion.BaseDamage = DeathExplosionDamage;
+		Explosion.InnerRadius = DeathExplosionInnerRadius;
+		Explosion.OuterRadius = DeathExplosionRadius;
+		Explosion.DamageCauser = DamageCauser;
+		Explosion.InstigatedBy = InstigatedBy;
+		Explosion.IgnoreActor = this;
+		ExplosionSubsystem->QueueExplosion(Explosion);
+	}
+
+	if (ExplosionParticleEffect.Get() && GalacticArmada::ShouldPlayCosmetics(this))
+	{
+		LLM_SCOPE_BYTAG(GalacticArmada_FX);
+		if (UNiagaraComponent* SpawnedExplosionEffect = UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, ExplosionParticleEffect.Get(), GetActorLocation(), GetActorRotation()))
 		{
 			SpawnedExplosionEffect->SetAutoDestroy(true);
 		}
@@ -264,36 +411,81 @@ void AShipPawn::OnDetectionOverlapBegin(UPrimitiveComponent* OverlappedComp, AAc
 {
 	if (OtherActor && OtherActor != this)
 	{
-		DetectedActors.AddUnique(OtherActor);
+		LLM_SCOPE_BYTAG(GalacticArmada_AI);
+		if (!DetectedActors.Contains(OtherActor))
+		{
+			DetectedActors.Add(OtherActor);
+			PublishDetectionEvent(OtherActor, true);
+		}
 	}
 }
 
 void AShipPawn::OnDetectionOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
-	if (IsValid(OtherActor) && OtherActor != this)
+	if (IsValid(OtherActor) && OtherActor != this && DetectedActors.RemoveSingle(OtherActor) > 0)
 	{
-		DetectedActors.RemoveSingle(OtherActor);
+		PublishDetectionEvent(OtherActor, false);
 	}
 }
 
-FVector AShipPawn::GetClosestCollisionLocation() const
+void AShipPawn::PublishDetectionEvent(AActor* Actor, bool bDetected)
+{
+	if (UShipEventSubsystem* EventSubsystem = UShipEventSubsystem::Get(this))
+	{
+		EventSubsystem->GetDetectionChannel().Publish({ this, Actor, bDetected });
+	}
+}
+
+FVector AShipPawn::GetClosestCollisionLocation(bool bShipsOnly, int32 MaxTraces, int32* OutNumTraces) const
 {
 	FVector ClosestCollisionLocation = FVector::ZeroVector;
 	float MinDistance = FLT_MAX;
 
-	FCollisionQueryParams CollisionParams;
-	CollisionParams.AddIgnoredActor(this);
-
+	// Scratch list from the frame arena, traced and dropped within this call
+	TFrameArray<AActor*> TraceActors;
+	TraceActors.Reserve(DetectedActors.Num());
 	for (AActor* Actor : DetectedActors)
 	{
 		if (!IsValid(Actor))
 		{
-			UE_LOG(LogShipPawn, Warning, TEXT("ShipPawn: DetectedActors contains an invalid actor."));
+			// Deferred detection only drops actors destroyed since the last batched pass on the next one
+			if (!bDeferredDetection)
+			{
+				UE_LOG(LogShipPawn, Warning, TEXT("ShipPawn: DetectedActors contains an invalid actor."));
+			}
 			continue;
 		}
 
+		if (bShipsOnly && !Actor->IsA<AShipPawn>()) continue;
+		if (AvoidanceIgnoredActors.Contains(Actor)) continue;
+
+		TraceActors.Add(Actor);
+	}
+
+	// Over the trace budget only the closest detected actors are traced
+	if (MaxTraces >= 0 && TraceActors.Num() > MaxTraces)
+	{
+		const FVector ShipLocation = GetActorLocation();
+		TraceActors.Sort([&ShipLocation](const AActor& A, const AActor& B)
+		{
+			return FVector::DistSquared(A.GetActorLocation(), ShipLocation) < FVector::DistSquared(B.GetActorLocation(), ShipLocation);
+		});
+		INC_DWORD_STAT_BY(STAT_AvoidanceTracesSkipped, TraceActors.Num() - MaxTraces);
+		TraceActors.SetNum(MaxTraces, false);
+	}
+
+	if (OutNumTraces)
+	{
+		*OutNumTraces = TraceActors.Num();
+	}
+
+	for (AActor* Actor : TraceActors)
+	{
+		INC_DWORD_STAT(STAT_AvoidanceTraces);
+		CSV_CUSTOM_STAT(GalacticArmada, AvoidanceTraces, 1, ECsvCustomStatOp::Accumulate);
+
 		FHitResult HitResult;
-		if (GetWorld()->LineTraceSingleByChannel(HitResult, GetActorLocation(), Actor->GetActorLocation(), ECC_Visibility, CollisionParams))
+		if (GetWorld()->LineTraceSingleByChannel(HitResult, GetActorLocation(), Actor->GetActorLocation(), ECC_Visibility, AvoidanceQueryParams))
 		{
 			const float Distance = FVector::Dist(HitResult.ImpactPoint, GetActorLocation());
 			if (Distance < MinDistance)
@@ -306,3 +498,183 @@ FVector AShipPawn::GetClosestCollisionLocation() const
 
 	return ClosestCollisionLocation;
 }
+
+
+FShipSteeringParams AShipPawn::GetSteeringParams() const
+{
+	FShipSteeringParams SteeringParams;
+	SteeringParams.StoppingDistance = StoppingDistance;
+	SteeringParams.ObstacleAvoidanceDistance = ObstacleAvoidanceDistance;
+	SteeringParams.MinAvoidanceStrength = MinAvoidanceStrength;
+	SteeringParams.MaxAvoidanceStrength = MaxAvoidanceStrength;
+	return SteeringParams;
+}
+
+void AShipPawn::SetRepresentation(EShipRepresentation NewRepresentation)
+{
+	if (Representation == NewRepresentation) return;
+	Representation = NewRepresentation;
+
+	const bool bIsProxy = Representation == EShipRepresentation::Proxy;
+
+	if (bIsProxy)
+	{
+		// Drop the physics body, pose evaluation and rendering of the skeletal ship
+		ShipMesh->SetSimulatePhysics(false);
+		ShipMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		ShipMesh->SetComponentTickEnabled(false);
+		ShipMesh->SetVisibility(false);
+
+		// Proxies are far from the player, they don't need to avoid anything
+		UpdateDetectionCollision();
+
+		ProxyCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	}
+	else
+	{
+		ProxyCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		UpdateDetectionCollision();
+
+		// Restore the skeletal ship and carry over its speed
+		ShipMesh->SetVisibility(true);
+		ShipMesh->SetComponentTickEnabled(true);
+		ShipMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+		ShipMesh->SetSimulatePhysics(true);
+		ShipMesh->SetPhysicsLinearVelocity(GetActorForwardVector() * ShipMovementComponent->GetCurrentSpeed());
+	}
+
+	for (UNiagaraComponent* ThrusterParticleEffect : ThrusterParticleEffects)
+	{
+		if (ThrusterParticleEffect)
+		{
+			ThrusterParticleEffect->SetVisibility(!bIsProxy);
+			ThrusterParticleEffect->SetPaused(bIsProxy);
+		}
+	}
+
+	ShipMovementComponent->SetKinematicFlight(bIsProxy);
+	CannonComponent->SetUseCachedSocketTransforms(bIsProxy);
+}
+
+void AShipPawn::GatherAssetBundles(FShipAssetBundles& OutBundles) const
+{
+	for (const FThrusterEffect& ThrusterEffect : ThrusterEffects)
+	{
+		OutBundles.AddCosmetic(ThrusterEffect.ThrusterParticleEffect);
+	}
+	OutBundles.AddCosmetic(ExplosionParticleEffect);
+	OutBundles.AddCosmetic(CollisionImpactParticleEffect);
+	OutBundles.AddCosmetic(ImpactCameraShake);
+
+	if (CannonComponent)
+	{
+		CannonComponent->GatherAssetBundles(OutBundles);
+	}
+}
+
+void AShipPawn::SetDetectionEnabled(bool bEnabled)
+{
+	if (bDetectionEnabled == bEnabled) return;
+	bDetectionEnabled = bEnabled;
+	UpdateDetectionCollision();
+}
+
+void AShipPawn::SetAvoidanceIgnoredActors(TConstArrayView<AActor*> Actors)
+{
+	AvoidanceQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ShipAvoidance), false, this);
+	AvoidanceIgnoredActors.Reset(Actors.Num());
+	for (AActor* Actor : Actors)
+	{
+		AvoidanceQueryParams.AddIgnoredActor(Actor);
+		AvoidanceIgnoredActors.Add(Actor);
+	}
+}
+
+void AShipPawn::SetDetectedActors(TConstArrayView<AActor*> Actors)
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_AI);
+
+	// Only diffed when someone listens to detection events
+	UShipEventSubsystem* EventSubsystem = UShipEventSubsystem::Get(this);
+	if (EventSubsystem && EventSubsystem->GetDetectionChannel().HasSubscribers())
+	{
+		for (AActor* Actor : Actors)
+		{
+			if (!DetectedActors.Contains(Actor))
+			{
+				EventSubsystem->GetDetectionChannel().Publish({ this, Actor, true });
+			}
+		}
+		for (AActor* Actor : DetectedActors)
+		{
+			if (!Actors.Contains(Actor))
+			{
+				EventSubsystem->GetDetectionChannel().Publish({ this, Actor, false });
+			}
+		}
+	}
+
+	DetectedActors.Reset();
+	DetectedActors.Append(Actors.GetData(), Actors.Num());
+}
+
+void AShipPawn::UpdateDetectionCollision()
+{
+	const bool bDetect = IsDetecting();
+	DetectionSphereCollision->SetCollisionEnabled(bDetect && !bDeferredDetection ? DetectionCollisionEnabled.GetValue() : ECollisionEnabled::NoCollision);
+
+	if (!bDetect)
+	{
+		SetDetectedActors(TConstArrayView<AActor*>());
+	}
+}
+
+void AShipPawn::SetDormant(bool bDormant)
+{
+	if (bIsDormant == bDormant) return;
+	bIsDormant = bDormant;
+
+	SetActorHiddenInGame(bDormant);
+	SetActorEnableCollision(!bDormant);
+	SetActorTickEnabled(!bDormant);
+	ShipMesh->SetSimulatePhysics(!bDormant && Representation == EShipRepresentation::Full);
+	ShipMovementComponent->SetComponentTickEnabled(!bDormant);
+	CannonComponent->SetComponentTickEnabled(!bDormant);
+
+	// A pooled ship neither thinks nor fires until it wakes up
+	if (bDormant)
+	{
+		CannonComponent->EndAllCannonFire();
+	}
+	AController* ShipController = GetController();
+	if (ShipController && !IsPlayerControlled())
+	{
+		ShipController->SetActorTickEnabled(!bDormant);
+	}
+
+	for (UNiagaraComponent* ThrusterParticleEffect : ThrusterParticleEffects)
+	{
+		if (ThrusterParticleEffect)
+		{
+			ThrusterParticleEffect->SetPaused(bDormant);
+		}
+	}
+
+	if (UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>())
+	{
+		if (bDormant)
+		{
+			ShipRegistry->UnregisterShip(this);
+		}
+		else
+		{
+			ShipRegistry->RegisterShip(this);
+		}
+	}
+
+	// Pooled ships are moved while asleep, their last sampled location is from before the jump
+	if (UShipGunnerySubsystem* GunnerySubsystem = GetWorld()->GetSubsystem<UShipGunnerySubsystem>())
+	{
+		GunnerySubsystem->ResetShipMotion(this);
+	}
+}
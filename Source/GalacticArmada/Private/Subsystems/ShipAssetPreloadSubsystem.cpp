@@ -0,0 +1,242 @@
+#include "Subsystems/ShipAssetPreloadSubsystem.h"
+#include "GalacticArmada.h"
+#include "Actors/ProjectileBase.h"
+#include "Components/CannonComponent.h"
+#include "Data/ShipAssetBundles.h"
+#include "Data/ShipLoadoutDataAsset.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipAssetPreload, Log, All)
+
+static FAutoConsoleCommandWithWorld AssetsReportCommand(
+	TEXT("ga.Assets.Report"),
+	TEXT("Logs streamed ship class assets and every map load time since startup."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipAssetPreloadSubsystem* AssetPreloader = UShipAssetPreloadSubsystem::Get(World))
+		{
+			AssetPreloader->LogReport();
+		}
+	}));
+
+UShipAssetPreloadSubsystem* UShipAssetPreloadSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UShipAssetPreloadSubsystem>() : nullptr;
+}
+
+void UShipAssetPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UShipAssetPreloadSubsystem::OnPreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UShipAssetPreloadSubsystem::OnPostLoadMap);
+}
+
+void UShipAssetPreloadSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	for (TPair<TWeakObjectPtr<UClass>, FShipClassAssets>& ShipClassPair : ShipClassAssets)
+	{
+		for (const TSharedPtr<FStreamableHandle>& Handle : ShipClassPair.Value.Handles)
+		{
+			if (Handle.IsValid())
+			{
+				Handle->CancelHandle();
+			}
+		}
+	}
+	ShipClassAssets.Reset();
+
+	Super::Deinitialize();
+}
+
+void UShipAssetPreloadSubsystem::LoadShipClassAssets(TSubclassOf<AShipPawn> ShipClass, TFunction<void()> OnLoaded)
+{
+	if (!ShipClass)
+	{
+		if (OnLoaded) OnLoaded();
+		return;
+	}
+
+	FShipClassAssets& Assets = ShipClassAssets.FindOrAdd(ShipClass.Get());
+	if (Assets.bLoaded)
+	{
+		if (OnLoaded) OnLoaded();
+		return;
+	}
+
+	if (OnLoaded)
+	{
+		Assets.PendingCallbacks.Add(MoveTemp(OnLoaded));
+	}
+
+	// Already streaming for an earlier ship of the same class
+	if (Assets.RequestTime > 0.0) return;
+	Assets.RequestTime = FPlatformTime::Seconds();
+
+	FShipAssetBundles Bundles;
+	ShipClass->GetDefaultObject<AShipPawn>()->GatherAssetBundles(Bundles);
+
+	if (!RequestAssets(ShipClass.Get(), GetRequestedPaths(Bundles), 0))
+	{
+		OnAssetsLoaded(ShipClass.Get(), 0);
+	}
+}
+
+void UShipAssetPreloadSubsystem::PreloadShipClasses(TConstArrayView<TSubclassOf<AShipPawn>> ShipClasses, TFunction<void()> OnLoaded)
+{
+	if (ShipClasses.Num() == 0)
+	{
+		if (OnLoaded) OnLoaded();
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TSharedRef<int32> NumRemaining = MakeShared<int32>(ShipClasses.Num());
+	for (const TSubclassOf<AShipPawn>& ShipClass : ShipClasses)
+	{
+		LoadShipClassAssets(ShipClass, [NumRemaining, OnLoaded, StartTime, NumClasses = ShipClasses.Num()]()
+		{
+			if (--(*NumRemaining) > 0) return;
+
+			UE_LOG(LogShipAssetPreload, Log, TEXT("ShipAssetPreload: Preloaded %d ship classes in %.1fms"), NumClasses, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+			if (OnLoaded) OnLoaded();
+		});
+	}
+}
+
+bool UShipAssetPreloadSubsystem::AreShipClassAssetsLoaded(const UClass* ShipClass) const
+{
+	const FShipClassAssets* Assets = ShipClassAssets.Find(ShipClass);
+	return Assets && Assets->bLoaded;
+}
+
+TArray<FSoftObjectPath> UShipAssetPreloadSubsystem::GetRequestedPaths(const FShipAssetBundles& Bundles) const
+{
+	TArray<FSoftObjectPath> AssetPaths = Bundles.Gameplay;
+
+	// Headless servers and battle simulations never touch effects, so they never pay to load them
+	if (GalacticArmada::ShouldPlayCosmetics(this))
+	{
+		AssetPaths.Append(Bundles.Cosmetic);
+	}
+	return AssetPaths;
+}
+
+bool UShipAssetPreloadSubsystem::RequestAssets(TWeakObjectPtr<UClass> ShipClass, const TArray<FSoftObjectPath>& AssetPaths, int32 Stage)
+{
+	if (AssetPaths.Num() == 0) return false;
+
+	if (FShipClassAssets* Assets = ShipClassAssets.Find(ShipClass))
+	{
+		Assets->NumAssets += AssetPaths.Num();
+	}
+
+	// The delegate may run before this returns when everything is already resident
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		AssetPaths,
+		FStreamableDelegate::CreateUObject(this, &UShipAssetPreloadSubsystem::OnAssetsLoaded, ShipClass, Stage),
+		FStreamableManager::AsyncLoadHighPriority);
+	if (!Handle.IsValid()) return false;
+
+	if (FShipClassAssets* Assets = ShipClassAssets.Find(ShipClass))
+	{
+		Assets->Handles.Add(Handle);
+	}
+	return true;
+}
+
+void UShipAssetPreloadSubsystem::OnAssetsLoaded(TWeakObjectPtr<UClass> ShipClass, int32 Stage)
+{
+	UClass* LoadedShipClass = ShipClass.Get();
+	if (!LoadedShipClass) return;
+
+	// Projectile classes are only known once loaded, their own effects stream in as a second stage
+	if (Stage == 0)
+	{
+		FShipAssetBundles ShipBundles;
+		LoadedShipClass->GetDefaultObject<AShipPawn>()->GatherAssetBundles(ShipBundles);
+
+		FShipAssetBundles ProjectileBundles;
+		for (const FSoftObjectPath& AssetPath : ShipBundles.Gameplay)
+		{
+			const UClass* ProjectileClass = Cast<UClass>(AssetPath.ResolveObject());
+			if (ProjectileClass && ProjectileClass->IsChildOf(AProjectileBase::StaticClass()))
+			{
+				ProjectileClass->GetDefaultObject<AProjectileBase>()->GatherAssetBundles(ProjectileBundles);
+			}
+		}
+
+		if (RequestAssets(ShipClass, GetRequestedPaths(ProjectileBundles), 1)) return;
+	}
+
+	CompleteShipClass(ShipClass);
+}
+
+void UShipAssetPreloadSubsystem::CompleteShipClass(TWeakObjectPtr<UClass> ShipClass)
+{
+	FShipClassAssets* Assets = ShipClassAssets.Find(ShipClass);
+	if (!Assets || Assets->bLoaded) return;
+
+	Assets->bLoaded = true;
+	Assets->LoadSeconds = FPlatformTime::Seconds() - Assets->RequestTime;
+
+	// Projectile speed and damage resolve into the shared loadout now that the classes are resident
+	UCannonComponent* CannonComponent = ShipClass.IsValid() ? ShipClass->GetDefaultObject<AShipPawn>()->GetCannonComponent() : nullptr;
+	if (UShipLoadoutDataAsset* Loadout = CannonComponent ? CannonComponent->GetLoadout() : nullptr)
+	{
+		Loadout->ResolveProjectiles(false);
+	}
+	UE_LOG(LogShipAssetPreload, Verbose, TEXT("ShipAssetPreload: %s streamed %d assets in %.1fms"), *GetNameSafe(ShipClass.Get()), Assets->NumAssets, Assets->LoadSeconds * 1000.0);
+
+	// Callbacks may spawn ships of other classes and grow the map, so run them from a local copy
+	TArray<TFunction<void()>> Callbacks = MoveTemp(Assets->PendingCallbacks);
+	for (TFunction<void()>& Callback : Callbacks)
+	{
+		Callback();
+	}
+}
+
+void UShipAssetPreloadSubsystem::OnPreLoadMap(const FString& MapName)
+{
+	LoadingMapName = MapName;
+	MapLoadStartTime = FPlatformTime::Seconds();
+}
+
+void UShipAssetPreloadSubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	if (MapLoadStartTime <= 0.0) return;
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	const FString MapName = LoadingMapName.IsEmpty() && LoadedWorld ? LoadedWorld->GetMapName() : LoadingMapName;
+	const FString Report = FString::Printf(TEXT("%s loaded in %.2fs, %.2fs after process start"), *MapName, CurrentTime - MapLoadStartTime, CurrentTime - GStartTime);
+
+	UE_LOG(LogShipAssetPreload, Log, TEXT("ShipAssetPreload: %s"), *Report);
+	MapLoadReports.Add(Report);
+	MapLoadStartTime = 0.0;
+}
+
+void UShipAssetPreloadSubsystem::LogReport() const
+{
+	UE_LOG(LogShipAssetPreload, Log, TEXT("ShipAssetPreload: %d ship classes, cosmetics %s"), ShipClassAssets.Num(), GalacticArmada::ShouldPlayCosmetics(this) ? TEXT("streamed") : TEXT("skipped"));
+	for (const TPair<TWeakObjectPtr<UClass>, FShipClassAssets>& ShipClassPair : ShipClassAssets)
+	{
+		const FShipClassAssets& Assets = ShipClassPair.Value;
+		UE_LOG(LogShipAssetPreload, Log, TEXT("ShipAssetPreload:   %s: %d assets, %s"), *GetNameSafe(ShipClassPair.Key.Get()), Assets.NumAssets,
+			Assets.bLoaded ? *FString::Printf(TEXT("loaded in %.1fms"), Assets.LoadSeconds * 1000.0) : TEXT("loading"));
+	}
+	for (const FString& Report : MapLoadReports)
+	{
+		UE_LOG(LogShipAssetPreload, Log, TEXT("ShipAssetPreload:   %s"), *Report);
+	}
+}
@@ -0,0 +1,168 @@
+#include "Subsystems/ShipAvoidanceFieldSubsystem.h"
+#include "GalacticArmada.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Navigation/SignedDistanceField.h"
+#include "Navigation/StaticObstacleGatherer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipAvoidanceField, Log, All)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Avoidance Field Samples"), STAT_AvoidanceFieldSamples, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarAvoidanceFieldEnable(
+	TEXT("ga.AvoidanceField.Enable"),
+	true,
+	TEXT("Avoid static geometry through the baked distance field instead of traces."));
+
+static TAutoConsoleVariable<float> CVarAvoidanceFieldVoxelSize(
+	TEXT("ga.AvoidanceField.VoxelSize"),
+	2000.0f,
+	TEXT("Voxel edge of the baked avoidance field."));
+
+static TAutoConsoleVariable<float> CVarAvoidanceFieldBand(
+	TEXT("ga.AvoidanceField.Band"),
+	30000.0f,
+	TEXT("Distance from static geometry covered by the field, should match the ships' obstacle avoidance distance."));
+
+static FAutoConsoleCommandWithWorld AvoidanceFieldReportCommand(
+	TEXT("ga.AvoidanceField.Report"),
+	TEXT("Logs avoidance field size, load time and samples."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipAvoidanceFieldSubsystem* AvoidanceFieldSubsystem = World ? World->GetSubsystem<UShipAvoidanceFieldSubsystem>() : nullptr)
+		{
+			AvoidanceFieldSubsystem->LogReport();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld AvoidanceFieldBakeCommand(
+	TEXT("ga.AvoidanceField.Bake"),
+	TEXT("Bakes the avoidance field from the level again."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UShipAvoidanceFieldSubsystem* AvoidanceFieldSubsystem = World ? World->GetSubsystem<UShipAvoidanceFieldSubsystem>() : nullptr)
+		{
+			AvoidanceFieldSubsystem->BakeField(true);
+		}
+	}));
+
+bool UShipAvoidanceFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShipAvoidanceFieldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	BakeField();
+}
+
+void UShipAvoidanceFieldSubsystem::Deinitialize()
+{
+	Field.Reset();
+	Super::Deinitialize();
+}
+
+bool UShipAvoidanceFieldSubsystem::IsReady() const
+{
+	return Field.IsValid() && Field->IsValid() && CVarAvoidanceFieldEnable.GetValueOnGameThread();
+}
+
+FString UShipAvoidanceFieldSubsystem::GetFieldFilePath() const
+{
+	const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Navigation"), MapName + TEXT(".shipsdf"));
+}
+
+void UShipAvoidanceFieldSubsystem::BakeField(bool bForceBake)
+{
+	if (bBakeInProgress || !CVarAvoidanceFieldEnable.GetValueOnGameThread()) return;
+
+	TSharedRef<FStaticObstacleSet> Obstacles = MakeShared<FStaticObstacleSet>();
+	StaticObstacles::Gather(GetWorld(), *Obstacles);
+	if (Obstacles->Boxes.Num() == 0) return;
+
+	const float VoxelSize = CVarAvoidanceFieldVoxelSize.GetValueOnGameThread();
+	const float Band = CVarAvoidanceFieldBand.GetValueOnGameThread();
+
+	// A matching baked file maps in without touching the geometry again
+	if (!bForceBake)
+	{
+		LoadField(Obstacles->Hash, VoxelSize, Band);
+		if (IsReady()) return;
+	}
+
+	bBakeInProgress = true;
+	const FString FilePath = GetFieldFilePath();
+	TWeakObjectPtr<UShipAvoidanceFieldSubsystem> WeakThis(this);
+	Field.Reset();
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Obstacles, VoxelSize, Band, FilePath]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		const bool bBaked = FSignedDistanceField::Bake(Obstacles->Boxes, Obstacles->Hash, VoxelSize, Band, FilePath);
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bBaked, Seconds, ObstacleHash = Obstacles->Hash, VoxelSize, Band]()
+		{
+			UShipAvoidanceFieldSubsystem* AvoidanceFieldSubsystem = WeakThis.Get();
+			if (!AvoidanceFieldSubsystem) return;
+
+			AvoidanceFieldSubsystem->bBakeInProgress = false;
+			AvoidanceFieldSubsystem->BakeSeconds = Seconds;
+			if (!bBaked)
+			{
+				UE_LOG(LogShipAvoidanceField, Warning, TEXT("ShipAvoidanceField: Bake failed, static obstacles fall back to traces."));
+				return;
+			}
+			AvoidanceFieldSubsystem->LoadField(ObstacleHash, VoxelSize, Band);
+			AvoidanceFieldSubsystem->LogReport();
+		});
+	});
+}
+
+void UShipAvoidanceFieldSubsystem::LoadField(uint32 ObstacleHash, float VoxelSize, float Band)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	Field = MakeShared<FSignedDistanceField>();
+	if (!Field->Load(GetFieldFilePath(), ObstacleHash, VoxelSize, Band))
+	{
+		Field.Reset();
+	}
+
+	LoadSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+bool UShipAvoidanceFieldSubsystem::FindClosestSurface(const FVector& Location, FVector& OutSurfaceLocation) const
+{
+	if (!IsReady()) return false;
+
+	INC_DWORD_STAT(STAT_AvoidanceFieldSamples);
+	++NumSamples;
+
+	float Distance;
+	FVector Gradient;
+	if (!Field->Sample(Location, Distance, Gradient) || Gradient.IsNearlyZero()) return false;
+
+	// Step down the gradient to the zero crossing
+	OutSurfaceLocation = Location - Gradient.GetSafeNormal() * Distance;
+	return true;
+}
+
+void UShipAvoidanceFieldSubsystem::LogReport() const
+{
+	const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	if (!IsReady())
+	{
+		UE_LOG(LogShipAvoidanceField, Log, TEXT("ShipAvoidanceField: %s has no field%s"), *MapName, bBakeInProgress ? TEXT(", bake in progress") : TEXT(""));
+		return;
+	}
+
+	UE_LOG(LogShipAvoidanceField, Log, TEXT("ShipAvoidanceField: %s %d bricks, %.2f MB %s, loaded in %.2fms, baked in %.1fms"),
+		*MapName, Field->GetNumBricks(), Field->GetDataSize() / (1024.0 * 1024.0), Field->IsMemoryMapped() ? TEXT("mapped") : TEXT("in memory"),
+		LoadSeconds * 1000.0, BakeSeconds * 1000.0);
+	UE_LOG(LogShipAvoidanceField, Log, TEXT("ShipAvoidanceField: %d samples"), NumSamples);
+}
@@ -0,0 +1,200 @@
+#include "Subsystems/ShipCameraFeedbackSubsystem.h"
+#include "GalacticArmada.h"
+#include "Camera/CameraShakeBase.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipCameraFeedback, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Camera Feedback"), STAT_CameraFeedback, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Shake Requests"), STAT_CameraShakeRequests, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarCameraShakeEnabled(
+	TEXT("ga.CameraShake.Enabled"),
+	true,
+	TEXT("Plays camera shakes for firing, projectile impacts and collisions."));
+
+static TAutoConsoleVariable<float> CVarCameraShakeMinScale(
+	TEXT("ga.CameraShake.MinScale"),
+	0.05f,
+	TEXT("Frame intensity below which a category does not shake the camera at all."));
+
+static TAutoConsoleVariable<float> CVarCameraShakeMaxScale(
+	TEXT("ga.CameraShake.MaxScale"),
+	1.5f,
+	TEXT("Upper bound of the summed intensity of one category in a frame."));
+
+static FAutoConsoleCommandWithWorld CameraShakeReportCommand(
+	TEXT("ga.CameraShake.Report"),
+	TEXT("Logs camera shake requests against the shakes actually started."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipCameraFeedbackSubsystem* CameraFeedbackSubsystem = World ? World->GetSubsystem<UShipCameraFeedbackSubsystem>() : nullptr)
+		{
+			CameraFeedbackSubsystem->LogReport();
+		}
+	}));
+
+bool UShipCameraFeedbackSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && GalacticArmada::ShouldPlayCosmetics(Outer);
+}
+
+bool UShipCameraFeedbackSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipCameraFeedbackSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipCameraFeedbackSubsystem, STATGROUP_Tickables);
+}
+
+void UShipCameraFeedbackSubsystem::Deinitialize()
+{
+	PendingRequests.Reset();
+	LocalPlayers.Reset();
+
+	Super::Deinitialize();
+}
+
+void UShipCameraFeedbackSubsystem::AddWorldShake(EShipCameraShakeCategory Category, TSubclassOf<UCameraShakeBase> ShakeClass, const FVector& Epicenter, float InnerRadius, float OuterRadius, float Scale)
+{
+	if (!ShakeClass || OuterRadius <= 0.0f || !CVarCameraShakeEnabled.GetValueOnGameThread()) return;
+
+	FShipCameraShakeRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.ShakeClass = ShakeClass;
+	Request.Epicenter = Epicenter;
+	Request.InnerRadius = InnerRadius;
+	Request.OuterRadius = OuterRadius;
+	Request.Scale = Scale;
+	Request.Category = Category;
+}
+
+void UShipCameraFeedbackSubsystem::AddPlayerShake(EShipCameraShakeCategory Category, TSubclassOf<UCameraShakeBase> ShakeClass, APlayerController* PlayerController, float Scale)
+{
+	if (!ShakeClass || !PlayerController || !CVarCameraShakeEnabled.GetValueOnGameThread()) return;
+
+	if (!PlayerController->IsLocalController())
+	{
+		PlayerController->ClientStartCameraShake(ShakeClass, Scale);
+		return;
+	}
+
+	FShipCameraShakeRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.ShakeClass = ShakeClass;
+	Request.Scale = Scale;
+	Request.PlayerController = PlayerController;
+	Request.Category = Category;
+}
+
+void UShipCameraFeedbackSubsystem::Tick(float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_CameraShakeRequests, PendingRequests.Num());
+	if (PendingRequests.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_CameraFeedback);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, CameraFeedback);
+
+	UpdateLocalPlayers();
+
+	constexpr int32 NumCategories = static_cast<int32>(EShipCameraShakeCategory::Num);
+	const float MaxScale = CVarCameraShakeMaxScale.GetValueOnGameThread();
+
+	for (FLocalPlayerShakes& LocalPlayer : LocalPlayers)
+	{
+		APlayerController* PlayerController = LocalPlayer.PlayerController.Get();
+		const FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+
+		// Sum every request of the frame per category, the strongest one picks the shake played
+		float Scales[NumCategories] = {};
+		float StrongestScales[NumCategories] = {};
+		UClass* ShakeClasses[NumCategories] = {};
+
+		for (const FShipCameraShakeRequest& Request : PendingRequests)
+		{
+			float Scale = Request.Scale;
+			if (!Request.PlayerController.IsExplicitlyNull())
+			{
+				if (Request.PlayerController.Get() != PlayerController) continue;
+			}
+			else
+			{
+				const float Distance = FVector::Dist(CameraLocation, Request.Epicenter);
+				if (Distance >= Request.OuterRadius) continue;
+				if (Distance > Request.InnerRadius)
+				{
+					Scale *= 1.0f - (Distance - Request.InnerRadius) / (Request.OuterRadius - Request.InnerRadius);
+				}
+			}
+
+			const int32 Category = static_cast<int32>(Request.Category);
+			Scales[Category] += Scale;
+			if (Scale > StrongestScales[Category])
+			{
+				StrongestScales[Category] = Scale;
+				ShakeClasses[Category] = Request.ShakeClass;
+			}
+		}
+
+		for (int32 Category = 0; Category < NumCategories; ++Category)
+		{
+			if (ShakeClasses[Category])
+			{
+				ApplyShake(PlayerController, LocalPlayer.Shakes[Category], ShakeClasses[Category], FMath::Min(Scales[Category], MaxScale));
+			}
+		}
+	}
+
+	NumRequests += PendingRequests.Num();
+	PendingRequests.Reset();
+}
+
+void UShipCameraFeedbackSubsystem::UpdateLocalPlayers()
+{
+	LocalPlayers.RemoveAllSwap([](const FLocalPlayerShakes& LocalPlayer)
+	{
+		const APlayerController* PlayerController = LocalPlayer.PlayerController.Get();
+		return !PlayerController || !PlayerController->PlayerCameraManager;
+	}, false);
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		APlayerController* PlayerController = Iterator->Get();
+		if (!PlayerController || !PlayerController->IsLocalController() || !PlayerController->PlayerCameraManager) continue;
+
+		if (!LocalPlayers.ContainsByPredicate([PlayerController](const FLocalPlayerShakes& LocalPlayer) { return LocalPlayer.PlayerController == PlayerController; }))
+		{
+			LocalPlayers.AddDefaulted_GetRef().PlayerController = PlayerController;
+		}
+	}
+}
+
+void UShipCameraFeedbackSubsystem::ApplyShake(APlayerController* PlayerController, TWeakObjectPtr<UCameraShakeBase>& Shake, UClass* ShakeClass, float Scale)
+{
+	if (Scale < CVarCameraShakeMinScale.GetValueOnGameThread())
+	{
+		++NumShakesSkipped;
+		return;
+	}
+
+	// A running shake of the category is made stronger rather than joined by another instance
+	UCameraShakeBase* ActiveShake = Shake.Get();
+	if (ActiveShake && !ActiveShake->IsFinished() && ActiveShake->GetClass() == ShakeClass)
+	{
+		ActiveShake->ShakeScale = FMath::Max(ActiveShake->ShakeScale, Scale);
+		++NumShakesRaised;
+		return;
+	}
+
+	Shake = PlayerController->PlayerCameraManager->StartCameraShake(ShakeClass, Scale);
+	++NumShakesStarted;
+}
+
+void UShipCameraFeedbackSubsystem::LogReport() const
+{
+	UE_LOG(LogShipCameraFeedback, Log, TEXT("ShipCameraFeedback: %lld shake requests became %lld shakes started, %lld raised and %lld too faint to play"),
+		NumRequests, NumShakesStarted, NumShakesRaised, NumShakesSkipped);
+}
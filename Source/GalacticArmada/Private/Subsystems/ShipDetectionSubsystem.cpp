@@ -0,0 +1,132 @@
+#include "Subsystems/ShipDetectionSubsystem.h"
+#include "GalacticArmada.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "Components/ShipMovementComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipDetection, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Detection"), STAT_ShipDetection, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Detection Overlap Updates"), STAT_DetectionOverlapUpdates, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<float> CVarDetectionInterval(
+	TEXT("ga.Detection.Interval"),
+	0.1f,
+	TEXT("Seconds between detection overlap queries of a ship, spread over the frames in between. Applies to ships that begin play afterwards, 0 or less updates their sphere's overlaps on every move instead."));
+
+static FAutoConsoleCommandWithWorld DetectionReportCommand(
+	TEXT("ga.Detection.Report"),
+	TEXT("Logs transform commits and detection overlap updates per ship per frame."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipDetectionSubsystem* DetectionSubsystem = World ? World->GetSubsystem<UShipDetectionSubsystem>() : nullptr)
+		{
+			DetectionSubsystem->LogReport();
+		}
+	}));
+
+bool UShipDetectionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipDetectionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipDetectionSubsystem, STATGROUP_Tickables);
+}
+
+bool UShipDetectionSubsystem::IsDeferredDetectionEnabled()
+{
+	return CVarDetectionInterval.GetValueOnGameThread() > 0.0f;
+}
+
+void UShipDetectionSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipDetection);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipDetection);
+
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (!ShipRegistry) return;
+
+	if (NumFrames++ == 0)
+	{
+		TransformCommitsAtStart = UShipMovementComponent::GetNumTransformCommits();
+	}
+
+	const TArray<AShipPawn*>& Ships = ShipRegistry->GetShips();
+	NumShipFrames += Ships.Num();
+	if (Ships.Num() == 0) return;
+
+	// Ships that still detect on the move re-evaluate their sphere's overlaps once per movement commit
+	for (const AShipPawn* ShipPawn : Ships)
+	{
+		if (IsValid(ShipPawn) && ShipPawn->IsDetecting() && !ShipPawn->IsDetectionDeferred())
+		{
+			++NumMovedSphereUpdates;
+		}
+	}
+
+	// Round robin over the registry so each ship comes up once per interval
+	const float Interval = CVarDetectionInterval.GetValueOnGameThread();
+	ShipsDue = Interval > 0.0f ? ShipsDue + Ships.Num() * DeltaTime / Interval : Ships.Num();
+	const int32 NumShipsToUpdate = FMath::Min(FMath::FloorToInt32(ShipsDue), Ships.Num());
+	ShipsDue = FMath::Min(ShipsDue - NumShipsToUpdate, (float)Ships.Num());
+
+	LLM_SCOPE_BYTAG(GalacticArmada_AI);
+	for (int32 i = 0; i < NumShipsToUpdate; ++i)
+	{
+		NextShipIndex = NextShipIndex % Ships.Num();
+		AShipPawn* ShipPawn = Ships[NextShipIndex++];
+		if (IsValid(ShipPawn) && ShipPawn->IsDetecting() && ShipPawn->IsDetectionDeferred())
+		{
+			UpdateDetection(ShipPawn);
+		}
+	}
+}
+
+void UShipDetectionSubsystem::UpdateDetection(AShipPawn* ShipPawn)
+{
+	INC_DWORD_STAT(STAT_DetectionOverlapUpdates);
+	CSV_CUSTOM_STAT(GalacticArmada, DetectionOverlapUpdates, 1, ECsvCustomStatOp::Accumulate);
+	++NumDeferredUpdates;
+
+	// Same shape, channel and responses the sphere would have overlapped with in the physics scene
+	const USphereComponent* DetectionSphere = ShipPawn->GetDetectionSphere();
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShipDetection), false, ShipPawn);
+	const FCollisionResponseParams ResponseParams(DetectionSphere->GetCollisionResponseToChannels());
+
+	Overlaps.Reset();
+	GetWorld()->OverlapMultiByChannel(Overlaps, DetectionSphere->GetComponentLocation(), FQuat::Identity, DetectionSphere->GetCollisionObjectType(), DetectionSphere->GetCollisionShape(), QueryParams, ResponseParams);
+
+	// Overlap events only fire for components that generate them, one entry per actor
+	OverlappingActors.Reset();
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		const UPrimitiveComponent* OtherComponent = Overlap.GetComponent();
+		AActor* OtherActor = Overlap.GetActor();
+		if (OtherActor && OtherComponent && OtherComponent->GetGenerateOverlapEvents())
+		{
+			OverlappingActors.Add(OtherActor);
+		}
+	}
+	Algo::Sort(OverlappingActors);
+	OverlappingActors.SetNum(Algo::Unique(OverlappingActors), false);
+
+	ShipPawn->SetDetectedActors(OverlappingActors);
+}
+
+void UShipDetectionSubsystem::LogReport() const
+{
+	const double ShipFrames = FMath::Max<double>(NumShipFrames, 1.0);
+	const uint64 TransformCommits = UShipMovementComponent::GetNumTransformCommits() - TransformCommitsAtStart;
+
+	UE_LOG(LogShipDetection, Log, TEXT("ShipDetection: %s detection, interval %.2fs, %lld frames, %lld ship frames"),
+		IsDeferredDetectionEnabled() ? TEXT("Deferred") : TEXT("Per move"), CVarDetectionInterval.GetValueOnGameThread(), NumFrames, NumShipFrames);
+	UE_LOG(LogShipDetection, Log, TEXT("ShipDetection: Per ship per frame %.3f transform commits, %.3f batched overlap updates, %.3f overlap updates on the move"),
+		TransformCommits / ShipFrames, NumDeferredUpdates / ShipFrames, NumMovedSphereUpdates / ShipFrames);
+}
@@ -0,0 +1,149 @@
+#include "Subsystems/ShipEventSubsystem.h"
+#include "GalacticArmada.h"
+#include "Components/CannonComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipEvents, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Event Dispatch"), STAT_ShipEventDispatch, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ship Events Dispatched"), STAT_ShipEventsDispatched, STATGROUP_GalacticArmada);
+
+static FAutoConsoleCommandWithWorld EventsReportCommand(
+	TEXT("ga.Events.Report"),
+	TEXT("Logs subscribers, events and batches of every gameplay event channel."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipEventSubsystem* EventSubsystem = World ? World->GetSubsystem<UShipEventSubsystem>() : nullptr)
+		{
+			EventSubsystem->LogReport();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs EventsBenchmarkCommand(
+	TEXT("ga.Events.Benchmark"),
+	TEXT("Compares dynamic multicast delegate broadcasts with batched native channel dispatch: ga.Events.Benchmark [Events] [Subscribers] [BatchSize]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UShipEventSubsystem* EventSubsystem = World ? World->GetSubsystem<UShipEventSubsystem>() : nullptr)
+		{
+			const int32 NumEvents = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000;
+			const int32 NumSubscribers = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 4;
+			const int32 BatchSize = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 256;
+			EventSubsystem->RunBenchmark(FMath::Max(NumEvents, 1), FMath::Max(NumSubscribers, 1), FMath::Max(BatchSize, 1));
+		}
+	}));
+
+namespace ShipEvents
+{
+	// Handlers publishing into a channel already dispatched get this many more passes within the frame
+	static constexpr int32 MaxDispatchPasses = 4;
+}
+
+bool UShipEventSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipEventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipEventSubsystem, STATGROUP_Tickables);
+}
+
+UShipEventSubsystem* UShipEventSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UShipEventSubsystem>() : nullptr;
+}
+
+void UShipEventSubsystem::Tick(float DeltaTime)
+{
+	DispatchEvents();
+}
+
+void UShipEventSubsystem::DispatchEvents()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipEventDispatch);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipEventDispatch);
+
+	for (int32 Pass = 0; Pass < ShipEvents::MaxDispatchPasses; ++Pass)
+	{
+		int32 NumDispatched = FireChannel.Dispatch();
+		NumDispatched += DamageChannel.Dispatch();
+		NumDispatched += DeathChannel.Dispatch();
+		NumDispatched += DetectionChannel.Dispatch();
+		if (NumDispatched == 0) break;
+
+		INC_DWORD_STAT_BY(STAT_ShipEventsDispatched, NumDispatched);
+		CSV_CUSTOM_STAT(GalacticArmada, ShipEventsDispatched, NumDispatched, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void UShipEventSubsystem::LogReport() const
+{
+	auto LogChannel = [](const TCHAR* Name, int32 NumSubscribers, int64 NumEvents, int64 NumBatches)
+	{
+		UE_LOG(LogShipEvents, Log, TEXT("ShipEvents: %s channel, %d subscribers, %lld events in %lld batches (%.1f per batch)"),
+			Name, NumSubscribers, NumEvents, NumBatches, NumBatches > 0 ? (double)NumEvents / NumBatches : 0.0);
+	};
+
+	LogChannel(TEXT("Fire"), FireChannel.GetNumSubscribers(), FireChannel.GetTotalDispatched(), FireChannel.GetTotalBatches());
+	LogChannel(TEXT("Damage"), DamageChannel.GetNumSubscribers(), DamageChannel.GetTotalDispatched(), DamageChannel.GetTotalBatches());
+	LogChannel(TEXT("Death"), DeathChannel.GetNumSubscribers(), DeathChannel.GetTotalDispatched(), DeathChannel.GetTotalBatches());
+	LogChannel(TEXT("Detection"), DetectionChannel.GetNumSubscribers(), DetectionChannel.GetTotalDispatched(), DetectionChannel.GetTotalBatches());
+}
+
+void UShipEventSubsystem::RunBenchmark(int32 NumEvents, int32 NumSubscribers, int32 BatchSize)
+{
+	// Both paths deliver the same cannon index to the same listeners, only the dispatch differs
+	FCannonFireEvent DynamicDelegate;
+	TShipEventChannel<FShipFireEvent> Channel;
+	TArray<UShipEventBenchmarkListener*> DynamicListeners;
+	TArray<UShipEventBenchmarkListener*> NativeListeners;
+	for (int32 SubscriberIndex = 0; SubscriberIndex < NumSubscribers; ++SubscriberIndex)
+	{
+		UShipEventBenchmarkListener* DynamicListener = NewObject<UShipEventBenchmarkListener>(this);
+		DynamicDelegate.AddDynamic(DynamicListener, &UShipEventBenchmarkListener::HandleCannonFired);
+		DynamicListeners.Add(DynamicListener);
+
+		UShipEventBenchmarkListener* NativeListener = NewObject<UShipEventBenchmarkListener>(this);
+		Channel.Subscribe<&UShipEventBenchmarkListener::HandleFireEvents>(NativeListener);
+		NativeListeners.Add(NativeListener);
+	}
+
+	const double DynamicStartTime = FPlatformTime::Seconds();
+	for (int32 EventIndex = 0; EventIndex < NumEvents; ++EventIndex)
+	{
+		DynamicDelegate.Broadcast(EventIndex & 1);
+	}
+	const double DynamicSeconds = FPlatformTime::Seconds() - DynamicStartTime;
+
+	// Dispatching every BatchSize events stands in for the per frame dispatch
+	const double NativeStartTime = FPlatformTime::Seconds();
+	FShipFireEvent Event;
+	for (int32 EventIndex = 0; EventIndex < NumEvents; ++EventIndex)
+	{
+		Event.CannonIndex = EventIndex & 1;
+		Channel.Publish(Event);
+		if ((EventIndex + 1) % BatchSize == 0)
+		{
+			Channel.Dispatch();
+		}
+	}
+	Channel.Dispatch();
+	const double NativeSeconds = FPlatformTime::Seconds() - NativeStartTime;
+
+	int64 DynamicChecksum = 0;
+	int64 NativeChecksum = 0;
+	for (int32 SubscriberIndex = 0; SubscriberIndex < NumSubscribers; ++SubscriberIndex)
+	{
+		DynamicChecksum += DynamicListeners[SubscriberIndex]->Checksum;
+		NativeChecksum += NativeListeners[SubscriberIndex]->Checksum;
+		DynamicListeners[SubscriberIndex]->MarkAsGarbage();
+		NativeListeners[SubscriberIndex]->MarkAsGarbage();
+	}
+
+	UE_LOG(LogShipEvents, Log, TEXT("ShipEvents: Benchmark %d events to %d subscribers. Dynamic delegate %.1fns per event, native channel %.1fns per event in batches of %d, %.1fx faster%s"),
+		NumEvents, NumSubscribers, DynamicSeconds * 1.0e9 / NumEvents, NativeSeconds * 1.0e9 / NumEvents, BatchSize,
+		NativeSeconds > 0.0 ? DynamicSeconds / NativeSeconds : 0.0, DynamicChecksum == NativeChecksum ? TEXT("") : TEXT(" (checksum mismatch)"));
+}
@@ -0,0 +1,289 @@
+#include "Subsystems/ShipExplosionSubsystem.h"
+#include "GalacticArmada.h"
+#include "Async/ParallelFor.h"
+#include "Engine/DamageEvents.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipExplosion, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Explosions"), STAT_ShipExplosions, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosions"), STAT_Explosions, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Hits"), STAT_ExplosionHits, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<float> CVarExplosionCellSize(
+	TEXT("ga.Explosion.CellSize"),
+	5000.0f,
+	TEXT("Edge length of the grid damageable actors are hashed into for explosion queries."));
+
+static TAutoConsoleVariable<int32> CVarExplosionParallelThreshold(
+	TEXT("ga.Explosion.ParallelThreshold"),
+	32,
+	TEXT("Explosions in a frame from which their queries run on worker threads."));
+
+static FAutoConsoleCommandWithWorldAndArgs ExplosionBenchmarkCommand(
+	TEXT("ga.Explosion.Benchmark"),
+	TEXT("Resolves harmless explosions around damageable actors in one batch and logs the time: ga.Explosion.Benchmark [Count] [Radius] [CompareApplyRadialDamage]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UShipExplosionSubsystem* ExplosionSubsystem = World ? World->GetSubsystem<UShipExplosionSubsystem>() : nullptr;
+		if (!ExplosionSubsystem) return;
+
+		const int32 Count = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+		const float Radius = Args.IsValidIndex(1) ? FCString::Atof(*Args[1]) : 3000.0f;
+		const bool bCompare = Args.IsValidIndex(2) && FCString::ToBool(*Args[2]);
+
+		// Origins scattered around the ships so most explosions catch somebody
+		TArray<FVector> Origins;
+		Origins.Reserve(Count);
+		const TArray<AActor*> Actors = ExplosionSubsystem->GetDamageables();
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const AActor* Actor = Actors.Num() > 0 ? Actors[FMath::RandHelper(Actors.Num())] : nullptr;
+			Origins.Add((Actor ? Actor->GetActorLocation() : FVector::ZeroVector) + FMath::VRand() * FMath::FRand() * Radius);
+		}
+
+		for (const FVector& Origin : Origins)
+		{
+			FShipExplosion Explosion;
+			Explosion.Origin = Origin;
+			Explosion.OuterRadius = Radius;
+			ExplosionSubsystem->QueueExplosion(Explosion);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		const int32 NumHits = ExplosionSubsystem->ProcessExplosions();
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogShipExplosion, Log, TEXT("ShipExplosion: %d explosions against %d damageables hit %d actors in %.3fms"), Count, Actors.Num(), NumHits, Seconds * 1000.0);
+
+		if (bCompare)
+		{
+			const double CompareStartTime = FPlatformTime::Seconds();
+			for (const FVector& Origin : Origins)
+			{
+				UGameplayStatics::ApplyRadialDamage(World, 0.0f, Origin, Radius, UDamageType::StaticClass(), TArray<AActor*>());
+			}
+			UE_LOG(LogShipExplosion, Log, TEXT("ShipExplosion: The same explosions through ApplyRadialDamage took %.3fms"), (FPlatformTime::Seconds() - CompareStartTime) * 1000.0);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld ExplosionReportCommand(
+	TEXT("ga.Explosion.Report"),
+	TEXT("Logs explosion batches, hits and query and apply times."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipExplosionSubsystem* ExplosionSubsystem = World ? World->GetSubsystem<UShipExplosionSubsystem>() : nullptr)
+		{
+			ExplosionSubsystem->LogReport();
+		}
+	}));
+
+bool UShipExplosionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipExplosionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipExplosionSubsystem, STATGROUP_Tickables);
+}
+
+void UShipExplosionSubsystem::Deinitialize()
+{
+	Damageables.Reset();
+	DamageableRadii.Reset();
+	QueuedExplosions.Reset();
+	ProcessingExplosions.Reset();
+
+	Super::Deinitialize();
+}
+
+void UShipExplosionSubsystem::RegisterDamageable(AActor* Actor)
+{
+	if (!Actor || Damageables.Contains(Actor)) return;
+
+	Damageables.Add(Actor);
+	DamageableRadii.Add(Actor->GetSimpleCollisionRadius());
+}
+
+void UShipExplosionSubsystem::UnregisterDamageable(AActor* Actor)
+{
+	const int32 Index = Damageables.Find(Actor);
+	if (Index == INDEX_NONE) return;
+
+	Damageables.RemoveAtSwap(Index, 1, false);
+	DamageableRadii.RemoveAtSwap(Index, 1, false);
+}
+
+void UShipExplosionSubsystem::QueueExplosion(const FShipExplosion& Explosion)
+{
+	if (Explosion.OuterRadius <= 0.0f) return;
+
+	QueuedExplosions.Add(Explosion);
+}
+
+void UShipExplosionSubsystem::Tick(float DeltaTime)
+{
+	ProcessExplosions();
+}
+
+int32 UShipExplosionSubsystem::ProcessExplosions()
+{
+	if (QueuedExplosions.Num() == 0) return 0;
+
+	LLM_SCOPE_BYTAG(GalacticArmada_Health);
+	SCOPE_CYCLE_COUNTER(STAT_ShipExplosions);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipExplosions);
+
+	// Explosions set off while applying this batch, ships dying in a chain, go into the next one
+	Swap(ProcessingExplosions, QueuedExplosions);
+	QueuedExplosions.Reset();
+
+	const double StartTime = FPlatformTime::Seconds();
+	const float CellSize = FMath::Max(CVarExplosionCellSize.GetValueOnGameThread(), 100.0f);
+	BuildGrid(CellSize);
+
+	ExplosionHits.SetNum(ProcessingExplosions.Num(), false);
+	const bool bParallel = ProcessingExplosions.Num() >= CVarExplosionParallelThreshold.GetValueOnGameThread();
+	ParallelFor(ProcessingExplosions.Num(), [this, CellSize](int32 ExplosionIndex)
+	{
+		QueryExplosion(ProcessingExplosions[ExplosionIndex], CellSize, ExplosionHits[ExplosionIndex]);
+	}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	const double QueryEndTime = FPlatformTime::Seconds();
+	const int32 NumHits = ApplyHits();
+	const double EndTime = FPlatformTime::Seconds();
+
+	INC_DWORD_STAT_BY(STAT_Explosions, ProcessingExplosions.Num());
+	INC_DWORD_STAT_BY(STAT_ExplosionHits, NumHits);
+	CSV_CUSTOM_STAT(GalacticArmada, Explosions, ProcessingExplosions.Num(), ECsvCustomStatOp::Accumulate);
+
+	++NumBatches;
+	TotalExplosions += ProcessingExplosions.Num();
+	TotalHits += NumHits;
+	LargestBatch = FMath::Max(LargestBatch, ProcessingExplosions.Num());
+	TotalQuerySeconds += QueryEndTime - StartTime;
+	TotalApplySeconds += EndTime - QueryEndTime;
+	WorstBatchSeconds = FMath::Max(WorstBatchSeconds, EndTime - StartTime);
+
+	// Frame memory must not be kept into the next frame
+	ExplosionHits.Reset();
+	ProcessingExplosions.Reset();
+	return NumHits;
+}
+
+void UShipExplosionSubsystem::BuildGrid(float CellSize)
+{
+	Targets.Reset();
+
+	// Cells are kept with their allocations between batches, until ships have wandered through too many of them
+	if (Cells.Num() > Damageables.Num() * 2 + 64)
+	{
+		Cells.Reset();
+	}
+	for (TPair<FIntVector, TArray<int32>>& Cell : Cells)
+	{
+		Cell.Value.Reset();
+	}
+	MaxTargetRadius = 0.0f;
+
+	for (int32 DamageableIndex = 0; DamageableIndex < Damageables.Num(); ++DamageableIndex)
+	{
+		// Dormant pooled ships have their collision off and cannot be hit
+		AActor* Actor = Damageables[DamageableIndex];
+		if (!Actor || !Actor->GetActorEnableCollision()) continue;
+
+		FExplosionTarget& Target = Targets.AddDefaulted_GetRef();
+		Target.Actor = Actor;
+		Target.Location = Actor->GetActorLocation();
+		Target.Radius = DamageableRadii[DamageableIndex];
+		MaxTargetRadius = FMath::Max(MaxTargetRadius, Target.Radius);
+
+		const FIntVector CellCoord(FMath::FloorToInt(Target.Location.X / CellSize), FMath::FloorToInt(Target.Location.Y / CellSize), FMath::FloorToInt(Target.Location.Z / CellSize));
+		Cells.FindOrAdd(CellCoord).Add(Targets.Num() - 1);
+	}
+}
+
+void UShipExplosionSubsystem::QueryExplosion(const FShipExplosion& Explosion, float CellSize, TFrameArray<FExplosionHit>& OutHits) const
+{
+	OutHits.Reset();
+
+	// Targets are hashed by their center, so reach further by the largest target radius
+	const float Reach = Explosion.OuterRadius + MaxTargetRadius;
+	const FIntVector MinCell(FMath::FloorToInt((Explosion.Origin.X - Reach) / CellSize), FMath::FloorToInt((Explosion.Origin.Y - Reach) / CellSize), FMath::FloorToInt((Explosion.Origin.Z - Reach) / CellSize));
+	const FIntVector MaxCell(FMath::FloorToInt((Explosion.Origin.X + Reach) / CellSize), FMath::FloorToInt((Explosion.Origin.Y + Reach) / CellSize), FMath::FloorToInt((Explosion.Origin.Z + Reach) / CellSize));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32>* CellTargets = Cells.Find(FIntVector(X, Y, Z));
+				if (!CellTargets) continue;
+
+				for (const int32 TargetIndex : *CellTargets)
+				{
+					const FExplosionTarget& Target = Targets[TargetIndex];
+					if (Target.Actor.HasSameIndexAndSerialNumber(Explosion.IgnoreActor)) continue;
+
+					// Distance to the target's bounding sphere rather than its center, large ships are hit by their hull
+					const FVector ToOrigin = Explosion.Origin - Target.Location;
+					const float DistanceToCenter = ToOrigin.Size();
+					if (DistanceToCenter - Target.Radius > Explosion.OuterRadius) continue;
+
+					FExplosionHit& Hit = OutHits.AddDefaulted_GetRef();
+					Hit.TargetIndex = TargetIndex;
+					Hit.ClosestPoint = DistanceToCenter > Target.Radius ? Target.Location + ToOrigin * (Target.Radius / DistanceToCenter) : Explosion.Origin;
+				}
+			}
+		}
+	}
+}
+
+int32 UShipExplosionSubsystem::ApplyHits()
+{
+	int32 NumHits = 0;
+
+	for (int32 ExplosionIndex = 0; ExplosionIndex < ProcessingExplosions.Num(); ++ExplosionIndex)
+	{
+		const FShipExplosion& Explosion = ProcessingExplosions[ExplosionIndex];
+		const TFrameArray<FExplosionHit>& Hits = ExplosionHits[ExplosionIndex];
+		NumHits += Hits.Num();
+		if (Explosion.BaseDamage <= 0.0f || Hits.Num() == 0) continue;
+
+		// The engine scales damage by the distance from the origin to the hit, the same falloff ApplyRadialDamageWithFalloff uses
+		FRadialDamageEvent DamageEvent;
+		DamageEvent.DamageTypeClass = Explosion.DamageTypeClass ? Explosion.DamageTypeClass : TSubclassOf<UDamageType>(UDamageType::StaticClass());
+		DamageEvent.Origin = Explosion.Origin;
+		DamageEvent.Params = FRadialDamageParams(Explosion.BaseDamage, Explosion.MinimumDamage, Explosion.InnerRadius, Explosion.OuterRadius, 1.0f);
+		DamageEvent.ComponentHits.SetNum(1);
+
+		for (const FExplosionHit& Hit : Hits)
+		{
+			// Earlier hits in the batch may have destroyed the target
+			AActor* Actor = Targets[Hit.TargetIndex].Actor.Get();
+			if (!IsValid(Actor)) continue;
+
+			FHitResult& HitResult = DamageEvent.ComponentHits[0];
+			HitResult = FHitResult(Actor, Cast<UPrimitiveComponent>(Actor->GetRootComponent()), Hit.ClosestPoint, (Hit.ClosestPoint - Explosion.Origin).GetSafeNormal());
+			HitResult.Distance = FVector::Dist(Explosion.Origin, Hit.ClosestPoint);
+
+			Actor->TakeDamage(Explosion.BaseDamage, DamageEvent, Explosion.InstigatedBy.Get(), Explosion.DamageCauser.Get());
+		}
+	}
+
+	return NumHits;
+}
+
+void UShipExplosionSubsystem::LogReport() const
+{
+	UE_LOG(LogShipExplosion, Log, TEXT("ShipExplosion: %lld explosions in %d batches, largest %d, %lld actors hit. Query %.3fms and apply %.3fms per batch, worst batch %.3fms"),
+		TotalExplosions, NumBatches, LargestBatch, TotalHits,
+		NumBatches > 0 ? TotalQuerySeconds * 1000.0 / NumBatches : 0.0,
+		NumBatches > 0 ? TotalApplySeconds * 1000.0 / NumBatches : 0.0,
+		WorstBatchSeconds * 1000.0);
+}
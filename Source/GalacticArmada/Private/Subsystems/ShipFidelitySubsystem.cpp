@@ -0,0 +1,176 @@
+#include "Subsystems/ShipFidelitySubsystem.h"
+#include "GalacticArmada.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderCore.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipFidelity, Log, All)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fidelity Level"), STAT_FidelityLevel, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Spawns Skipped"), STAT_FXSpawnsSkipped, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarFidelityEnabled(
+	TEXT("ga.Fidelity.Enabled"),
+	true,
+	TEXT("Lowers simulation fidelity when the game thread runs over its frame budget. Battle simulations stay at full fidelity unless ga.Fidelity.ForceLevel is set."));
+
+static TAutoConsoleVariable<int32> CVarFidelityForceLevel(
+	TEXT("ga.Fidelity.ForceLevel"),
+	-1,
+	TEXT("Holds the fidelity level at 0 (full) to 3 (lowest), -1 lets the governor choose."));
+
+static TAutoConsoleVariable<float> CVarFidelityFrameBudgetMs(
+	TEXT("ga.Fidelity.FrameBudgetMs"),
+	GA_WITH_COSMETICS ? 16.6f : 33.3f,
+	TEXT("Game thread milliseconds per frame the governor aims for, the dedicated server aims for its 30Hz tick."));
+
+static TAutoConsoleVariable<float> CVarFidelityUpgradeRatio(
+	TEXT("ga.Fidelity.UpgradeRatio"),
+	0.75f,
+	TEXT("Fraction of the frame budget game thread time must stay under before fidelity is raised again."));
+
+static TAutoConsoleVariable<float> CVarFidelityDegradeDelay(
+	TEXT("ga.Fidelity.DegradeDelay"),
+	0.5f,
+	TEXT("Seconds over budget before the fidelity level is lowered."));
+
+static TAutoConsoleVariable<float> CVarFidelityUpgradeDelay(
+	TEXT("ga.Fidelity.UpgradeDelay"),
+	3.0f,
+	TEXT("Seconds under the upgrade threshold before the fidelity level is raised."));
+
+static FAutoConsoleCommandWithWorld FidelityReportCommand(
+	TEXT("ga.Fidelity.Report"),
+	TEXT("Logs the fidelity level, level changes, time spent at each level and skipped effects."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipFidelitySubsystem* FidelitySubsystem = World ? World->GetSubsystem<UShipFidelitySubsystem>() : nullptr)
+		{
+			FidelitySubsystem->LogReport();
+		}
+	}));
+
+namespace ShipFidelity
+{
+	// AI think, avoidance, FX spawns, thruster updates, avoidance traces
+	static const FShipFidelitySettings Levels[UShipFidelitySubsystem::NumLevels] =
+	{
+		{ 0.0f, 0.0f, -1, 0.0f, -1 },
+		{ 0.05f, 0.1f, 32, 0.1f, 8 },
+		{ 0.1f, 0.2f, 16, 0.25f, 4 },
+		{ 0.2f, 0.4f, 4, 0.5f, 2 },
+	};
+
+	// Weight of the newest frame in the smoothed game thread time
+	static constexpr double SmoothingFactor = 0.1;
+}
+
+bool UShipFidelitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipFidelitySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipFidelitySubsystem, STATGROUP_Tickables);
+}
+
+const FShipFidelitySettings& UShipFidelitySubsystem::GetSettings() const
+{
+	return ShipFidelity::Levels[Level];
+}
+
+const FShipFidelitySettings& UShipFidelitySubsystem::GetSettings(const UWorld* World)
+{
+	const UShipFidelitySubsystem* FidelitySubsystem = World ? World->GetSubsystem<UShipFidelitySubsystem>() : nullptr;
+	return FidelitySubsystem ? FidelitySubsystem->GetSettings() : ShipFidelity::Levels[0];
+}
+
+bool UShipFidelitySubsystem::ConsumeFXSpawn()
+{
+	const int32 FXSpawnBudget = GetSettings().FXSpawnBudget;
+	if (FXSpawnBudget >= 0 && FXSpawnsThisFrame >= FXSpawnBudget)
+	{
+		++NumFXSpawnsSkipped;
+		INC_DWORD_STAT(STAT_FXSpawnsSkipped);
+		return false;
+	}
+
+	++FXSpawnsThisFrame;
+	return true;
+}
+
+void UShipFidelitySubsystem::Tick(float DeltaTime)
+{
+	FXSpawnsThisFrame = 0;
+	SecondsAtLevel[Level] += DeltaTime;
+
+	// Game thread work of the last frame, without the wait for the render thread that the delta time includes
+	const double FrameMs = GGameThreadTime > 0 ? FPlatformTime::ToMilliseconds(GGameThreadTime) : DeltaTime * 1000.0;
+	SmoothedFrameMs = SmoothedFrameMs > 0.0 ? FMath::Lerp(SmoothedFrameMs, FrameMs, ShipFidelity::SmoothingFactor) : FrameMs;
+
+	SET_DWORD_STAT(STAT_FidelityLevel, Level);
+	CSV_CUSTOM_STAT(GalacticArmada, FidelityLevel, Level, ECsvCustomStatOp::Set);
+
+	const int32 ForcedLevel = CVarFidelityForceLevel.GetValueOnGameThread();
+	if (ForcedLevel >= 0)
+	{
+		SetLevel(FMath::Min(ForcedLevel, NumLevels - 1), TEXT("forced"));
+		return;
+	}
+
+	if (!CVarFidelityEnabled.GetValueOnGameThread())
+	{
+		SetLevel(0, TEXT("governor disabled"));
+		return;
+	}
+
+	// Fidelity following host load would give the same seed different results across parallel simulation processes
+	if (GalacticArmada::IsBattleSimulation())
+	{
+		SetLevel(0, TEXT("battle simulation"));
+		return;
+	}
+
+	// Lower fidelity quickly when over budget, raise it slowly once well under it
+	const double FrameBudgetMs = CVarFidelityFrameBudgetMs.GetValueOnGameThread();
+	TimeOverBudget = SmoothedFrameMs > FrameBudgetMs ? TimeOverBudget + DeltaTime : 0.0f;
+	TimeUnderBudget = SmoothedFrameMs < FrameBudgetMs * CVarFidelityUpgradeRatio.GetValueOnGameThread() ? TimeUnderBudget + DeltaTime : 0.0f;
+
+	if (Level < NumLevels - 1 && TimeOverBudget >= CVarFidelityDegradeDelay.GetValueOnGameThread())
+	{
+		SetLevel(Level + 1, TEXT("over budget"));
+	}
+	else if (Level > 0 && TimeUnderBudget >= CVarFidelityUpgradeDelay.GetValueOnGameThread())
+	{
+		SetLevel(Level - 1, TEXT("recovered"));
+	}
+}
+
+void UShipFidelitySubsystem::SetLevel(int32 NewLevel, const TCHAR* Reason)
+{
+	if (NewLevel == Level) return;
+
+	const int32 OldLevel = Level;
+	Level = NewLevel;
+	TimeOverBudget = 0.0f;
+	TimeUnderBudget = 0.0f;
+	++NumLevelChanges;
+
+	const FShipFidelitySettings& Settings = GetSettings();
+	UE_LOG(LogShipFidelity, Log, TEXT("ShipFidelity: Level %d -> %d at %.1fs (%s, game thread %.2fms of %.2fms). AI think %.2fs, avoidance %.2fs, FX %d per frame, thrusters %.2fs, traces %d"),
+		OldLevel, NewLevel, GetWorld()->GetTimeSeconds(), Reason, SmoothedFrameMs, CVarFidelityFrameBudgetMs.GetValueOnGameThread(),
+		Settings.AIThinkInterval, Settings.AvoidanceInterval, Settings.FXSpawnBudget, Settings.ThrusterUpdateInterval, Settings.AvoidanceTraceBudget);
+	CSV_EVENT(GalacticArmada, TEXT("Fidelity %d"), NewLevel);
+}
+
+void UShipFidelitySubsystem::LogReport() const
+{
+	UE_LOG(LogShipFidelity, Log, TEXT("ShipFidelity: Level %d, game thread %.2fms, %d level changes, %lld effect spawns skipped"),
+		Level, SmoothedFrameMs, NumLevelChanges, NumFXSpawnsSkipped);
+
+	for (int32 LevelIndex = 0; LevelIndex < NumLevels; ++LevelIndex)
+	{
+		UE_LOG(LogShipFidelity, Log, TEXT("ShipFidelity: %.1fs at level %d"), SecondsAtLevel[LevelIndex], LevelIndex);
+	}
+}
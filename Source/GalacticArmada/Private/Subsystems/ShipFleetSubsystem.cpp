@@ -0,0 +1,378 @@
+#include "Subsystems/ShipFleetSubsystem.h"
+#include "GalacticArmada.h"
+#include "Components/CannonComponent.h"
+#include "Components/HealthComponent.h"
+#include "Components/ShipMovementComponent.h"
+#include "Data/ShipLoadoutDataAsset.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Mass/ShipFleetFragments.h"
+#include "Mass/ShipFleetProcessors.h"
+#include "MassCommonFragments.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipRepresentationSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipFleet, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Fleet Update"), STAT_ShipFleetUpdate, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fleet Entities"), STAT_FleetEntities, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Promoted Fleet Ships"), STAT_PromotedFleetShips, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<float> CVarFleetPromoteDistance(
+	TEXT("ga.Fleet.PromoteDistance"),
+	100000.0f,
+	TEXT("Distance from the closest view within which fleet entities become full ship actors."));
+
+static TAutoConsoleVariable<float> CVarFleetDemoteDistance(
+	TEXT("ga.Fleet.DemoteDistance"),
+	130000.0f,
+	TEXT("Distance from the closest view beyond which promoted ships turn back into fleet entities. Kept above PromoteDistance for hysteresis."));
+
+static TAutoConsoleVariable<int32> CVarFleetMaxPromotionsPerUpdate(
+	TEXT("ga.Fleet.MaxPromotionsPerUpdate"),
+	8,
+	TEXT("Upper bound on actors spawned from fleet entities per evaluation, spreading spawn cost over frames."));
+
+static TAutoConsoleVariable<float> CVarFleetEvaluationInterval(
+	TEXT("ga.Fleet.EvaluationInterval"),
+	0.25f,
+	TEXT("Seconds between fleet promotion distance checks."));
+
+static TAutoConsoleVariable<FString> CVarFleetDefaultShipClass(
+	TEXT("ga.Fleet.DefaultShipClass"),
+	TEXT("/Game/GalacticArmada/Blueprints/Pawns/BP_SpaceFighter.BP_SpaceFighter_C"),
+	TEXT("Ship class spawned by ga.Fleet.Spawn when none is given. Promoted entities become this class, so it needs a mesh and cannons."));
+
+static FAutoConsoleCommandWithWorldAndArgs FleetSpawnCommand(
+	TEXT("ga.Fleet.Spawn"),
+	TEXT("Spawns background fleet entities: ga.Fleet.Spawn <Count> [TeamId] [Radius] [ShipClassPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UShipFleetSubsystem* FleetSubsystem = World ? World->GetSubsystem<UShipFleetSubsystem>() : nullptr;
+		if (!FleetSubsystem || Args.Num() == 0) return;
+
+		const int32 Count = FCString::Atoi(*Args[0]);
+		const uint8 TeamId = Args.IsValidIndex(1) ? (uint8)FCString::Atoi(*Args[1]) : 1;
+		const float Radius = Args.IsValidIndex(2) ? FCString::Atof(*Args[2]) : 500000.0f;
+
+		const TSubclassOf<AShipPawn> ShipClass = LoadClass<AShipPawn>(nullptr, Args.IsValidIndex(3) ? *Args[3] : *CVarFleetDefaultShipClass.GetValueOnGameThread());
+		if (!ShipClass)
+		{
+			UE_LOG(LogShipFleet, Warning, TEXT("ShipFleet: Could not load ship class %s"), Args.IsValidIndex(3) ? *Args[3] : *CVarFleetDefaultShipClass.GetValueOnGameThread());
+			return;
+		}
+
+		FleetSubsystem->SpawnFleet(ShipClass, TeamId, Count, FVector::ZeroVector, Radius);
+	}));
+
+static FAutoConsoleCommandWithWorld FleetReportCommand(
+	TEXT("ga.Fleet.Report"),
+	TEXT("Logs fleet entity counts and promotions."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipFleetSubsystem* FleetSubsystem = World ? World->GetSubsystem<UShipFleetSubsystem>() : nullptr)
+		{
+			FleetSubsystem->LogReport();
+		}
+	}));
+
+void UShipFleetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	FleetQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	FleetQuery.AddConstSharedRequirement<FShipArchetypeFragment>();
+	FleetQuery.AddTagRequirement<FShipFleetTag>(EMassFragmentPresence::All);
+}
+
+bool UShipFleetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipFleetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipFleetSubsystem, STATGROUP_Tickables);
+}
+
+FMassEntityManager* UShipFleetSubsystem::GetEntityManager() const
+{
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	return EntitySubsystem ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+}
+
+void UShipFleetSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipFleetUpdate);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipFleet);
+
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager || !FleetArchetype.IsValid()) return;
+
+	TimeSinceEvaluation += DeltaTime;
+	if (TimeSinceEvaluation >= CVarFleetEvaluationInterval.GetValueOnGameThread())
+	{
+		TimeSinceEvaluation = 0.0f;
+		EvaluatePromotions(*EntityManager);
+	}
+
+	NumFleetEntities = FleetQuery.GetNumMatchingEntities(*EntityManager);
+	if (GalacticArmada::ShouldPlayCosmetics(this))
+	{
+		UpdateProxyInstances(*EntityManager);
+	}
+
+	SET_DWORD_STAT(STAT_FleetEntities, NumFleetEntities);
+	SET_DWORD_STAT(STAT_PromotedFleetShips, PromotedShips.Num());
+	CSV_CUSTOM_STAT(GalacticArmada, FleetEntities, NumFleetEntities, ECsvCustomStatOp::Set);
+}
+
+const FConstSharedStruct& UShipFleetSubsystem::GetOrCreateArchetypeFragment(FMassEntityManager& EntityManager, TSubclassOf<AShipPawn> ShipClass)
+{
+	if (const FConstSharedStruct* ExistingFragment = ArchetypeFragments.Find(ShipClass))
+	{
+		return *ExistingFragment;
+	}
+
+	// Everything an entity needs is read once from the ship class defaults
+	const AShipPawn* ShipDefaults = ShipClass->GetDefaultObject<AShipPawn>();
+
+	FShipArchetypeFragment Fragment;
+	Fragment.ShipClass = ShipClass;
+	Fragment.FlightParams = ShipDefaults->GetShipMovementComponent()->MakeFlightParams();
+	Fragment.SteeringParams = ShipDefaults->GetSteeringParams();
+	Fragment.PrimaryFireRange = ShipDefaults->PrimaryFireRange;
+	Fragment.SecondaryFireRange = ShipDefaults->SecondaryFireRange;
+	Fragment.MaxHealth = ShipDefaults->GetHealthComponent()->GetDefaultHealth();
+
+	UShipLoadoutDataAsset* Loadout = ShipDefaults->GetCannonComponent()->GetLoadout();
+	if (Loadout)
+	{
+		Loadout->ResolveProjectiles(true);
+	}
+
+	for (int32 CannonIndex = 0; CannonIndex < UE_ARRAY_COUNT(Fragment.FireInterval); ++CannonIndex)
+	{
+		if (!Loadout || !Loadout->IsValidCannon(CannonIndex)) continue;
+
+		const FShipLoadoutCannon& Cannon = Loadout->GetCannon(CannonIndex);
+		if (!Cannon.bEnabled || !Cannon.ProjectileClass)
+		{
+			Fragment.DamagePerShot[CannonIndex] = 0.0f;
+			continue;
+		}
+
+		Fragment.FireInterval[CannonIndex] = Cannon.FireInterval;
+		Fragment.DamagePerShot[CannonIndex] = Cannon.DamagePerVolley;
+	}
+
+	return ArchetypeFragments.Add(ShipClass, EntityManager.GetOrCreateConstSharedFragment(Fragment));
+}
+
+void UShipFleetSubsystem::CreateEntities(FMassEntityManager& EntityManager, TSubclassOf<AShipPawn> ShipClass, int32 Count, TArray<FMassEntityHandle>& OutEntities)
+{
+	if (!FleetArchetype.IsValid())
+	{
+		FleetArchetype = EntityManager.CreateArchetype({
+			FTransformFragment::StaticStruct(),
+			FShipFlightFragment::StaticStruct(),
+			FShipTargetFragment::StaticStruct(),
+			FShipCannonFragment::StaticStruct(),
+			FShipHealthFragment::StaticStruct(),
+			FShipTeamFragment::StaticStruct(),
+			FShipFleetTag::StaticStruct()
+		}, TEXT("ShipFleet"));
+	}
+
+	FMassArchetypeSharedFragmentValues SharedFragmentValues;
+	SharedFragmentValues.AddConstSharedFragment(GetOrCreateArchetypeFragment(EntityManager, ShipClass));
+	SharedFragmentValues.Sort();
+
+	EntityManager.BatchCreateEntities(FleetArchetype, SharedFragmentValues, Count, OutEntities);
+
+	// Random first searches, otherwise a whole spawned fleet searches on the same frame
+	const float RetargetInterval = UShipFleetTargetingProcessor::GetRetargetInterval();
+	for (const FMassEntityHandle Entity : OutEntities)
+	{
+		EntityManager.GetFragmentDataChecked<FShipTargetFragment>(Entity).RetargetCooldown = FMath::FRandRange(0.0f, RetargetInterval);
+	}
+}
+
+void UShipFleetSubsystem::SpawnFleet(TSubclassOf<AShipPawn> ShipClass, uint8 TeamId, int32 Count, const FVector& Center, float Radius)
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager || !ShipClass || Count <= 0) return;
+
+	TArray<FMassEntityHandle> Entities;
+	CreateEntities(*EntityManager, ShipClass, Count, Entities);
+
+	const FShipArchetypeFragment& Archetype = ArchetypeFragments.FindChecked(ShipClass).Get<FShipArchetypeFragment>();
+	for (const FMassEntityHandle Entity : Entities)
+	{
+		const FVector Location = Center + FMath::VRand() * FMath::FRandRange(0.0f, Radius);
+		const FRotator Rotation = (Center - Location).Rotation();
+		EntityManager->GetFragmentDataChecked<FTransformFragment>(Entity).SetTransform(FTransform(Rotation, Location));
+		EntityManager->GetFragmentDataChecked<FShipFlightFragment>(Entity).State.Speed = Archetype.FlightParams.MinSpeed;
+		EntityManager->GetFragmentDataChecked<FShipHealthFragment>(Entity).Health = Archetype.MaxHealth;
+		EntityManager->GetFragmentDataChecked<FShipTeamFragment>(Entity).TeamId = TeamId;
+	}
+
+	UE_LOG(LogShipFleet, Log, TEXT("ShipFleet: Spawned %d %s entities for team %d"), Count, *GetNameSafe(ShipClass), TeamId);
+}
+
+void UShipFleetSubsystem::EvaluatePromotions(FMassEntityManager& EntityManager)
+{
+	const UShipRepresentationSubsystem* RepresentationSubsystem = GetWorld()->GetSubsystem<UShipRepresentationSubsystem>();
+	TFrameArray<FVector> ViewLocations;
+	if (RepresentationSubsystem)
+	{
+		RepresentationSubsystem->GetViewLocations(ViewLocations);
+	}
+
+	auto GetClosestViewDistanceSquared = [&ViewLocations](const FVector& Location)
+	{
+		double ClosestViewDistanceSquared = TNumericLimits<double>::Max();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ClosestViewDistanceSquared = FMath::Min(ClosestViewDistanceSquared, FVector::DistSquared(ViewLocation, Location));
+		}
+		return ClosestViewDistanceSquared;
+	};
+
+	// Demote Promoted Ships That Left Every View, Without Views (Headless Runs) All Of Them
+	const double DemoteDistanceSquared = FMath::Square(CVarFleetDemoteDistance.GetValueOnGameThread());
+	for (int32 ShipIndex = PromotedShips.Num() - 1; ShipIndex >= 0; --ShipIndex)
+	{
+		AShipPawn* ShipPawn = PromotedShips[ShipIndex];
+		if (!IsValid(ShipPawn) || ShipPawn->GetHealthComponent()->GetHealth() <= 0.0f)
+		{
+			PromotedShips.RemoveAtSwap(ShipIndex);
+			continue;
+		}
+
+		if (GetClosestViewDistanceSquared(ShipPawn->GetActorLocation()) > DemoteDistanceSquared)
+		{
+			PromotedShips.RemoveAtSwap(ShipIndex);
+			DemoteShip(EntityManager, ShipPawn);
+		}
+	}
+
+	if (ViewLocations.Num() == 0) return;
+
+	// Promote Entities Close To A View
+	const double PromoteDistanceSquared = FMath::Square(CVarFleetPromoteDistance.GetValueOnGameThread());
+	const int32 MaxPromotions = CVarFleetMaxPromotionsPerUpdate.GetValueOnGameThread();
+	TFrameArray<FMassEntityHandle> EntitiesToPromote;
+
+	FMassExecutionContext ExecutionContext(EntityManager);
+	FleetQuery.ForEachEntityChunk(EntityManager, ExecutionContext, [&](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		for (int32 EntityIndex = 0; EntityIndex < Context.GetNumEntities() && EntitiesToPromote.Num() < MaxPromotions; ++EntityIndex)
+		{
+			if (GetClosestViewDistanceSquared(Transforms[EntityIndex].GetTransform().GetLocation()) < PromoteDistanceSquared)
+			{
+				EntitiesToPromote.Add(Context.GetEntity(EntityIndex));
+			}
+		}
+	});
+
+	for (const FMassEntityHandle Entity : EntitiesToPromote)
+	{
+		if (AShipPawn* ShipPawn = PromoteEntity(EntityManager, Entity))
+		{
+			PromotedShips.Add(ShipPawn);
+		}
+	}
+}
+
+AShipPawn* UShipFleetSubsystem::PromoteEntity(FMassEntityManager& EntityManager, FMassEntityHandle Entity)
+{
+	const FShipArchetypeFragment& Archetype = EntityManager.GetConstSharedFragmentDataChecked<FShipArchetypeFragment>(Entity);
+	const FTransform SpawnTransform = EntityManager.GetFragmentDataChecked<FTransformFragment>(Entity).GetTransform();
+	const FShipFlightFragment& Flight = EntityManager.GetFragmentDataChecked<FShipFlightFragment>(Entity);
+	const float Health = EntityManager.GetFragmentDataChecked<FShipHealthFragment>(Entity).Health;
+	const uint8 TeamId = EntityManager.GetFragmentDataChecked<FShipTeamFragment>(Entity).TeamId;
+
+	LLM_SCOPE_BYTAG(GalacticArmada_Ships);
+	AShipPawn* ShipPawn = GetWorld()->SpawnActorDeferred<AShipPawn>(Archetype.ShipClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!ShipPawn) return nullptr;
+
+	ShipPawn->TeamId = TeamId;
+	ShipPawn->FinishSpawning(SpawnTransform);
+
+	if (!ShipPawn->GetController())
+	{
+		ShipPawn->SpawnDefaultController();
+	}
+
+	// Carry the entity's state over so the hand-off is seamless
+	ShipPawn->GetShipMovementComponent()->SetFlightState(Flight.State);
+	ShipPawn->GetShipMovementComponent()->SetFlightInput(Flight.Input);
+	ShipPawn->GetHealthComponent()->SetHealth(Health);
+
+	if (UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(ShipPawn->GetRootComponent()); RootPrimitive && RootPrimitive->IsSimulatingPhysics())
+	{
+		RootPrimitive->SetPhysicsLinearVelocity(SpawnTransform.GetRotation().GetForwardVector() * Flight.State.Speed);
+	}
+
+	EntityManager.DestroyEntity(Entity);
+	++NumPromotions;
+	return ShipPawn;
+}
+
+void UShipFleetSubsystem::DemoteShip(FMassEntityManager& EntityManager, AShipPawn* ShipPawn)
+{
+	TArray<FMassEntityHandle> Entities;
+	CreateEntities(EntityManager, ShipPawn->GetClass(), 1, Entities);
+	if (Entities.Num() == 0) return;
+
+	const FMassEntityHandle Entity = Entities[0];
+	const UShipMovementComponent* ShipMovementComponent = ShipPawn->GetShipMovementComponent();
+	FShipFlightFragment& Flight = EntityManager.GetFragmentDataChecked<FShipFlightFragment>(Entity);
+	Flight.Input = ShipMovementComponent->GetFlightInput();
+	Flight.State = ShipMovementComponent->GetFlightState();
+	EntityManager.GetFragmentDataChecked<FTransformFragment>(Entity).SetTransform(ShipPawn->GetActorTransform());
+	EntityManager.GetFragmentDataChecked<FShipHealthFragment>(Entity).Health = ShipPawn->GetHealthComponent()->GetHealth();
+	EntityManager.GetFragmentDataChecked<FShipTeamFragment>(Entity).TeamId = ShipPawn->TeamId;
+
+	if (AController* Controller = ShipPawn->GetController())
+	{
+		Controller->Destroy();
+	}
+	ShipPawn->Destroy();
+	++NumDemotions;
+}
+
+void UShipFleetSubsystem::UpdateProxyInstances(FMassEntityManager& EntityManager)
+{
+	UShipRepresentationSubsystem* RepresentationSubsystem = GetWorld()->GetSubsystem<UShipRepresentationSubsystem>();
+	if (!RepresentationSubsystem) return;
+
+	// Fleet entities share the proxy meshes of distant ship actors
+	FMassExecutionContext ExecutionContext(EntityManager);
+	TFrameArray<FTransform> InstanceTransforms;
+	FleetQuery.ForEachEntityChunk(EntityManager, ExecutionContext, [RepresentationSubsystem, &InstanceTransforms](FMassExecutionContext& Context)
+	{
+		const FShipArchetypeFragment& Archetype = Context.GetConstSharedFragment<FShipArchetypeFragment>();
+		UStaticMesh* ProxyStaticMesh = Archetype.ShipClass ? Archetype.ShipClass->GetDefaultObject<AShipPawn>()->GetProxyStaticMesh() : nullptr;
+		if (!ProxyStaticMesh) return;
+
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		InstanceTransforms.Reset(Transforms.Num());
+		for (const FTransformFragment& Transform : Transforms)
+		{
+			InstanceTransforms.Add(Transform.GetTransform());
+		}
+		RepresentationSubsystem->AddExternalProxyInstances(ProxyStaticMesh, InstanceTransforms);
+	});
+}
+
+void UShipFleetSubsystem::LogReport() const
+{
+	UE_LOG(LogShipFleet, Log, TEXT("ShipFleet: %d entities, %d promoted ships"), NumFleetEntities, PromotedShips.Num());
+	UE_LOG(LogShipFleet, Log, TEXT("ShipFleet: %d promotions, %d demotions"), NumPromotions, NumDemotions);
+}
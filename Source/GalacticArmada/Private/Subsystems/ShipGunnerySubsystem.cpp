@@ -0,0 +1,190 @@
+#include "Subsystems/ShipGunnerySubsystem.h"
+#include "GalacticArmada.h"
+#include "Components/CannonComponent.h"
+#include "Controllers/ShipAIController.h"
+#include "Data/ShipLoadoutDataAsset.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipGunnery, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Gunnery"), STAT_ShipGunnery, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI Shots Fired"), STAT_AIShotsFired, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarGunneryLeadTargeting(
+	TEXT("ga.Gunnery.LeadTargeting"),
+	true,
+	TEXT("AI aims at intercept points and gates fire on hit probability. Off aims at the target and fires on range alone."));
+
+static TAutoConsoleVariable<float> CVarGunneryMinHitProbability(
+	TEXT("ga.Gunnery.MinHitProbability"),
+	0.2f,
+	TEXT("Predicted hit probability below which AI ships hold fire."));
+
+static FAutoConsoleCommandWithWorld GunneryReportCommand(
+	TEXT("ga.Gunnery.Report"),
+	TEXT("Logs AI shots fired, kills and shots per kill."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipGunnerySubsystem* GunnerySubsystem = World ? World->GetSubsystem<UShipGunnerySubsystem>() : nullptr)
+		{
+			GunnerySubsystem->LogReport();
+		}
+	}));
+
+bool UShipGunnerySubsystem::IsLeadTargetingEnabled()
+{
+	return CVarGunneryLeadTargeting.GetValueOnGameThread();
+}
+
+float UShipGunnerySubsystem::GetMinHitProbability()
+{
+	return CVarGunneryMinHitProbability.GetValueOnGameThread();
+}
+
+bool UShipGunnerySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipGunnerySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipGunnerySubsystem, STATGROUP_Tickables);
+}
+
+void UShipGunnerySubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipGunnery);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipGunnery);
+
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (!ShipRegistry || DeltaTime <= 0.0f) return;
+
+	UpdateShipMotions(DeltaTime);
+	if (!IsLeadTargetingEnabled()) return;
+
+	Shooters.Reset();
+	Requests.Reset();
+
+	// Gather Every AI Shooter With A Target
+	for (AShipPawn* ShipPawn : ShipRegistry->GetShips())
+	{
+		AShipAIController* ShipAIController = IsValid(ShipPawn) ? Cast<AShipAIController>(ShipPawn->GetController()) : nullptr;
+		const AShipPawn* TargetShipPawn = ShipAIController ? ShipAIController->GetTargetShipPawn() : nullptr;
+		if (!IsValid(TargetShipPawn)) continue;
+
+		const FShipMotion* TargetMotion = ShipMotions.Find(TargetShipPawn);
+		if (!TargetMotion || !ShipMotions.Contains(ShipPawn)) continue;
+
+		const int32 CannonIndex = FVector::Distance(ShipPawn->GetActorLocation(), TargetShipPawn->GetActorLocation()) <= ShipPawn->PrimaryFireRange ? 0 : 1;
+
+		FInterceptRequest& Request = Requests.AddDefaulted_GetRef();
+		Request.ShooterLocation = ShipPawn->GetActorLocation();
+		Request.ShooterForward = ShipPawn->GetActorForwardVector();
+		Request.TargetLocation = TargetShipPawn->GetActorLocation();
+		Request.TargetVelocity = TargetMotion->Velocity;
+		Request.TargetAcceleration = TargetMotion->Acceleration;
+		Request.TargetManeuver = TargetMotion->Maneuver;
+		Request.TargetRadius = TargetShipPawn->GetRootComponent()->Bounds.SphereRadius;
+		Request.ProjectileSpeed = GetProjectileSpeed(ShipPawn, CannonIndex);
+		Shooters.Add(ShipAIController);
+	}
+
+	Solutions.SetNum(Requests.Num());
+	ProjectileBallistics::SolveInterceptBatch(Requests, Solutions);
+
+	for (int32 ShooterIndex = 0; ShooterIndex < Shooters.Num(); ++ShooterIndex)
+	{
+		Shooters[ShooterIndex]->SetGunnerySolution(Solutions[ShooterIndex]);
+	}
+}
+
+void UShipGunnerySubsystem::UpdateShipMotions(float DeltaTime)
+{
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+
+	for (auto MotionIterator = ShipMotions.CreateIterator(); MotionIterator; ++MotionIterator)
+	{
+		if (!MotionIterator->Key.IsValid())
+		{
+			MotionIterator.RemoveCurrent();
+		}
+	}
+
+	// Finite differences work the same for physics, kinematic and proxy ships
+	for (const AShipPawn* ShipPawn : ShipRegistry->GetShips())
+	{
+		if (!IsValid(ShipPawn)) continue;
+
+		FShipMotion& Motion = ShipMotions.FindOrAdd(ShipPawn);
+		const FVector Location = ShipPawn->GetActorLocation();
+
+		if (Motion.NumSamples > 0)
+		{
+			const FVector Velocity = (Location - Motion.Location) / DeltaTime;
+			if (Motion.NumSamples > 1)
+			{
+				const FVector Acceleration = (Velocity - Motion.Velocity) / DeltaTime;
+				Motion.Maneuver = FMath::Lerp(Motion.Maneuver, (float)FVector::Distance(Acceleration, Motion.Acceleration), 0.1f);
+				Motion.Acceleration = FMath::Lerp(Motion.Acceleration, Acceleration, 0.3f);
+			}
+			Motion.Velocity = Velocity;
+		}
+
+		Motion.Location = Location;
+		++Motion.NumSamples;
+	}
+}
+
+float UShipGunnerySubsystem::GetProjectileSpeed(const AShipPawn* ShipPawn, int32 CannonIndex)
+{
+	UShipLoadoutDataAsset* Loadout = ShipPawn->GetCannonComponent()->GetLoadout();
+	if (!Loadout || !Loadout->IsValidCannon(CannonIndex)) return 0.0f;
+
+	const FShipLoadoutCannon& Cannon = Loadout->GetCannon(CannonIndex);
+	if (!Cannon.bProjectileResolved)
+	{
+		Loadout->ResolveProjectiles(true);
+	}
+	return Cannon.ProjectileSpeed;
+}
+
+bool UShipGunnerySubsystem::GetShipMotion(const AShipPawn* ShipPawn, FVector& OutLocation, FVector& OutVelocity) const
+{
+	const FShipMotion* Motion = ShipMotions.Find(ShipPawn);
+	if (!Motion || Motion->NumSamples == 0) return false;
+
+	OutLocation = Motion->Location;
+	OutVelocity = Motion->Velocity;
+	return true;
+}
+
+void UShipGunnerySubsystem::ResetShipMotion(const AShipPawn* ShipPawn)
+{
+	ShipMotions.Remove(ShipPawn);
+}
+
+void UShipGunnerySubsystem::NotifyShotFired(const APawn* Shooter)
+{
+	if (!Shooter || Shooter->IsPlayerControlled()) return;
+
+	++ShotsFired;
+	INC_DWORD_STAT(STAT_AIShotsFired);
+	CSV_CUSTOM_STAT(GalacticArmada, AIShotsFired, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void UShipGunnerySubsystem::NotifyShipKilled(const AController* Killer)
+{
+	if (!Cast<AShipAIController>(Killer)) return;
+
+	++Kills;
+	CSV_CUSTOM_STAT(GalacticArmada, AIKills, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void UShipGunnerySubsystem::LogReport() const
+{
+	UE_LOG(LogShipGunnery, Log, TEXT("ShipGunnery: Lead targeting %s, %d AI shots, %d kills, %.1f shots per kill"),
+		IsLeadTargetingEnabled() ? TEXT("on") : TEXT("off"), ShotsFired, Kills, Kills > 0 ? (float)ShotsFired / Kills : 0.0f);
+}
@@ -0,0 +1,381 @@
+#include "Subsystems/ShipInfluenceSubsystem.h"
+#include "GalacticArmada.h"
+#include "Async/Async.h"
+#include "Components/CannonComponent.h"
+#include "Components/HealthComponent.h"
+#include "Data/ShipLoadoutDataAsset.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipInfluence, Log, All)
+
+static_assert(AShipPawn::PlayerTeamId < FInfluenceMap::MaxTeams, "The player's team must fit the influence map");
+
+DECLARE_CYCLE_STAT(TEXT("Influence Map Update"), STAT_InfluenceUpdate, STATGROUP_GalacticArmada);
+DECLARE_CYCLE_STAT(TEXT("Influence AI Decisions"), STAT_InfluenceDecisions, STATGROUP_GalacticArmada);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Influence Map Cells"), STAT_InfluenceCells, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarInfluenceEnable(
+	TEXT("ga.Influence.Enable"),
+	true,
+	TEXT("AI chooses targets, retreats and flanks from the influence map. Off falls back to the player or the closest hostile."));
+
+static TAutoConsoleVariable<float> CVarInfluenceUpdateRate(
+	TEXT("ga.Influence.UpdateRate"),
+	4.0f,
+	TEXT("Influence map updates per second."));
+
+static TAutoConsoleVariable<float> CVarInfluenceCellSize(
+	TEXT("ga.Influence.CellSize"),
+	10000.0f,
+	TEXT("Edge of an influence map cell. Changing it starts a new map."));
+
+static TAutoConsoleVariable<float> CVarInfluenceDistanceScale(
+	TEXT("ga.Influence.DistanceScale"),
+	100000.0f,
+	TEXT("Distance that costs a target as much as a full influence advantage."));
+
+static TAutoConsoleVariable<float> CVarInfluenceRetreatHealth(
+	TEXT("ga.Influence.RetreatHealth"),
+	0.35f,
+	TEXT("Health fraction below which an outgunned AI ship retreats."));
+
+static TAutoConsoleVariable<float> CVarInfluenceRetreatAdvantage(
+	TEXT("ga.Influence.RetreatAdvantage"),
+	0.3f,
+	TEXT("How far hostile influence has to outweigh friendly influence, in [0, 1], before a hurt AI ship retreats."));
+
+static FAutoConsoleCommandWithWorld InfluenceReportCommand(
+	TEXT("ga.Influence.Report"),
+	TEXT("Logs influence map size, cells updated per second and AI decision time."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipInfluenceSubsystem* InfluenceSubsystem = World ? World->GetSubsystem<UShipInfluenceSubsystem>() : nullptr)
+		{
+			InfluenceSubsystem->LogReport();
+		}
+	}));
+
+namespace ShipInfluence
+{
+	static constexpr int32 MaxTargetCandidates = 8;
+
+	// Incremental updates are stamped from scratch this often to drop rounding drift
+	static constexpr int32 RebuildInterval = 32;
+
+	// Friendly minus hostile influence over their sum, in [-1, 1]
+	static float GetAdvantage(const FInfluenceMap& Map, const FVector& Location, int32 TeamId)
+	{
+		float Friendly, Hostile;
+		Map.Sample(Location, TeamId, Friendly, Hostile);
+		return (Friendly - Hostile) / FMath::Max(Friendly + Hostile, UE_KINDA_SMALL_NUMBER);
+	}
+
+	static void RankTargetCandidates(FShipInfluenceSnapshot& Snapshot, TConstArrayView<FInfluenceSource> Sources)
+	{
+		bool bTeamPresent[FInfluenceMap::MaxTeams] = {};
+		for (const FInfluenceSource& Source : Sources)
+		{
+			bTeamPresent[Source.TeamId] = true;
+		}
+
+		for (int32 TeamId = 0; TeamId < FInfluenceMap::MaxTeams; ++TeamId)
+		{
+			if (!bTeamPresent[TeamId]) continue;
+
+			TArray<FShipInfluenceCandidate>& Candidates = Snapshot.TargetCandidates[TeamId];
+			for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+			{
+				if (Sources[SourceIndex].TeamId == TeamId) continue;
+
+				FShipInfluenceCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+				Candidate.ShipIndex = SourceIndex;
+				Candidate.Advantage = GetAdvantage(Snapshot.Map, Sources[SourceIndex].Location, TeamId);
+			}
+
+			Candidates.Sort([](const FShipInfluenceCandidate& A, const FShipInfluenceCandidate& B) { return A.Advantage > B.Advantage; });
+			Candidates.SetNum(FMath::Min(Candidates.Num(), MaxTargetCandidates));
+		}
+	}
+}
+
+bool UShipInfluenceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipInfluenceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipInfluenceSubsystem, STATGROUP_Tickables);
+}
+
+void UShipInfluenceSubsystem::Deinitialize()
+{
+	Snapshot.Reset();
+	WorkingMap.Reset();
+	Super::Deinitialize();
+}
+
+bool UShipInfluenceSubsystem::IsReady() const
+{
+	return Snapshot.IsValid() && CVarInfluenceEnable.GetValueOnGameThread();
+}
+
+void UShipInfluenceSubsystem::Tick(float DeltaTime)
+{
+	if (!CVarInfluenceEnable.GetValueOnGameThread()) return;
+
+	TimeSinceUpdate += DeltaTime;
+	if (bUpdateInFlight || TimeSinceUpdate < 1.0f / FMath::Max(CVarInfluenceUpdateRate.GetValueOnGameThread(), 0.1f)) return;
+
+	TimeSinceUpdate = 0.0f;
+	StartUpdate();
+}
+
+void UShipInfluenceSubsystem::StartUpdate()
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_AI);
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (!ShipRegistry) return;
+
+	const float CellSize = FMath::Max(CVarInfluenceCellSize.GetValueOnGameThread(), 1.0f);
+	if (!WorkingMap.IsValid() || WorkingMap->GetCellSize() != CellSize)
+	{
+		WorkingMap = MakeShared<FInfluenceMap>(CellSize);
+	}
+
+	if (NumUpdates == 0)
+	{
+		FirstUpdateTime = GetWorld()->GetTimeSeconds();
+	}
+
+	// Gather Sources On The Game Thread
+	TSharedPtr<FShipInfluenceSnapshot> NewSnapshot = MakeShared<FShipInfluenceSnapshot>();
+	TArray<FInfluenceSource> Sources;
+	Sources.Reserve(ShipRegistry->GetShips().Num());
+
+	for (AShipPawn* ShipPawn : ShipRegistry->GetShips())
+	{
+		if (!IsValid(ShipPawn)) continue;
+		if (ShipPawn->TeamId >= FInfluenceMap::MaxTeams)
+		{
+			bool bAlreadyWarned = false;
+			UnmappedTeams.Add(ShipPawn->TeamId, &bAlreadyWarned);
+			if (!bAlreadyWarned)
+			{
+				UE_LOG(LogShipInfluence, Warning, TEXT("ShipInfluence: %s is on team %d but the influence map only holds %d teams, ships of that team are left off the map."),
+					*ShipPawn->GetName(), ShipPawn->TeamId, FInfluenceMap::MaxTeams);
+			}
+			continue;
+		}
+
+		const float Health = ShipPawn->GetHealthComponent()->GetHealth();
+		if (Health <= 0.0f) continue;
+
+		FInfluenceSource& Source = Sources.AddDefaulted_GetRef();
+		Source.Id = ShipPawn->GetUniqueID();
+		Source.Location = ShipPawn->GetActorLocation();
+		Source.TeamId = ShipPawn->TeamId;
+		Source.Strength = Health * FMath::Max(GetDamagePerSecond(ShipPawn), 1.0f);
+		Source.Radius = ShipPawn->SecondaryFireRange;
+		NewSnapshot->Ships.Add(ShipPawn);
+	}
+
+	const bool bRebuild = ++UpdatesSinceRebuild >= ShipInfluence::RebuildInterval;
+	if (bRebuild)
+	{
+		UpdatesSinceRebuild = 0;
+	}
+
+	bUpdateInFlight = true;
+	TWeakObjectPtr<UShipInfluenceSubsystem> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Map = WorkingMap, NewSnapshot, Sources = MoveTemp(Sources), bRebuild]()
+	{
+		LLM_SCOPE_BYTAG(GalacticArmada_AI);
+		SCOPE_CYCLE_COUNTER(STAT_InfluenceUpdate);
+		const double StartTime = FPlatformTime::Seconds();
+
+		int32 NumCellWrites = Map->Update(Sources);
+		if (bRebuild)
+		{
+			NumCellWrites += Map->Rebuild();
+		}
+
+		NewSnapshot->Map = *Map;
+		ShipInfluence::RankTargetCandidates(*NewSnapshot, Sources);
+
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, NewSnapshot, NumCellWrites, Seconds]()
+		{
+			if (UShipInfluenceSubsystem* InfluenceSubsystem = WeakThis.Get())
+			{
+				InfluenceSubsystem->OnUpdateComplete(NewSnapshot, NumCellWrites, Seconds);
+			}
+		});
+	});
+}
+
+void UShipInfluenceSubsystem::OnUpdateComplete(TSharedPtr<const FShipInfluenceSnapshot> NewSnapshot, int32 NumCellWrites, double Seconds)
+{
+	bUpdateInFlight = false;
+	Snapshot = NewSnapshot;
+
+	++NumUpdates;
+	TotalCellWrites += NumCellWrites;
+	TotalUpdateSeconds += Seconds;
+
+	SET_DWORD_STAT(STAT_InfluenceCells, Snapshot->Map.GetNumCells());
+	CSV_CUSTOM_STAT(GalacticArmada, InfluenceCellWrites, NumCellWrites, ECsvCustomStatOp::Accumulate);
+}
+
+float UShipInfluenceSubsystem::GetDamagePerSecond(const AShipPawn* ShipPawn)
+{
+	UClass* ShipClass = ShipPawn->GetClass();
+	if (const float* ShipDamagePerSecond = DamagePerSecond.Find(ShipClass))
+	{
+		return *ShipDamagePerSecond;
+	}
+
+	// AI fires one cannon group at a time, the strongest one counts
+	float BestDamagePerSecond = 0.0f;
+	if (UShipLoadoutDataAsset* Loadout = ShipPawn->GetCannonComponent()->GetLoadout())
+	{
+		Loadout->ResolveProjectiles(true);
+		for (int32 CannonIndex = 0; CannonIndex < Loadout->GetNumCannons(); ++CannonIndex)
+		{
+			const FShipLoadoutCannon& Cannon = Loadout->GetCannon(CannonIndex);
+			if (!Cannon.bEnabled || !Cannon.ProjectileClass) continue;
+
+			BestDamagePerSecond = FMath::Max(BestDamagePerSecond, Cannon.DamagePerVolley / Cannon.FireInterval);
+		}
+	}
+
+	return DamagePerSecond.Add(ShipClass, BestDamagePerSecond);
+}
+
+AShipPawn* UShipInfluenceSubsystem::ChooseTarget(const AShipPawn* ShipPawn) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InfluenceDecisions);
+	FScopedDurationTimer DecisionTimer(TotalDecisionSeconds);
+	++NumDecisions;
+
+	if (!IsReady() || !IsValid(ShipPawn) || ShipPawn->TeamId >= FInfluenceMap::MaxTeams) return nullptr;
+
+	const float DistanceScale = FMath::Max(CVarInfluenceDistanceScale.GetValueOnGameThread(), 1.0f);
+	const FVector Location = ShipPawn->GetActorLocation();
+
+	AShipPawn* BestTarget = nullptr;
+	float BestScore = -TNumericLimits<float>::Max();
+
+	for (const FShipInfluenceCandidate& Candidate : Snapshot->TargetCandidates[ShipPawn->TeamId])
+	{
+		AShipPawn* CandidateShip = Snapshot->Ships[Candidate.ShipIndex].Get();
+		if (!IsValid(CandidateShip) || !ShipPawn->IsHostileTo(CandidateShip)) continue;
+
+		const float Score = Candidate.Advantage - FVector::Distance(Location, CandidateShip->GetActorLocation()) / DistanceScale;
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestTarget = CandidateShip;
+		}
+	}
+
+	return BestTarget;
+}
+
+bool UShipInfluenceSubsystem::ShouldRetreat(const AShipPawn* ShipPawn, FVector& OutRetreatLocation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InfluenceDecisions);
+	FScopedDurationTimer DecisionTimer(TotalDecisionSeconds);
+	++NumDecisions;
+
+	if (!IsReady() || !IsValid(ShipPawn) || ShipPawn->TeamId >= FInfluenceMap::MaxTeams) return false;
+
+	const UHealthComponent* HealthComponent = ShipPawn->GetHealthComponent();
+	if (HealthComponent->GetHealth() >= HealthComponent->GetDefaultHealth() * CVarInfluenceRetreatHealth.GetValueOnGameThread()) return false;
+
+	const FInfluenceMap& Map = Snapshot->Map;
+	const FVector Location = ShipPawn->GetActorLocation();
+	const float Advantage = ShipInfluence::GetAdvantage(Map, Location, ShipPawn->TeamId);
+	if (Advantage > -CVarInfluenceRetreatAdvantage.GetValueOnGameThread()) return false;
+
+	// Safest of the 26 neighbouring directions, two cells out
+	const float RetreatDistance = Map.GetCellSize() * 2.0f;
+	float BestAdvantage = Advantage;
+
+	for (int32 Z = -1; Z <= 1; ++Z)
+	{
+		for (int32 Y = -1; Y <= 1; ++Y)
+		{
+			for (int32 X = -1; X <= 1; ++X)
+			{
+				if (X == 0 && Y == 0 && Z == 0) continue;
+
+				const FVector Candidate = Location + FVector(X, Y, Z).GetSafeNormal() * RetreatDistance;
+				const float CandidateAdvantage = ShipInfluence::GetAdvantage(Map, Candidate, ShipPawn->TeamId);
+				if (CandidateAdvantage > BestAdvantage)
+				{
+					BestAdvantage = CandidateAdvantage;
+					OutRetreatLocation = Candidate;
+				}
+			}
+		}
+	}
+
+	return BestAdvantage > Advantage;
+}
+
+bool UShipInfluenceSubsystem::FindFlankLocation(const AShipPawn* ShipPawn, const FVector& TargetLocation, FVector& OutFlankLocation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InfluenceDecisions);
+	FScopedDurationTimer DecisionTimer(TotalDecisionSeconds);
+	++NumDecisions;
+
+	if (!IsReady() || !IsValid(ShipPawn) || ShipPawn->TeamId >= FInfluenceMap::MaxTeams) return false;
+
+	const FVector ToTarget = TargetLocation - ShipPawn->GetActorLocation();
+	const float FlankDistance = ShipPawn->PrimaryFireRange;
+	if (ToTarget.SizeSquared() <= FMath::Square(FlankDistance)) return false;
+
+	const FVector Direction = ToTarget.GetSafeNormal();
+	FVector Right, Up;
+	Direction.FindBestAxisVectors(Right, Up);
+
+	float Friendly, DirectHostile;
+	Snapshot->Map.Sample(TargetLocation - Direction * FlankDistance, ShipPawn->TeamId, Friendly, DirectHostile);
+
+	// Only worth the detour when a side is clearly less defended than the direct approach
+	float BestHostile = DirectHostile * 0.7f;
+	bool bFoundFlank = false;
+
+	for (const FVector& Side : { Right, -Right, Up, -Up })
+	{
+		const FVector Candidate = TargetLocation + Side * FlankDistance;
+
+		float Hostile;
+		Snapshot->Map.Sample(Candidate, ShipPawn->TeamId, Friendly, Hostile);
+		if (Hostile < BestHostile)
+		{
+			BestHostile = Hostile;
+			OutFlankLocation = Candidate;
+			bFoundFlank = true;
+		}
+	}
+
+	return bFoundFlank;
+}
+
+void UShipInfluenceSubsystem::LogReport() const
+{
+	const double ElapsedSeconds = NumUpdates > 0 ? FMath::Max(GetWorld()->GetTimeSeconds() - FirstUpdateTime, UE_DOUBLE_KINDA_SMALL_NUMBER) : 1.0;
+	const FInfluenceMap* Map = Snapshot.IsValid() ? &Snapshot->Map : nullptr;
+
+	UE_LOG(LogShipInfluence, Log, TEXT("ShipInfluence: %d cells, %d sources, %.1f KB. %d updates, %.0f cells updated per second, %.3fms per update on the worker"),
+		Map ? Map->GetNumCells() : 0, Map ? Map->GetNumSources() : 0, Map ? Map->GetAllocatedSize() / 1024.0f : 0.0f,
+		NumUpdates, TotalCellWrites / ElapsedSeconds, NumUpdates > 0 ? TotalUpdateSeconds * 1000.0 / NumUpdates : 0.0);
+	UE_LOG(LogShipInfluence, Log, TEXT("ShipInfluence: %d AI decisions, %.4fms average, %.3fms per second"),
+		NumDecisions, NumDecisions > 0 ? TotalDecisionSeconds * 1000.0 / NumDecisions : 0.0, TotalDecisionSeconds * 1000.0 / ElapsedSeconds);
+}
@@ -0,0 +1,146 @@
+#include "Subsystems/ShipMemoryBudgetSubsystem.h"
+#include "GalacticArmada.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipMemory, Log, All)
+
+static TAutoConsoleVariable<float> CVarMemoryBudgetShips(
+	TEXT("ga.Memory.Budget.Ships"),
+	256.0f,
+	TEXT("Megabytes the Ships LLM tag may use before a warning, 0 has no budget. Set per platform in [ConsoleVariables]."));
+
+static TAutoConsoleVariable<float> CVarMemoryBudgetCannons(
+	TEXT("ga.Memory.Budget.Cannons"),
+	16.0f,
+	TEXT("Megabytes the Cannons LLM tag may use before a warning, 0 has no budget."));
+
+static TAutoConsoleVariable<float> CVarMemoryBudgetProjectiles(
+	TEXT("ga.Memory.Budget.Projectiles"),
+	128.0f,
+	TEXT("Megabytes the Projectiles LLM tag may use before a warning, 0 has no budget."));
+
+static TAutoConsoleVariable<float> CVarMemoryBudgetFX(
+	TEXT("ga.Memory.Budget.FX"),
+	192.0f,
+	TEXT("Megabytes the FX LLM tag may use before a warning, 0 has no budget."));
+
+static TAutoConsoleVariable<float> CVarMemoryBudgetAI(
+	TEXT("ga.Memory.Budget.AI"),
+	64.0f,
+	TEXT("Megabytes the AI LLM tag may use before a warning, 0 has no budget."));
+
+static TAutoConsoleVariable<float> CVarMemoryBudgetHealth(
+	TEXT("ga.Memory.Budget.Health"),
+	16.0f,
+	TEXT("Megabytes the Health LLM tag may use before a warning, 0 has no budget."));
+
+static FAutoConsoleCommandWithWorld MemoryDumpCommand(
+	TEXT("ga.Memory.Dump"),
+	TEXT("Logs current and peak memory of every GalacticArmada LLM tag against its budget. Needs -llm."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipMemoryBudgetSubsystem* MemoryBudgetSubsystem = World ? World->GetSubsystem<UShipMemoryBudgetSubsystem>() : nullptr)
+		{
+			MemoryBudgetSubsystem->LogReport();
+		}
+	}));
+
+bool UShipMemoryBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipMemoryBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipMemoryBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UShipMemoryBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	auto AddBudget = [this](FName TagName, const TCHAR* DisplayName, TAutoConsoleVariable<float>& BudgetVariable, bool bPerShip)
+	{
+		FShipMemoryBudget& Budget = Budgets.AddDefaulted_GetRef();
+		Budget.TagName = TagName;
+		Budget.DisplayName = DisplayName;
+		Budget.BudgetVariable = BudgetVariable.AsVariable();
+		Budget.bPerShip = bPerShip;
+	};
+
+	AddBudget(LLM_TAG_NAME(GalacticArmada_Ships), TEXT("Ships"), CVarMemoryBudgetShips, true);
+	AddBudget(LLM_TAG_NAME(GalacticArmada_Cannons), TEXT("Cannons"), CVarMemoryBudgetCannons, true);
+	AddBudget(LLM_TAG_NAME(GalacticArmada_Projectiles), TEXT("Projectiles"), CVarMemoryBudgetProjectiles, false);
+	AddBudget(LLM_TAG_NAME(GalacticArmada_FX), TEXT("FX"), CVarMemoryBudgetFX, true);
+	AddBudget(LLM_TAG_NAME(GalacticArmada_AI), TEXT("AI"), CVarMemoryBudgetAI, true);
+	AddBudget(LLM_TAG_NAME(GalacticArmada_Health), TEXT("Health"), CVarMemoryBudgetHealth, true);
+#endif
+}
+
+void UShipMemoryBudgetSubsystem::Tick(float DeltaTime)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (!FLowLevelMemTracker::IsEnabled()) return;
+
+	FLowLevelMemTracker& MemTracker = FLowLevelMemTracker::Get();
+	int64 PerShipBytes = 0;
+	for (FShipMemoryBudget& Budget : Budgets)
+	{
+		Budget.CurrentBytes = MemTracker.GetTagAmountForTracker(ELLMTracker::Default, Budget.TagName, ELLMTagSet::None);
+		Budget.PeakBytes = FMath::Max(Budget.PeakBytes, Budget.CurrentBytes);
+		PerShipBytes += Budget.bPerShip ? Budget.CurrentBytes : 0;
+
+		// Warn once per crossing, a tag hovering at its budget does not flood the log
+		const int64 BudgetBytes = static_cast<int64>(Budget.BudgetVariable->GetFloat() * 1024.0 * 1024.0);
+		const bool bOverBudget = BudgetBytes > 0 && Budget.CurrentBytes > BudgetBytes;
+		if (bOverBudget && !Budget.bOverBudget)
+		{
+			++Budget.NumBreaches;
+			UE_LOG(LogShipMemory, Warning, TEXT("ShipMemory: %s is over budget, %.1fMB of %.1fMB"),
+				Budget.DisplayName, Budget.CurrentBytes / (1024.0 * 1024.0), BudgetBytes / (1024.0 * 1024.0));
+		}
+		Budget.bOverBudget = bOverBudget;
+	}
+
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	const int32 NumShips = ShipRegistry ? ShipRegistry->GetShips().Num() : 0;
+	if (NumShips > PeakNumShips)
+	{
+		PeakNumShips = NumShips;
+		PerShipBytesAtPeak = PerShipBytes;
+	}
+#endif
+}
+
+void UShipMemoryBudgetSubsystem::LogReport() const
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		UE_LOG(LogShipMemory, Log, TEXT("ShipMemory: The low level memory tracker is off, run with -llm"));
+		return;
+	}
+
+	for (const FShipMemoryBudget& Budget : Budgets)
+	{
+		const double BudgetMB = Budget.BudgetVariable->GetFloat();
+		const double PeakMB = Budget.PeakBytes / (1024.0 * 1024.0);
+		UE_LOG(LogShipMemory, Log, TEXT("ShipMemory: %-12s current %8.2fMB, peak %8.2fMB, budget %8.2fMB, %d breaches"),
+			Budget.DisplayName, Budget.CurrentBytes / (1024.0 * 1024.0), PeakMB, BudgetMB, Budget.NumBreaches);
+
+		if (BudgetMB > 0.0 && PeakMB > BudgetMB)
+		{
+			UE_LOG(LogShipMemory, Warning, TEXT("ShipMemory: %s peaked %.1fMB over its budget"), Budget.DisplayName, PeakMB - BudgetMB);
+		}
+	}
+
+	// Ships, cannons, FX, AI and health at the busiest frame, the figure to hold against the other build target
+	UE_LOG(LogShipMemory, Log, TEXT("ShipMemory: %s target, %.1fKB per ship with %d ships"),
+		GalacticArmada::GetTargetName(), PeakNumShips > 0 ? PerShipBytesAtPeak / (1024.0 * PeakNumShips) : 0.0, PeakNumShips);
+#else
+	UE_LOG(LogShipMemory, Log, TEXT("ShipMemory: The low level memory tracker is not compiled into this build"));
+#endif
+}
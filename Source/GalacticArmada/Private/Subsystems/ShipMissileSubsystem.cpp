@@ -0,0 +1,419 @@
+#include "Subsystems/ShipMissileSubsystem.h"
+#include "GalacticArmada.h"
+#include "Actors/GuidedMissile.h"
+#include "Async/ParallelFor.h"
+#include "Controllers/ShipAIController.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipGunnerySubsystem.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipMissile, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Missile Guidance"), STAT_MissileGuidance, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Guided Missiles"), STAT_GuidedMissiles, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<int32> CVarMissileMaxLocksPerTarget(
+	TEXT("ga.Missile.MaxLocksPerTarget"),
+	4,
+	TEXT("Missiles that may be locked onto one ship at a time, later missiles look for another target. 0 is unlimited."));
+
+static TAutoConsoleVariable<bool> CVarMissileUsePool(
+	TEXT("ga.Missile.UsePool"),
+	true,
+	TEXT("Spent missiles wait hidden for the next launch instead of being destroyed."));
+
+static TAutoConsoleVariable<int32> CVarMissileParallelThreshold(
+	TEXT("ga.Missile.ParallelThreshold"),
+	256,
+	TEXT("Live missiles from which guidance runs on worker threads."));
+
+static TAutoConsoleVariable<FString> CVarMissileDefaultClass(
+	TEXT("ga.Missile.DefaultClass"),
+	TEXT("/Script/GalacticArmada.GuidedMissile"),
+	TEXT("Missile class launched by ga.Missile.Benchmark when none is given."));
+
+static FAutoConsoleCommandWithWorldAndArgs MissileBenchmarkCommand(
+	TEXT("ga.Missile.Benchmark"),
+	TEXT("Launches missiles from random ships at random other ships, see ga.Missile.Report for guidance cost. Set ga.Missile.MaxLocksPerTarget 0 to guide them all: ga.Missile.Benchmark [Count] [MissileClassPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UShipMissileSubsystem* MissileSubsystem = World ? World->GetSubsystem<UShipMissileSubsystem>() : nullptr;
+		const UShipRegistrySubsystem* ShipRegistry = World ? World->GetSubsystem<UShipRegistrySubsystem>() : nullptr;
+		if (!MissileSubsystem || !ShipRegistry || ShipRegistry->GetShips().Num() < 2) return;
+
+		const int32 Count = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 2000;
+		const FString MissileClassPath = Args.IsValidIndex(1) ? Args[1] : CVarMissileDefaultClass.GetValueOnGameThread();
+		UClass* MissileClass = TSoftClassPtr<AGuidedMissile>(FSoftObjectPath(MissileClassPath)).LoadSynchronous();
+		if (!MissileClass)
+		{
+			UE_LOG(LogShipMissile, Warning, TEXT("ShipMissile: No missile class %s"), *MissileClassPath);
+			return;
+		}
+
+		const TArray<AShipPawn*>& Ships = ShipRegistry->GetShips();
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			AShipPawn* Shooter = Ships[FMath::RandHelper(Ships.Num())];
+			AShipPawn* Target = Ships[FMath::RandHelper(Ships.Num())];
+			if (!IsValid(Shooter) || !IsValid(Target) || Shooter == Target) continue;
+
+			const FVector ToTarget = Target->GetActorLocation() - Shooter->GetActorLocation();
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.Owner = Shooter;
+			SpawnParams.Instigator = Shooter;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			MissileSubsystem->LaunchMissile(MissileClass, FTransform(ToTarget.Rotation(), Shooter->GetActorLocation() + ToTarget.GetSafeNormal() * 1000.0f), SpawnParams, Target);
+		}
+
+		UE_LOG(LogShipMissile, Log, TEXT("ShipMissile: Launched %d missiles in %.2fms, %d live"), Count, (FPlatformTime::Seconds() - StartTime) * 1000.0, MissileSubsystem->GetNumActiveMissiles());
+	}));
+
+static FAutoConsoleCommandWithWorld MissileReportCommand(
+	TEXT("ga.Missile.Report"),
+	TEXT("Logs missiles launched, pool reuse, denied locks and guidance time."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipMissileSubsystem* MissileSubsystem = World ? World->GetSubsystem<UShipMissileSubsystem>() : nullptr)
+		{
+			MissileSubsystem->LogReport();
+		}
+	}));
+
+bool UShipMissileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipMissileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipMissileSubsystem, STATGROUP_Tickables);
+}
+
+void UShipMissileSubsystem::Deinitialize()
+{
+	ActiveMissiles.Reset();
+	Pool.Reset();
+	LockCounts.Reset();
+
+	Super::Deinitialize();
+}
+
+AGuidedMissile* UShipMissileSubsystem::LaunchMissile(TSubclassOf<AGuidedMissile> MissileClass, const FTransform& LaunchTransform, const FActorSpawnParameters& SpawnParams, AShipPawn* Target)
+{
+	if (!MissileClass) return nullptr;
+
+	LLM_SCOPE_BYTAG(GalacticArmada_Projectiles);
+	AGuidedMissile* Missile = CVarMissileUsePool.GetValueOnGameThread() ? TakeFromPool(MissileClass) : nullptr;
+	if (Missile)
+	{
+		// A pooled missile only needs moving, waking up and pointing the way it was fired
+		Missile->SetOwner(SpawnParams.Owner);
+		Missile->SetInstigator(SpawnParams.Instigator);
+		Missile->SetActorTransform(LaunchTransform, false, nullptr, ETeleportType::ResetPhysics);
+		Missile->SetActorHiddenInGame(false);
+		Missile->SetActorEnableCollision(true);
+
+		UProjectileMovementComponent* MovementComponent = Missile->GetProjectileMovementComponent();
+		MovementComponent->SetUpdatedComponent(Missile->GetRootComponent());
+		MovementComponent->Velocity = LaunchTransform.GetRotation().GetForwardVector() * MovementComponent->InitialSpeed;
+		MovementComponent->Activate(true);
+		++NumFromPool;
+	}
+	else
+	{
+		Missile = GetWorld()->SpawnActor<AGuidedMissile>(MissileClass, LaunchTransform, SpawnParams);
+		if (!Missile) return nullptr;
+	}
+
+	Missile->FlightAge = 0.0f;
+	Missile->ActiveIndex = ActiveMissiles.Add(Missile);
+	SetLock(Missile, FindLockTarget(Missile, Target));
+
+	++NumLaunched;
+	PeakActiveMissiles = FMath::Max(PeakActiveMissiles, ActiveMissiles.Num());
+	return Missile;
+}
+
+void UShipMissileSubsystem::ReleaseMissile(AGuidedMissile* Missile)
+{
+	if (!Missile || !ActiveMissiles.IsValidIndex(Missile->ActiveIndex) || ActiveMissiles[Missile->ActiveIndex] != Missile) return;
+
+	SetLock(Missile, nullptr);
+
+	const int32 Index = Missile->ActiveIndex;
+	ActiveMissiles.RemoveAtSwap(Index, 1, false);
+	if (ActiveMissiles.IsValidIndex(Index) && ActiveMissiles[Index])
+	{
+		ActiveMissiles[Index]->ActiveIndex = Index;
+	}
+	Missile->ActiveIndex = INDEX_NONE;
+
+	if (!CVarMissileUsePool.GetValueOnGameThread() || !IsValid(Missile))
+	{
+		Missile->Destroy();
+		return;
+	}
+
+	UProjectileMovementComponent* MovementComponent = Missile->GetProjectileMovementComponent();
+	MovementComponent->StopMovementImmediately();
+	MovementComponent->Deactivate();
+	Missile->SetActorEnableCollision(false);
+	Missile->SetActorHiddenInGame(true);
+	Pool.FindOrAdd(Missile->GetClass()).Add(Missile);
+}
+
+AGuidedMissile* UShipMissileSubsystem::TakeFromPool(UClass* MissileClass)
+{
+	TArray<TWeakObjectPtr<AGuidedMissile>>* PooledMissiles = Pool.Find(MissileClass);
+	while (PooledMissiles && PooledMissiles->Num() > 0)
+	{
+		if (AGuidedMissile* Missile = PooledMissiles->Pop(false).Get())
+		{
+			return Missile;
+		}
+	}
+	return nullptr;
+}
+
+int32 UShipMissileSubsystem::GetNumLocks(const AShipPawn* Target) const
+{
+	const int32* NumLocks = LockCounts.Find(Target);
+	return NumLocks ? *NumLocks : 0;
+}
+
+bool UShipMissileSubsystem::CanLock(const AGuidedMissile* Missile, const AShipPawn* Target) const
+{
+	if (!IsValid(Target) || Target->IsDormant() || Target == Missile->GetInstigator()) return false;
+
+	const int32 MaxLocksPerTarget = CVarMissileMaxLocksPerTarget.GetValueOnGameThread();
+	if (MaxLocksPerTarget > 0 && GetNumLocks(Target) >= MaxLocksPerTarget) return false;
+
+	const FVector ToTarget = Target->GetActorLocation() - Missile->GetActorLocation();
+	const double Distance = ToTarget.Size();
+	if (Distance > Missile->LockOnRange) return false;
+
+	return (Missile->GetActorForwardVector() | ToTarget) >= FMath::Cos(FMath::DegreesToRadians(Missile->SeekerHalfAngle)) * Distance;
+}
+
+AShipPawn* UShipMissileSubsystem::FindLockTarget(const AGuidedMissile* Missile, AShipPawn* PreferredTarget) const
+{
+	if (CanLock(Missile, PreferredTarget)) return PreferredTarget;
+
+	// AI shooters lock the ship they are fighting
+	const AShipPawn* Shooter = Cast<AShipPawn>(Missile->GetInstigator());
+	const AShipAIController* ShipAIController = Shooter ? Cast<AShipAIController>(Shooter->GetController()) : nullptr;
+	if (AShipPawn* AITarget = ShipAIController ? ShipAIController->GetTargetShipPawn() : nullptr)
+	{
+		if (CanLock(Missile, AITarget)) return AITarget;
+	}
+
+	// Otherwise the ship nearest the aim, players may lock any ship they point at
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (!ShipRegistry || !Shooter) return nullptr;
+
+	AShipPawn* BestTarget = nullptr;
+	double BestScore = TNumericLimits<double>::Max();
+	const FVector Location = Missile->GetActorLocation();
+	const FVector Forward = Missile->GetActorForwardVector();
+
+	for (AShipPawn* Candidate : ShipRegistry->GetShips())
+	{
+		if (!IsValid(Candidate) || (!Shooter->IsHostileTo(Candidate) && !Shooter->IsPlayerControlled())) continue;
+		if (!CanLock(Missile, Candidate)) continue;
+
+		// Favour ships near the centre of the seeker over merely close ones
+		const FVector ToCandidate = Candidate->GetActorLocation() - Location;
+		const double Distance = ToCandidate.Size();
+		const double Score = Distance * (2.0 - (Forward | ToCandidate) / FMath::Max(Distance, 1.0));
+		if (Score < BestScore)
+		{
+			BestScore = Score;
+			BestTarget = Candidate;
+		}
+	}
+
+	if (!BestTarget)
+	{
+		++const_cast<UShipMissileSubsystem*>(this)->NumLocksDenied;
+	}
+	return BestTarget;
+}
+
+void UShipMissileSubsystem::SetLock(AGuidedMissile* Missile, AShipPawn* Target)
+{
+	if (const AShipPawn* PreviousTarget = Missile->LockedTarget.Get())
+	{
+		if (int32* NumLocks = LockCounts.Find(PreviousTarget))
+		{
+			if (--(*NumLocks) <= 0)
+			{
+				LockCounts.Remove(PreviousTarget);
+			}
+		}
+	}
+
+	Missile->LockedTarget = Target;
+	if (Target)
+	{
+		++LockCounts.FindOrAdd(Target);
+	}
+}
+
+void UShipMissileSubsystem::Tick(float DeltaTime)
+{
+	// Missiles destroyed by someone else, level streaming or the world ending, leave the batch
+	for (int32 Index = ActiveMissiles.Num() - 1; Index >= 0; --Index)
+	{
+		AGuidedMissile* Missile = ActiveMissiles[Index];
+		if (IsValid(Missile)) continue;
+
+		if (Missile)
+		{
+			SetLock(Missile, nullptr);
+			Missile->ActiveIndex = INDEX_NONE;
+		}
+		ActiveMissiles.RemoveAtSwap(Index, 1, false);
+		if (ActiveMissiles.IsValidIndex(Index))
+		{
+			ActiveMissiles[Index]->ActiveIndex = Index;
+		}
+	}
+
+	for (auto LockIterator = LockCounts.CreateIterator(); LockIterator; ++LockIterator)
+	{
+		if (!LockIterator->Key.IsValid())
+		{
+			LockIterator.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GuidedMissiles, ActiveMissiles.Num());
+	if (ActiveMissiles.Num() == 0 || DeltaTime <= 0.0f) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_MissileGuidance);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, MissileGuidance);
+
+	const double StartTime = FPlatformTime::Seconds();
+	UpdateGuidance(DeltaTime);
+
+	++NumGuidanceFrames;
+	TotalGuidedMissiles += ActiveMissiles.Num();
+	TotalGuidanceSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void UShipMissileSubsystem::UpdateGuidance(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_Projectiles);
+	const UShipGunnerySubsystem* GunnerySubsystem = GetWorld()->GetSubsystem<UShipGunnerySubsystem>();
+	const int32 NumMissiles = ActiveMissiles.Num();
+
+	MissileLocations.SetNum(NumMissiles, false);
+	MissileVelocities.SetNum(NumMissiles, false);
+	MissileGuidance.SetNum(NumMissiles, false);
+	MissileTargets.SetNum(NumMissiles, false);
+	NewVelocities.SetNum(NumMissiles, false);
+	LostLocks.SetNum(NumMissiles, false);
+	TargetLocations.Reset();
+	TargetVelocities.Reset();
+	TargetSlots.Reset();
+	ExpiredMissiles.Reset();
+
+	// Gather missile state, and each target's motion once however many missiles chase it
+	for (int32 MissileIndex = 0; MissileIndex < NumMissiles; ++MissileIndex)
+	{
+		AGuidedMissile* Missile = ActiveMissiles[MissileIndex];
+		Missile->FlightAge += DeltaTime;
+		if (Missile->FlightAge >= Missile->FlightTime)
+		{
+			ExpiredMissiles.Add(Missile);
+		}
+
+		MissileLocations[MissileIndex] = Missile->GetActorLocation();
+		MissileVelocities[MissileIndex] = Missile->GetProjectileMovementComponent()->Velocity;
+		MissileGuidance[MissileIndex] = FVector3f(Missile->NavigationConstant, Missile->MaxAcceleration, FMath::Cos(FMath::DegreesToRadians(Missile->SeekerHalfAngle)));
+		MissileTargets[MissileIndex] = INDEX_NONE;
+
+		const AShipPawn* Target = Missile->LockedTarget.Get();
+		if (!Target || Target->IsDormant()) continue;
+
+		if (const int32* TargetSlot = TargetSlots.Find(Target))
+		{
+			MissileTargets[MissileIndex] = *TargetSlot;
+			continue;
+		}
+
+		FVector TargetLocation;
+		FVector TargetVelocity;
+		if (!GunnerySubsystem || !GunnerySubsystem->GetShipMotion(Target, TargetLocation, TargetVelocity))
+		{
+			TargetLocation = Target->GetActorLocation();
+			TargetVelocity = Target->GetVelocity();
+		}
+
+		MissileTargets[MissileIndex] = TargetLocations.Add(TargetLocation);
+		TargetVelocities.Add(TargetVelocity);
+		TargetSlots.Add(Target, MissileTargets[MissileIndex]);
+	}
+
+	// Proportional navigation: turn with the line of sight rotation rate scaled by the navigation constant
+	const bool bParallel = NumMissiles >= CVarMissileParallelThreshold.GetValueOnGameThread();
+	ParallelFor(NumMissiles, [this, DeltaTime](int32 MissileIndex)
+	{
+		const FVector& MissileVelocity = MissileVelocities[MissileIndex];
+		const int32 TargetIndex = MissileTargets[MissileIndex];
+		NewVelocities[MissileIndex] = MissileVelocity;
+		LostLocks[MissileIndex] = 0;
+		if (TargetIndex == INDEX_NONE) return;
+
+		const double Speed = MissileVelocity.Size();
+		const FVector LineOfSight = TargetLocations[TargetIndex] - MissileLocations[MissileIndex];
+		const double DistanceSquared = LineOfSight.SizeSquared();
+		if (Speed < UE_KINDA_SMALL_NUMBER || DistanceSquared < UE_KINDA_SMALL_NUMBER) return;
+
+		const FVector3f& Guidance = MissileGuidance[MissileIndex];
+		if ((MissileVelocity | LineOfSight) < Guidance.Z * Speed * FMath::Sqrt(DistanceSquared))
+		{
+			LostLocks[MissileIndex] = 1;
+			return;
+		}
+
+		const FVector LineOfSightRate = (LineOfSight ^ (TargetVelocities[TargetIndex] - MissileVelocity)) / DistanceSquared;
+		const FVector Acceleration = (Guidance.X * (LineOfSightRate ^ MissileVelocity)).GetClampedToMaxSize(Guidance.Y);
+		NewVelocities[MissileIndex] = (MissileVelocity + Acceleration * DeltaTime).GetSafeNormal() * Speed;
+	}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	for (int32 MissileIndex = 0; MissileIndex < NumMissiles; ++MissileIndex)
+	{
+		if (MissileTargets[MissileIndex] == INDEX_NONE) continue;
+
+		AGuidedMissile* Missile = ActiveMissiles[MissileIndex];
+		Missile->GetProjectileMovementComponent()->Velocity = NewVelocities[MissileIndex];
+		if (LostLocks[MissileIndex])
+		{
+			SetLock(Missile, nullptr);
+		}
+	}
+
+	for (AGuidedMissile* Missile : ExpiredMissiles)
+	{
+		ReleaseMissile(Missile);
+	}
+}
+
+void UShipMissileSubsystem::LogReport() const
+{
+	int32 NumPooled = 0;
+	for (const TPair<UClass*, TArray<TWeakObjectPtr<AGuidedMissile>>>& PoolPair : Pool)
+	{
+		NumPooled += PoolPair.Value.Num();
+	}
+
+	UE_LOG(LogShipMissile, Log, TEXT("ShipMissile: %d launched (%d from the pool), %d launches without a lock, %d live, peak %d, %d pooled. Guidance %.3fms per frame, %.1fns per missile"),
+		NumLaunched, NumFromPool, NumLocksDenied, ActiveMissiles.Num(), PeakActiveMissiles, NumPooled,
+		NumGuidanceFrames > 0 ? TotalGuidanceSeconds * 1000.0 / NumGuidanceFrames : 0.0,
+		TotalGuidedMissiles > 0 ? TotalGuidanceSeconds * 1000000000.0 / TotalGuidedMissiles : 0.0);
+}
@@ -0,0 +1,305 @@
+#include "Subsystems/ShipNavigationSubsystem.h"
+#include "GalacticArmada.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Navigation/SparseVoxelOctree.h"
+#include "Navigation/StaticObstacleGatherer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipNavigation, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Path Query"), STAT_ShipPathQuery, STATGROUP_GalacticArmada);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ship Nav Memory"), STAT_ShipNavMemory, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarShipNavEnable(
+	TEXT("ga.Nav.Enable"),
+	true,
+	TEXT("Build 3D navigation around static geometry at level start."));
+
+static TAutoConsoleVariable<float> CVarShipNavVoxelSize(
+	TEXT("ga.Nav.VoxelSize"),
+	2000.0f,
+	TEXT("Smallest voxel edge of the navigation octree."));
+
+static TAutoConsoleVariable<float> CVarShipNavAgentRadius(
+	TEXT("ga.Nav.AgentRadius"),
+	1500.0f,
+	TEXT("Clearance kept between paths and static geometry."));
+
+static TAutoConsoleVariable<float> CVarShipNavPathCacheTime(
+	TEXT("ga.Nav.PathCacheTime"),
+	10.0f,
+	TEXT("Seconds a cached path between two octree leaves stays valid."));
+
+static TAutoConsoleVariable<int32> CVarShipNavMaxCachedPaths(
+	TEXT("ga.Nav.MaxCachedPaths"),
+	1024,
+	TEXT("Cached paths kept before stale entries are evicted."));
+
+static FAutoConsoleCommandWithWorld ShipNavReportCommand(
+	TEXT("ga.Nav.Report"),
+	TEXT("Logs navigation build time, memory footprint and path query latency."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipNavigationSubsystem* NavigationSubsystem = World ? World->GetSubsystem<UShipNavigationSubsystem>() : nullptr)
+		{
+			NavigationSubsystem->LogReport();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld ShipNavRebuildCommand(
+	TEXT("ga.Nav.Rebuild"),
+	TEXT("Rebuilds navigation from the level, ignoring the baked file."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UShipNavigationSubsystem* NavigationSubsystem = World ? World->GetSubsystem<UShipNavigationSubsystem>() : nullptr)
+		{
+			NavigationSubsystem->BuildNavigation(true);
+		}
+	}));
+
+namespace ShipNavigation
+{
+	static const uint32 FileMagic = 0x56414E47; // 'GNAV'
+	static const int32 FileVersion = 1;
+
+	static bool LoadOctree(const FString& FilePath, uint32 ObstacleHash, const FSparseVoxelOctreeSettings& Settings, FSparseVoxelOctree& OutOctree)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+		if (!Reader) return false;
+
+		uint32 Magic = 0;
+		int32 Version = 0;
+		uint32 Hash = 0;
+		*Reader << Magic << Version << Hash;
+		if (Magic != FileMagic || Version != FileVersion || Hash != ObstacleHash) return false;
+
+		OutOctree.Serialize(*Reader);
+		return !Reader->IsError() && OutOctree.IsValid() && OutOctree.GetSettings() == Settings;
+	}
+
+	static void SaveOctree(const FString& FilePath, uint32 ObstacleHash, FSparseVoxelOctree& Octree)
+	{
+		// Written to a private copy and swapped in whole, so no reader ever sees a half written file
+		const FString TempPath = FPaths::CreateTempFilename(*FPaths::GetPath(FilePath), *FPaths::GetBaseFilename(FilePath), TEXT(".tmp"));
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+		if (!Writer)
+		{
+			UE_LOG(LogShipNavigation, Warning, TEXT("ShipNavigation: Could not write %s"), *FilePath);
+			return;
+		}
+
+		uint32 Magic = FileMagic;
+		int32 Version = FileVersion;
+		*Writer << Magic << Version << ObstacleHash;
+		Octree.Serialize(*Writer);
+		const bool bWritten = Writer->Close();
+		Writer.Reset();
+
+		if (!bWritten || !IFileManager::Get().Move(*FilePath, *TempPath))
+		{
+			IFileManager::Get().Delete(*TempPath);
+			UE_LOG(LogShipNavigation, Warning, TEXT("ShipNavigation: Could not write %s"), *FilePath);
+		}
+	}
+}
+
+bool UShipNavigationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShipNavigationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	BuildNavigation();
+}
+
+void UShipNavigationSubsystem::Deinitialize()
+{
+	Octree.Reset();
+	PathCache.Reset();
+	SET_DWORD_STAT(STAT_ShipNavMemory, 0);
+
+	Super::Deinitialize();
+}
+
+FString UShipNavigationSubsystem::GetNavigationFilePath() const
+{
+	const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Navigation"), MapName + TEXT(".shipnav"));
+}
+
+void UShipNavigationSubsystem::BuildNavigation(bool bForceRebuild)
+{
+	if (bBuildInProgress || !CVarShipNavEnable.GetValueOnGameThread()) return;
+
+	// Gathering touches components so it stays on the game thread, the octree itself is built on a worker
+	TSharedRef<FStaticObstacleSet> Obstacles = MakeShared<FStaticObstacleSet>();
+	StaticObstacles::Gather(GetWorld(), *Obstacles);
+	if (Obstacles->Boxes.Num() == 0)
+	{
+		UE_LOG(LogShipNavigation, Log, TEXT("ShipNavigation: No static obstacles in %s, ships steer straight."), *GetWorld()->GetMapName());
+		return;
+	}
+
+	FSparseVoxelOctreeSettings Settings;
+	Settings.VoxelSize = CVarShipNavVoxelSize.GetValueOnGameThread();
+	Settings.AgentRadius = CVarShipNavAgentRadius.GetValueOnGameThread();
+
+	bBuildInProgress = true;
+	const FString FilePath = GetNavigationFilePath();
+	TWeakObjectPtr<UShipNavigationSubsystem> WeakThis(this);
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Obstacles, Settings, FilePath, bForceRebuild]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		TSharedPtr<FSparseVoxelOctree> NewOctree = MakeShared<FSparseVoxelOctree>();
+		const bool bLoaded = !bForceRebuild && ShipNavigation::LoadOctree(FilePath, Obstacles->Hash, Settings, *NewOctree);
+		if (!bLoaded)
+		{
+			NewOctree->Build(Obstacles->Boxes, Settings);
+			ShipNavigation::SaveOctree(FilePath, Obstacles->Hash, *NewOctree);
+		}
+
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, NewOctree, Seconds, bLoaded]()
+		{
+			if (UShipNavigationSubsystem* NavigationSubsystem = WeakThis.Get())
+			{
+				NavigationSubsystem->OnBuildComplete(NewOctree, Seconds, bLoaded);
+			}
+		});
+	});
+}
+
+void UShipNavigationSubsystem::OnBuildComplete(TSharedPtr<const FSparseVoxelOctree> NewOctree, double Seconds, bool bLoaded)
+{
+	bBuildInProgress = false;
+	BuildSeconds = Seconds;
+	bLoadedFromDisk = bLoaded;
+	PathCache.Reset();
+	Octree = NewOctree->IsValid() ? NewOctree : TSharedPtr<const FSparseVoxelOctree>();
+
+	SET_DWORD_STAT(STAT_ShipNavMemory, Octree ? Octree->GetAllocatedSize() : 0);
+	LogReport();
+}
+
+bool UShipNavigationSubsystem::IsSegmentFree(const FVector& Start, const FVector& End) const
+{
+	return !Octree.IsValid() || Octree->IsSegmentFree(Start, End);
+}
+
+void UShipNavigationSubsystem::RequestPath(const FVector& Start, const FVector& Goal, TFunction<void(const TArray<FVector>&)> OnComplete)
+{
+	if (!Octree.IsValid())
+	{
+		OnComplete(TArray<FVector>());
+		return;
+	}
+
+	++NumQueries;
+	const int32 StartFreeIndex = Octree->FindFreeIndex(Octree->ClampToBounds(Start));
+	const int32 GoalFreeIndex = Octree->FindFreeIndex(Octree->ClampToBounds(Goal));
+	if (StartFreeIndex == INDEX_NONE || GoalFreeIndex == INDEX_NONE)
+	{
+		++NumFailedQueries;
+		OnComplete(TArray<FVector>());
+		return;
+	}
+
+	// Ships in the same region heading for the same region share one search
+	const uint64 CacheKey = ((uint64)(uint32)StartFreeIndex << 32) | (uint32)GoalFreeIndex;
+	if (const FCachedPath* CachedPath = PathCache.Find(CacheKey))
+	{
+		if (GetWorld()->GetTimeSeconds() - CachedPath->Time < CVarShipNavPathCacheTime.GetValueOnGameThread())
+		{
+			++NumCacheHits;
+			TArray<FVector> Waypoints = CachedPath->Waypoints;
+			if (CachedPath->bFound)
+			{
+				Waypoints.Add(Goal);
+			}
+			OnComplete(Waypoints);
+			return;
+		}
+	}
+
+	TWeakObjectPtr<UShipNavigationSubsystem> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, SearchOctree = Octree, Start, Goal, StartFreeIndex, GoalFreeIndex, CacheKey, OnComplete = MoveTemp(OnComplete)]() mutable
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ShipPathQuery);
+		const double StartTime = FPlatformTime::Seconds();
+
+		TArray<FVector> Waypoints;
+		if (SearchOctree->FindPath(StartFreeIndex, GoalFreeIndex, Waypoints))
+		{
+			// Leaf centres at either end are replaced by the real locations before smoothing
+			Waypoints[0] = Start;
+			Waypoints.Add(Goal);
+			SearchOctree->SmoothPath(Waypoints);
+			Waypoints.RemoveAt(0);
+		}
+
+		const double QuerySeconds = FPlatformTime::Seconds() - StartTime;
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Waypoints = MoveTemp(Waypoints), CacheKey, QuerySeconds, OnComplete = MoveTemp(OnComplete)]()
+		{
+			if (UShipNavigationSubsystem* NavigationSubsystem = WeakThis.Get())
+			{
+				NavigationSubsystem->OnPathComplete(CacheKey, Waypoints, QuerySeconds);
+			}
+			OnComplete(Waypoints);
+		});
+	});
+}
+
+void UShipNavigationSubsystem::OnPathComplete(uint64 CacheKey, const TArray<FVector>& Waypoints, double QuerySeconds)
+{
+	++NumSearches;
+	TotalQuerySeconds += QuerySeconds;
+	MaxQuerySeconds = FMath::Max(MaxQuerySeconds, QuerySeconds);
+	NumFailedQueries += Waypoints.Num() == 0 ? 1 : 0;
+	CSV_CUSTOM_STAT(GalacticArmada, ShipPathQueries, 1, ECsvCustomStatOp::Accumulate);
+
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	if (PathCache.Num() >= CVarShipNavMaxCachedPaths.GetValueOnGameThread())
+	{
+		const float PathCacheTime = CVarShipNavPathCacheTime.GetValueOnGameThread();
+		for (auto CacheIterator = PathCache.CreateIterator(); CacheIterator; ++CacheIterator)
+		{
+			if (CurrentTime - CacheIterator->Value.Time >= PathCacheTime)
+			{
+				CacheIterator.RemoveCurrent();
+			}
+		}
+	}
+
+	// The goal is stored separately by each request, only the route to it is shared
+	FCachedPath& CachedPath = PathCache.FindOrAdd(CacheKey);
+	CachedPath.Waypoints = Waypoints;
+	CachedPath.bFound = Waypoints.Num() > 0;
+	if (CachedPath.bFound)
+	{
+		CachedPath.Waypoints.Pop();
+	}
+	CachedPath.Time = CurrentTime;
+}
+
+void UShipNavigationSubsystem::LogReport() const
+{
+	const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	if (!Octree.IsValid())
+	{
+		UE_LOG(LogShipNavigation, Log, TEXT("ShipNavigation: %s has no navigation%s"), *MapName, bBuildInProgress ? TEXT(", build in progress") : TEXT(""));
+		return;
+	}
+
+	UE_LOG(LogShipNavigation, Log, TEXT("ShipNavigation: %s %s in %.1fms, %d nodes, %d free leaves, %.2f MB"),
+		*MapName, bLoadedFromDisk ? TEXT("loaded") : TEXT("built"), BuildSeconds * 1000.0,
+		Octree->GetNumNodes(), Octree->GetNumFreeLeaves(), Octree->GetAllocatedSize() / (1024.0 * 1024.0));
+	UE_LOG(LogShipNavigation, Log, TEXT("ShipNavigation: %d path queries, %d cache hits, %d failed, search %.3fms average, %.3fms worst"),
+		NumQueries, NumCacheHits, NumFailedQueries, NumSearches > 0 ? TotalQuerySeconds * 1000.0 / NumSearches : 0.0, MaxQuerySeconds * 1000.0);
+}
@@ -0,0 +1,88 @@
+#include "Subsystems/ShipRegistrySubsystem.h"
+#include "Components/HealthComponent.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipEventSubsystem.h"
+
+void UShipRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EventSubsystem = Collection.InitializeDependency<UShipEventSubsystem>();
+	if (EventSubsystem)
+	{
+		EventSubsystem->GetDeathChannel().Subscribe<&UShipRegistrySubsystem::HandleDeathEvents>(this);
+	}
+}
+
+void UShipRegistrySubsystem::Deinitialize()
+{
+	if (EventSubsystem)
+	{
+		EventSubsystem->GetDeathChannel().Unsubscribe(this);
+		EventSubsystem = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+void UShipRegistrySubsystem::RegisterShip(AShipPawn* ShipPawn)
+{
+	if (IsValid(ShipPawn))
+	{
+		Ships.AddUnique(ShipPawn);
+	}
+}
+
+void UShipRegistrySubsystem::UnregisterShip(AShipPawn* ShipPawn)
+{
+	Ships.RemoveSingleSwap(ShipPawn);
+}
+
+AShipPawn* UShipRegistrySubsystem::FindPlayerShip() const
+{
+	for (AShipPawn* ShipPawn : Ships)
+	{
+		if (IsValid(ShipPawn) && ShipPawn->IsPlayerControlled())
+		{
+			return ShipPawn;
+		}
+	}
+
+	return nullptr;
+}
+
+AShipPawn* UShipRegistrySubsystem::FindClosestHostileShip(const AShipPawn* ShipPawn) const
+{
+	if (!IsValid(ShipPawn)) return nullptr;
+
+	AShipPawn* ClosestShip = nullptr;
+	double MinDistanceSquared = TNumericLimits<double>::Max();
+	const FVector Location = ShipPawn->GetActorLocation();
+
+	for (AShipPawn* OtherShip : Ships)
+	{
+		if (!IsValid(OtherShip) || !ShipPawn->IsHostileTo(OtherShip)) continue;
+
+		const double DistanceSquared = FVector::DistSquared(Location, OtherShip->GetActorLocation());
+		if (DistanceSquared < MinDistanceSquared)
+		{
+			MinDistanceSquared = DistanceSquared;
+			ClosestShip = OtherShip;
+		}
+	}
+
+	return ClosestShip;
+}
+
+void UShipRegistrySubsystem::HandleDeathEvents(TConstArrayView<FShipDeathEvent> Events)
+{
+	for (const FShipDeathEvent& Event : Events)
+	{
+		const UHealthComponent* HealthComponent = Event.HealthComponent.Get();
+		AShipPawn* ShipPawn = HealthComponent ? Cast<AShipPawn>(HealthComponent->GetOwner()) : nullptr;
+		if (IsValid(ShipPawn))
+		{
+			ShipPawn->OnPawnDied(Event.InstigatedBy.Get(), Event.DamageCauser.Get());
+		}
+	}
+}
@@ -0,0 +1,291 @@
+#include "Subsystems/ShipRepresentationSubsystem.h"
+#include "GalacticArmada.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipRepresentation, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Representation Update"), STAT_ShipRepresentationUpdate, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proxy Ships"), STAT_ProxyShips, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Full Ships"), STAT_FullShips, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarShipProxyEnable(
+	TEXT("ga.ShipProxy.Enable"),
+	true,
+	TEXT("Swap distant AI ships to kinematic proxies."));
+
+static TAutoConsoleVariable<float> CVarShipProxyDistance(
+	TEXT("ga.ShipProxy.ProxyDistance"),
+	150000.0f,
+	TEXT("Distance from the closest view beyond which AI ships become proxies."));
+
+static TAutoConsoleVariable<float> CVarShipFullDistance(
+	TEXT("ga.ShipProxy.FullDistance"),
+	120000.0f,
+	TEXT("Distance from the closest view within which proxies turn back into full ships. Kept below ProxyDistance for hysteresis."));
+
+static TAutoConsoleVariable<bool> CVarShipProxyHeadless(
+	TEXT("ga.ShipProxy.Headless"),
+	false,
+	TEXT("Proxy AI ships when there is no player view at all. Off keeps headless runs on full ships with physics collisions."));
+
+static TAutoConsoleVariable<float> CVarShipProxyEvaluationInterval(
+	TEXT("ga.ShipProxy.EvaluationInterval"),
+	0.25f,
+	TEXT("Seconds between representation distance checks."));
+
+static FAutoConsoleCommandWithWorld ShipProxyReportCommand(
+	TEXT("ga.ShipProxy.Report"),
+	TEXT("Logs proxy counts, CPU time and memory per proxy."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipRepresentationSubsystem* RepresentationSubsystem = World ? World->GetSubsystem<UShipRepresentationSubsystem>() : nullptr)
+		{
+			RepresentationSubsystem->LogReport();
+		}
+	}));
+
+void UShipRepresentationSubsystem::Deinitialize()
+{
+	if (IsValid(ProxyRendererActor))
+	{
+		ProxyRendererActor->Destroy();
+	}
+	ProxyRendererActor = nullptr;
+	ProxyMeshComponents.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UShipRepresentationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipRepresentationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipRepresentationSubsystem, STATGROUP_Tickables);
+}
+
+void UShipRepresentationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShipRepresentationUpdate);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipRepresentation);
+	const double StartTime = FPlatformTime::Seconds();
+
+	TimeSinceEvaluation += DeltaTime;
+	if (TimeSinceEvaluation >= CVarShipProxyEvaluationInterval.GetValueOnGameThread())
+	{
+		TimeSinceEvaluation = 0.0f;
+		EvaluateRepresentations();
+	}
+
+	UpdateProxyInstances();
+
+	ProxyShipUpdates += NumProxyShips;
+	UpdateSecondsTotal += FPlatformTime::Seconds() - StartTime;
+	++UpdateCount;
+
+	SET_DWORD_STAT(STAT_ProxyShips, NumProxyShips);
+	SET_DWORD_STAT(STAT_FullShips, NumFullShips);
+	CSV_CUSTOM_STAT(GalacticArmada, ProxyShips, NumProxyShips, ECsvCustomStatOp::Set);
+}
+
+void UShipRepresentationSubsystem::EvaluateRepresentations()
+{
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (!ShipRegistry) return;
+
+	const bool bProxiesEnabled = CVarShipProxyEnable.GetValueOnGameThread();
+	const double ProxyDistanceSquared = FMath::Square(CVarShipProxyDistance.GetValueOnGameThread());
+	const double FullDistanceSquared = FMath::Square(CVarShipFullDistance.GetValueOnGameThread());
+
+	TFrameArray<FVector> ViewLocations;
+	GetViewLocations(ViewLocations);
+
+	// Headless runs measure the battle itself, proxies would drop its ship to ship collisions
+	const bool bHasViewOrHeadless = ViewLocations.Num() > 0 || CVarShipProxyHeadless.GetValueOnGameThread();
+
+	for (AShipPawn* ShipPawn : ShipRegistry->GetShips())
+	{
+		if (!IsValid(ShipPawn)) continue;
+
+		if (!bProxiesEnabled || !bHasViewOrHeadless || !ShipPawn->CanUseProxyRepresentation())
+		{
+			ShipPawn->SetRepresentation(EShipRepresentation::Full);
+			continue;
+		}
+
+		// Without any view (ga.ShipProxy.Headless) every AI ship becomes a proxy
+		double ClosestViewDistanceSquared = TNumericLimits<double>::Max();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ClosestViewDistanceSquared = FMath::Min(ClosestViewDistanceSquared, FVector::DistSquared(ViewLocation, ShipPawn->GetActorLocation()));
+		}
+
+		if (ShipPawn->GetRepresentation() == EShipRepresentation::Full && ClosestViewDistanceSquared > ProxyDistanceSquared)
+		{
+			ShipPawn->SetRepresentation(EShipRepresentation::Proxy);
+		}
+		else if (ShipPawn->GetRepresentation() == EShipRepresentation::Proxy && ClosestViewDistanceSquared < FullDistanceSquared)
+		{
+			ShipPawn->SetRepresentation(EShipRepresentation::Full);
+		}
+	}
+}
+
+void UShipRepresentationSubsystem::UpdateProxyInstances()
+{
+	const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>();
+	if (!ShipRegistry) return;
+
+	const bool bDrawProxies = GalacticArmada::ShouldPlayCosmetics(this);
+	NumProxyShips = 0;
+	NumFullShips = 0;
+
+	for (TPair<UStaticMesh*, TArray<FTransform>>& Pair : ProxyInstanceTransforms)
+	{
+		Pair.Value.Reset();
+	}
+
+	// Gather Proxy Transforms Per Mesh
+	for (const AShipPawn* ShipPawn : ShipRegistry->GetShips())
+	{
+		if (!IsValid(ShipPawn)) continue;
+
+		if (ShipPawn->GetRepresentation() != EShipRepresentation::Proxy)
+		{
+			++NumFullShips;
+			continue;
+		}
+
+		++NumProxyShips;
+		if (bDrawProxies && ShipPawn->GetProxyStaticMesh())
+		{
+			ProxyInstanceTransforms.FindOrAdd(ShipPawn->GetProxyStaticMesh()).Add(ShipPawn->GetActorTransform());
+		}
+	}
+
+	for (TPair<UStaticMesh*, TArray<FTransform>>& Pair : ExternalProxyTransforms)
+	{
+		if (bDrawProxies && Pair.Value.Num() > 0)
+		{
+			ProxyInstanceTransforms.FindOrAdd(Pair.Key).Append(Pair.Value);
+		}
+		Pair.Value.Reset();
+	}
+
+	// Push Them To The Instanced Meshes In One Batch Each
+	for (const TPair<UStaticMesh*, TArray<FTransform>>& Pair : ProxyInstanceTransforms)
+	{
+		UInstancedStaticMeshComponent* ProxyMeshComponent = FindOrCreateProxyMeshComponent(Pair.Key);
+		if (!ProxyMeshComponent) continue;
+
+		if (ProxyMeshComponent->GetInstanceCount() != Pair.Value.Num())
+		{
+			ProxyMeshComponent->ClearInstances();
+			ProxyMeshComponent->AddInstances(Pair.Value, false, true);
+		}
+		else if (Pair.Value.Num() > 0)
+		{
+			ProxyMeshComponent->BatchUpdateInstancesTransforms(0, Pair.Value, true, true, true);
+		}
+	}
+}
+
+void UShipRepresentationSubsystem::AddExternalProxyInstances(UStaticMesh* StaticMesh, TConstArrayView<FTransform> Transforms)
+{
+	if (!StaticMesh || Transforms.Num() == 0) return;
+	ExternalProxyTransforms.FindOrAdd(StaticMesh).Append(Transforms.GetData(), Transforms.Num());
+}
+
+void UShipRepresentationSubsystem::GetViewLocations(TFrameArray<FVector>& OutViewLocations) const
+{
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (!PlayerController || !PlayerController->GetPawn()) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		OutViewLocations.Add(ViewLocation);
+	}
+}
+
+UInstancedStaticMeshComponent* UShipRepresentationSubsystem::FindOrCreateProxyMeshComponent(UStaticMesh* StaticMesh)
+{
+	if (UInstancedStaticMeshComponent** ExistingComponent = ProxyMeshComponents.Find(StaticMesh))
+	{
+		return *ExistingComponent;
+	}
+
+	if (!IsValid(ProxyRendererActor))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.Name = TEXT("ShipProxyRenderer");
+		SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+		ProxyRendererActor = GetWorld()->SpawnActor<AActor>(SpawnParams);
+		if (!ProxyRendererActor) return nullptr;
+		ProxyRendererActor->SetRootComponent(NewObject<USceneComponent>(ProxyRendererActor, TEXT("Root")));
+		ProxyRendererActor->GetRootComponent()->RegisterComponent();
+	}
+
+	// Proxies are drawn only, gameplay collision lives on each ship's proxy sphere
+	UInstancedStaticMeshComponent* ProxyMeshComponent = NewObject<UInstancedStaticMeshComponent>(ProxyRendererActor);
+	ProxyMeshComponent->SetStaticMesh(StaticMesh);
+	ProxyMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	ProxyMeshComponent->SetCanEverAffectNavigation(false);
+	ProxyMeshComponent->SetupAttachment(ProxyRendererActor->GetRootComponent());
+	ProxyMeshComponent->RegisterComponent();
+
+	ProxyMeshComponents.Add(StaticMesh, ProxyMeshComponent);
+	return ProxyMeshComponent;
+}
+
+void UShipRepresentationSubsystem::LogReport() const
+{
+	// What a full ship's skeletal mesh holds (pose buffers, bone transforms) against the proxy's instance
+	int64 FullShipBytes = 0;
+	int32 NumMeasuredShips = 0;
+	if (const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>())
+	{
+		for (const AShipPawn* ShipPawn : ShipRegistry->GetShips())
+		{
+			if (IsValid(ShipPawn) && ShipPawn->GetRepresentation() == EShipRepresentation::Full && ShipPawn->GetShipMesh())
+			{
+				FullShipBytes += ShipPawn->GetShipMesh()->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+				++NumMeasuredShips;
+			}
+		}
+	}
+
+	int64 InstanceBytes = 0;
+	for (const TPair<UStaticMesh*, UInstancedStaticMeshComponent*>& Pair : ProxyMeshComponents)
+	{
+		if (Pair.Value)
+		{
+			InstanceBytes += Pair.Value->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+	}
+
+	const double AverageUpdateMs = UpdateCount > 0 ? UpdateSecondsTotal * 1000.0 / UpdateCount : 0.0;
+	UE_LOG(LogShipRepresentation, Log, TEXT("ShipRepresentation: %d proxies, %d full ships"), NumProxyShips, NumFullShips);
+	UE_LOG(LogShipRepresentation, Log, TEXT("ShipRepresentation: Update %.3fms average, %.3fus per proxy"),
+		AverageUpdateMs, NumProxyShips > 0 ? AverageUpdateMs * 1000.0 / NumProxyShips : 0.0);
+	UE_LOG(LogShipRepresentation, Log, TEXT("ShipRepresentation: Instance memory %lld bytes, %lld bytes per proxy"),
+		InstanceBytes, NumProxyShips > 0 ? InstanceBytes / NumProxyShips : 0);
+
+	const int64 FullShipBytesAverage = NumMeasuredShips > 0 ? FullShipBytes / NumMeasuredShips : 0;
+	const int64 ProxyBytesAverage = NumProxyShips > 0 ? InstanceBytes / NumProxyShips : 0;
+	UE_LOG(LogShipRepresentation, Log, TEXT("ShipRepresentation: Saves %lld bytes per proxy (%lld per full skeletal ship), %lld bytes now"),
+		FullShipBytesAverage - ProxyBytesAverage, FullShipBytesAverage, (FullShipBytesAverage - ProxyBytesAverage) * NumProxyShips);
+	UE_LOG(LogShipRepresentation, Log, TEXT("ShipRepresentation: %llu skeletal pose and physics body updates skipped, %.1f per update, at %.3fus of proxy bookkeeping each"),
+		ProxyShipUpdates, UpdateCount > 0 ? double(ProxyShipUpdates) / UpdateCount : 0.0, ProxyShipUpdates > 0 ? UpdateSecondsTotal * 1.0e6 / ProxyShipUpdates : 0.0);
+}
@@ -0,0 +1,596 @@
+#include "Subsystems/ShipSnapshotSubsystem.h"
+#include "GalacticArmada.h"
+#include "Actors/GuidedMissile.h"
+#include "Actors/ProjectileBase.h"
+#include "Async/MappedFileHandle.h"
+#include "Components/HealthComponent.h"
+#include "Components/ShipMovementComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipGunnerySubsystem.h"
+#include "Subsystems/ShipMissileSubsystem.h"
+#include "Subsystems/ShipRegistrySubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipSnapshot, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Snapshot Save"), STAT_SnapshotSave, STATGROUP_GalacticArmada);
+DECLARE_CYCLE_STAT(TEXT("Snapshot Load"), STAT_SnapshotLoad, STATGROUP_GalacticArmada);
+
+namespace ShipSnapshot
+{
+	static const uint32 FileMagic = 0x50414E53; // 'SNAP'
+	static const int32 FileVersion = 1;
+	static const TCHAR* DefaultName = TEXT("Battle");
+
+	FORCEINLINE int64 AlignSection(int64 Offset)
+	{
+		return Align(Offset, 16);
+	}
+
+	template<typename RecordType>
+	static bool IsSectionValid(int64 Offset, int32 Num, int64 Size)
+	{
+		return Num >= 0 && Offset >= (int64)sizeof(FBattleSnapshotHeader) && Offset == AlignSection(Offset) && Offset + (int64)Num * sizeof(RecordType) <= Size;
+	}
+
+	template<typename RecordType>
+	static TConstArrayView<RecordType> GetSection(const uint8* Data, int64 Offset, int32 Num)
+	{
+		return TConstArrayView<RecordType>(reinterpret_cast<const RecordType*>(Data + Offset), Num);
+	}
+}
+
+static TAutoConsoleVariable<float> CVarSnapshotAutosaveInterval(
+	TEXT("ga.Snapshot.AutosaveInterval"),
+	0.0f,
+	TEXT("Seconds between battle snapshots saved as Autosave for crash recovery, 0 turns autosaving off."));
+
+static FAutoConsoleCommandWithWorldAndArgs SnapshotSaveCommand(
+	TEXT("ga.Snapshot.Save"),
+	TEXT("Saves every ship and live projectile to Saved/Snapshots: ga.Snapshot.Save [Name]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UShipSnapshotSubsystem* SnapshotSubsystem = World ? World->GetSubsystem<UShipSnapshotSubsystem>() : nullptr)
+		{
+			SnapshotSubsystem->SaveSnapshot(UShipSnapshotSubsystem::GetSnapshotFilePath(Args.IsValidIndex(0) ? Args[0] : ShipSnapshot::DefaultName));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs SnapshotLoadCommand(
+	TEXT("ga.Snapshot.Load"),
+	TEXT("Restores ships and projectiles from a snapshot in Saved/Snapshots: ga.Snapshot.Load [Name]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UShipSnapshotSubsystem* SnapshotSubsystem = World ? World->GetSubsystem<UShipSnapshotSubsystem>() : nullptr)
+		{
+			SnapshotSubsystem->LoadSnapshot(UShipSnapshotSubsystem::GetSnapshotFilePath(Args.IsValidIndex(0) ? Args[0] : ShipSnapshot::DefaultName));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld SnapshotReportCommand(
+	TEXT("ga.Snapshot.Report"),
+	TEXT("Logs the size and timings of the last snapshot save and load."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipSnapshotSubsystem* SnapshotSubsystem = World ? World->GetSubsystem<UShipSnapshotSubsystem>() : nullptr)
+		{
+			SnapshotSubsystem->LogReport();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs SnapshotBenchmarkCommand(
+	TEXT("ga.Snapshot.Benchmark"),
+	TEXT("Tops the battle up to the given ships and projectiles, then saves and restores it: ga.Snapshot.Benchmark [Ships] [Projectiles] [ShipClassPath] [ProjectileClassPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UShipSnapshotSubsystem* SnapshotSubsystem = World ? World->GetSubsystem<UShipSnapshotSubsystem>() : nullptr;
+		const UShipRegistrySubsystem* ShipRegistry = World ? World->GetSubsystem<UShipRegistrySubsystem>() : nullptr;
+		if (!SnapshotSubsystem || !ShipRegistry) return;
+
+		const int32 NumShips = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 0) : 1000;
+		const int32 NumProjectiles = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 0) : 20000;
+		UClass* ShipClass = Args.IsValidIndex(2) ? TSoftClassPtr<AShipPawn>(FSoftObjectPath(Args[2])).LoadSynchronous() : nullptr;
+		UClass* ProjectileClass = Args.IsValidIndex(3) ? TSoftClassPtr<AProjectileBase>(FSoftObjectPath(Args[3])).LoadSynchronous() : AProjectileBase::StaticClass();
+
+		// Without a class given, more of the ships already flying
+		if (!ShipClass && ShipRegistry->GetShips().Num() > 0 && ShipRegistry->GetShips()[0])
+		{
+			ShipClass = ShipRegistry->GetShips()[0]->GetClass();
+		}
+		if (!ShipClass || !ProjectileClass)
+		{
+			UE_LOG(LogShipSnapshot, Warning, TEXT("ShipSnapshot: Benchmark needs a ship class and a projectile class"));
+			return;
+		}
+
+		const float Radius = 200000.0f;
+		{
+			LLM_SCOPE_BYTAG(GalacticArmada_Ships);
+			for (int32 Index = ShipRegistry->GetShips().Num(); Index < NumShips; ++Index)
+			{
+				const FTransform SpawnTransform(FMath::VRand().Rotation(), FMath::VRand() * FMath::FRandRange(0.0f, Radius));
+				AShipPawn* ShipPawn = World->SpawnActorDeferred<AShipPawn>(ShipClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+				if (!ShipPawn) continue;
+
+				ShipPawn->TeamId = Index % 2;
+				ShipPawn->FinishSpawning(SpawnTransform);
+				if (!ShipPawn->GetController())
+				{
+					ShipPawn->SpawnDefaultController();
+				}
+			}
+		}
+
+		int32 NumLiveProjectiles = 0;
+		for (TActorIterator<AProjectileBase> ProjectileIterator(World); ProjectileIterator; ++ProjectileIterator)
+		{
+			NumLiveProjectiles += !ProjectileIterator->IsSpent();
+		}
+
+		const TArray<AShipPawn*>& Ships = ShipRegistry->GetShips();
+		{
+			LLM_SCOPE_BYTAG(GalacticArmada_Projectiles);
+			for (int32 Index = NumLiveProjectiles; Index < NumProjectiles && Ships.Num() > 0; ++Index)
+			{
+				AShipPawn* Shooter = Ships[FMath::RandHelper(Ships.Num())];
+				if (!IsValid(Shooter)) continue;
+
+				FActorSpawnParameters SpawnParams;
+				SpawnParams.Owner = Shooter;
+				SpawnParams.Instigator = Shooter;
+				SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+				World->SpawnActor<AProjectileBase>(ProjectileClass, FTransform(FMath::VRand().Rotation(), Shooter->GetActorLocation() + FMath::VRand() * 5000.0f), SpawnParams);
+			}
+		}
+
+		const FString FilePath = UShipSnapshotSubsystem::GetSnapshotFilePath(TEXT("Benchmark"));
+		if (SnapshotSubsystem->SaveSnapshot(FilePath))
+		{
+			SnapshotSubsystem->LoadSnapshot(FilePath);
+		}
+	}));
+
+bool UShipSnapshotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipSnapshotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipSnapshotSubsystem, STATGROUP_Tickables);
+}
+
+void UShipSnapshotSubsystem::Tick(float DeltaTime)
+{
+	const float AutosaveInterval = CVarSnapshotAutosaveInterval.GetValueOnGameThread();
+	if (AutosaveInterval <= 0.0f)
+	{
+		TimeSinceAutosave = 0.0f;
+		return;
+	}
+
+	TimeSinceAutosave += DeltaTime;
+	if (TimeSinceAutosave >= AutosaveInterval)
+	{
+		TimeSinceAutosave = 0.0f;
+		SaveSnapshot(GetSnapshotFilePath(TEXT("Autosave")));
+	}
+}
+
+FString UShipSnapshotSubsystem::GetSnapshotFilePath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Snapshots") / (Name + TEXT(".gasnap"));
+}
+
+int32 UShipSnapshotSubsystem::GetClassIndex(UClass* Class)
+{
+	if (const int32* ClassIndex = ClassIndices.Find(Class)) return *ClassIndex;
+
+	FBattleSnapshotClass& ClassRecord = Classes.AddDefaulted_GetRef();
+	FCStringAnsi::Strncpy(ClassRecord.PathName, TCHAR_TO_ANSI(*Class->GetPathName()), UE_ARRAY_COUNT(ClassRecord.PathName));
+	return ClassIndices.Add(Class, Classes.Num() - 1);
+}
+
+void UShipSnapshotSubsystem::Capture()
+{
+	Classes.Reset();
+	ShipRecords.Reset();
+	CannonRecords.Reset();
+	ProjectileRecords.Reset();
+	ClassIndices.Reset();
+	ShipIndices.Reset();
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+
+	if (const UShipRegistrySubsystem* ShipRegistry = GetWorld()->GetSubsystem<UShipRegistrySubsystem>())
+	{
+		ShipRecords.Reserve(ShipRegistry->GetShips().Num());
+		for (AShipPawn* ShipPawn : ShipRegistry->GetShips())
+		{
+			if (!IsValid(ShipPawn)) continue;
+
+			const UShipMovementComponent* ShipMovementComponent = ShipPawn->GetShipMovementComponent();
+			FBattleSnapshotShip& ShipRecord = ShipRecords.AddDefaulted_GetRef();
+			ShipRecord.FlightInput = ShipMovementComponent->GetFlightInput();
+			ShipRecord.FlightState = ShipMovementComponent->GetFlightState();
+			ShipRecord.Rotation = ShipPawn->GetActorQuat();
+			ShipRecord.Location = ShipPawn->GetActorLocation();
+			ShipRecord.LinearVelocity = ShipPawn->GetVelocity();
+			if (const UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(ShipPawn->GetRootComponent()); RootPrimitive && RootPrimitive->IsSimulatingPhysics())
+			{
+				ShipRecord.AngularVelocity = RootPrimitive->GetPhysicsAngularVelocityInDegrees();
+			}
+			ShipRecord.Health = ShipPawn->GetHealthComponent()->GetHealth();
+			ShipRecord.ClassIndex = GetClassIndex(ShipPawn->GetClass());
+			ShipRecord.TeamId = ShipPawn->TeamId;
+			ShipRecord.bPlayerControlled = ShipPawn->IsPlayerControlled();
+
+			// Fire times are stored relative to the snapshot so they resume at any world time
+			const TConstArrayView<FCannonFireState> FireStates = ShipPawn->GetCannonComponent()->GetFireStates();
+			ShipRecord.FirstCannon = CannonRecords.Num();
+			ShipRecord.NumCannons = FireStates.Num();
+			CannonRecords.Append(FireStates.GetData(), FireStates.Num());
+			for (int32 CannonIndex = ShipRecord.FirstCannon; CannonIndex < CannonRecords.Num(); ++CannonIndex)
+			{
+				CannonRecords[CannonIndex].NextFireTime -= WorldTime;
+			}
+
+			ShipIndices.Add(ShipPawn, ShipRecords.Num() - 1);
+		}
+	}
+
+	for (TActorIterator<AProjectileBase> ProjectileIterator(GetWorld()); ProjectileIterator; ++ProjectileIterator)
+	{
+		AProjectileBase* Projectile = *ProjectileIterator;
+		if (!IsValid(Projectile) || Projectile->IsSpent()) continue;
+
+		FBattleSnapshotProjectile& ProjectileRecord = ProjectileRecords.AddDefaulted_GetRef();
+		ProjectileRecord.Rotation = Projectile->GetActorQuat();
+		ProjectileRecord.Location = Projectile->GetActorLocation();
+		ProjectileRecord.Velocity = Projectile->GetProjectileMovementComponent()->Velocity;
+		ProjectileRecord.FlightAge = Projectile->GetFlightAge();
+		ProjectileRecord.ClassIndex = GetClassIndex(Projectile->GetClass());
+		if (const int32* InstigatorIndex = ShipIndices.Find(Projectile->GetInstigator()))
+		{
+			ProjectileRecord.InstigatorShip = *InstigatorIndex;
+		}
+		if (const AGuidedMissile* Missile = Cast<AGuidedMissile>(Projectile))
+		{
+			if (const int32* TargetIndex = ShipIndices.Find(Missile->GetLockedTarget()))
+			{
+				ProjectileRecord.TargetShip = *TargetIndex;
+			}
+		}
+	}
+}
+
+bool UShipSnapshotSubsystem::SaveSnapshot(const FString& FilePath)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SnapshotSave);
+
+	const double CaptureStartTime = FPlatformTime::Seconds();
+	Capture();
+	const double WriteStartTime = FPlatformTime::Seconds();
+
+	FBattleSnapshotHeader FileHeader;
+	FileHeader.Magic = ShipSnapshot::FileMagic;
+	FileHeader.Version = ShipSnapshot::FileVersion;
+	FileHeader.ShipRecordSize = sizeof(FBattleSnapshotShip);
+	FileHeader.CannonRecordSize = sizeof(FCannonFireState);
+	FileHeader.ProjectileRecordSize = sizeof(FBattleSnapshotProjectile);
+	FileHeader.NumClasses = Classes.Num();
+	FileHeader.NumShips = ShipRecords.Num();
+	FileHeader.NumCannons = CannonRecords.Num();
+	FileHeader.NumProjectiles = ProjectileRecords.Num();
+	FileHeader.ClassesOffset = ShipSnapshot::AlignSection(sizeof(FBattleSnapshotHeader));
+	FileHeader.ShipsOffset = ShipSnapshot::AlignSection(FileHeader.ClassesOffset + Classes.Num() * sizeof(FBattleSnapshotClass));
+	FileHeader.CannonsOffset = ShipSnapshot::AlignSection(FileHeader.ShipsOffset + ShipRecords.Num() * sizeof(FBattleSnapshotShip));
+	FileHeader.ProjectilesOffset = ShipSnapshot::AlignSection(FileHeader.CannonsOffset + CannonRecords.Num() * sizeof(FCannonFireState));
+	FileHeader.FileSize = FileHeader.ProjectilesOffset + ProjectileRecords.Num() * sizeof(FBattleSnapshotProjectile);
+	FileHeader.WorldTime = GetWorld()->GetTimeSeconds();
+
+	// The previous snapshot stays intact until the new one is completely written, a crash mid save keeps it recoverable
+	const FString TempPath = FilePath + TEXT(".tmp");
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+	if (!Writer)
+	{
+		UE_LOG(LogShipSnapshot, Warning, TEXT("ShipSnapshot: Failed to open %s for writing"), *TempPath);
+		return false;
+	}
+
+	// Each section is written whole, padded up to its aligned offset
+	uint8 Padding[16] = {};
+	auto WriteSection = [&Writer, &Padding](int64 Offset, const void* Data, int64 Bytes)
+	{
+		Writer->Serialize(Padding, Offset - Writer->Tell());
+		Writer->Serialize(const_cast<void*>(Data), Bytes);
+	};
+
+	Writer->Serialize(&FileHeader, sizeof(FileHeader));
+	WriteSection(FileHeader.ClassesOffset, Classes.GetData(), Classes.Num() * sizeof(FBattleSnapshotClass));
+	WriteSection(FileHeader.ShipsOffset, ShipRecords.GetData(), ShipRecords.Num() * sizeof(FBattleSnapshotShip));
+	WriteSection(FileHeader.CannonsOffset, CannonRecords.GetData(), CannonRecords.Num() * sizeof(FCannonFireState));
+	WriteSection(FileHeader.ProjectilesOffset, ProjectileRecords.GetData(), ProjectileRecords.Num() * sizeof(FBattleSnapshotProjectile));
+	const bool bWritten = Writer->Close();
+	Writer.Reset();
+	if (!bWritten || !IFileManager::Get().Move(*FilePath, *TempPath))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		UE_LOG(LogShipSnapshot, Warning, TEXT("ShipSnapshot: Failed to write %s"), *FilePath);
+		return false;
+	}
+
+	++NumSaves;
+	LastNumShips = ShipRecords.Num();
+	LastNumProjectiles = ProjectileRecords.Num();
+	LastFileSize = FileHeader.FileSize;
+	LastCaptureSeconds = WriteStartTime - CaptureStartTime;
+	LastWriteSeconds = FPlatformTime::Seconds() - WriteStartTime;
+
+	UE_LOG(LogShipSnapshot, Log, TEXT("ShipSnapshot: Saved %d ships and %d projectiles to %s, %.1fKB. Capture %.2fms, write %.2fms"),
+		LastNumShips, LastNumProjectiles, *FilePath, LastFileSize / 1024.0, LastCaptureSeconds * 1000.0, LastWriteSeconds * 1000.0);
+	return true;
+}
+
+bool UShipSnapshotSubsystem::LoadSnapshot(const FString& FilePath)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SnapshotLoad);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*FilePath))
+	{
+		UE_LOG(LogShipSnapshot, Warning, TEXT("ShipSnapshot: No snapshot %s"), *FilePath);
+		return false;
+	}
+
+	const double ReadStartTime = FPlatformTime::Seconds();
+
+	// Records are used straight from the mapped file, only the pages holding them are read
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*FilePath));
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	// Fallback for platforms without memory mapped files
+	TArray64<uint8> LoadedData;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(LoadedData, *FilePath))
+	{
+		Data = LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+
+	const double ApplyStartTime = FPlatformTime::Seconds();
+	if (!Apply(Data, Size))
+	{
+		UE_LOG(LogShipSnapshot, Warning, TEXT("ShipSnapshot: %s is not a snapshot of this build"), *FilePath);
+		return false;
+	}
+
+	++NumLoads;
+	bLastLoadMapped = MappedRegion.IsValid();
+	LastFileSize = Size;
+	LastReadSeconds = ApplyStartTime - ReadStartTime;
+	LastApplySeconds = FPlatformTime::Seconds() - ApplyStartTime;
+
+	UE_LOG(LogShipSnapshot, Log, TEXT("ShipSnapshot: Restored %d ships and %d projectiles taken at %.1fs from %s, %d actors reused, %d spawned. Read %.2fms (%s), apply %.2fms"),
+		LastNumShips, LastNumProjectiles, LastSnapshotWorldTime, *FilePath, LastActorsReused, LastActorsSpawned,
+		LastReadSeconds * 1000.0, bLastLoadMapped ? TEXT("mapped") : TEXT("loaded"), LastApplySeconds * 1000.0);
+	return true;
+}
+
+bool UShipSnapshotSubsystem::Apply(const uint8* Data, int64 Size)
+{
+	if (!Data || Size < (int64)sizeof(FBattleSnapshotHeader)) return false;
+
+	const FBattleSnapshotHeader* FileHeader = reinterpret_cast<const FBattleSnapshotHeader*>(Data);
+	if (FileHeader->Magic != ShipSnapshot::FileMagic || FileHeader->Version != ShipSnapshot::FileVersion || FileHeader->FileSize != Size) return false;
+	if (FileHeader->ShipRecordSize != sizeof(FBattleSnapshotShip) || FileHeader->CannonRecordSize != sizeof(FCannonFireState) || FileHeader->ProjectileRecordSize != sizeof(FBattleSnapshotProjectile)) return false;
+	if (!ShipSnapshot::IsSectionValid<FBattleSnapshotClass>(FileHeader->ClassesOffset, FileHeader->NumClasses, Size)
+		|| !ShipSnapshot::IsSectionValid<FBattleSnapshotShip>(FileHeader->ShipsOffset, FileHeader->NumShips, Size)
+		|| !ShipSnapshot::IsSectionValid<FCannonFireState>(FileHeader->CannonsOffset, FileHeader->NumCannons, Size)
+		|| !ShipSnapshot::IsSectionValid<FBattleSnapshotProjectile>(FileHeader->ProjectilesOffset, FileHeader->NumProjectiles, Size)) return false;
+
+	LastSnapshotWorldTime = FileHeader->WorldTime;
+
+	const TConstArrayView<FBattleSnapshotClass> ClassSection = ShipSnapshot::GetSection<FBattleSnapshotClass>(Data, FileHeader->ClassesOffset, FileHeader->NumClasses);
+	const TConstArrayView<FBattleSnapshotShip> ShipSection = ShipSnapshot::GetSection<FBattleSnapshotShip>(Data, FileHeader->ShipsOffset, FileHeader->NumShips);
+	const TConstArrayView<FCannonFireState> CannonSection = ShipSnapshot::GetSection<FCannonFireState>(Data, FileHeader->CannonsOffset, FileHeader->NumCannons);
+	const TConstArrayView<FBattleSnapshotProjectile> ProjectileSection = ShipSnapshot::GetSection<FBattleSnapshotProjectile>(Data, FileHeader->ProjectilesOffset, FileHeader->NumProjectiles);
+
+	TArray<UClass*> ResolvedClasses;
+	ResolvedClasses.Reserve(ClassSection.Num());
+	for (const FBattleSnapshotClass& ClassRecord : ClassSection)
+	{
+		const FString PathName(FCStringAnsi::Strnlen(ClassRecord.PathName, UE_ARRAY_COUNT(ClassRecord.PathName)), ClassRecord.PathName);
+		ResolvedClasses.Add(FSoftClassPath(PathName).TryLoadClass<AActor>());
+	}
+
+	UWorld* World = GetWorld();
+	UShipRegistrySubsystem* ShipRegistry = World->GetSubsystem<UShipRegistrySubsystem>();
+	UShipMissileSubsystem* MissileSubsystem = World->GetSubsystem<UShipMissileSubsystem>();
+	UShipGunnerySubsystem* GunnerySubsystem = World->GetSubsystem<UShipGunnerySubsystem>();
+	LastActorsReused = 0;
+	LastActorsSpawned = 0;
+
+	// Ships already flying are moved onto the records of their class, the player keeps their own ship
+	AShipPawn* PlayerShip = ShipRegistry ? ShipRegistry->FindPlayerShip() : nullptr;
+	TMap<UClass*, TArray<AShipPawn*>> ReusableShips;
+	if (ShipRegistry)
+	{
+		for (AShipPawn* ShipPawn : ShipRegistry->GetShips())
+		{
+			if (IsValid(ShipPawn) && ShipPawn != PlayerShip)
+			{
+				ReusableShips.FindOrAdd(ShipPawn->GetClass()).Add(ShipPawn);
+			}
+		}
+	}
+
+	TArray<AShipPawn*> RestoredShips;
+	RestoredShips.Reserve(ShipSection.Num());
+	for (const FBattleSnapshotShip& ShipRecord : ShipSection)
+	{
+		UClass* ShipClass = ResolvedClasses.IsValidIndex(ShipRecord.ClassIndex) ? ResolvedClasses[ShipRecord.ClassIndex] : nullptr;
+		const bool bCannonsValid = ShipRecord.FirstCannon >= 0 && ShipRecord.NumCannons >= 0 && ShipRecord.FirstCannon + ShipRecord.NumCannons <= CannonSection.Num();
+		if (!ShipClass || !ShipClass->IsChildOf<AShipPawn>() || !bCannonsValid)
+		{
+			RestoredShips.Add(nullptr);
+			continue;
+		}
+
+		AShipPawn* ShipPawn = nullptr;
+		if (ShipRecord.bPlayerControlled && PlayerShip && PlayerShip->GetClass() == ShipClass)
+		{
+			ShipPawn = PlayerShip;
+			PlayerShip = nullptr;
+		}
+		else if (TArray<AShipPawn*>* ReusableOfClass = ReusableShips.Find(ShipClass); ReusableOfClass && ReusableOfClass->Num() > 0)
+		{
+			ShipPawn = ReusableOfClass->Pop(false);
+		}
+
+		const FTransform ShipTransform(ShipRecord.Rotation, ShipRecord.Location);
+		if (ShipPawn)
+		{
+			ShipPawn->TeamId = ShipRecord.TeamId;
+			ShipPawn->SetActorLocationAndRotation(ShipRecord.Location, ShipRecord.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+			if (GunnerySubsystem)
+			{
+				GunnerySubsystem->ResetShipMotion(ShipPawn);
+			}
+			++LastActorsReused;
+		}
+		else
+		{
+			LLM_SCOPE_BYTAG(GalacticArmada_Ships);
+			ShipPawn = World->SpawnActorDeferred<AShipPawn>(ShipClass, ShipTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+			if (!ShipPawn)
+			{
+				RestoredShips.Add(nullptr);
+				continue;
+			}
+
+			ShipPawn->TeamId = ShipRecord.TeamId;
+			ShipPawn->FinishSpawning(ShipTransform);
+			if (!ShipPawn->GetController())
+			{
+				ShipPawn->SpawnDefaultController();
+			}
+			++LastActorsSpawned;
+		}
+
+		ShipPawn->GetShipMovementComponent()->SetFlightState(ShipRecord.FlightState);
+		ShipPawn->GetShipMovementComponent()->SetFlightInput(ShipRecord.FlightInput);
+		ShipPawn->GetHealthComponent()->SetHealth(ShipRecord.Health);
+		ShipPawn->GetCannonComponent()->RestoreFireStates(CannonSection.Slice(ShipRecord.FirstCannon, ShipRecord.NumCannons));
+
+		if (UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(ShipPawn->GetRootComponent()); RootPrimitive && RootPrimitive->IsSimulatingPhysics())
+		{
+			RootPrimitive->SetPhysicsLinearVelocity(ShipRecord.LinearVelocity);
+			RootPrimitive->SetPhysicsAngularVelocityInDegrees(ShipRecord.AngularVelocity);
+		}
+
+		RestoredShips.Add(ShipPawn);
+	}
+
+	for (const TPair<UClass*, TArray<AShipPawn*>>& ReusablePair : ReusableShips)
+	{
+		for (AShipPawn* ShipPawn : ReusablePair.Value)
+		{
+			ShipPawn->Destroy();
+		}
+	}
+
+	// Live bolts are moved onto the records as well, missiles go back to their pool and are launched again
+	TMap<UClass*, TArray<AProjectileBase*>> ReusableProjectiles;
+	for (TActorIterator<AProjectileBase> ProjectileIterator(World); ProjectileIterator; ++ProjectileIterator)
+	{
+		AProjectileBase* Projectile = *ProjectileIterator;
+		if (!IsValid(Projectile) || Projectile->IsSpent()) continue;
+
+		if (AGuidedMissile* Missile = Cast<AGuidedMissile>(Projectile); Missile && MissileSubsystem)
+		{
+			MissileSubsystem->ReleaseMissile(Missile);
+		}
+		else
+		{
+			ReusableProjectiles.FindOrAdd(Projectile->GetClass()).Add(Projectile);
+		}
+	}
+
+	for (const FBattleSnapshotProjectile& ProjectileRecord : ProjectileSection)
+	{
+		UClass* ProjectileClass = ResolvedClasses.IsValidIndex(ProjectileRecord.ClassIndex) ? ResolvedClasses[ProjectileRecord.ClassIndex] : nullptr;
+		if (!ProjectileClass || !ProjectileClass->IsChildOf<AProjectileBase>()) continue;
+
+		AShipPawn* InstigatorShip = RestoredShips.IsValidIndex(ProjectileRecord.InstigatorShip) ? RestoredShips[ProjectileRecord.InstigatorShip] : nullptr;
+		const FTransform ProjectileTransform(ProjectileRecord.Rotation, ProjectileRecord.Location);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = InstigatorShip;
+		SpawnParams.Instigator = InstigatorShip;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		AProjectileBase* Projectile = nullptr;
+		if (MissileSubsystem && ProjectileClass->IsChildOf<AGuidedMissile>())
+		{
+			AShipPawn* TargetShip = RestoredShips.IsValidIndex(ProjectileRecord.TargetShip) ? RestoredShips[ProjectileRecord.TargetShip] : nullptr;
+			Projectile = MissileSubsystem->LaunchMissile(ProjectileClass, ProjectileTransform, SpawnParams, TargetShip);
+		}
+		else if (TArray<AProjectileBase*>* ReusableOfClass = ReusableProjectiles.Find(ProjectileClass); ReusableOfClass && ReusableOfClass->Num() > 0)
+		{
+			Projectile = ReusableOfClass->Pop(false);
+			Projectile->SetOwner(InstigatorShip);
+			Projectile->SetInstigator(InstigatorShip);
+			Projectile->SetActorLocationAndRotation(ProjectileRecord.Location, ProjectileRecord.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+			++LastActorsReused;
+		}
+		else
+		{
+			LLM_SCOPE_BYTAG(GalacticArmada_Projectiles);
+			Projectile = World->SpawnActor<AProjectileBase>(ProjectileClass, ProjectileTransform, SpawnParams);
+			++LastActorsSpawned;
+		}
+		if (!Projectile) continue;
+
+		Projectile->GetProjectileMovementComponent()->Velocity = ProjectileRecord.Velocity;
+		Projectile->RestoreFlightAge(ProjectileRecord.FlightAge);
+	}
+
+	for (const TPair<UClass*, TArray<AProjectileBase*>>& ReusablePair : ReusableProjectiles)
+	{
+		for (AProjectileBase* Projectile : ReusablePair.Value)
+		{
+			Projectile->Destroy();
+		}
+	}
+
+	LastNumShips = ShipSection.Num();
+	LastNumProjectiles = ProjectileSection.Num();
+	return true;
+}
+
+void UShipSnapshotSubsystem::LogReport() const
+{
+	UE_LOG(LogShipSnapshot, Log, TEXT("ShipSnapshot: %d saves, %d loads. Last snapshot %d ships, %d projectiles, %.1fKB. Save: capture %.2fms, write %.2fms. Load: read %.2fms (%s), apply %.2fms, %d actors reused, %d spawned"),
+		NumSaves, NumLoads, LastNumShips, LastNumProjectiles, LastFileSize / 1024.0,
+		LastCaptureSeconds * 1000.0, LastWriteSeconds * 1000.0,
+		LastReadSeconds * 1000.0, bLastLoadMapped ? TEXT("mapped") : TEXT("loaded"), LastApplySeconds * 1000.0,
+		LastActorsReused, LastActorsSpawned);
+}
@@ -0,0 +1,227 @@
+#include "Subsystems/ShipSquadSubsystem.h"
+#include "GalacticArmada.h"
+#include "Controllers/ShipAIController.h"
+#include "Data/ShipFormationDataAsset.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipSquad, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Squads"), STAT_ShipSquads, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Squad Target Searches"), STAT_SquadTargetSearches, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Squad Avoidance Queries"), STAT_SquadAvoidanceQueries, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Squad Avoidance Traces"), STAT_SquadAvoidanceTraces, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarSquadEnable(
+	TEXT("ga.Squad.Enable"),
+	true,
+	TEXT("Wingmen share their squad leader's target and obstacle queries. Off runs every query per ship, still counted per squad."));
+
+static FAutoConsoleCommandWithWorld SquadReportCommand(
+	TEXT("ga.Squad.Report"),
+	TEXT("Logs squads and the target searches, obstacle queries and obstacle traces they ran."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipSquadSubsystem* SquadSubsystem = World ? World->GetSubsystem<UShipSquadSubsystem>() : nullptr)
+		{
+			SquadSubsystem->LogReport();
+		}
+	}));
+
+bool UShipSquadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipSquadSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipSquadSubsystem, STATGROUP_Tickables);
+}
+
+int32 UShipSquadSubsystem::FormSquads(const UShipFormationDataAsset* Formation, TConstArrayView<AShipPawn*> ShipPawns)
+{
+	if (!Formation)
+	{
+		Formation = GetDefault<UShipFormationDataAsset>();
+	}
+
+	const int32 SquadSize = Formation->GetSquadSize();
+	int32 NumFormed = 0;
+
+	for (int32 FirstIndex = 0; FirstIndex < ShipPawns.Num(); FirstIndex += SquadSize)
+	{
+		const int32 SquadId = NextSquadId++;
+		FShipSquad& Squad = Squads.Add(SquadId);
+		Squad.Formation = Formation;
+
+		for (int32 ShipIndex = FirstIndex; ShipIndex < FMath::Min(FirstIndex + SquadSize, ShipPawns.Num()); ++ShipIndex)
+		{
+			AShipPawn* ShipPawn = ShipPawns[ShipIndex];
+			if (!IsValid(ShipPawn) || ShipToSquad.Contains(ShipPawn)) continue;
+
+			Squad.Members.Add(ShipPawn);
+			ShipToSquad.Add(ShipPawn, SquadId);
+		}
+
+		ShipsInSquads += Squad.Members.Num();
+		++SquadsFormed;
+		++NumFormed;
+	}
+
+	return NumFormed;
+}
+
+const FShipSquadOrders* UShipSquadSubsystem::FindOrders(const AShipPawn* ShipPawn) const
+{
+	return ShipOrders.Find(ShipPawn);
+}
+
+FShipSquad* UShipSquadSubsystem::FindSquad(const AShipPawn* ShipPawn)
+{
+	const int32* SquadId = ShipToSquad.Find(ShipPawn);
+	return SquadId ? Squads.Find(*SquadId) : nullptr;
+}
+
+void UShipSquadSubsystem::RecordTargetSearch(const AShipPawn* ShipPawn)
+{
+	if (FShipSquad* Squad = FindSquad(ShipPawn))
+	{
+		++Squad->TargetSearches;
+		++TotalTargetSearches;
+		INC_DWORD_STAT(STAT_SquadTargetSearches);
+		CSV_CUSTOM_STAT(GalacticArmada, SquadTargetSearches, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void UShipSquadSubsystem::RecordAvoidanceQuery(const AShipPawn* ShipPawn, int32 NumTraces)
+{
+	if (FShipSquad* Squad = FindSquad(ShipPawn))
+	{
+		++Squad->AvoidanceQueries;
+		++TotalAvoidanceQueries;
+		Squad->AvoidanceTraces += NumTraces;
+		TotalAvoidanceTraces += NumTraces;
+		INC_DWORD_STAT(STAT_SquadAvoidanceQueries);
+		INC_DWORD_STAT_BY(STAT_SquadAvoidanceTraces, NumTraces);
+		CSV_CUSTOM_STAT(GalacticArmada, SquadAvoidanceQueries, 1, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(GalacticArmada, SquadAvoidanceTraces, NumTraces, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void UShipSquadSubsystem::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_AI);
+	SCOPE_CYCLE_COUNTER(STAT_ShipSquads);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipSquads);
+
+	ShipOrders.Reset();
+
+	for (auto SquadIterator = Squads.CreateIterator(); SquadIterator; ++SquadIterator)
+	{
+		FShipSquad& Squad = SquadIterator->Value;
+
+		// Dead ships drop out in order, so the next wingman takes the lead
+		Squad.Members.RemoveAll([](const TWeakObjectPtr<AShipPawn>& Member) { return !Member.IsValid(); });
+		if (Squad.Members.Num() == 0)
+		{
+			SquadIterator.RemoveCurrent();
+			continue;
+		}
+
+		Squad.Seconds += DeltaTime;
+		TotalSquadSeconds += DeltaTime;
+
+		UpdateSquad(Squad);
+	}
+
+	for (auto ShipIterator = ShipToSquad.CreateIterator(); ShipIterator; ++ShipIterator)
+	{
+		if (!ShipIterator->Key.IsValid())
+		{
+			ShipIterator.RemoveCurrent();
+		}
+	}
+}
+
+void UShipSquadSubsystem::UpdateSquad(FShipSquad& Squad)
+{
+	const bool bSquadsEnabled = CVarSquadEnable.GetValueOnGameThread();
+
+	// Only the leader keeps a detection sphere, wingmen get its obstacles
+	for (int32 MemberIndex = 0; MemberIndex < Squad.Members.Num(); ++MemberIndex)
+	{
+		Squad.Members[MemberIndex]->SetDetectionEnabled(!bSquadsEnabled || MemberIndex == 0);
+	}
+
+	// The leader's closest obstacle goes to every wingman, so it must never be one of them
+	AShipPawn* Leader = Squad.Members[0].Get();
+	const int32 NumAvoidanceIgnored = bSquadsEnabled ? Squad.Members.Num() - 1 : 0;
+	if (Squad.AvoidanceLeader != Leader || Squad.NumAvoidanceIgnored != NumAvoidanceIgnored)
+	{
+		Squad.AvoidanceLeader = Leader;
+		Squad.NumAvoidanceIgnored = NumAvoidanceIgnored;
+
+		TArray<AActor*, TInlineAllocator<8>> Wingmen;
+		for (int32 MemberIndex = 1; MemberIndex <= NumAvoidanceIgnored; ++MemberIndex)
+		{
+			Wingmen.Add(Squad.Members[MemberIndex].Get());
+		}
+		Leader->SetAvoidanceIgnoredActors(Wingmen);
+	}
+
+	if (!bSquadsEnabled) return;
+
+	const UShipFormationDataAsset* Formation = Squad.Formation.IsValid() ? Squad.Formation.Get() : GetDefault<UShipFormationDataAsset>();
+	const AShipAIController* LeaderController = Cast<AShipAIController>(Leader->GetController());
+
+	FShipSquadOrders LeaderOrders;
+	LeaderOrders.Target = LeaderController ? LeaderController->GetTargetShipPawn() : nullptr;
+	LeaderOrders.CollisionLocation = LeaderController ? LeaderController->GetLastCollisionLocation() : FVector::ZeroVector;
+	LeaderOrders.EngageRange = Formation->EngageRange;
+
+	// Formation Slots And Separation For The Whole Squad
+	const FVector LeaderLocation = Leader->GetActorLocation();
+	const FQuat LeaderRotation = Leader->GetActorQuat();
+	const float SeparationRadius = FMath::Max(Formation->SeparationRadius, 1.0f);
+
+	MemberLocations.Reset();
+	for (const TWeakObjectPtr<AShipPawn>& Member : Squad.Members)
+	{
+		MemberLocations.Add(Member->GetActorLocation());
+	}
+
+	for (int32 MemberIndex = 0; MemberIndex < Squad.Members.Num(); ++MemberIndex)
+	{
+		FShipSquadOrders& Orders = ShipOrders.Add(Squad.Members[MemberIndex], LeaderOrders);
+		Orders.bIsLeader = MemberIndex == 0;
+
+		const int32 SlotIndex = MemberIndex - 1;
+		Orders.SlotLocation = Formation->SlotOffsets.IsValidIndex(SlotIndex) ? LeaderLocation + LeaderRotation.RotateVector(Formation->SlotOffsets[SlotIndex]) : LeaderLocation;
+
+		for (int32 OtherIndex = 0; OtherIndex < MemberLocations.Num(); ++OtherIndex)
+		{
+			const FVector Offset = MemberLocations[MemberIndex] - MemberLocations[OtherIndex];
+			const float Distance = Offset.Size();
+			if (OtherIndex == MemberIndex || Distance >= SeparationRadius || Distance <= UE_KINDA_SMALL_NUMBER) continue;
+
+			Orders.Separation += Offset / Distance * (SeparationRadius - Distance) * Formation->SeparationStrength;
+		}
+	}
+}
+
+void UShipSquadSubsystem::LogReport() const
+{
+	const double SquadSeconds = FMath::Max(TotalSquadSeconds, UE_DOUBLE_KINDA_SMALL_NUMBER);
+
+	UE_LOG(LogShipSquad, Log, TEXT("ShipSquad: Squads %s, %d formed with %d ships, %d alive. Per squad per second: %.2f target searches, %.2f obstacle queries, %.2f obstacle traces"),
+		CVarSquadEnable.GetValueOnGameThread() ? TEXT("on") : TEXT("off"), SquadsFormed, ShipsInSquads, Squads.Num(),
+		TotalTargetSearches / SquadSeconds, TotalAvoidanceQueries / SquadSeconds, TotalAvoidanceTraces / SquadSeconds);
+
+	for (const TPair<int32, FShipSquad>& SquadPair : Squads)
+	{
+		const FShipSquad& Squad = SquadPair.Value;
+		UE_LOG(LogShipSquad, Log, TEXT("ShipSquad:   Squad %d, %d ships, %lld target searches, %lld obstacle queries, %lld obstacle traces in %.1fs"),
+			SquadPair.Key, Squad.Members.Num(), Squad.TargetSearches, Squad.AvoidanceQueries, Squad.AvoidanceTraces, Squad.Seconds);
+	}
+}
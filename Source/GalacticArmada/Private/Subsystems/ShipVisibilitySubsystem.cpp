@@ -0,0 +1,224 @@
+#include "Subsystems/ShipVisibilitySubsystem.h"
+#include "GalacticArmada.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipVisibility, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Visibility"), STAT_ShipVisibility, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Traces"), STAT_LineOfSightTraces, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Cache Hits"), STAT_LineOfSightCacheHits, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Pending"), STAT_LineOfSightPending, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<bool> CVarVisibilityGateFire(
+	TEXT("ga.Visibility.GateFire"),
+	true,
+	TEXT("AI hold fire while the line of sight to their target is blocked. Off fires on range alone, blocked shots are still counted."));
+
+static TAutoConsoleVariable<float> CVarVisibilityCacheTTL(
+	TEXT("ga.Visibility.CacheTTL"),
+	0.25f,
+	TEXT("Seconds a line of sight result is used before the pair is traced again."));
+
+static TAutoConsoleVariable<int32> CVarVisibilityTracesPerFrame(
+	TEXT("ga.Visibility.TracesPerFrame"),
+	GA_WITH_COSMETICS ? 32 : 64,
+	TEXT("Line of sight traces issued per frame, the rest wait in the queue for the next frames. The dedicated server ticks half as often and traces twice as many."));
+
+static FAutoConsoleCommandWithWorld VisibilityReportCommand(
+	TEXT("ga.Visibility.Report"),
+	TEXT("Logs line of sight requests, cache hits, traces and shots fired with the line of sight blocked."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipVisibilitySubsystem* VisibilitySubsystem = World ? World->GetSubsystem<UShipVisibilitySubsystem>() : nullptr)
+		{
+			VisibilitySubsystem->LogReport();
+		}
+	}));
+
+namespace ShipVisibility
+{
+	// Entries nobody asked for in this long are dropped
+	static constexpr double EvictAfterSeconds = 2.0;
+}
+
+bool UShipVisibilitySubsystem::IsFireGateEnabled()
+{
+	return CVarVisibilityGateFire.GetValueOnGameThread();
+}
+
+bool UShipVisibilitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipVisibilitySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipVisibilitySubsystem, STATGROUP_Tickables);
+}
+
+EShipLineOfSight UShipVisibilitySubsystem::RequestLineOfSight(const AShipPawn* Shooter, const AActor* Target)
+{
+	if (!Shooter || !Target) return EShipLineOfSight::Unknown;
+
+	++NumRequests;
+	const double Now = GetWorld()->GetTimeSeconds();
+	const FPairKey Key(FObjectKey(Shooter), FObjectKey(Target));
+	ShooterTargets.Add(FObjectKey(Shooter), FObjectKey(Target));
+
+	FLineOfSightEntry& Entry = Entries.FindOrAdd(Key);
+	Entry.LastRequestTime = Now;
+	if (Entry.Result != EShipLineOfSight::Unknown && Now < Entry.ExpireTime)
+	{
+		++NumCacheHits;
+		INC_DWORD_STAT(STAT_LineOfSightCacheHits);
+		return Entry.Result;
+	}
+
+	// Expired results keep answering until the new trace is back
+	if (!Entry.bQueued)
+	{
+		LLM_SCOPE_BYTAG(GalacticArmada_AI);
+		Entry.Shooter = Shooter;
+		Entry.Target = Target;
+		Entry.bQueued = true;
+		PendingPairs.Add(Key);
+	}
+	return Entry.Result;
+}
+
+void UShipVisibilitySubsystem::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(GalacticArmada_AI);
+	SCOPE_CYCLE_COUNTER(STAT_ShipVisibility);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipVisibility);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (!TraceDelegate.IsBound())
+	{
+		TraceDelegate.BindUObject(this, &UShipVisibilitySubsystem::OnTraceCompleted);
+	}
+
+	IssueTraces();
+	EvictEntries();
+
+	SET_DWORD_STAT(STAT_LineOfSightPending, PendingPairs.Num());
+	if (NumRequests > 0)
+	{
+		ActiveSeconds += DeltaTime;
+	}
+	GameThreadSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void UShipVisibilitySubsystem::IssueTraces()
+{
+	const int32 NumTracesThisFrame = FMath::Min(PendingPairs.Num(), FMath::Max(CVarVisibilityTracesPerFrame.GetValueOnGameThread(), 1));
+	if (NumTracesThisFrame == 0) return;
+
+	UWorld* World = GetWorld();
+	for (int32 PairIndex = 0; PairIndex < NumTracesThisFrame; ++PairIndex)
+	{
+		FLineOfSightEntry* Entry = Entries.Find(PendingPairs[PairIndex]);
+		if (!Entry) continue;
+
+		const AShipPawn* Shooter = Entry->Shooter.Get();
+		const AActor* Target = Entry->Target.Get();
+		if (!Shooter || !Target)
+		{
+			Entry->bQueued = false;
+			continue;
+		}
+
+		// Results arrive with next frame's async trace batch, the id finds the pair again
+		const uint32 TraceId = NextTraceId++;
+		TracesInFlight.Add(TraceId, PendingPairs[PairIndex]);
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShipLineOfSight), false, Shooter);
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Shooter->GetActorLocation(), Target->GetActorLocation(), ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, TraceId);
+
+		++NumTraces;
+		INC_DWORD_STAT(STAT_LineOfSightTraces);
+		CSV_CUSTOM_STAT(GalacticArmada, LineOfSightTraces, 1, ECsvCustomStatOp::Accumulate);
+	}
+
+	PendingPairs.RemoveAt(0, NumTracesThisFrame, false);
+}
+
+void UShipVisibilitySubsystem::OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	FPairKey Key;
+	if (!TracesInFlight.RemoveAndCopyValue(TraceDatum.UserData, Key)) return;
+
+	FLineOfSightEntry* Entry = Entries.Find(Key);
+	if (!Entry) return;
+
+	// Anything but the target itself in the way blocks the shot: stations, asteroids and allies alike
+	const AActor* Target = Entry->Target.Get();
+	const FHitResult* BlockingHit = TraceDatum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	const bool bBlocked = BlockingHit && BlockingHit->GetActor() != Target;
+
+	Entry->Result = bBlocked ? EShipLineOfSight::Blocked : EShipLineOfSight::Clear;
+	Entry->ExpireTime = GetWorld()->GetTimeSeconds() + CVarVisibilityCacheTTL.GetValueOnGameThread();
+	Entry->bQueued = false;
+	NumBlockedResults += bBlocked ? 1 : 0;
+
+	GameThreadSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void UShipVisibilitySubsystem::EvictEntries()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (auto EntryIterator = Entries.CreateIterator(); EntryIterator; ++EntryIterator)
+	{
+		const FLineOfSightEntry& Entry = EntryIterator->Value;
+		if (!Entry.bQueued && (Now - Entry.LastRequestTime > ShipVisibility::EvictAfterSeconds || !Entry.Shooter.IsValid() || !Entry.Target.IsValid()))
+		{
+			EntryIterator.RemoveCurrent();
+		}
+	}
+
+	for (auto ShooterIterator = ShooterTargets.CreateIterator(); ShooterIterator; ++ShooterIterator)
+	{
+		if (!Entries.Contains(FPairKey(ShooterIterator->Key, ShooterIterator->Value)))
+		{
+			ShooterIterator.RemoveCurrent();
+		}
+	}
+}
+
+void UShipVisibilitySubsystem::NotifyFireHeld()
+{
+	++NumFireHeld;
+}
+
+void UShipVisibilitySubsystem::NotifyShotFired(const APawn* Shooter)
+{
+	if (!Shooter || Shooter->IsPlayerControlled()) return;
+
+	// Judged by the shooter's current target, whatever the projectile ends up hitting
+	const FObjectKey* TargetKey = ShooterTargets.Find(FObjectKey(Shooter));
+	const FLineOfSightEntry* Entry = TargetKey ? Entries.Find(FPairKey(FObjectKey(Shooter), *TargetKey)) : nullptr;
+	const EShipLineOfSight Result = Entry ? Entry->Result : EShipLineOfSight::Unknown;
+
+	NumShotsClear += Result == EShipLineOfSight::Clear ? 1 : 0;
+	NumShotsBlocked += Result == EShipLineOfSight::Blocked ? 1 : 0;
+	NumShotsUnknown += Result == EShipLineOfSight::Unknown ? 1 : 0;
+	if (Result == EShipLineOfSight::Blocked)
+	{
+		CSV_CUSTOM_STAT(GalacticArmada, WastedShots, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void UShipVisibilitySubsystem::LogReport() const
+{
+	const int64 NumShots = NumShotsClear + NumShotsBlocked + NumShotsUnknown;
+	UE_LOG(LogShipVisibility, Log, TEXT("ShipVisibility: Fire gate %s, %lld requests, %.1f%% cache hits, %lld traces (%.0f per second, %.1f%% blocked), %.3fms game thread per traced pair"),
+		IsFireGateEnabled() ? TEXT("on") : TEXT("off"), NumRequests, NumRequests > 0 ? NumCacheHits * 100.0 / NumRequests : 0.0,
+		NumTraces, ActiveSeconds > 0.0 ? NumTraces / ActiveSeconds : 0.0, NumTraces > 0 ? NumBlockedResults * 100.0 / NumTraces : 0.0,
+		NumTraces > 0 ? GameThreadSeconds * 1000.0 / NumTraces : 0.0);
+	UE_LOG(LogShipVisibility, Log, TEXT("ShipVisibility: %lld AI shots, %lld wasted with the line of sight blocked (%.1f%%), %lld before a result, %lld fire decisions held"),
+		NumShots, NumShotsBlocked, NumShots > 0 ? NumShotsBlocked * 100.0 / NumShots : 0.0, NumShotsUnknown, NumFireHeld);
+}
@@ -0,0 +1,342 @@
+#include "Subsystems/ShipWaveSubsystem.h"
+#include "GalacticArmada.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Pawns/ShipPawn.h"
+#include "Subsystems/ShipAssetPreloadSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipWave, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Ship Wave Spawning"), STAT_ShipWaveSpawning, STATGROUP_GalacticArmada);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wave Ships Spawned"), STAT_WaveShipsSpawned, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<float> CVarWaveBudgetMs(
+	TEXT("ga.Wave.BudgetMs"),
+	2.0f,
+	TEXT("Game thread milliseconds per frame spent spawning wave ships. 0 spawns a whole wave in one frame."));
+
+static TAutoConsoleVariable<bool> CVarWaveUsePool(
+	TEXT("ga.Wave.UsePool"),
+	true,
+	TEXT("Waves activate dormant pooled ships of their class before spawning new ones."));
+
+static TAutoConsoleVariable<FString> CVarWaveDefaultShipClass(
+	TEXT("ga.Wave.DefaultShipClass"),
+	TEXT("/Game/GalacticArmada/Blueprints/Pawns/BP_SpaceFighter.BP_SpaceFighter_C"),
+	TEXT("Ship class spawned by the wave console commands when none is given."));
+
+namespace ShipWave
+{
+	// Dormant pool ships wait out here, hidden and without collision
+	static const FVector PoolLocation(0.0f, 0.0f, -10000000.0f);
+
+	static TSoftClassPtr<AShipPawn> GetShipClass(const TArray<FString>& Args, int32 ArgIndex)
+	{
+		return TSoftClassPtr<AShipPawn>(FSoftObjectPath(Args.IsValidIndex(ArgIndex) ? Args[ArgIndex] : CVarWaveDefaultShipClass.GetValueOnGameThread()));
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs WaveSpawnCommand(
+	TEXT("ga.Wave.Spawn"),
+	TEXT("Spawns a wave in front of the player: ga.Wave.Spawn [Count] [TeamId] [ShipClassPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UShipWaveSubsystem* WaveSubsystem = World ? World->GetSubsystem<UShipWaveSubsystem>() : nullptr;
+		if (!WaveSubsystem) return;
+
+		const int32 Count = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 100;
+		const uint8 TeamId = Args.IsValidIndex(1) ? (uint8)FCString::Atoi(*Args[1]) : 1;
+
+		FTransform Center = FTransform::Identity;
+		const APlayerController* PlayerController = World->GetFirstPlayerController();
+		if (const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr)
+		{
+			// Face the wave towards the player from well out of weapons range
+			const FVector Location = PlayerPawn->GetActorLocation() + PlayerPawn->GetActorForwardVector() * 100000.0f;
+			Center = FTransform((PlayerPawn->GetActorLocation() - Location).Rotation(), Location);
+		}
+
+		WaveSubsystem->QueueWave(ShipWave::GetShipClass(Args, 2), Count, TeamId, Center);
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs WavePrewarmCommand(
+	TEXT("ga.Wave.Prewarm"),
+	TEXT("Fills the spawn pool with dormant ships: ga.Wave.Prewarm [Count] [ShipClassPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UShipWaveSubsystem* WaveSubsystem = World ? World->GetSubsystem<UShipWaveSubsystem>() : nullptr)
+		{
+			WaveSubsystem->PrewarmPool(ShipWave::GetShipClass(Args, 1), Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 100);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld WaveReportCommand(
+	TEXT("ga.Wave.Report"),
+	TEXT("Logs spawn time and the worst frame of every finished wave."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShipWaveSubsystem* WaveSubsystem = World ? World->GetSubsystem<UShipWaveSubsystem>() : nullptr)
+		{
+			WaveSubsystem->LogReport();
+		}
+	}));
+
+bool UShipWaveSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShipWaveSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShipWaveSubsystem, STATGROUP_Tickables);
+}
+
+void UShipWaveSubsystem::Deinitialize()
+{
+	for (FShipWave& Wave : Waves)
+	{
+		if (Wave.LoadHandle.IsValid())
+		{
+			Wave.LoadHandle->CancelHandle();
+		}
+	}
+	Waves.Reset();
+	Pool.Reset();
+
+	Super::Deinitialize();
+}
+
+int32 UShipWaveSubsystem::QueueWave(TSoftClassPtr<AShipPawn> ShipClass, int32 Count, uint8 TeamId, const FTransform& Center, float Spacing)
+{
+	FShipWave Wave;
+	Wave.ShipClass = ShipClass;
+	Wave.Count = Count;
+	Wave.TeamId = TeamId;
+	Wave.Center = Center;
+	Wave.Spacing = Spacing;
+	return AddWave(MoveTemp(Wave));
+}
+
+int32 UShipWaveSubsystem::PrewarmPool(TSoftClassPtr<AShipPawn> ShipClass, int32 Count)
+{
+	FShipWave Wave;
+	Wave.ShipClass = ShipClass;
+	Wave.Count = Count;
+	Wave.Center = FTransform(ShipWave::PoolLocation);
+	Wave.bPrewarm = true;
+	return AddWave(MoveTemp(Wave));
+}
+
+int32 UShipWaveSubsystem::AddWave(FShipWave&& Wave)
+{
+	if (Wave.ShipClass.IsNull() || Wave.Count <= 0)
+	{
+		UE_LOG(LogShipWave, Warning, TEXT("ShipWave: Ignoring a wave of %d ships of class %s."), Wave.Count, *Wave.ShipClass.ToString());
+		return INDEX_NONE;
+	}
+
+	Wave.WaveId = NextWaveId++;
+	Wave.QueueTime = FPlatformTime::Seconds();
+
+	// Load the class off the game thread, waves wait in the queue until it is in memory
+	if (!Wave.ShipClass.Get())
+	{
+		Wave.LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Wave.ShipClass.ToSoftObjectPath());
+	}
+
+	Waves.Add(MoveTemp(Wave));
+	return Waves.Last().WaveId;
+}
+
+int32 UShipWaveSubsystem::GetNumPooled(TSubclassOf<AShipPawn> ShipClass) const
+{
+	const TArray<TWeakObjectPtr<AShipPawn>>* PooledShips = Pool.Find(ShipClass);
+	return PooledShips ? PooledShips->Num() : 0;
+}
+
+void UShipWaveSubsystem::Tick(float DeltaTime)
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+	const double FrameSeconds = LastTickTime > 0.0 ? CurrentTime - LastTickTime : 0.0;
+	LastTickTime = CurrentTime;
+
+	if (Waves.Num() == 0)
+	{
+		AverageIdleFrameSeconds = AverageIdleFrameSeconds > 0.0 ? FMath::Lerp(AverageIdleFrameSeconds, FrameSeconds, 0.05) : FrameSeconds;
+		return;
+	}
+
+	// Waves run one after another, the first one may still be loading
+	FShipWave& Wave = Waves[0];
+	++Wave.Frames;
+	Wave.WorstFrameSeconds = FMath::Max(Wave.WorstFrameSeconds, FrameSeconds);
+
+	UClass* ShipClass = Wave.ShipClass.Get();
+	if (!ShipClass)
+	{
+		if (!Wave.LoadHandle.IsValid() || Wave.LoadHandle->HasLoadCompleted() || Wave.LoadHandle->WasCanceled())
+		{
+			UE_LOG(LogShipWave, Warning, TEXT("ShipWave: Wave %d failed to load %s."), Wave.WaveId, *Wave.ShipClass.ToString());
+			Waves.RemoveAt(0);
+		}
+		return;
+	}
+
+	// Then its weapons and effects, so the first ship of the wave does not load them on the game thread
+	UShipAssetPreloadSubsystem* AssetPreloader = UShipAssetPreloadSubsystem::Get(this);
+	if (AssetPreloader && !AssetPreloader->AreShipClassAssetsLoaded(ShipClass))
+	{
+		AssetPreloader->LoadShipClassAssets(ShipClass);
+		if (!AssetPreloader->AreShipClassAssetsLoaded(ShipClass)) return;
+	}
+
+	if (Wave.LoadSeconds <= 0.0)
+	{
+		Wave.LoadSeconds = CurrentTime - Wave.QueueTime;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ShipWaveSpawning);
+	CSV_SCOPED_TIMING_STAT(GalacticArmada, ShipWaveSpawning);
+
+	// Spawn, finish and possess one step at a time until the budget runs out, at least one step per frame
+	const double BudgetSeconds = CVarWaveBudgetMs.GetValueOnGameThread() / 1000.0;
+	while (StepWave(Wave, ShipClass))
+	{
+		if (BudgetSeconds > 0.0 && FPlatformTime::Seconds() - CurrentTime >= BudgetSeconds) break;
+	}
+
+	const double WorkSeconds = FPlatformTime::Seconds() - CurrentTime;
+	Wave.WorkSeconds += WorkSeconds;
+	Wave.WorstFrameWorkSeconds = FMath::Max(Wave.WorstFrameWorkSeconds, WorkSeconds);
+
+	if (Wave.NumCompleted >= Wave.Count || (Wave.NumStarted >= Wave.Count && Wave.PendingFinish.Num() == 0 && Wave.PendingPossess.Num() == 0))
+	{
+		CompleteWave(Wave);
+		Waves.RemoveAt(0);
+	}
+}
+
+bool UShipWaveSubsystem::StepWave(FShipWave& Wave, UClass* ShipClass)
+{
+	// Finish ships already under way first, so each one joins the fight as early as possible
+	if (Wave.PendingPossess.Num() > 0)
+	{
+		if (AShipPawn* ShipPawn = Wave.PendingPossess.Pop(false).Get())
+		{
+			if (!ShipPawn->GetController())
+			{
+				ShipPawn->SpawnDefaultController();
+			}
+			++Wave.NumCompleted;
+		}
+		return true;
+	}
+
+	if (Wave.PendingFinish.Num() > 0)
+	{
+		if (AShipPawn* ShipPawn = Wave.PendingFinish.Pop(false).Get())
+		{
+			const int32 ShipIndex = Wave.NumStarted - Wave.PendingFinish.Num() - 1;
+
+			// Prewarmed ships wait without a controller, they get one when they leave the pool
+			const EAutoPossessAI AutoPossessAI = ShipPawn->AutoPossessAI;
+			if (Wave.bPrewarm)
+			{
+				ShipPawn->AutoPossessAI = EAutoPossessAI::Disabled;
+			}
+			ShipPawn->FinishSpawning(GetSpawnTransform(Wave, ShipIndex));
+			ShipPawn->AutoPossessAI = AutoPossessAI;
+
+			if (Wave.bPrewarm)
+			{
+				ShipPawn->SetDormant(true);
+				Pool.FindOrAdd(ShipClass).Add(ShipPawn);
+				++Wave.NumCompleted;
+			}
+			else
+			{
+				Wave.PendingPossess.Add(ShipPawn);
+			}
+		}
+		return true;
+	}
+
+	if (Wave.NumStarted >= Wave.Count) return false;
+
+	const int32 ShipIndex = Wave.NumStarted++;
+	const FTransform SpawnTransform = GetSpawnTransform(Wave, ShipIndex);
+	INC_DWORD_STAT(STAT_WaveShipsSpawned);
+
+	// A pooled ship already ran its constructor and BeginPlay, it only needs moving and waking up
+	AShipPawn* PooledShipPawn = !Wave.bPrewarm && CVarWaveUsePool.GetValueOnGameThread() ? TakeFromPool(ShipClass) : nullptr;
+	if (PooledShipPawn)
+	{
+		PooledShipPawn->TeamId = Wave.TeamId;
+		PooledShipPawn->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::TeleportPhysics);
+		PooledShipPawn->SetDormant(false);
+		Wave.PendingPossess.Add(PooledShipPawn);
+		++Wave.NumFromPool;
+		return true;
+	}
+
+	LLM_SCOPE_BYTAG(GalacticArmada_Ships);
+	AShipPawn* ShipPawn = GetWorld()->SpawnActorDeferred<AShipPawn>(ShipClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (ShipPawn)
+	{
+		ShipPawn->TeamId = Wave.TeamId;
+		Wave.PendingFinish.Add(ShipPawn);
+	}
+	return true;
+}
+
+AShipPawn* UShipWaveSubsystem::TakeFromPool(UClass* ShipClass)
+{
+	TArray<TWeakObjectPtr<AShipPawn>>* PooledShips = Pool.Find(ShipClass);
+	while (PooledShips && PooledShips->Num() > 0)
+	{
+		if (AShipPawn* ShipPawn = PooledShips->Pop(false).Get())
+		{
+			return ShipPawn;
+		}
+	}
+	return nullptr;
+}
+
+FTransform UShipWaveSubsystem::GetSpawnTransform(const FShipWave& Wave, int32 ShipIndex) const
+{
+	const int32 RowLength = FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Wave.Count))), 1);
+	const FVector LocalOffset(
+		0.0f,
+		(ShipIndex % RowLength - RowLength * 0.5f) * Wave.Spacing,
+		(ShipIndex / RowLength - RowLength * 0.5f) * Wave.Spacing);
+
+	return FTransform(Wave.Center.GetRotation(), Wave.Center.TransformPosition(LocalOffset));
+}
+
+void UShipWaveSubsystem::CompleteWave(const FShipWave& Wave)
+{
+	const FString Report = FString::Printf(TEXT("Wave %d%s: %d ships (%d from the pool) in %d frames. Load %.1fms, spawn work %.2fms, worst frame %.2fms of spawn work and %.2fms total against %.2fms before the wave"),
+		Wave.WaveId, Wave.bPrewarm ? TEXT(" (prewarm)") : TEXT(""), Wave.NumCompleted, Wave.NumFromPool, Wave.Frames,
+		Wave.LoadSeconds * 1000.0, Wave.WorkSeconds * 1000.0, Wave.WorstFrameWorkSeconds * 1000.0, Wave.WorstFrameSeconds * 1000.0, AverageIdleFrameSeconds * 1000.0);
+
+	UE_LOG(LogShipWave, Log, TEXT("ShipWave: %s"), *Report);
+	CompletedWaveReports.Add(Report);
+}
+
+void UShipWaveSubsystem::LogReport() const
+{
+	int32 NumPooled = 0;
+	for (const TPair<UClass*, TArray<TWeakObjectPtr<AShipPawn>>>& PoolPair : Pool)
+	{
+		NumPooled += PoolPair.Value.Num();
+	}
+
+	UE_LOG(LogShipWave, Log, TEXT("ShipWave: %d waves queued, %d pooled ships, budget %.2fms"), Waves.Num(), NumPooled, CVarWaveBudgetMs.GetValueOnGameThread());
+	for (const FString& Report : CompletedWaveReports)
+	{
+		UE_LOG(LogShipWave, Log, TEXT("ShipWave:   %s"), *Report);
+	}
+}
@@ -0,0 +1,445 @@
+#include "Telemetry/ShipTelemetry.h"
+#include "GalacticArmada.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Compression.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShipTelemetry, Log, All)
+
+DECLARE_CYCLE_STAT(TEXT("Telemetry Flush"), STAT_TelemetryFlush, STATGROUP_GalacticArmada);
+
+static TAutoConsoleVariable<float> CVarTelemetryFlushInterval(
+	TEXT("ga.Telemetry.FlushInterval"),
+	0.5f,
+	TEXT("Seconds between telemetry flushes, rings that are half full are flushed sooner."));
+
+static FAutoConsoleCommand TelemetryStartCommand(
+	TEXT("ga.Telemetry.Start"),
+	TEXT("Starts recording gameplay telemetry to a new file in Saved/Telemetry."),
+	FConsoleCommandDelegate::CreateStatic(&FShipTelemetry::Start));
+
+static FAutoConsoleCommand TelemetryStopCommand(
+	TEXT("ga.Telemetry.Stop"),
+	TEXT("Writes the remaining telemetry and closes the file."),
+	FConsoleCommandDelegate::CreateStatic(&FShipTelemetry::Stop));
+
+static FAutoConsoleCommand TelemetryReportCommand(
+	TEXT("ga.Telemetry.Report"),
+	TEXT("Logs recorded, dropped and written telemetry events, compression and flush time."),
+	FConsoleCommandDelegate::CreateStatic(&FShipTelemetry::LogReport));
+
+static FAutoConsoleCommandWithArgs TelemetryBenchmarkCommand(
+	TEXT("ga.Telemetry.Benchmark"),
+	TEXT("Records synthetic events at a steady rate on top of the running game and logs recording time against frame time: ga.Telemetry.Benchmark [EventsPerSecond] [Seconds]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		struct FBenchmarkState
+		{
+			float EventsPerSecond = 10000.0f;
+			float Duration = 10.0f;
+			float Elapsed = 0.0f;
+			float PendingEvents = 0.0f;
+			int64 NumEvents = 0;
+			int32 NumFrames = 0;
+			double RecordSeconds = 0.0;
+			double FrameSeconds = 0.0;
+			bool bStarted = false;
+		};
+
+		TSharedRef<FBenchmarkState> State = MakeShared<FBenchmarkState>();
+		State->EventsPerSecond = Args.IsValidIndex(0) ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 10000.0f;
+		State->Duration = Args.IsValidIndex(1) ? FMath::Max(FCString::Atof(*Args[1]), 1.0f) : 10.0f;
+
+		// Recording has to reach the file for the measurement to include the rings draining
+		if (!FShipTelemetry::IsEnabled())
+		{
+			FShipTelemetry::Start();
+			State->bStarted = true;
+		}
+
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([State](float DeltaTime)
+		{
+			State->Elapsed += DeltaTime;
+			State->FrameSeconds += DeltaTime;
+			State->PendingEvents += State->EventsPerSecond * DeltaTime;
+			const int32 FrameEvents = FMath::FloorToInt(State->PendingEvents);
+			State->PendingEvents -= FrameEvents;
+
+			const double StartTime = FPlatformTime::Seconds();
+			FShipTelemetryEvent Event;
+			Event.Type = EShipTelemetryEventType::Shot;
+			for (int32 EventIndex = 0; EventIndex < FrameEvents; ++EventIndex)
+			{
+				Event.Time = StartTime;
+				Event.Subject = EventIndex;
+				FShipTelemetry::Write(Event);
+			}
+			State->RecordSeconds += FPlatformTime::Seconds() - StartTime;
+			State->NumEvents += FrameEvents;
+			++State->NumFrames;
+
+			if (State->Elapsed < State->Duration) return true;
+
+			const double Overhead = State->FrameSeconds > 0.0 ? State->RecordSeconds / State->FrameSeconds : 0.0;
+			UE_LOG(LogShipTelemetry, Log, TEXT("ShipTelemetry: Benchmark recorded %lld events over %d frames (%.0f/s), %.1fns per event, %.4fms per %.2fms frame, %.3f%% of frame time"),
+				State->NumEvents, State->NumFrames, State->NumEvents / State->Elapsed,
+				State->NumEvents > 0 ? State->RecordSeconds * 1000000000.0 / State->NumEvents : 0.0,
+				State->RecordSeconds * 1000.0 / FMath::Max(State->NumFrames, 1), State->FrameSeconds * 1000.0 / FMath::Max(State->NumFrames, 1), Overhead * 100.0);
+
+			if (State->bStarted)
+			{
+				FShipTelemetry::Stop();
+			}
+			else
+			{
+				FShipTelemetry::LogReport();
+			}
+			return false;
+		}));
+	}));
+
+namespace ShipTelemetry
+{
+	static const uint32 FileMagic = 0x4C544147; // 'GATL'
+	static const uint32 ChunkMagic = 0x43544147; // 'GATC'
+	static const int32 FileVersion = 1;
+
+	static constexpr uint32 RingCapacity = 16384;
+	static constexpr uint32 RingMask = RingCapacity - 1;
+
+	struct FFileHeader
+	{
+		uint32 Magic = 0;
+		int32 Version = 0;
+		uint32 EventSize = 0;
+		int64 StartTicks = 0;
+	};
+
+	// Events of one flush, CompressedSize 0 when stored uncompressed
+	struct FChunkHeader
+	{
+		uint32 Magic = 0;
+		int32 NumEvents = 0;
+		int32 CompressedSize = 0;
+		int32 UncompressedSize = 0;
+	};
+
+	// Single producer, single consumer ring: Head is only written by the thread that owns it, Tail only by the flush
+	struct FRing
+	{
+		FShipTelemetryEvent Events[RingCapacity];
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Head{ 0 };
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Tail{ 0 };
+		std::atomic<uint32> Dropped{ 0 };
+	};
+
+	static FCriticalSection RingsLock;
+	static TArray<FRing*> Rings;
+	static thread_local FRing* ThreadRing = nullptr;
+
+	// Only one flush runs at a time, the file and the buffers below belong to it
+	static TFuture<void> FlushFuture;
+	static double LastFlushTime = 0.0;
+	static TUniquePtr<FArchive> Writer;
+	static FString FilePath;
+	static TArray<FShipTelemetryEvent> FlushEvents;
+	static TArray<uint8> CompressedData;
+
+	static int64 NumEventsWritten = 0;
+	static int64 NumBytesUncompressed = 0;
+	static int64 NumBytesWritten = 0;
+	static int32 NumFlushes = 0;
+	static double TotalFlushSeconds = 0.0;
+
+	static void WaitForFlush()
+	{
+		if (FlushFuture.IsValid())
+		{
+			FlushFuture.Wait();
+		}
+	}
+
+	static FDelayedAutoRegisterHelper EndFrameRegistration(EDelayedRegisterRunPhase::EndOfEngineInit, []()
+	{
+		FCoreDelegates::OnEndFrame.AddStatic(&FShipTelemetry::OnEndFrame);
+		FCoreDelegates::OnPreExit.AddStatic(&FShipTelemetry::Stop);
+
+		if (FParse::Param(FCommandLine::Get(), TEXT("Telemetry")))
+		{
+			FShipTelemetry::Start();
+		}
+	});
+}
+
+std::atomic<bool> FShipTelemetry::bEnabled{ false };
+
+FString FShipTelemetry::GetTelemetryDir()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Telemetry");
+}
+
+void FShipTelemetry::Write(const FShipTelemetryEvent& Event)
+{
+	ShipTelemetry::FRing* Ring = ShipTelemetry::ThreadRing;
+	if (!Ring)
+	{
+		// Never freed, worker threads live as long as the process
+		Ring = ShipTelemetry::ThreadRing = new ShipTelemetry::FRing();
+
+		FScopeLock Lock(&ShipTelemetry::RingsLock);
+		ShipTelemetry::Rings.Add(Ring);
+	}
+
+	const uint32 Head = Ring->Head.load(std::memory_order_relaxed);
+	if (Head - Ring->Tail.load(std::memory_order_acquire) >= ShipTelemetry::RingCapacity)
+	{
+		Ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	Ring->Events[Head & ShipTelemetry::RingMask] = Event;
+	Ring->Head.store(Head + 1, std::memory_order_release);
+}
+
+void FShipTelemetry::RecordActorEvent(EShipTelemetryEventType Type, const AActor* Subject, const AActor* Other, float Value, uint8 Detail)
+{
+	const UWorld* World = Subject->GetWorld();
+
+	FShipTelemetryEvent Event;
+	Event.Time = World ? World->GetTimeSeconds() : 0.0;
+	Event.Subject = Subject->GetUniqueID();
+	Event.Other = Other ? Other->GetUniqueID() : 0;
+	Event.Value = Value;
+	Event.Type = Type;
+	Event.Detail = Detail;
+	Write(Event);
+}
+
+void FShipTelemetry::RecordMatchEvent(EShipTelemetryEventType Type, const UWorld* World, int32 Match, const AActor* Subject, float Value, uint8 Detail)
+{
+	FShipTelemetryEvent Event;
+	Event.Time = World->GetTimeSeconds();
+	Event.Subject = Subject ? Subject->GetUniqueID() : 0;
+	Event.Value = Value;
+	Event.Match = (int16)Match;
+	Event.Type = Type;
+	Event.Detail = Detail;
+	Write(Event);
+}
+
+void FShipTelemetry::Start()
+{
+	check(IsInGameThread());
+	if (IsEnabled()) return;
+
+	ShipTelemetry::WaitForFlush();
+
+	// Events recorded while stopped are not part of this file
+	{
+		FScopeLock Lock(&ShipTelemetry::RingsLock);
+		for (ShipTelemetry::FRing* Ring : ShipTelemetry::Rings)
+		{
+			Ring->Tail.store(Ring->Head.load(std::memory_order_acquire), std::memory_order_release);
+		}
+	}
+
+	ShipTelemetry::FilePath = GetTelemetryDir() / FString::Printf(TEXT("Telemetry_%s_%u.gatl"), *FDateTime::Now().ToString(), FPlatformProcess::GetCurrentProcessId());
+	ShipTelemetry::Writer.Reset(IFileManager::Get().CreateFileWriter(*ShipTelemetry::FilePath, FILEWRITE_AllowRead));
+	if (!ShipTelemetry::Writer)
+	{
+		UE_LOG(LogShipTelemetry, Warning, TEXT("ShipTelemetry: Failed to open %s"), *ShipTelemetry::FilePath);
+		return;
+	}
+
+	ShipTelemetry::FFileHeader FileHeader;
+	FileHeader.Magic = ShipTelemetry::FileMagic;
+	FileHeader.Version = ShipTelemetry::FileVersion;
+	FileHeader.EventSize = sizeof(FShipTelemetryEvent);
+	FileHeader.StartTicks = FDateTime::UtcNow().GetTicks();
+	ShipTelemetry::Writer->Serialize(&FileHeader, sizeof(FileHeader));
+
+	ShipTelemetry::NumEventsWritten = 0;
+	ShipTelemetry::NumBytesUncompressed = 0;
+	ShipTelemetry::NumBytesWritten = sizeof(FileHeader);
+	ShipTelemetry::NumFlushes = 0;
+	ShipTelemetry::TotalFlushSeconds = 0.0;
+	ShipTelemetry::LastFlushTime = FPlatformTime::Seconds();
+	bEnabled.store(true);
+
+	UE_LOG(LogShipTelemetry, Log, TEXT("ShipTelemetry: Recording to %s"), *ShipTelemetry::FilePath);
+}
+
+void FShipTelemetry::Stop()
+{
+	check(IsInGameThread());
+	if (!IsEnabled()) return;
+
+	bEnabled.store(false);
+	ShipTelemetry::WaitForFlush();
+	Flush();
+
+	if (ShipTelemetry::Writer)
+	{
+		ShipTelemetry::Writer->Close();
+		ShipTelemetry::Writer.Reset();
+	}
+
+	LogReport();
+}
+
+void FShipTelemetry::OnEndFrame()
+{
+	if (!IsEnabled() || (ShipTelemetry::FlushFuture.IsValid() && !ShipTelemetry::FlushFuture.IsReady())) return;
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	bool bShouldFlush = CurrentTime - ShipTelemetry::LastFlushTime >= CVarTelemetryFlushInterval.GetValueOnGameThread();
+	if (!bShouldFlush)
+	{
+		FScopeLock Lock(&ShipTelemetry::RingsLock);
+		for (const ShipTelemetry::FRing* Ring : ShipTelemetry::Rings)
+		{
+			if (Ring->Head.load(std::memory_order_relaxed) - Ring->Tail.load(std::memory_order_relaxed) >= ShipTelemetry::RingCapacity / 2)
+			{
+				bShouldFlush = true;
+				break;
+			}
+		}
+	}
+	if (!bShouldFlush) return;
+
+	ShipTelemetry::LastFlushTime = CurrentTime;
+	ShipTelemetry::FlushFuture = Async(EAsyncExecution::ThreadPool, []()
+	{
+		Flush();
+	});
+}
+
+void FShipTelemetry::Flush()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TelemetryFlush);
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<ShipTelemetry::FRing*, TInlineAllocator<64>> FlushRings;
+	{
+		FScopeLock Lock(&ShipTelemetry::RingsLock);
+		FlushRings.Append(ShipTelemetry::Rings);
+	}
+
+	// Take everything recorded so far, in at most two copies per ring
+	TArray<FShipTelemetryEvent>& Events = ShipTelemetry::FlushEvents;
+	Events.Reset();
+	for (ShipTelemetry::FRing* Ring : FlushRings)
+	{
+		const uint32 Head = Ring->Head.load(std::memory_order_acquire);
+		const uint32 Tail = Ring->Tail.load(std::memory_order_relaxed);
+		const uint32 Count = Head - Tail;
+		if (Count == 0) continue;
+
+		const uint32 First = Tail & ShipTelemetry::RingMask;
+		const uint32 FirstCount = FMath::Min(Count, ShipTelemetry::RingCapacity - First);
+		Events.Append(Ring->Events + First, FirstCount);
+		Events.Append(Ring->Events, Count - FirstCount);
+		Ring->Tail.store(Head, std::memory_order_release);
+	}
+
+	if (Events.Num() == 0 || !ShipTelemetry::Writer) return;
+
+	ShipTelemetry::FChunkHeader ChunkHeader;
+	ChunkHeader.Magic = ShipTelemetry::ChunkMagic;
+	ChunkHeader.NumEvents = Events.Num();
+	ChunkHeader.UncompressedSize = Events.Num() * sizeof(FShipTelemetryEvent);
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, ChunkHeader.UncompressedSize);
+	ShipTelemetry::CompressedData.SetNumUninitialized(CompressedSize, false);
+	const bool bCompressed = FCompression::CompressMemory(NAME_Oodle, ShipTelemetry::CompressedData.GetData(), CompressedSize, Events.GetData(), ChunkHeader.UncompressedSize)
+		&& CompressedSize < ChunkHeader.UncompressedSize;
+	ChunkHeader.CompressedSize = bCompressed ? CompressedSize : 0;
+
+	// Flushed chunk by chunk so a crash loses at most the events still in the rings
+	FArchive& FileWriter = *ShipTelemetry::Writer;
+	FileWriter.Serialize(&ChunkHeader, sizeof(ChunkHeader));
+	if (bCompressed)
+	{
+		FileWriter.Serialize(ShipTelemetry::CompressedData.GetData(), CompressedSize);
+	}
+	else
+	{
+		FileWriter.Serialize(Events.GetData(), ChunkHeader.UncompressedSize);
+	}
+	FileWriter.Flush();
+
+	ShipTelemetry::NumEventsWritten += Events.Num();
+	ShipTelemetry::NumBytesUncompressed += ChunkHeader.UncompressedSize;
+	ShipTelemetry::NumBytesWritten += sizeof(ChunkHeader) + (bCompressed ? CompressedSize : ChunkHeader.UncompressedSize);
+	++ShipTelemetry::NumFlushes;
+	ShipTelemetry::TotalFlushSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void FShipTelemetry::LogReport()
+{
+	int64 NumRecorded = 0;
+	int64 NumDropped = 0;
+	int32 NumRings = 0;
+	{
+		FScopeLock Lock(&ShipTelemetry::RingsLock);
+		for (const ShipTelemetry::FRing* Ring : ShipTelemetry::Rings)
+		{
+			NumRecorded += Ring->Head.load(std::memory_order_relaxed);
+			NumDropped += Ring->Dropped.load(std::memory_order_relaxed);
+		}
+		NumRings = ShipTelemetry::Rings.Num();
+	}
+
+	UE_LOG(LogShipTelemetry, Log, TEXT("ShipTelemetry: %s. %lld events recorded on %d threads, %lld dropped. %lld written to %s in %d chunks, %.1fKB compressed to %.1fKB. Flush %.3fms on average"),
+		IsEnabled() ? TEXT("Recording") : TEXT("Stopped"), NumRecorded, NumRings, NumDropped,
+		ShipTelemetry::NumEventsWritten, *ShipTelemetry::FilePath, ShipTelemetry::NumFlushes,
+		ShipTelemetry::NumBytesUncompressed / 1024.0, ShipTelemetry::NumBytesWritten / 1024.0,
+		ShipTelemetry::NumFlushes > 0 ? ShipTelemetry::TotalFlushSeconds * 1000.0 / ShipTelemetry::NumFlushes : 0.0);
+}
+
+bool FShipTelemetry::ReadFile(const FString& InFilePath, TArray<FShipTelemetryEvent>& OutEvents)
+{
+	TArray64<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *InFilePath) || Data.Num() < (int64)sizeof(ShipTelemetry::FFileHeader)) return false;
+
+	const ShipTelemetry::FFileHeader* FileHeader = reinterpret_cast<const ShipTelemetry::FFileHeader*>(Data.GetData());
+	if (FileHeader->Magic != ShipTelemetry::FileMagic || FileHeader->Version != ShipTelemetry::FileVersion || FileHeader->EventSize != sizeof(FShipTelemetryEvent)) return false;
+
+	// A file cut short by a crash keeps every chunk written before it
+	int64 Offset = sizeof(ShipTelemetry::FFileHeader);
+	while (Offset + (int64)sizeof(ShipTelemetry::FChunkHeader) <= Data.Num())
+	{
+		const ShipTelemetry::FChunkHeader* ChunkHeader = reinterpret_cast<const ShipTelemetry::FChunkHeader*>(Data.GetData() + Offset);
+		Offset += sizeof(ShipTelemetry::FChunkHeader);
+
+		const int32 StoredSize = ChunkHeader->CompressedSize > 0 ? ChunkHeader->CompressedSize : ChunkHeader->UncompressedSize;
+		if (ChunkHeader->Magic != ShipTelemetry::ChunkMagic || ChunkHeader->NumEvents <= 0 || StoredSize <= 0
+			|| ChunkHeader->UncompressedSize != ChunkHeader->NumEvents * (int32)sizeof(FShipTelemetryEvent) || Offset + StoredSize > Data.Num()) break;
+
+		const int32 FirstEvent = OutEvents.AddUninitialized(ChunkHeader->NumEvents);
+		if (ChunkHeader->CompressedSize > 0)
+		{
+			if (!FCompression::UncompressMemory(NAME_Oodle, OutEvents.GetData() + FirstEvent, ChunkHeader->UncompressedSize, Data.GetData() + Offset, ChunkHeader->CompressedSize))
+			{
+				OutEvents.SetNum(FirstEvent, false);
+				break;
+			}
+		}
+		else
+		{
+			FMemory::Memcpy(OutEvents.GetData() + FirstEvent, Data.GetData() + Offset, ChunkHeader->UncompressedSize);
+		}
+		Offset += StoredSize;
+	}
+
+	return true;
+}
@@ -0,0 +1,152 @@
+#include "Flight/ProjectileBallistics.h"
+#include "Flight/ShipFlightModel.h"
+#include "Flight/ShipSteering.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The flight core needs no world, these run headless: -ExecCmds="Automation RunTests GalacticArmada.Flight" -nullrhi -unattended
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShipFlightStateTest, "GalacticArmada.Flight.FlightModel.UpdateState", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShipFlightStateTest::RunTest(const FString& Parameters)
+{
+	const FShipFlightParams Params;
+
+	// A full second at these interp speeds reaches the targets, pitch input is inverted
+	FShipFlightState State;
+	ShipFlight::UpdateState(Params, { 1.0f, 1.0f, -1.0f, 1.0f }, 1.0f, State);
+	TestEqual(TEXT("Roll reaches the flap angle"), State.Roll, Params.FlapAngle, 0.001f);
+	TestEqual(TEXT("Pitch is inverted"), State.Pitch, -Params.ElevatorAngle, 0.001f);
+	TestEqual(TEXT("Yaw reaches the rudder angle"), State.Yaw, -Params.RudderAngle, 0.001f);
+	TestEqual(TEXT("Speed reaches the max speed"), State.Speed, Params.MaxSpeed, 0.001f);
+
+	// A short step only covers part of the gap
+	FShipFlightState PartialState;
+	ShipFlight::UpdateState(Params, { 1.0f, 0.0f, 0.0f, 0.0f }, 0.05f, PartialState);
+	TestEqual(TEXT("Roll moves half way at alpha 0.5"), PartialState.Roll, Params.FlapAngle * 0.5f, 0.001f);
+	TestEqual(TEXT("No thrust keeps the ship at min speed"), PartialState.Speed, Params.MinSpeed, 0.001f);
+
+	// The array update with shared params matches ship by ship updates
+	const TArray<FShipFlightInput> Inputs = { { 0.5f, -0.25f, 1.0f, 1.0f }, { -1.0f, 0.75f, 0.0f, -1.0f }, { 0.0f, 0.0f, 0.0f, 0.5f } };
+	TArray<FShipFlightState> ArrayStates;
+	ArrayStates.SetNum(Inputs.Num());
+	ShipFlight::UpdateStates(MakeArrayView(&Params, 1), Inputs, 0.016f, ArrayStates);
+	for (int32 Index = 0; Index < Inputs.Num(); ++Index)
+	{
+		FShipFlightState SingleState;
+		ShipFlight::UpdateState(Params, Inputs[Index], 0.016f, SingleState);
+		TestEqual(TEXT("Array roll matches"), ArrayStates[Index].Roll, SingleState.Roll);
+		TestEqual(TEXT("Array pitch matches"), ArrayStates[Index].Pitch, SingleState.Pitch);
+		TestEqual(TEXT("Array yaw matches"), ArrayStates[Index].Yaw, SingleState.Yaw);
+		TestEqual(TEXT("Array speed matches"), ArrayStates[Index].Speed, SingleState.Speed);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShipFlightPoseTest, "GalacticArmada.Flight.FlightModel.IntegratePose", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShipFlightPoseTest::RunTest(const FString& Parameters)
+{
+	// Without rotation rates the ship flies straight along its forward vector
+	FShipFlightState State;
+	State.Speed = 1000.0f;
+	FShipFlightPose Pose;
+	ShipFlight::IntegratePose(State, 0.5f, Pose);
+	TestEqual(TEXT("Straight flight"), Pose.Location, FVector(500.0f, 0.0f, 0.0f), 0.01f);
+
+	// A yaw rate turns the nose before the step moves the ship
+	State.Yaw = 90.0f;
+	FShipFlightPose TurningPose;
+	ShipFlight::IntegratePose(State, 1.0f, TurningPose);
+	TestEqual(TEXT("Quarter turn faces right"), TurningPose.Rotation.GetForwardVector(), FVector(0.0f, 1.0f, 0.0f), 0.001f);
+	TestEqual(TEXT("Quarter turn moves right"), TurningPose.Location, FVector(0.0f, 1000.0f, 0.0f), 0.1f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShipSteeringTest, "GalacticArmada.Flight.Steering", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShipSteeringTest::RunTest(const FString& Parameters)
+{
+	const FShipSteeringParams Params;
+
+	// Target far ahead: no turning, full thrust
+	const FRotator AheadRotation = ShipSteering::GetTargetDeltaRotation(FVector::ZeroVector, FRotator::ZeroRotator, FVector(100000.0f, 0.0f, 0.0f));
+	const FShipFlightInput AheadInput = ShipSteering::ComputeInput(AheadRotation, ShipSteering::ShouldApproach(Params, FVector::ZeroVector, FVector(100000.0f, 0.0f, 0.0f)));
+	TestEqual(TEXT("No yaw towards a target ahead"), AheadInput.Yaw, 0.0f, 0.001f);
+	TestEqual(TEXT("Full thrust towards a distant target"), AheadInput.Thrust, 1.0f);
+
+	// Inside the stopping distance the ship brakes
+	TestFalse(TEXT("No approach inside the stopping distance"), ShipSteering::ShouldApproach(Params, FVector::ZeroVector, FVector(10000.0f, 0.0f, 0.0f)));
+
+	// Target to the right: half yaw input for a 90 degree turn
+	const FRotator RightRotation = ShipSteering::GetTargetDeltaRotation(FVector::ZeroVector, FRotator::ZeroRotator, FVector(0.0f, 100000.0f, 0.0f));
+	TestEqual(TEXT("Yaw towards a target on the right"), ShipSteering::ComputeInput(RightRotation, true).Yaw, 0.5f, 0.001f);
+	TestEqual(TEXT("Input axes clamp"), ShipSteering::RotationToInputAxis(360.0f, 180.0f), 1.0f);
+
+	// Avoidance only kicks in for obstacles inside the avoidance distance
+	FRotator TargetRotation = FRotator::ZeroRotator;
+	TestFalse(TEXT("No obstacle, no avoidance"), ShipSteering::ApplyAvoidance(Params, FVector::ZeroVector, FVector::ZeroVector, TargetRotation));
+	TestFalse(TEXT("Distant obstacle, no avoidance"), ShipSteering::ApplyAvoidance(Params, FVector::ZeroVector, FVector(40000.0f, 0.0f, 0.0f), TargetRotation));
+	TestTrue(TEXT("Close obstacle is avoided"), ShipSteering::ApplyAvoidance(Params, FVector::ZeroVector, FVector(10000.0f, 0.0f, 0.0f), TargetRotation));
+	TestFalse(TEXT("Avoidance changes the target rotation"), TargetRotation.Equals(FRotator::ZeroRotator));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProjectileBallisticsTest, "GalacticArmada.Flight.Ballistics", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FProjectileBallisticsTest::RunTest(const FString& Parameters)
+{
+	FVector Location = FVector::ZeroVector;
+	ProjectileBallistics::Integrate(Location, FVector(100.0f, 0.0f, 0.0f), 2.0f);
+	TestEqual(TEXT("Bolts fly straight"), Location, FVector(200.0f, 0.0f, 0.0f));
+
+	// Stationary target dead ahead: aim at it, certain hit
+	FInterceptRequest Request;
+	Request.TargetLocation = FVector(20000.0f, 0.0f, 0.0f);
+	Request.ProjectileSpeed = 10000.0f;
+	const FInterceptSolution StillSolution = ProjectileBallistics::SolveIntercept(Request);
+	TestTrue(TEXT("Stationary target is solvable"), StillSolution.bValid);
+	TestEqual(TEXT("Time to a stationary target"), StillSolution.TimeToImpact, 2.0f, 0.001f);
+	TestEqual(TEXT("Aim at a stationary target"), StillSolution.AimLocation, Request.TargetLocation, 1.0f);
+	TestEqual(TEXT("Certain hit on a stationary target"), StillSolution.HitProbability, 1.0f, 0.01f);
+
+	// Crossing target: the bolt and the target arrive at the aim point together
+	Request.TargetVelocity = FVector(0.0f, 5000.0f, 0.0f);
+	const FInterceptSolution CrossingSolution = ProjectileBallistics::SolveIntercept(Request);
+	TestTrue(TEXT("Crossing target is solvable"), CrossingSolution.bValid);
+	TestEqual(TEXT("Bolt reaches the aim point"), CrossingSolution.AimLocation.Size(), Request.ProjectileSpeed * CrossingSolution.TimeToImpact, 1.0f);
+	TestEqual(TEXT("Target reaches the aim point"), CrossingSolution.AimLocation.Y, Request.TargetVelocity.Y * CrossingSolution.TimeToImpact, 1.0f);
+	TestTrue(TEXT("Misaligned cannons lower the hit chance"), CrossingSolution.HitProbability < StillSolution.HitProbability);
+
+	// A target outrunning the bolt cannot be intercepted
+	Request.TargetVelocity = FVector(0.0f, 20000.0f, 0.0f);
+	const FInterceptSolution EscapingSolution = ProjectileBallistics::SolveIntercept(Request);
+	TestFalse(TEXT("Faster target is not solvable"), EscapingSolution.bValid);
+	TestEqual(TEXT("No hit chance on a faster target"), EscapingSolution.HitProbability, 0.0f);
+
+	// A batch that does not fill its last four lanes matches the single solves
+	TArray<FInterceptRequest> Requests;
+	for (int32 Index = 0; Index < 5; ++Index)
+	{
+		FInterceptRequest& BatchRequest = Requests.Add_GetRef(Request);
+		BatchRequest.ShooterLocation = FVector(0.0f, 0.0f, Index * 1000.0f);
+		BatchRequest.TargetVelocity = FVector(0.0f, Index * 1000.0f, 0.0f);
+	}
+	TArray<FInterceptSolution> Solutions;
+	Solutions.SetNum(Requests.Num());
+	ProjectileBallistics::SolveInterceptBatch(Requests, Solutions);
+	for (int32 Index = 0; Index < Requests.Num(); ++Index)
+	{
+		const FInterceptSolution SingleSolution = ProjectileBallistics::SolveIntercept(Requests[Index]);
+		TestEqual(TEXT("Batched aim matches"), Solutions[Index].AimLocation, SingleSolution.AimLocation);
+		TestEqual(TEXT("Batched time matches"), Solutions[Index].TimeToImpact, SingleSolution.TimeToImpact);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Actors/ProjectileBase.h"
+#include "ExplosiveProjectile.generated.h"
+
+/**
+ * Area weapon for cannons such as flak and torpedoes. Detonates on impact or when its fuse runs out and deals
+ * its damage to every damageable actor in the blast radius, falling off from the inner radius outwards.
+ */
+UCLASS()
+class GALACTICARMADA_API AExplosiveProjectile : public AProjectileBase
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void HandleImpact(AActor* OtherActor, const FHitResult& SweepResult) override;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float ExplosionInnerRadius = 500.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float ExplosionRadius = 2500.0f;
+
+	// Damage at the edge of the blast, Damage applies inside the inner radius
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float MinimumDamage = 0.0f;
+
+	// Seconds after launch the projectile bursts on its own, flak uses it to burst in the target's path. 0 waits for an impact.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	float FuseTime = 0.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Explosion")
+	TSubclassOf<UDamageType> ExplosionDamageType;
+
+	UFUNCTION(BlueprintCallable, Category = "Explosion")
+	void Detonate();
+
+public:
+	virtual void RestoreFlightAge(float Age) override;
+
+private:
+	FTimerHandle FuseTimerHandle;
+	bool bDetonated = false;
+};
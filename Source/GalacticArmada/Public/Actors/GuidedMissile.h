@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Actors/ProjectileBase.h"
+#include "GuidedMissile.generated.h"
+
+class AShipPawn;
+
+/**
+ * Homing missile for the secondary cannon group. Guidance is not run by the missile itself, the missile subsystem
+ * steers every live missile with proportional navigation in one pass per frame and recycles spent missiles.
+ */
+UCLASS()
+class GALACTICARMADA_API AGuidedMissile : public AProjectileBase
+{
+	GENERATED_BODY()
+
+public:
+	AGuidedMissile();
+
+	// Proportional navigation constant, 3 to 5 intercepts manoeuvring targets without overshooting
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guidance")
+	float NavigationConstant = 4.0f;
+
+	// Lateral acceleration limit in cm/s^2
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guidance")
+	float MaxAcceleration = 400000.0f;
+
+	// Targets further than this cannot be locked at launch
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guidance")
+	float LockOnRange = 80000.0f;
+
+	// Half angle of the seeker in degrees, the lock is lost once the target leaves it
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guidance")
+	float SeekerHalfAngle = 60.0f;
+
+	// Seconds of flight before the missile self destructs and returns to the pool
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guidance")
+	float FlightTime = 8.0f;
+
+	virtual float GetFlightAge() const override;
+	virtual void RestoreFlightAge(float Age) override;
+
+	FORCEINLINE AShipPawn* GetLockedTarget() const { return LockedTarget.Get(); }
+
+protected:
+	virtual void HandleImpact(AActor* OtherActor, const FHitResult& SweepResult) override;
+
+private:
+	friend class UShipMissileSubsystem;
+
+	TWeakObjectPtr<AShipPawn> LockedTarget;
+	float FlightAge = 0.0f;
+	int32 ActiveIndex = INDEX_NONE;
+};
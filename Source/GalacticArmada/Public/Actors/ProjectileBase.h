@@ -27,19 +27,45 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Damage")
 	float Damage = 10.0f;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Impact Effects")
-	UNiagaraSystem* ImpactEffect;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Impact Effects", meta = (AssetBundles = "Cosmetic"))
+	TSoftObjectPtr<UNiagaraSystem> ImpactEffect;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Impact Effects")
-	TSubclassOf<UCameraShakeBase> ImpactCameraShake;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Impact Effects", meta = (AssetBundles = "Cosmetic"))
+	TSoftClassPtr<UCameraShakeBase> ImpactCameraShake;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Lifetime")
 	float DestroyDelay = 2.0f;  // Delay before destroying the projectile
 
 	FTimerHandle DestroyTimerHandle;
 
+	// World time the current flight started at, moved back when a snapshot restores an older flight
+	float LaunchTime = 0.0f;
+
+	virtual void BeginPlay() override;
+
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
+	// Deals the projectile's damage to whatever it hit, area weapons detonate instead
+	virtual void HandleImpact(AActor* OtherActor, const FHitResult& SweepResult);
+
+	void PlayImpactEffects() const;
+
 	void DestroyProjectile();
+
+public:
+	// Launch speed of the movement component, read from the class defaults by AI gunnery
+	float GetInitialSpeed() const;
+
+	void GatherAssetBundles(struct FShipAssetBundles& OutBundles) const;
+
+	// Seconds since launch, battle snapshots store it so lifetimes and fuses resume where they were
+	virtual float GetFlightAge() const;
+	virtual void RestoreFlightAge(float Age);
+
+	// Projectiles that already hit something or wait hidden in a pool are no longer part of the battle
+	FORCEINLINE bool IsSpent() const { return IsHidden() || DestroyTimerHandle.IsValid(); }
+
+	FORCEINLINE float GetDamage() const { return Damage; }
+	FORCEINLINE UProjectileMovementComponent* GetProjectileMovementComponent() const { return ProjectileMovementComponent; }
 };
\ No newline at end of file
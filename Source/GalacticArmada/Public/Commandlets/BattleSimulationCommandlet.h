@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BattleSimulationCommandlet.generated.h"
+
+/**
+ * Fans a battle simulation batch out over several headless game processes and merges their results.
+ * Usage: -run=BattleSimulation -Map=/Game/GalacticArmada/Maps/TestLevel -Processes=8 -Matches=1000 [-ShipsPerTeam=4 -ShipA=... -ShipB=... -LLM -Telemetry]
+ */
+UCLASS()
+class GALACTICARMADA_API UBattleSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBattleSimulationCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TelemetryAnalyzerCommandlet.generated.h"
+
+/**
+ * Aggregates gameplay telemetry files into per match statistics (accuracy, damage by source, time to kill,
+ * engagement ranges) and a table of who damaged and destroyed whom, written as CSV next to the input.
+ * Usage: -run=TelemetryAnalyzer [-Input=<file or directory, default Saved/Telemetry>] [-Output=<directory>]
+ */
+UCLASS()
+class GALACTICARMADA_API UTelemetryAnalyzerCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTelemetryAnalyzerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
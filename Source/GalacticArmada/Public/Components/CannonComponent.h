@@ -7,6 +7,7 @@
 class USkeletalMeshComponent;
 class UNiagaraSystem;
 class UNiagaraComponent;
+class UShipLoadoutDataAsset;
 
 UENUM(BlueprintType)
 enum class ECannonFireMode : uint8
@@ -35,25 +36,31 @@ struct FCannonFireProperties
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cannon")
     TArray<FName> FireLocationSocketNames;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cannon")
-    TSubclassOf<class AProjectileBase> ProjectileClass;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cannon", meta = (AssetBundles = "Gameplay"))
+    TSoftClassPtr<class AProjectileBase> ProjectileClass;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cannon")
-    UNiagaraSystem* MuzzleParticleEffect;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cannon", meta = (AssetBundles = "Cosmetic"))
+    TSoftObjectPtr<UNiagaraSystem> MuzzleParticleEffect;
 
     FCannonFireProperties()
         : Enabled(true),
           IsAutomaticFire(false),
           FireRate(1.0f),
-          CannonFireMode(ECannonFireMode::All),
-          ProjectileClass(nullptr),
-          MuzzleParticleEffect(nullptr)
+          CannonFireMode(ECannonFireMode::All)
     {
     }
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCannonFireEvent, int32, CannonIndex);
 
+// Per ship runtime state of one cannon group, everything else is shared through the loadout
+struct FCannonFireState
+{
+    float NextFireTime = 0.0f;
+    uint8 NextSocket = 0;
+    bool bFiring = false;
+};
+
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class GALACTICARMADA_API UCannonComponent : public UActorComponent
 {
@@ -62,6 +69,9 @@ class GALACTICARMADA_API UCannonComponent : public UActorComponent
 public:
     UCannonComponent();
 
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
 protected:
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -70,14 +80,20 @@ protected:
     APawn* PawnOwner;
 
 public:
+    // Shared weapon loadout, takes precedence over the cannon array below
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cannon")
+    UShipLoadoutDataAsset* Loadout;
+
+    // Per instance cannons of ships not yet moved to a loadout, shared through a transient loadout at runtime
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cannon")
     TArray<FCannonFireProperties> CannonFirePropertiesArray;
 
     UPROPERTY(BlueprintReadWrite, Category = "Cannon")
     USkeletalMeshComponent* OwnerSkeletalMeshComponent;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effects")
-    TSubclassOf<UCameraShakeBase> FireCameraShake;
+    // Used with the cannon array, loadouts carry their own
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effects", meta = (AssetBundles = "Cosmetic"))
+    TSoftClassPtr<UCameraShakeBase> FireCameraShake;
 
     UFUNCTION(BlueprintCallable, Category = "Cannon")
     void BeginCannonFire(int32 CannonIndex);
@@ -85,18 +101,48 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Cannon")
     void EndCannonFire(int32 CannonIndex);
 
+    // Stops every cannon group, for ships leaving the fight
+    void EndAllCannonFire();
+
+    // Blueprint adapter, native code subscribes to the fire channel of UShipEventSubsystem
     UPROPERTY(BlueprintAssignable, Category = "Cannon")
     FCannonFireEvent OnCannonFired;
 
+    // Fire from socket transforms captured once instead of evaluating the skeletal pose, used by proxy ships
+    void SetUseCachedSocketTransforms(bool bUseCached);
+
+    void GatherAssetBundles(struct FShipAssetBundles& OutBundles) const;
+
+    // Loadout this cannon fires with. Class defaults resolve it without caching it, so they are never modified.
+    UShipLoadoutDataAsset* GetLoadout() const;
+
+    // Resolves the loadout and sizes the per ship fire state, called from BeginPlay
+    void InitializeLoadout();
+
+    // Heap memory owned by this component on top of its object size
+    SIZE_T GetAllocatedSize() const;
+
+    FORCEINLINE TConstArrayView<FCannonFireState> GetFireStates() const { return FireStates; }
+
+    // Copies fire states saved in a battle snapshot back in, their NextFireTime relative to the current world time
+    void RestoreFireStates(TConstArrayView<FCannonFireState> States);
+
 private:
-    TArray<int32> SequentialCannonIndices;
-    TArray<FTimerHandle> AutomaticFireTimers;
+    // Loadout asset or the transient one built from the cannon array
+    UPROPERTY(Transient)
+    UShipLoadoutDataAsset* ActiveLoadout;
+
+    TArray<FCannonFireState> FireStates;
+
+    bool bUseCachedSocketTransforms = false;
+    TArray<FTransform> CachedSocketTransforms;
 
     FActorSpawnParameters ProjectileSpawnParams;
     
     void FireCannon(int32 CannonIndex);
-    void FireAllCannons(const FCannonFireProperties& CannonFireProps) const;
-    void FireSequentialCannon(const FCannonFireProperties& CannonFireProps, int32& CurrentCannonIndex) const;
+    void FireAllCannons(int32 CannonIndex) const;
+    void FireSequentialCannon(int32 CannonIndex);
+    void FireFromSocket(int32 CannonIndex, int32 SocketIndex) const;
     void StartAutomaticFire(int32 CannonIndex);
     void StopAutomaticFire(int32 CannonIndex);
 };
\ No newline at end of file
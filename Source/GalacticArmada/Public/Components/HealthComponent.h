@@ -20,6 +20,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Health")
 	float DefaultHealth;
@@ -27,16 +28,12 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Health")
 	float Health;
 
+	// Point and radial damage broadcast OnTakeAnyDamage as well, binding their own delegates would apply them twice
 	UFUNCTION()
 	void HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
 
-	UFUNCTION()
-	void HandleTakePointDamage(AActor* DamagedActor, float Damage, class AController* InstigatedBy, FVector HitLocation, class UPrimitiveComponent* FHitComponent, FName BoneName, FVector ShotFromDirection, const class UDamageType* DamageType, AActor* DamageCauser);
-
-	UFUNCTION()
-	void HandleTakeRadialDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, class AController* InstigatedBy, AActor* DamageCauser);
-
 public:
+	// Blueprint adapters, native code subscribes to the damage and death channels of UShipEventSubsystem
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FOnHealthChangedSignature OnHealthChanged;
 
@@ -47,4 +44,5 @@ public:
 	FORCEINLINE float GetHealth() const { return Health; }
 
 	FORCEINLINE void SetDefaultHealth(const float HealthValue) { DefaultHealth = HealthValue; }
+	FORCEINLINE void SetHealth(const float HealthValue) { Health = FMath::Clamp(HealthValue, 0.0f, DefaultHealth); }
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Flight/ShipFlightModel.h"
 #include "ShipMovementComponent.generated.h"
 
 
@@ -13,7 +14,10 @@ class GALACTICARMADA_API UShipMovementComponent : public UActorComponent
 public:	
 	UShipMovementComponent();
 	
+	virtual void BeginPlay() override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void AsyncPhysicsTickComponent(float DeltaTime, float SimTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 protected:
 	// Thrust Properties
@@ -52,32 +56,68 @@ protected:
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement Properties")
 	float RudderSpeed;
+
+
+	// Physics Properties
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement Properties|Physics")
+	bool bUseAsyncPhysicsFlight;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement Properties|Physics", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float LinearResponse;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement Properties|Physics", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AngularResponse;
 	
 public:
 	void SetYawInput(float InputValue);
 	void SetPitchInput(float InputValue);
 	void SetRollInput(float InputValue);
 	void SetThrustInput(float InputValue);
+	void SetFlightInput(const FShipFlightInput& InputValue);
 
-private:
-	float CurrentThrustInput;
-	float CurrentRollInput;
-	float CurrentPitchInput;
-	float CurrentYawInput;
+	// Restores flight state carried over from another representation, e.g. a Mass fleet entity
+	void SetFlightState(const FShipFlightState& StateValue);
+
+	FShipFlightParams MakeFlightParams() const;
 
-	float CurrentSpeed;
-	float CurrentRoll;
-	float CurrentPitch;
-	float CurrentYaw;
+	// Kinematic flight moves the actor without sweeps or a physics body, used by proxy ships
+	void SetKinematicFlight(bool bEnable);
 
-	void UpdateRotationMovement(float DeltaSeconds, float& CurrentValue, float InputValue, float MaxAngle, float Speed, FRotator RotationAxis);
-	void UpdateThrustMovement(float DeltaSeconds);
+	// Game thread moves committed by every ship since startup, each one propagates to all attached components
+	static uint64 GetNumTransformCommits();
+
+private:
+	FShipFlightParams FlightParams;
+	FShipFlightInput FlightInput;
+	FShipFlightState FlightState;
+
+	// Async physics flight: inputs are buffered for the physics thread and its state is published back, all under AsyncFlightLock
+	bool bAsyncFlightActive = false;
+	FBodyInstance* FlightBodyInstance = nullptr;
+	FCriticalSection AsyncFlightLock;
+	FShipFlightInput BufferedFlightInput;
+	FShipFlightState AsyncFlightState;
+	FShipFlightState PublishedFlightState;
+
+	bool bKinematicFlight = false;
+	bool bResumeAsyncFlight = false;
+
+	bool StartAsyncPhysicsFlight();
+	void StopAsyncPhysicsFlight();
+	void BufferFlightInput();
+	void UpdateKinematicMovement(float DeltaSeconds);
+	void UpdateFlightMovement(float DeltaSeconds);
 
 public:
 	FORCEINLINE float GetMinSpeed() const { return MinSpeed; }
 	FORCEINLINE float GetMaxSpeed() const { return MaxSpeed; }
-	FORCEINLINE float GetCurrentSpeed() const { return CurrentSpeed; }
-	FORCEINLINE float GetCurrentRoll() const { return CurrentYaw; }
-	FORCEINLINE float GetCurrentPitch() const { return CurrentPitch; }
-	FORCEINLINE float GetCurrentYaw() const { return CurrentYaw; }
+	FORCEINLINE float GetCurrentSpeed() const { return FlightState.Speed; }
+	FORCEINLINE float GetCurrentRoll() const { return FlightState.Roll; }
+	FORCEINLINE float GetCurrentPitch() const { return FlightState.Pitch; }
+	FORCEINLINE float GetCurrentYaw() const { return FlightState.Yaw; }
+	FORCEINLINE const FShipFlightInput& GetFlightInput() const { return FlightInput; }
+	FORCEINLINE const FShipFlightState& GetFlightState() const { return FlightState; }
+	FORCEINLINE const FShipFlightParams& GetFlightParams() const { return FlightParams; }
+	FORCEINLINE bool IsAsyncPhysicsFlightActive() const { return bAsyncFlightActive; }
+	FORCEINLINE bool IsKinematicFlight() const { return bKinematicFlight; }
 };
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "Flight/ProjectileBallistics.h"
+#include "Subsystems/ShipSquadSubsystem.h"
 #include "ShipAIController.generated.h"
 
 class AShipPawn;
@@ -11,6 +13,13 @@ class GALACTICARMADA_API AShipAIController : public AAIController
 {
 	GENERATED_BODY()
 
+public:
+	FORCEINLINE AShipPawn* GetTargetShipPawn() const { return TargetShipPawn; }
+	FORCEINLINE FVector GetLastCollisionLocation() const { return LastCollisionLocation; }
+
+	// Lead aim point from the gunnery subsystem, refreshed every frame while the target is alive
+	void SetGunnerySolution(const FInterceptSolution& InGunnerySolution) { GunnerySolution = InGunnerySolution; }
+
 protected:
 	UPROPERTY(BlueprintReadOnly)
 	AShipPawn* ControlledShipPawn;
@@ -24,16 +33,58 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "AI Debug")
 	bool bEnableAvoidanceDebug = true;
 
+	// AI Navigation
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AI Navigation")
+	float WaypointAcceptanceRadius = 5000.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AI Navigation")
+	float RepathInterval = 2.0f;
+
+	// AI Tactics, sampled from the influence map
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AI Tactics")
+	float TacticsInterval = 1.0f;
+
 	virtual void BeginPlay() override;
+	virtual void OnPossess(APawn* InPawn) override;
 	virtual void Tick(float DeltaSeconds) override;
 
 private:
 	FTimerHandle CollisionAvoidanceTimerHandle;
+
+	TArray<FVector> PathWaypoints;
+	int32 PathWaypointIndex = 0;
+	float TimeSincePathUpdate = 0.0f;
+	bool bPathRequestPending = false;
+
+	FInterceptSolution GunnerySolution;
+
+	FShipSquadOrders SquadOrders;
+	FVector LastCollisionLocation = FVector::ZeroVector;
+
+	// Think and obstacle query rates follow the fidelity governor
+	float ThinkInterval = 0.0f;
+	float TimeSinceThink = 0.0f;
+	float TimeSinceAvoidanceUpdate = 0.0f;
+
+	float TimeSinceTacticsUpdate = 0.0f;
+	FVector RetreatLocation = FVector::ZeroVector;
+	FVector FlankLocation = FVector::ZeroVector;
+	bool bRetreating = false;
+	bool bFlanking = false;
+
+	// Cannon group last opened on the target, engagement telemetry is recorded when either changes
+	int32 EngagedCannonIndex = INDEX_NONE;
+	TWeakObjectPtr<AShipPawn> EngagedTarget;
 	
+	bool AcquireTarget();
+	void TickSquadMember();
+	void UpdateTactics(float DeltaSeconds);
+	void UpdatePathFollowing(float DeltaSeconds);
+	bool IsFollowingPath() const;
+	FVector GetDestination() const;
+	FVector GetSteeringLocation() const;
 	FRotator GetTargetShipRotation() const;
 	void UpdateMovement(float DeltaSeconds) const;
-	void UpdateCollisionAvoidance();
-	void UpdateFiring() const;
-	static float RotationToInputAxis(float Value, float RotVal);
-	bool IsInRange() const;
+	void UpdateCollisionAvoidance(float DeltaSeconds);
+	void UpdateFiring();
 };
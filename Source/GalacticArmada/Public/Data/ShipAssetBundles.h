@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPtr.h"
+
+// Soft asset references a ship streams in, split into the simulation's needs and what only players see and hear.
+// The same split is tagged on the properties as AssetBundles="Gameplay" and AssetBundles="Cosmetic".
+struct FShipAssetBundles
+{
+	TArray<FSoftObjectPath> Gameplay;
+	TArray<FSoftObjectPath> Cosmetic;
+
+	template <typename SoftPtrType>
+	FORCEINLINE void AddGameplay(const SoftPtrType& SoftPtr)
+	{
+		if (!SoftPtr.IsNull())
+		{
+			Gameplay.AddUnique(SoftPtr.ToSoftObjectPath());
+		}
+	}
+
+	template <typename SoftPtrType>
+	FORCEINLINE void AddCosmetic(const SoftPtrType& SoftPtr)
+	{
+		if (!SoftPtr.IsNull())
+		{
+			Cosmetic.AddUnique(SoftPtr.ToSoftObjectPath());
+		}
+	}
+
+	FORCEINLINE bool IsEmpty() const { return Gameplay.Num() == 0 && Cosmetic.Num() == 0; }
+};
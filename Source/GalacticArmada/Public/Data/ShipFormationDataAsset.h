@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShipFormationDataAsset.generated.h"
+
+// Squad layout flown by AI wingmen around their leader. The squad size is one leader plus one ship per slot.
+UCLASS(BlueprintType)
+class GALACTICARMADA_API UShipFormationDataAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UShipFormationDataAsset();
+
+	// Wingman positions in the leader's local space, X forward
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Formation")
+	TArray<FVector> SlotOffsets;
+
+	// Wingmen push away from squad mates closer than this
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Formation")
+	float SeparationRadius = 2500.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Formation")
+	float SeparationStrength = 1.0f;
+
+	// Wingmen break formation and attack on their own once the squad target is this close
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Formation")
+	float EngageRange = 30000.0f;
+
+	FORCEINLINE int32 GetSquadSize() const { return SlotOffsets.Num() + 1; }
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Components/CannonComponent.h"
+#include "ShipLoadoutDataAsset.generated.h"
+
+class USkeletalMesh;
+struct FShipAssetBundles;
+
+// One cannon group resolved for firing, aligned so a group never shares a cache line with its neighbour
+struct alignas(PLATFORM_CACHE_LINE_SIZE) FShipLoadoutCannon
+{
+	UClass* ProjectileClass = nullptr;
+
+	// Seconds between shots of an automatic cannon
+	float FireInterval = 0.0f;
+	float ProjectileSpeed = 0.0f;
+	float DamagePerVolley = 0.0f;
+
+	// Range in the loadout's socket list
+	int16 FirstSocket = 0;
+	int16 NumSockets = 0;
+
+	ECannonFireMode FireMode = ECannonFireMode::All;
+	bool bEnabled = false;
+	bool bAutomatic = false;
+	bool bProjectileResolved = false;
+	// Launched through the missile subsystem instead of spawned
+	bool bGuided = false;
+
+	FORCEINLINE int32 GetShotsPerVolley() const { return FireMode == ECannonFireMode::All ? FMath::Max<int32>(NumSockets, 1) : 1; }
+};
+
+/**
+ * Weapon loadout shared by every ship that references it. Cannon groups are authored as before and resolved once
+ * into packed read-only records: fire intervals and socket ranges at load, projectile class, speed and damage once
+ * the projectile classes are resident, and socket indices once per skeletal mesh.
+ */
+UCLASS(BlueprintType)
+class GALACTICARMADA_API UShipLoadoutDataAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Cannon groups by index, 0 is primary fire and 1 secondary fire
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loadout")
+	TArray<FCannonFireProperties> Cannons;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loadout", meta = (AssetBundles = "Cosmetic"))
+	TSoftClassPtr<UCameraShakeBase> FireCameraShake;
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	// Loadout for a cannon component still configured with its own cannon array
+	static UShipLoadoutDataAsset* CreateTransient(const TArray<FCannonFireProperties>& InCannons, const TSoftClassPtr<UCameraShakeBase>& InFireCameraShake);
+
+	// Fills in unresolved projectiles that are resident, loading the rest synchronously when allowed
+	void ResolveProjectiles(bool bAllowLoad);
+
+	// Index of every cannon socket in the mesh's socket list, INDEX_NONE for missing sockets
+	const TArray<int32>& GetMeshSocketIndices(const USkeletalMesh* Mesh);
+
+	void GatherAssetBundles(FShipAssetBundles& OutBundles) const;
+
+	FORCEINLINE int32 GetNumCannons() const { return ResolvedCannons.Num(); }
+	FORCEINLINE int32 GetNumSockets() const { return SocketNames.Num(); }
+	FORCEINLINE bool IsValidCannon(int32 CannonIndex) const { return ResolvedCannons.IsValidIndex(CannonIndex); }
+	FORCEINLINE const FShipLoadoutCannon& GetCannon(int32 CannonIndex) const { return ResolvedCannons[CannonIndex]; }
+	FORCEINLINE FName GetSocketName(int32 CannonIndex, int32 SocketIndex) const { return SocketNames[ResolvedCannons[CannonIndex].FirstSocket + SocketIndex]; }
+
+private:
+	TArray<FShipLoadoutCannon> ResolvedCannons;
+	TArray<FName> SocketNames;
+	TMap<TWeakObjectPtr<const USkeletalMesh>, TArray<int32>> MeshSocketIndices;
+
+	// Keeps the resolved projectile classes alive
+	UPROPERTY(Transient)
+	TArray<UClass*> ProjectileClassReferences;
+
+	void ResolveCannons();
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Engine-independent projectile integration. Bolts fly in straight lines with no gravity or drag.
+
+struct FInterceptRequest
+{
+	// Bolts launch at their own speed and do not inherit the shooter's velocity
+	FVector ShooterLocation = FVector::ZeroVector;
+
+	// Cannons are fixed, shots leave along the shooter's forward vector
+	FVector ShooterForward = FVector::ForwardVector;
+
+	FVector TargetLocation = FVector::ZeroVector;
+	FVector TargetVelocity = FVector::ZeroVector;
+	FVector TargetAcceleration = FVector::ZeroVector;
+
+	float ProjectileSpeed = 0.0f;
+	float TargetRadius = 500.0f;
+
+	// How far the target's acceleration strays from its average, its unpredictable maneuvering
+	float TargetManeuver = 0.0f;
+};
+
+struct FInterceptSolution
+{
+	FVector AimLocation = FVector::ZeroVector;
+	float TimeToImpact = 0.0f;
+	float HitProbability = 0.0f;
+	bool bValid = false;
+};
+
+namespace ProjectileBallistics
+{
+	GALACTICARMADA_API void Integrate(FVector& Location, const FVector& Velocity, float DeltaSeconds);
+	GALACTICARMADA_API void Integrate(TArrayView<FVector> Locations, TConstArrayView<FVector> Velocities, float DeltaSeconds);
+
+	// Lead aim point against the target's world velocity, and the chance a bolt fired along the shooter's forward vector hits
+	GALACTICARMADA_API FInterceptSolution SolveIntercept(const FInterceptRequest& Request);
+
+	// Solves four requests per SIMD pass
+	GALACTICARMADA_API void SolveInterceptBatch(TConstArrayView<FInterceptRequest> Requests, TArrayView<FInterceptSolution> OutSolutions);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Engine-independent ship flight model. Only depends on Core so it can run without a world or any UObject.
+// Per-ship values are packed as four floats (Roll, Pitch, Yaw, Speed) so one ship updates in a single vector operation.
+
+struct alignas(16) FShipFlightInput
+{
+	float Roll = 0.0f;
+	float Pitch = 0.0f;
+	float Yaw = 0.0f;
+	float Thrust = 0.0f;
+};
+
+struct alignas(16) FShipFlightState
+{
+	// Current rotation rates in degrees per second
+	float Roll = 0.0f;
+	float Pitch = 0.0f;
+	float Yaw = 0.0f;
+
+	// Current forward speed in cm per second
+	float Speed = 0.0f;
+};
+
+struct alignas(16) FShipFlightParams
+{
+	// Rotation rates at full input and top speed
+	float FlapAngle = 30.0f;
+	float ElevatorAngle = 30.0f;
+	float RudderAngle = 30.0f;
+	float MaxSpeed = 10000.0f;
+
+	// Interpolation speeds towards the targets above
+	float FlapSpeed = 10.0f;
+	float ElevatorSpeed = 10.0f;
+	float RudderSpeed = 10.0f;
+	float Acceleration = 500.0f;
+
+	float Deceleration = 300.0f;
+	float MinSpeed = 0.0f;
+};
+
+struct FShipFlightPose
+{
+	FQuat Rotation = FQuat::Identity;
+	FVector Location = FVector::ZeroVector;
+};
+
+namespace ShipFlight
+{
+	// Moves rotation rates and speed towards the input targets
+	GALACTICARMADA_API void UpdateState(const FShipFlightParams& Params, const FShipFlightInput& Input, float DeltaSeconds, FShipFlightState& State);
+
+	// Local rotation for one step, applied roll first, then pitch, then yaw
+	GALACTICARMADA_API FRotator GetRollDelta(const FShipFlightState& State, float DeltaSeconds);
+	GALACTICARMADA_API FRotator GetPitchDelta(const FShipFlightState& State, float DeltaSeconds);
+	GALACTICARMADA_API FRotator GetYawDelta(const FShipFlightState& State, float DeltaSeconds);
+	GALACTICARMADA_API FQuat GetRotationDelta(const FShipFlightState& State, float DeltaSeconds);
+
+	// Rotates the pose by the local rotation delta and moves it along its new forward vector
+	GALACTICARMADA_API void IntegratePose(const FShipFlightState& State, float DeltaSeconds, FShipFlightPose& Pose);
+
+	// Array versions, a plain loop over the single ship functions above. Each ship is still one four lane update,
+	// ships are not vectorized across each other. Params may hold a single entry shared by every ship, otherwise one entry per ship.
+	GALACTICARMADA_API void UpdateStates(TConstArrayView<FShipFlightParams> Params, TConstArrayView<FShipFlightInput> Inputs, float DeltaSeconds, TArrayView<FShipFlightState> States);
+	GALACTICARMADA_API void IntegratePoses(TConstArrayView<FShipFlightState> States, float DeltaSeconds, TArrayView<FShipFlightPose> Poses);
+	GALACTICARMADA_API void Step(TConstArrayView<FShipFlightParams> Params, TConstArrayView<FShipFlightInput> Inputs, float DeltaSeconds, TArrayView<FShipFlightState> States, TArrayView<FShipFlightPose> Poses);
+}
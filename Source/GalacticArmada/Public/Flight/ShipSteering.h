@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Flight/ShipFlightModel.h"
+
+// Engine-independent AI steering rules that turn a target and nearby obstacles into flight input
+
+struct FShipSteeringParams
+{
+	float StoppingDistance = 20000.0f;
+	float ObstacleAvoidanceDistance = 30000.0f;
+	float MinAvoidanceStrength = 0.1f;
+	float MaxAvoidanceStrength = 3.0f;
+};
+
+struct FShipSteeringRequest
+{
+	FVector ShipLocation = FVector::ZeroVector;
+	FRotator ShipRotation = FRotator::ZeroRotator;
+	FVector TargetLocation = FVector::ZeroVector;
+
+	// Closest obstacle hit, zero when nothing is in the way
+	FVector CollisionLocation = FVector::ZeroVector;
+};
+
+namespace ShipSteering
+{
+	// Rotation from the ship's facing towards the target, normalized to [-180, 180]
+	GALACTICARMADA_API FRotator GetTargetDeltaRotation(const FVector& ShipLocation, const FRotator& ShipRotation, const FVector& TargetLocation);
+
+	// Blends the target rotation away from an obstacle closer than the avoidance distance. Returns false if no avoidance was needed.
+	GALACTICARMADA_API bool ApplyAvoidance(const FShipSteeringParams& Params, const FVector& ShipLocation, const FVector& CollisionLocation, FRotator& InOutTargetRotation);
+
+	// Maps a rotation in degrees onto an input axis in [-1, 1]
+	GALACTICARMADA_API float RotationToInputAxis(float Value, float MaxRotation);
+
+	GALACTICARMADA_API bool ShouldApproach(const FShipSteeringParams& Params, const FVector& ShipLocation, const FVector& TargetLocation);
+	GALACTICARMADA_API FShipFlightInput ComputeInput(const FRotator& TargetRotation, bool bApproach);
+
+	// Steers every request towards its target, avoiding its obstacle. Params may hold a single shared entry.
+	GALACTICARMADA_API void ComputeInputs(TConstArrayView<FShipSteeringParams> Params, TConstArrayView<FShipSteeringRequest> Requests, TArrayView<FShipFlightInput> OutInputs);
+}
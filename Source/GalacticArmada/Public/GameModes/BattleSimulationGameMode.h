@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "BattleSimulationGameMode.generated.h"
+
+class AShipPawn;
+class UHealthComponent;
+class UShipFormationDataAsset;
+
+struct FBattleSimulationMatch
+{
+	int32 MatchIndex = INDEX_NONE;
+	int32 ArenaIndex = INDEX_NONE;
+	double StartTime = 0.0;
+
+	TArray<TWeakObjectPtr<AShipPawn>> Ships;
+
+	int32 ShipsAlive[2] = { 0, 0 };
+	int32 Kills[2] = { 0, 0 };
+	float DamageDealt[2] = { 0.0f, 0.0f };
+	TArray<float> KillTimes;
+
+	FORCEINLINE bool IsActive() const { return MatchIndex != INDEX_NONE; }
+};
+
+/**
+ * Runs AI versus AI matches without a player, as fast as the CPU allows, and appends
+ * win/loss, time-to-kill and damage statistics to a CSV file in Saved/BattleSim.
+ * Launched with -BattleSim, usually together with -nullrhi -nosound -unattended.
+ */
+UCLASS()
+class GALACTICARMADA_API ABattleSimulationGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	ABattleSimulationGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Battle Simulation - Teams
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	TSubclassOf<AShipPawn> TeamAShipClass;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	TSubclassOf<AShipPawn> TeamBShipClass;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	int32 ShipsPerTeam = 4;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	float TeamSeparation = 60000.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	float ShipSpacing = 4000.0f;
+
+	// Groups each team into squads flying this formation, every ship fights alone when unset
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	UShipFormationDataAsset* SquadFormation;
+
+	// Battle Simulation - Matches
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	int32 MatchCount = 100;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	int32 ParallelMatches = 4;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	float ArenaSpacing = 2000000.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	float MatchTimeLimit = 300.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	float FixedTimeStep = 0.05f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	int32 RandomSeed = 0;
+
+	// Battle Simulation - Background Fleet, simulated as Mass entities beside the matches
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	int32 BackgroundFleetShips = 0;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	float BackgroundFleetRadius = 200000.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	FString OutputFileName = TEXT("BattleSimResults.csv");
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Battle Simulation")
+	bool bExitWhenFinished = true;
+
+private:
+	TArray<FBattleSimulationMatch> Matches;
+	TMap<TWeakObjectPtr<const AActor>, int32> ShipToArena;
+
+	int32 NextMatchIndex = 0;
+	int32 CompletedMatches = 0;
+	int32 TeamWins[3] = { 0, 0, 0 };
+
+	uint64 SimulatedFrames = 0;
+	double RunStartTime = 0.0;
+	double LastFrameTime = 0.0;
+	double TotalFrameSeconds = 0.0;
+	double WorstFrameSeconds = 0.0;
+	bool bFleetBenchmark = false;
+
+	void ParseCommandLineOverrides();
+	void StartSimulation();
+	void StartMatch(int32 ArenaIndex);
+	void FinishMatch(FBattleSimulationMatch& Match, float Duration);
+	void FinishSimulation();
+	AShipPawn* SpawnShip(TSubclassOf<AShipPawn> ShipClass, uint8 TeamId, const FTransform& SpawnTransform);
+	void WriteResultRow(const FBattleSimulationMatch& Match, int32 WinningTeam, float Duration) const;
+	FString GetOutputFilePath() const;
+
+	// Damage and kills per team from the frame's batch of damage events
+	void HandleDamageEvents(TConstArrayView<struct FShipDamageEvent> Events);
+
+	// Ship behind the damage, through its controller or the projectile it fired
+	static const AShipPawn* GetAttackingShip(const struct FShipDamageEvent& Event);
+};
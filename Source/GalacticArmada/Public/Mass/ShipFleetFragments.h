@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Flight/ShipFlightModel.h"
+#include "Flight/ShipSteering.h"
+#include "ShipFleetFragments.generated.h"
+
+class AShipPawn;
+
+// Tag for background fleet ships simulated as Mass entities
+USTRUCT()
+struct FShipFleetTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+// Per ship class data, shared by every entity of that class
+USTRUCT()
+struct FShipArchetypeFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<AShipPawn> ShipClass;
+
+	FShipFlightParams FlightParams;
+	FShipSteeringParams SteeringParams;
+
+	float PrimaryFireRange = 30000.0f;
+	float SecondaryFireRange = 60000.0f;
+	float FireInterval[2] = { 1.0f, 1.0f };
+	float DamagePerShot[2] = { 10.0f, 10.0f };
+	float MaxHealth = 100.0f;
+};
+
+USTRUCT()
+struct FShipFlightFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FShipFlightInput Input;
+	FShipFlightState State;
+};
+
+USTRUCT()
+struct FShipTargetFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FMassEntityHandle Target;
+	FVector TargetLocation = FVector::ZeroVector;
+	float RetargetCooldown = 0.0f;
+
+	// False when no hostile exists anywhere, the ship then just keeps flying
+	bool bHasTarget = false;
+};
+
+USTRUCT()
+struct FShipCannonFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	float Cooldown[2] = { 0.0f, 0.0f };
+};
+
+USTRUCT()
+struct FShipHealthFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	float Health = 100.0f;
+};
+
+USTRUCT()
+struct FShipTeamFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	uint8 TeamId = 0;
+};
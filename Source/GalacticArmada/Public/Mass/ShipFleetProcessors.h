@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "ShipFleetProcessors.generated.h"
+
+/**
+ * Picks the closest hostile fleet entity through a coarse spatial hash and tracks its location.
+ * Entities retarget on a staggered interval instead of every frame.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipFleetTargetingProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UShipFleetTargetingProcessor();
+
+	// Seconds between target searches of one entity, safe to read from any thread
+	static float GetRetargetInterval();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+// Turns each entity's target into flight input using the same rules as AShipAIController
+UCLASS()
+class GALACTICARMADA_API UShipFleetSteeringProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UShipFleetSteeringProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+// Advances the UShipMovementComponent flight model and integrates the entity transform
+UCLASS()
+class GALACTICARMADA_API UShipFleetFlightProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UShipFleetFlightProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+// Runs cannon cooldowns and resolves hits statistically instead of spawning projectiles
+UCLASS()
+class GALACTICARMADA_API UShipFleetCannonProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UShipFleetCannonProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
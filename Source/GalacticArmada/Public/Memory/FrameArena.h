@@ -0,0 +1,184 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+// Bump allocator for scratch data that never outlives the frame it was created in. Every thread gets its own
+// arena and only that thread ever touches it. Ending a frame releases the game thread's arena right away and every
+// other arena on its owner's next use, so frame memory may only be used by game thread code and by parallel work
+// that finishes within the frame (ParallelFor), never by tasks spanning frames.
+class GALACTICARMADA_API FFrameArena
+{
+public:
+	// Arena of the calling thread, created on first use and released here when a frame ended since its last use
+	static FFrameArena& Get();
+
+	// Starts a new frame for every arena, runs at the end of each frame on the game thread
+	static void EndFrame();
+
+	// Off with ga.FrameArena.Enable=0, frame arrays then allocate from the heap so the two can be compared
+	static bool IsEnabled();
+
+	// Counts a heap allocation made for frame scratch data: an arena block, or a frame array while the arena is off
+	static void CountHeapAllocation();
+
+	// Logs the peak frame usage of every thread's arena and the heap allocations per frame
+	static void LogReport();
+
+	void* Allocate(SIZE_T Size, uint32 Alignment = DefaultAlignment);
+
+	// Grows or shrinks in place when Ptr is the newest allocation of this arena, otherwise copies BytesToCopy
+	void* Reallocate(void* Ptr, SIZE_T AllocatedSize, SIZE_T BytesToCopy, SIZE_T NewSize, uint32 Alignment = DefaultAlignment);
+
+	FFrameArena(const FFrameArena&) = delete;
+	FFrameArena& operator=(const FFrameArena&) = delete;
+
+private:
+	static constexpr uint32 DefaultAlignment = 16;
+
+	struct FBlock
+	{
+		uint8* Memory = nullptr;
+		SIZE_T Size = 0;
+	};
+
+	FFrameArena(uint32 InThreadId, uint32 InFrame);
+
+	// Blocks used this frame, folded into a single block of their total size on reset
+	TArray<FBlock> Blocks;
+	uint8* Top = nullptr;
+	uint8* End = nullptr;
+
+	uint32 ThreadId = 0;
+	uint32 Frame = 0;
+	SIZE_T FrameBytes = 0;
+	int32 FrameAllocations = 0;
+
+	// Written by the owning thread, read by reports from the game thread
+	std::atomic<SIZE_T> PeakFrameBytes = 0;
+	std::atomic<SIZE_T> ReservedBytes = 0;
+	std::atomic<int32> PeakFrameAllocations = 0;
+	std::atomic<int32> NumOverflowBlocks = 0;
+
+	void AddBlock(SIZE_T MinSize);
+	void Reset();
+};
+
+// Container allocator drawing from the calling thread's frame arena, freeing is a no-op until the frame ends
+class FFrameArenaAllocator
+{
+public:
+	using SizeType = int32;
+
+	enum { NeedsElementType = false };
+	enum { RequireRangeCheck = true };
+
+	class ForAnyElementType
+	{
+	public:
+		ForAnyElementType() = default;
+		ForAnyElementType(const ForAnyElementType&) = delete;
+		ForAnyElementType& operator=(const ForAnyElementType&) = delete;
+
+		~ForAnyElementType()
+		{
+			if (bHeap && Data)
+			{
+				FMemory::Free(Data);
+			}
+		}
+
+		FORCEINLINE void MoveToEmpty(ForAnyElementType& Other)
+		{
+			checkSlow(this != &Other);
+			if (bHeap && Data)
+			{
+				FMemory::Free(Data);
+			}
+
+			Data = Other.Data;
+			AllocatedSize = Other.AllocatedSize;
+			bHeap = Other.bHeap;
+			Other.Data = nullptr;
+			Other.AllocatedSize = 0;
+			Other.bHeap = false;
+		}
+
+		FORCEINLINE FScriptContainerElement* GetAllocation() const { return Data; }
+
+		void ResizeAllocation(SizeType PreviousNumElements, SizeType NumElements, SIZE_T NumBytesPerElement)
+		{
+			const SIZE_T NewSize = NumElements * NumBytesPerElement;
+			if (NewSize == 0)
+			{
+				if (bHeap && Data)
+				{
+					FMemory::Free(Data);
+				}
+				Data = nullptr;
+				AllocatedSize = 0;
+				bHeap = false;
+				return;
+			}
+
+			// An array stays on the heap or in the arena for its whole allocation, whatever the setting does meanwhile
+			if (!Data)
+			{
+				bHeap = !FFrameArena::IsEnabled();
+			}
+
+			if (bHeap)
+			{
+				Data = static_cast<FScriptContainerElement*>(FMemory::Realloc(Data, NewSize));
+				FFrameArena::CountHeapAllocation();
+			}
+			else
+			{
+				Data = static_cast<FScriptContainerElement*>(FFrameArena::Get().Reallocate(Data, AllocatedSize, PreviousNumElements * NumBytesPerElement, NewSize));
+			}
+			AllocatedSize = NewSize;
+		}
+
+		FORCEINLINE SizeType CalculateSlackReserve(SizeType NumElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackReserve(NumElements, NumBytesPerElement, false);
+		}
+
+		FORCEINLINE SizeType CalculateSlackShrink(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackShrink(NumElements, NumAllocatedElements, NumBytesPerElement, false);
+		}
+
+		FORCEINLINE SizeType CalculateSlackGrow(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackGrow(NumElements, NumAllocatedElements, NumBytesPerElement, false);
+		}
+
+		FORCEINLINE SIZE_T GetAllocatedSize(SizeType CurrentMax, SIZE_T NumBytesPerElement) const { return CurrentMax * NumBytesPerElement; }
+		FORCEINLINE bool HasAllocation() const { return Data != nullptr; }
+		FORCEINLINE SizeType GetInitialCapacity() const { return 0; }
+
+	private:
+		FScriptContainerElement* Data = nullptr;
+		SIZE_T AllocatedSize = 0;
+		bool bHeap = false;
+	};
+
+	template <typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		FORCEINLINE ElementType* GetAllocation() const { return static_cast<ElementType*>(ForAnyElementType::GetAllocation()); }
+	};
+};
+
+template <>
+struct TAllocatorTraits<FFrameArenaAllocator> : TAllocatorTraitsBase<FFrameArenaAllocator>
+{
+	enum { SupportsMove = true };
+	enum { IsZeroConstruct = true };
+};
+
+// Scratch array for the current frame, must not be kept past it
+template <typename ElementType>
+using TFrameArray = TArray<ElementType, FFrameArenaAllocator>;
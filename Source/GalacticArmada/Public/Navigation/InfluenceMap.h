@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Engine-independent sparse 3D influence map, each team stamps a linear falloff around its sources
+
+struct FInfluenceSource
+{
+	// Stable for the lifetime of the source, identifies the stamp to take back when it moves
+	uint32 Id = 0;
+
+	FVector Location = FVector::ZeroVector;
+	int32 TeamId = 0;
+	float Strength = 0.0f;
+	float Radius = 0.0f;
+};
+
+class GALACTICARMADA_API FInfluenceMap
+{
+public:
+	static constexpr int32 MaxTeams = 4;
+
+	explicit FInfluenceMap(float InCellSize = 10000.0f);
+
+	// Re-stamps only sources that changed cell, team, radius or strength beyond the tolerance and takes back
+	// the stamps of sources that are gone. Sources outside [0, MaxTeams) are skipped and ensure once.
+	// Returns the number of cell writes.
+	int32 Update(TConstArrayView<FInfluenceSource> Sources, float StrengthTolerance = 0.05f);
+
+	// Stamps every source again from scratch, dropping the rounding drift of incremental updates
+	int32 Rebuild();
+
+	float GetInfluence(const FVector& Location, int32 TeamId) const;
+
+	// Influence of the team and the sum of every other team at Location
+	void Sample(const FVector& Location, int32 TeamId, float& OutFriendly, float& OutHostile) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+	FORCEINLINE float GetCellSize() const { return CellSize; }
+	FORCEINLINE int32 GetNumCells() const { return Cells.Num(); }
+	FORCEINLINE int32 GetNumSources() const { return Stamps.Num(); }
+
+private:
+	struct FCell
+	{
+		float Influence[MaxTeams] = {};
+
+		// Stamps covering the cell, it is dropped once the last one is taken back
+		int32 NumStamps = 0;
+	};
+
+	struct FStamp
+	{
+		FIntVector Cell = FIntVector::ZeroValue;
+		int32 TeamId = 0;
+		float Strength = 0.0f;
+		float Radius = 0.0f;
+		uint32 Generation = 0;
+	};
+
+	float CellSize;
+	TMap<FIntVector, FCell> Cells;
+	TMap<uint32, FStamp> Stamps;
+	uint32 Generation = 0;
+
+	FIntVector ToCell(const FVector& Location) const;
+	int32 ApplyStamp(const FStamp& Stamp, float Sign);
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Sparse signed distance field around static obstacles, baked to a flat file that is memory mapped at load
+
+// File layout: header, brick index grid (int32, none for bricks with nothing in band), brick samples (uint8)
+struct FSignedDistanceFieldHeader
+{
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 ObstacleHash = 0;
+	float VoxelSize = 0.0f;
+	float Band = 0.0f;
+	FVector3f Origin = FVector3f::ZeroVector;
+	int32 BrickCountX = 0;
+	int32 BrickCountY = 0;
+	int32 BrickCountZ = 0;
+	int32 NumBricks = 0;
+};
+
+class GALACTICARMADA_API FSignedDistanceField
+{
+public:
+	// Each brick covers 8^3 voxels and stores 9^3 samples, the shared apron keeps interpolation inside one brick
+	static constexpr int32 BrickCells = 8;
+	static constexpr int32 BrickSamples = BrickCells + 1;
+	static constexpr int32 BrickSize = BrickSamples * BrickSamples * BrickSamples;
+
+	FSignedDistanceField();
+	~FSignedDistanceField();
+
+	// Bakes distances within Band of the obstacles and writes them to FilePath. Safe on worker threads.
+	static bool Bake(TConstArrayView<FBox> Obstacles, uint32 ObstacleHash, float VoxelSize, float Band, const FString& FilePath);
+
+	// Maps a baked file, false when it is missing or baked from other geometry or settings
+	bool Load(const FString& FilePath, uint32 ObstacleHash, float VoxelSize, float Band);
+
+	// Trilinear distance and its gradient, false when Location is farther than Band from every obstacle
+	bool Sample(const FVector& Location, float& OutDistance, FVector& OutGradient) const;
+
+	FORCEINLINE bool IsValid() const { return Header != nullptr; }
+	FORCEINLINE bool IsMemoryMapped() const { return MappedRegion.IsValid(); }
+	FORCEINLINE int64 GetDataSize() const { return DataSize; }
+	FORCEINLINE int32 GetNumBricks() const { return Header ? Header->NumBricks : 0; }
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Fallback for platforms without memory mapped files
+	TArray64<uint8> LoadedData;
+
+	const FSignedDistanceFieldHeader* Header = nullptr;
+	const int32* BrickIndices = nullptr;
+	const uint8* BrickData = nullptr;
+	int64 DataSize = 0;
+
+	bool SetData(const uint8* Data, int64 Size, uint32 ObstacleHash, float VoxelSize, float Band);
+	void Reset();
+};
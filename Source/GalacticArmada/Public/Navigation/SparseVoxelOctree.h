@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Sparse voxel octree over static obstacle boxes, needs no world or actors, with a free space graph for 3D path finding
+
+struct FSparseVoxelOctreeNode
+{
+	FVector3f Center = FVector3f::ZeroVector;
+	float HalfExtent = 0.0f;
+
+	// First of eight consecutive children, none for leaves
+	int32 FirstChild = INDEX_NONE;
+
+	// Index into the free space graph, none for blocked leaves and interior nodes
+	int32 FreeIndex = INDEX_NONE;
+
+	FORCEINLINE bool IsLeaf() const { return FirstChild == INDEX_NONE; }
+	FORCEINLINE bool IsBlocked() const { return IsLeaf() && FreeIndex == INDEX_NONE; }
+
+	friend FArchive& operator<<(FArchive& Ar, FSparseVoxelOctreeNode& Node)
+	{
+		return Ar << Node.Center << Node.HalfExtent << Node.FirstChild << Node.FreeIndex;
+	}
+};
+
+struct FSparseVoxelOctreeSettings
+{
+	// Smallest voxel edge, obstacles are resolved to this size
+	float VoxelSize = 2000.0f;
+
+	// Obstacles are inflated by this so paths keep the ship's hull clear
+	float AgentRadius = 1500.0f;
+
+	// Free space kept around the obstacle bounds for paths that go around the outside
+	float BoundsPadding = 50000.0f;
+
+	int32 MaxDepth = 12;
+
+	int32 MaxSearchNodes = 20000;
+
+	friend FArchive& operator<<(FArchive& Ar, FSparseVoxelOctreeSettings& Settings)
+	{
+		return Ar << Settings.VoxelSize << Settings.AgentRadius << Settings.BoundsPadding << Settings.MaxDepth << Settings.MaxSearchNodes;
+	}
+
+	FORCEINLINE bool operator==(const FSparseVoxelOctreeSettings& Other) const
+	{
+		return VoxelSize == Other.VoxelSize && AgentRadius == Other.AgentRadius && BoundsPadding == Other.BoundsPadding && MaxDepth == Other.MaxDepth && MaxSearchNodes == Other.MaxSearchNodes;
+	}
+};
+
+class GALACTICARMADA_API FSparseVoxelOctree
+{
+public:
+	// Subdivides only nodes that touch an obstacle, then links face adjacent free leaves
+	void Build(TConstArrayView<FBox> Obstacles, const FSparseVoxelOctreeSettings& InSettings);
+	void Serialize(FArchive& Ar);
+
+	FORCEINLINE bool IsValid() const { return Nodes.Num() > 0; }
+
+	// Leaf containing Location, none outside the octree
+	int32 FindLeaf(const FVector& Location) const;
+
+	// Free space graph index containing Location, none when blocked or outside
+	int32 FindFreeIndex(const FVector& Location) const;
+
+	// Closest point inside the octree, used for queries that start or end in open space beyond it
+	FVector ClampToBounds(const FVector& Location) const;
+
+	// Outside the octree counts as free, there is nothing there to hit
+	bool IsBlocked(const FVector& Location) const;
+	bool IsSegmentFree(const FVector& Start, const FVector& End) const;
+
+	// A* over free leaves, returns leaf centers from start to goal
+	bool FindPath(int32 StartFreeIndex, int32 GoalFreeIndex, TArray<FVector>& OutPath) const;
+
+	// Drops every waypoint that can be skipped with a free straight segment
+	void SmoothPath(TArray<FVector>& InOutPath) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+	FORCEINLINE int32 GetNumNodes() const { return Nodes.Num(); }
+	FORCEINLINE int32 GetNumFreeLeaves() const { return FreeLeafNodes.Num(); }
+	FORCEINLINE const FSparseVoxelOctreeSettings& GetSettings() const { return Settings; }
+
+private:
+	FSparseVoxelOctreeSettings Settings;
+	TArray<FSparseVoxelOctreeNode> Nodes;
+
+	// Free space graph in compressed rows: neighbours of free leaf i are Edges[EdgeOffsets[i] .. EdgeOffsets[i + 1])
+	TArray<int32> FreeLeafNodes;
+	TArray<int32> EdgeOffsets;
+	TArray<int32> Edges;
+
+	void BuildNode(int32 NodeIndex, int32 Depth, TConstArrayView<FBox> Obstacles, const TArray<int32>& Candidates);
+	void BuildFreeSpaceGraph();
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+// World space boxes around every static obstacle ships can collide with
+struct FStaticObstacleSet
+{
+	TArray<FBox> Boxes;
+	FBox Bounds = FBox(ForceInit);
+
+	// Changes whenever the gathered geometry changes, used to validate baked data
+	uint32 Hash = 0;
+};
+
+namespace StaticObstacles
+{
+	// Actors with this tag are gathered even when their components are movable
+	GALACTICARMADA_API extern const FName StaticObstacleTag;
+
+	// Collects static or stationary primitives that block ships, one box per simple collision element. Game thread only.
+	GALACTICARMADA_API void Gather(const UWorld* World, FStaticObstacleSet& OutObstacles);
+}
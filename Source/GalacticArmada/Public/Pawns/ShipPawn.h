@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "CollisionQueryParams.h"
+#include "Flight/ShipSteering.h"
 #include "ShipPawn.generated.h"
 
 class USkeletalMeshComponent;
@@ -13,10 +15,18 @@ class UCannonComponent;
 class UHealthComponent;
 class UNiagaraSystem;
 class UNiagaraComponent;
+class UStaticMesh;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
 
+UENUM(BlueprintType)
+enum class EShipRepresentation : uint8
+{
+	Full UMETA(DisplayName = "Full"),
+	Proxy UMETA(DisplayName = "Proxy")
+};
+
 USTRUCT(BlueprintType)
 struct FThrusterEffect
 {
@@ -31,8 +41,8 @@ struct FThrusterEffect
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Thruster Effect")
 	float MaxScale;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Thruster Effect")
-	UNiagaraSystem* ThrusterParticleEffect;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Thruster Effect", meta = (AssetBundles = "Cosmetic"))
+	TSoftObjectPtr<UNiagaraSystem> ThrusterParticleEffect;
 };
 
 UCLASS()
@@ -50,7 +60,11 @@ protected:
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Collision")
 	USphereComponent* DetectionSphereCollision;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Collision")
+	USphereComponent* ProxyCollision;
 	
+	// Camera components are not created on the dedicated server target and stay null there
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Camera")
 	USpringArmComponent* SpringArm;
 
@@ -79,18 +93,35 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Collision Damage Properties")
 	bool bBounceOffOnCollision = true;
 
+	// ShipPawn - Death Explosion, splash damage dealt to nearby ships when this one is destroyed
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Death Explosion")
+	float DeathExplosionDamage = 40.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Death Explosion")
+	float DeathExplosionInnerRadius = 1000.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Death Explosion")
+	float DeathExplosionRadius = 5000.0f;
+
 	// ShipPawn - Effects
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effects - Particles")
-	UNiagaraSystem* ExplosionParticleEffect;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effects - Particles", meta = (AssetBundles = "Cosmetic"))
+	TSoftObjectPtr<UNiagaraSystem> ExplosionParticleEffect;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effects - Particles")
-	UNiagaraSystem* CollisionImpactParticleEffect;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effects - Particles", meta = (AssetBundles = "Cosmetic"))
+	TSoftObjectPtr<UNiagaraSystem> CollisionImpactParticleEffect;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effects - Particles")
 	TArray<FThrusterEffect> ThrusterEffects;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effects - Camera Shake")
-	TSubclassOf<UCameraShakeBase> ImpactCameraShake;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effects - Camera Shake", meta = (AssetBundles = "Cosmetic"))
+	TSoftClassPtr<UCameraShakeBase> ImpactCameraShake;
+
+	// ShipPawn - Representation
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Representation")
+	bool bAllowProxyRepresentation = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Representation")
+	UStaticMesh* ProxyStaticMesh;
 
 public:
 	// ShipPawn - AI Properties
@@ -112,6 +143,13 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AI Behavior")
 	float SecondaryFireRange = 60000.0f;
 
+	// ShipPawn - Team
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Team")
+	uint8 TeamId = 0;
+
+	// Ships a player possesses join this team, apart from AI ships placed in the level (team 0) and waves or fleets (team 1)
+	static constexpr uint8 PlayerTeamId = 3;
+
 protected:
 	// ShipPawn - Input
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
@@ -143,14 +181,36 @@ protected:
 
 	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	virtual void Tick(float DeltaSeconds) override;
+	virtual void PossessedBy(AController* NewController) override;
+
+	// Ship mesh hits arrive natively instead of through the component's dynamic hit delegate
+	virtual void NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) override;
+
+	// Called by the ship registry with the frame's batch of death events
+	void OnPawnDied(AController* InstigatedBy, AActor* DamageCauser);
 
 private:
+	EShipRepresentation Representation = EShipRepresentation::Full;
+	TEnumAsByte<ECollisionEnabled::Type> DetectionCollisionEnabled = ECollisionEnabled::QueryOnly;
+	bool bDetectionEnabled = true;
+	bool bDeferredDetection = false;
+	bool bIsDormant = false;
+
 	bool bIsCollisionCooldown;
 	FTimerHandle CollisionCooldownTimerHandle;
+
+	float TimeSinceThrusterUpdate = 0.0f;
+
+	// Built once instead of for every obstacle query
+	FCollisionQueryParams AvoidanceQueryParams;
+	TArray<TWeakObjectPtr<const AActor>> AvoidanceIgnoredActors;
 	
+	void UpdateDetectionCollision();
+	void PublishDetectionEvent(AActor* Actor, bool bDetected);
 	void InitializeThrusterEffects();
 	void UpdateThrusterEffects();
 	
@@ -166,12 +226,8 @@ private:
 
 	void ClearCollisionCooldown();
 
-	UFUNCTION()
 	void OnShipCollision(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
-	UFUNCTION()
-	void OnPawnDied(AController* InstigatedBy, AActor* DamageCauser);
-
 	UFUNCTION()
 	void OnDetectionOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
@@ -179,8 +235,37 @@ private:
 	void OnDetectionOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
 public:
-	FVector GetClosestCollisionLocation() const;
-	FORCEINLINE TArray<AActor*> GetDetectedActors() const { return DetectedActors; }
+	// Traces towards detected actors, only other ships when static obstacles come from the avoidance field.
+	// With a trace budget only the closest detected actors are traced, OutNumTraces receives the traces issued.
+	FVector GetClosestCollisionLocation(bool bShipsOnly = false, int32 MaxTraces = -1, int32* OutNumTraces = nullptr) const;
+	FShipSteeringParams GetSteeringParams() const;
+	void SetRepresentation(EShipRepresentation NewRepresentation);
+
+	// Soft weapon and effect references the asset preloader streams in before this class flies
+	void GatherAssetBundles(struct FShipAssetBundles& OutBundles) const;
+
+	// Squad wingmen turn their detection sphere off and fly on their leader's obstacle queries
+	void SetDetectionEnabled(bool bEnabled);
+
+	// Actors obstacle queries neither trace towards nor hit, a squad leader ignores its own wingmen
+	void SetAvoidanceIgnoredActors(TConstArrayView<AActor*> Actors);
+
+	// Deferred detection leaves overlaps to the detection subsystem's batched pass, which hands them over here
+	void SetDetectedActors(TConstArrayView<AActor*> Actors);
+
+	// Dormant ships wait hidden in the wave spawner's pool, out of the registry so nothing targets them
+	void SetDormant(bool bDormant);
+	FORCEINLINE bool IsDormant() const { return bIsDormant; }
+	FORCEINLINE EShipRepresentation GetRepresentation() const { return Representation; }
+	FORCEINLINE bool CanUseProxyRepresentation() const { return bAllowProxyRepresentation && !IsPlayerControlled(); }
+	FORCEINLINE UStaticMesh* GetProxyStaticMesh() const { return ProxyStaticMesh; }
+	FORCEINLINE USkeletalMeshComponent* GetShipMesh() const { return ShipMesh; }
+	FORCEINLINE bool IsHostileTo(const AShipPawn* OtherShip) const { return OtherShip && OtherShip != this && OtherShip->TeamId != TeamId; }
+	FORCEINLINE const TArray<AActor*>& GetDetectedActors() const { return DetectedActors; }
+	FORCEINLINE USphereComponent* GetDetectionSphere() const { return DetectionSphereCollision; }
+	FORCEINLINE bool IsDetecting() const { return bDetectionEnabled && Representation == EShipRepresentation::Full; }
+	FORCEINLINE bool IsDetectionDeferred() const { return bDeferredDetection; }
 	FORCEINLINE UShipMovementComponent* GetShipMovementComponent() const { return ShipMovementComponent; }
 	FORCEINLINE UCannonComponent* GetCannonComponent() const { return CannonComponent; }
+	FORCEINLINE UHealthComponent* GetHealthComponent() const { return HealthComponent; }
 };
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "ShipAssetPreloadSubsystem.generated.h"
+
+class AShipPawn;
+struct FStreamableHandle;
+struct FShipAssetBundles;
+
+struct FShipClassAssets
+{
+	// Kept for the lifetime of the game instance so streamed assets stay resident between matches and waves
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+	TArray<TFunction<void()>> PendingCallbacks;
+
+	bool bLoaded = false;
+	double RequestTime = 0.0;
+	double LoadSeconds = 0.0;
+	int32 NumAssets = 0;
+};
+
+/**
+ * Streams the soft weapon and effect references of ship classes in the background, gameplay assets always and
+ * cosmetic ones only where somebody can see them, so maps no longer load every Blueprint's effects up front.
+ * Also times every map load to track cold start cost.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipAssetPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UShipAssetPreloadSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Calls back once the class's assets are resident, immediately when they already are
+	void LoadShipClassAssets(TSubclassOf<AShipPawn> ShipClass, TFunction<void()> OnLoaded = nullptr);
+
+	// Loads every class in parallel and calls back once all of them are resident
+	void PreloadShipClasses(TConstArrayView<TSubclassOf<AShipPawn>> ShipClasses, TFunction<void()> OnLoaded);
+
+	bool AreShipClassAssetsLoaded(const UClass* ShipClass) const;
+
+	void LogReport() const;
+
+private:
+	TMap<TWeakObjectPtr<UClass>, FShipClassAssets> ShipClassAssets;
+
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FString LoadingMapName;
+	double MapLoadStartTime = 0.0;
+	TArray<FString> MapLoadReports;
+
+	bool RequestAssets(TWeakObjectPtr<UClass> ShipClass, const TArray<FSoftObjectPath>& AssetPaths, int32 Stage);
+	void OnAssetsLoaded(TWeakObjectPtr<UClass> ShipClass, int32 Stage);
+	void CompleteShipClass(TWeakObjectPtr<UClass> ShipClass);
+	TArray<FSoftObjectPath> GetRequestedPaths(const FShipAssetBundles& Bundles) const;
+
+	void OnPreLoadMap(const FString& MapName);
+	void OnPostLoadMap(UWorld* LoadedWorld);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipAvoidanceFieldSubsystem.generated.h"
+
+class FSignedDistanceField;
+
+/**
+ * Static obstacle avoidance from a baked signed distance field, so AI ships only trace against other ships.
+ * The field is baked on a worker thread when Saved/Navigation holds none for the current geometry, then memory mapped.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipAvoidanceFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	void BakeField(bool bForceBake = false);
+
+	// Closest static surface point within the field's band, false when nothing static is near
+	bool FindClosestSurface(const FVector& Location, FVector& OutSurfaceLocation) const;
+
+	void LogReport() const;
+
+	bool IsReady() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TSharedPtr<FSignedDistanceField> Field;
+	bool bBakeInProgress = false;
+	double LoadSeconds = 0.0;
+	double BakeSeconds = 0.0;
+	mutable int32 NumSamples = 0;
+
+	FString GetFieldFilePath() const;
+	void LoadField(uint32 ObstacleHash, float VoxelSize, float Band);
+};
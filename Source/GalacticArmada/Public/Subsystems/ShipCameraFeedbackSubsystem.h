@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipCameraFeedbackSubsystem.generated.h"
+
+class APlayerController;
+class UCameraShakeBase;
+
+// Every category drives at most one shake per local player
+enum class EShipCameraShakeCategory : uint8
+{
+	Fire,
+	Impact,
+	Collision,
+	Num
+};
+
+struct FShipCameraShakeRequest
+{
+	TSubclassOf<UCameraShakeBase> ShakeClass;
+	FVector Epicenter = FVector::ZeroVector;
+	float InnerRadius = 0.0f;
+	float OuterRadius = 0.0f;
+	float Scale = 1.0f;
+
+	// Shakes only this player's camera at full scale, world shakes fall off with distance when unset
+	TWeakObjectPtr<APlayerController> PlayerController;
+
+	EShipCameraShakeCategory Category = EShipCameraShakeCategory::Fire;
+};
+
+/**
+ * Collects the camera shakes requested during a frame and turns them into one intensity per local player and
+ * category. Each category keeps a single shake instance alive, raising its scale instead of stacking a new
+ * instance for every shot. Not created on dedicated servers or when cosmetics are off, callers skip the request.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipCameraFeedbackSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Shakes every local camera within the outer radius, like UGameplayStatics::PlayWorldCameraShake
+	void AddWorldShake(EShipCameraShakeCategory Category, TSubclassOf<UCameraShakeBase> ShakeClass, const FVector& Epicenter, float InnerRadius, float OuterRadius, float Scale = 1.0f);
+
+	// Shakes one player's camera, remote players still get the client call
+	void AddPlayerShake(EShipCameraShakeCategory Category, TSubclassOf<UCameraShakeBase> ShakeClass, APlayerController* PlayerController, float Scale = 1.0f);
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FLocalPlayerShakes
+	{
+		TWeakObjectPtr<APlayerController> PlayerController;
+		TWeakObjectPtr<UCameraShakeBase> Shakes[static_cast<int32>(EShipCameraShakeCategory::Num)];
+	};
+
+	TArray<FShipCameraShakeRequest> PendingRequests;
+	TArray<FLocalPlayerShakes> LocalPlayers;
+
+	int64 NumRequests = 0;
+	int64 NumShakesStarted = 0;
+	int64 NumShakesRaised = 0;
+	int64 NumShakesSkipped = 0;
+
+	void UpdateLocalPlayers();
+	void ApplyShake(APlayerController* PlayerController, TWeakObjectPtr<UCameraShakeBase>& Shake, UClass* ShakeClass, float Scale);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/OverlapResult.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipDetectionSubsystem.generated.h"
+
+class AShipPawn;
+
+/**
+ * Batched detection pass. Ships with deferred detection keep their 40000 unit detection sphere out of the physics
+ * scene, so moving a ship no longer re-evaluates its overlaps, and this subsystem queries every such ship once per
+ * ga.Detection.Interval instead, spread over the frames in between. Also measures transform commits and overlap
+ * updates per ship per frame.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipDetectionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Read by ships as they begin play, a ship keeps its detection mode for its lifetime
+	static bool IsDeferredDetectionEnabled();
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	int32 NextShipIndex = 0;
+	float ShipsDue = 0.0f;
+	TArray<FOverlapResult> Overlaps;
+	TArray<AActor*> OverlappingActors;
+
+	int64 NumFrames = 0;
+	int64 NumShipFrames = 0;
+	int64 NumDeferredUpdates = 0;
+	int64 NumMovedSphereUpdates = 0;
+	uint64 TransformCommitsAtStart = 0;
+
+	void UpdateDetection(AShipPawn* ShipPawn);
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipEventSubsystem.generated.h"
+
+class AShipPawn;
+class UCannonComponent;
+class UDamageType;
+class UHealthComponent;
+
+// A cannon group fired
+struct FShipFireEvent
+{
+	TWeakObjectPtr<UCannonComponent> Cannon;
+	int32 CannonIndex = INDEX_NONE;
+};
+
+// A health component lost Damage health and has Health left
+struct FShipDamageEvent
+{
+	TWeakObjectPtr<UHealthComponent> HealthComponent;
+	TWeakObjectPtr<AController> InstigatedBy;
+	TWeakObjectPtr<AActor> DamageCauser;
+	const UDamageType* DamageType = nullptr;
+	float Health = 0.0f;
+	float Damage = 0.0f;
+};
+
+// A health component ran out of health
+struct FShipDeathEvent
+{
+	TWeakObjectPtr<UHealthComponent> HealthComponent;
+	TWeakObjectPtr<AController> InstigatedBy;
+	TWeakObjectPtr<AActor> DamageCauser;
+};
+
+// A ship's detection started or stopped seeing an actor
+struct FShipDetectionEvent
+{
+	TWeakObjectPtr<AShipPawn> Ship;
+	TWeakObjectPtr<AActor> Actor;
+	bool bDetected = false;
+};
+
+/**
+ * One strongly typed event channel. Events published during the frame queue up in one array and every subscriber
+ * gets them as a single batch when the event subsystem dispatches. Subscribers are a flat array of object and
+ * function pointers, so dispatch needs neither reflection nor a heap allocated binding.
+ */
+template <typename EventType>
+class TShipEventChannel
+{
+public:
+	using FHandler = void (*)(void* Subscriber, TConstArrayView<EventType> Events);
+
+	// Calls Subscriber->*Method with every batch until Unsubscribe, which has to come before the subscriber is destroyed
+	template <auto Method, typename SubscriberType>
+	void Subscribe(SubscriberType* Subscriber)
+	{
+		Subscribers.Add({ Subscriber, [](void* Object, TConstArrayView<EventType> Events) { (static_cast<SubscriberType*>(Object)->*Method)(Events); } });
+	}
+
+	void Unsubscribe(const void* Subscriber)
+	{
+		Subscribers.RemoveAll([Subscriber](const FSubscriber& Entry) { return Entry.Object == Subscriber; });
+	}
+
+	FORCEINLINE bool HasSubscribers() const { return Subscribers.Num() > 0; }
+
+	// Events nobody listens to are not queued
+	FORCEINLINE void Publish(const EventType& Event)
+	{
+		if (Subscribers.Num() > 0)
+		{
+			Pending.Add(Event);
+		}
+	}
+
+	// Hands the queued events to every subscriber, events published meanwhile wait for the next dispatch
+	int32 Dispatch()
+	{
+		if (Pending.Num() == 0) return 0;
+
+		Swap(Pending, Dispatching);
+		for (int32 SubscriberIndex = 0; SubscriberIndex < Subscribers.Num(); ++SubscriberIndex)
+		{
+			Subscribers[SubscriberIndex].Handler(Subscribers[SubscriberIndex].Object, Dispatching);
+		}
+
+		const int32 NumDispatched = Dispatching.Num();
+		Dispatching.Reset();
+		TotalDispatched += NumDispatched;
+		++TotalBatches;
+		return NumDispatched;
+	}
+
+	FORCEINLINE int32 GetNumSubscribers() const { return Subscribers.Num(); }
+	FORCEINLINE int64 GetTotalDispatched() const { return TotalDispatched; }
+	FORCEINLINE int64 GetTotalBatches() const { return TotalBatches; }
+
+private:
+	struct FSubscriber
+	{
+		void* Object;
+		FHandler Handler;
+	};
+
+	TArray<FSubscriber> Subscribers;
+	TArray<EventType> Pending;
+	TArray<EventType> Dispatching;
+	int64 TotalDispatched = 0;
+	int64 TotalBatches = 0;
+};
+
+/**
+ * Gameplay event bus with native channels for cannon fire, damage, death and detection. Publishers queue events
+ * as they happen and the bus dispatches every channel in batches once the actors have ticked. The dynamic
+ * delegates on the components stay as thin adapters for Blueprints and are only broadcast while bound.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	static UShipEventSubsystem* Get(const UObject* WorldContextObject);
+
+	// Dispatches damage before death, repeats while handlers publish new events up to a few passes
+	void DispatchEvents();
+
+	FORCEINLINE TShipEventChannel<FShipFireEvent>& GetFireChannel() { return FireChannel; }
+	FORCEINLINE TShipEventChannel<FShipDamageEvent>& GetDamageChannel() { return DamageChannel; }
+	FORCEINLINE TShipEventChannel<FShipDeathEvent>& GetDeathChannel() { return DeathChannel; }
+	FORCEINLINE TShipEventChannel<FShipDetectionEvent>& GetDetectionChannel() { return DetectionChannel; }
+
+	void LogReport() const;
+
+	// Broadcasts fire events through a dynamic multicast delegate and through a native channel and logs both costs
+	void RunBenchmark(int32 NumEvents, int32 NumSubscribers, int32 BatchSize);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TShipEventChannel<FShipFireEvent> FireChannel;
+	TShipEventChannel<FShipDamageEvent> DamageChannel;
+	TShipEventChannel<FShipDeathEvent> DeathChannel;
+	TShipEventChannel<FShipDetectionEvent> DetectionChannel;
+};
+
+// Receiver for ga.Events.Benchmark, bound through both dispatch paths
+UCLASS(Transient)
+class UShipEventBenchmarkListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void HandleCannonFired(int32 CannonIndex) { Checksum += CannonIndex; }
+
+	void HandleFireEvents(TConstArrayView<FShipFireEvent> Events)
+	{
+		for (const FShipFireEvent& Event : Events)
+		{
+			Checksum += Event.CannonIndex;
+		}
+	}
+
+	int64 Checksum = 0;
+};
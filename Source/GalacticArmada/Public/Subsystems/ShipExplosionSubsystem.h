@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Memory/FrameArena.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipExplosionSubsystem.generated.h"
+
+class UDamageType;
+
+struct FShipExplosion
+{
+	FVector Origin = FVector::ZeroVector;
+
+	// Full damage inside the inner radius, falling off to the minimum at the outer radius
+	float BaseDamage = 0.0f;
+	float MinimumDamage = 0.0f;
+	float InnerRadius = 0.0f;
+	float OuterRadius = 0.0f;
+
+	TSubclassOf<UDamageType> DamageTypeClass;
+	TWeakObjectPtr<AActor> DamageCauser;
+	TWeakObjectPtr<AController> InstigatedBy;
+
+	// Never damaged by this explosion, usually the ship that fired it
+	TWeakObjectPtr<const AActor> IgnoreActor;
+};
+
+/**
+ * Resolves every explosion queued in a frame together: damageable actors are hashed into a uniform grid once,
+ * each explosion visits only the cells its radius overlaps, then radial damage is applied after all queries.
+ * Replaces the physics overlap and per component visibility traces of UGameplayStatics::ApplyRadialDamage.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipExplosionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Health components register their owners, only registered actors take splash damage
+	void RegisterDamageable(AActor* Actor);
+	void UnregisterDamageable(AActor* Actor);
+
+	// Damage is dealt on the next tick together with every other explosion of the frame
+	void QueueExplosion(const FShipExplosion& Explosion);
+
+	// Resolves the queued explosions now, returns the number of actors hit
+	int32 ProcessExplosions();
+
+	FORCEINLINE int32 GetNumQueuedExplosions() const { return QueuedExplosions.Num(); }
+	FORCEINLINE const TArray<AActor*>& GetDamageables() const { return Damageables; }
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FExplosionTarget
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FVector Location = FVector::ZeroVector;
+		float Radius = 0.0f;
+	};
+
+	struct FExplosionHit
+	{
+		int32 TargetIndex = INDEX_NONE;
+		FVector ClosestPoint = FVector::ZeroVector;
+	};
+
+	UPROPERTY()
+	TArray<AActor*> Damageables;
+
+	// Bounding radius of each damageable, captured when it registers
+	TArray<float> DamageableRadii;
+
+	TArray<FShipExplosion> QueuedExplosions;
+	TArray<FShipExplosion> ProcessingExplosions;
+
+	// Rebuilt for every batch, allocations are kept between frames
+	TArray<FExplosionTarget> Targets;
+	float MaxTargetRadius = 0.0f;
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	// Hits of each explosion, gathered into the worker threads' frame arenas and dropped with the batch
+	TArray<TFrameArray<FExplosionHit>> ExplosionHits;
+
+	int32 NumBatches = 0;
+	int64 TotalExplosions = 0;
+	int64 TotalHits = 0;
+	int32 LargestBatch = 0;
+	double TotalQuerySeconds = 0.0;
+	double TotalApplySeconds = 0.0;
+	double WorstBatchSeconds = 0.0;
+
+	void BuildGrid(float CellSize);
+	void QueryExplosion(const FShipExplosion& Explosion, float CellSize, TFrameArray<FExplosionHit>& OutHits) const;
+	int32 ApplyHits();
+};
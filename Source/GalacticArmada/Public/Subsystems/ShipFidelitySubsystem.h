@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipFidelitySubsystem.generated.h"
+
+// What each fidelity level allows, level 0 runs everything at full rate
+struct FShipFidelitySettings
+{
+	// Seconds between AI decisions and between obstacle queries, 0 every frame
+	float AIThinkInterval = 0.0f;
+	float AvoidanceInterval = 0.0f;
+
+	// Transient effects spawned per frame such as muzzle flashes and impacts, negative is unlimited
+	int32 FXSpawnBudget = -1;
+
+	// Seconds between thruster parameter updates, 0 every frame
+	float ThrusterUpdateInterval = 0.0f;
+
+	// Closest detected actors traced per obstacle query, negative traces all of them
+	int32 AvoidanceTraceBudget = -1;
+};
+
+/**
+ * Watches game thread time and moves a global fidelity level down when frames run over budget and back up once
+ * they have recovered, with separate thresholds and hold times so the level does not oscillate. AI think rates,
+ * the FX spawn budget, thruster updates and avoidance traces read the current level's settings.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipFidelitySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 NumLevels = 4;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	FORCEINLINE int32 GetLevel() const { return Level; }
+	const FShipFidelitySettings& GetSettings() const;
+
+	// Settings of the world's level, full fidelity when the governor does not run in this world
+	static const FShipFidelitySettings& GetSettings(const UWorld* World);
+
+	// Takes one transient effect spawn from this frame's budget, false when the effect should be skipped
+	bool ConsumeFXSpawn();
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	int32 Level = 0;
+	double SmoothedFrameMs = 0.0;
+	float TimeOverBudget = 0.0f;
+	float TimeUnderBudget = 0.0f;
+	int32 FXSpawnsThisFrame = 0;
+
+	int32 NumLevelChanges = 0;
+	int64 NumFXSpawnsSkipped = 0;
+	double SecondsAtLevel[NumLevels] = {};
+
+	void SetLevel(int32 NewLevel, const TCHAR* Reason);
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MassEntityTypes.h"
+#include "MassEntityQuery.h"
+#include "ShipFleetSubsystem.generated.h"
+
+class AShipPawn;
+struct FMassEntityManager;
+
+/**
+ * Simulates large background fleets as Mass entities and turns them into full AShipPawn actors
+ * near a player view, handing flight state, health and team over in both directions.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipFleetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Creates Count fleet entities of ShipClass spread within Radius of Center
+	void SpawnFleet(TSubclassOf<AShipPawn> ShipClass, uint8 TeamId, int32 Count, const FVector& Center, float Radius);
+
+	void LogReport() const;
+
+	FORCEINLINE int32 GetNumFleetEntities() const { return NumFleetEntities; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY()
+	TArray<AShipPawn*> PromotedShips;
+
+	TMap<UClass*, FConstSharedStruct> ArchetypeFragments;
+	FMassArchetypeHandle FleetArchetype;
+	FMassEntityQuery FleetQuery;
+
+	float TimeSinceEvaluation = 0.0f;
+	int32 NumFleetEntities = 0;
+	int32 NumPromotions = 0;
+	int32 NumDemotions = 0;
+
+	FMassEntityManager* GetEntityManager() const;
+	const FConstSharedStruct& GetOrCreateArchetypeFragment(FMassEntityManager& EntityManager, TSubclassOf<AShipPawn> ShipClass);
+	void CreateEntities(FMassEntityManager& EntityManager, TSubclassOf<AShipPawn> ShipClass, int32 Count, TArray<FMassEntityHandle>& OutEntities);
+
+	void EvaluatePromotions(FMassEntityManager& EntityManager);
+	void UpdateProxyInstances(FMassEntityManager& EntityManager);
+	AShipPawn* PromoteEntity(FMassEntityManager& EntityManager, FMassEntityHandle Entity);
+	void DemoteShip(FMassEntityManager& EntityManager, AShipPawn* ShipPawn);
+};
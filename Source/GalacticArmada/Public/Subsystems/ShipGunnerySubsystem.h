@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Flight/ProjectileBallistics.h"
+#include "ShipGunnerySubsystem.generated.h"
+
+class AShipPawn;
+class AShipAIController;
+
+/**
+ * Tracks every ship's velocity and acceleration and solves lead aim points for all AI shooters in one batch
+ * per frame. AI controllers steer towards the aim point and hold fire while the predicted hit probability is low.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipGunnerySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void NotifyShotFired(const APawn* Shooter);
+	void NotifyShipKilled(const AController* Killer);
+
+	// Location and velocity sampled this frame, false for ships not tracked yet
+	bool GetShipMotion(const AShipPawn* ShipPawn, FVector& OutLocation, FVector& OutVelocity) const;
+
+	// Forgets the sampled motion of a ship that teleported or rejoined the registry, so its velocity is not taken across the jump
+	void ResetShipMotion(const AShipPawn* ShipPawn);
+
+	void LogReport() const;
+
+	static bool IsLeadTargetingEnabled();
+	static float GetMinHitProbability();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FShipMotion
+	{
+		FVector Location = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+		FVector Acceleration = FVector::ZeroVector;
+		float Maneuver = 0.0f;
+		int32 NumSamples = 0;
+	};
+
+	TMap<TWeakObjectPtr<const AShipPawn>, FShipMotion> ShipMotions;
+
+	TArray<AShipAIController*> Shooters;
+	TArray<FInterceptRequest> Requests;
+	TArray<FInterceptSolution> Solutions;
+
+	int32 ShotsFired = 0;
+	int32 Kills = 0;
+
+	void UpdateShipMotions(float DeltaTime);
+	float GetProjectileSpeed(const AShipPawn* ShipPawn, int32 CannonIndex);
+};
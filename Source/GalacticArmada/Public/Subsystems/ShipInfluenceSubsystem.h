@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Navigation/InfluenceMap.h"
+#include "ShipInfluenceSubsystem.generated.h"
+
+class AShipPawn;
+
+struct FShipInfluenceCandidate
+{
+	int32 ShipIndex = INDEX_NONE;
+
+	// Friendly minus hostile influence at the ship over their sum, from the attacking team's point of view
+	float Advantage = 0.0f;
+};
+
+// Influence map published by the worker together with the ships it was built from
+struct FShipInfluenceSnapshot
+{
+	FInfluenceMap Map;
+	TArray<TWeakObjectPtr<AShipPawn>> Ships;
+
+	// Most exposed hostile ships for each team, best first
+	TArray<FShipInfluenceCandidate> TargetCandidates[FInfluenceMap::MaxTeams];
+};
+
+/**
+ * Coarse influence map of every team's firepower, updated incrementally on a worker thread a few times a second.
+ * AI ships sample it in constant time to choose targets, retreat from lost fights and flank around defended space.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipInfluenceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	bool IsReady() const;
+
+	// Most exposed hostile ship weighed against distance, null when the map has none for the ship's team
+	AShipPawn* ChooseTarget(const AShipPawn* ShipPawn) const;
+
+	// True when the ship is hurt and outgunned where it is, with the safest nearby location to fall back to
+	bool ShouldRetreat(const AShipPawn* ShipPawn, FVector& OutRetreatLocation) const;
+
+	// Approach point beside the target with less hostile influence than the direct line, false when the direct line is best
+	bool FindFlankLocation(const AShipPawn* ShipPawn, const FVector& TargetLocation, FVector& OutFlankLocation) const;
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Only touched by the update in flight, so incremental stamps survive between updates
+	TSharedPtr<FInfluenceMap> WorkingMap;
+	TSharedPtr<const FShipInfluenceSnapshot> Snapshot;
+
+	TMap<UClass*, float> DamagePerSecond;
+
+	// Teams beyond the map's team count already warned about, so each is reported once
+	TSet<uint8> UnmappedTeams;
+
+	bool bUpdateInFlight = false;
+	float TimeSinceUpdate = 0.0f;
+	int32 UpdatesSinceRebuild = 0;
+
+	int32 NumUpdates = 0;
+	int64 TotalCellWrites = 0;
+	double TotalUpdateSeconds = 0.0;
+	double FirstUpdateTime = 0.0;
+	mutable int32 NumDecisions = 0;
+	mutable double TotalDecisionSeconds = 0.0;
+
+	void StartUpdate();
+	void OnUpdateComplete(TSharedPtr<const FShipInfluenceSnapshot> NewSnapshot, int32 NumCellWrites, double Seconds);
+	float GetDamagePerSecond(const AShipPawn* ShipPawn);
+};
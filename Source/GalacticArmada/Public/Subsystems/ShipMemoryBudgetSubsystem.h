@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipMemoryBudgetSubsystem.generated.h"
+
+struct IConsoleVariable;
+
+struct FShipMemoryBudget
+{
+	FName TagName;
+	const TCHAR* DisplayName = nullptr;
+
+	// ga.Memory.Budget.* in megabytes, 0 has no budget
+	IConsoleVariable* BudgetVariable = nullptr;
+
+	int64 CurrentBytes = 0;
+	int64 PeakBytes = 0;
+	int32 NumBreaches = 0;
+	bool bOverBudget = false;
+
+	// Scales with the ship count and goes into the per ship figure
+	bool bPerShip = false;
+};
+
+/**
+ * Follows the low level memory tracker tags of ships, cannons, projectiles, FX, AI and health every frame,
+ * keeps their peak and warns once each time a tag crosses its budget. Only has data with -llm.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipMemoryBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	FORCEINLINE const TArray<FShipMemoryBudget>& GetBudgets() const { return Budgets; }
+
+	// Logs current, peak and budget of every tag, warnings for tags that went over, and the memory per ship
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TArray<FShipMemoryBudget> Budgets;
+
+	// Per ship tags at the frame with the most registered ships
+	int32 PeakNumShips = 0;
+	int64 PerShipBytesAtPeak = 0;
+};
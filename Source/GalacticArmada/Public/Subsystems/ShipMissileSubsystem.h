@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipMissileSubsystem.generated.h"
+
+class AGuidedMissile;
+class AShipPawn;
+
+/**
+ * Launches, steers and recycles guided missiles. Every live missile is steered by proportional navigation in a
+ * single pass per frame against target motion sampled once per target, spent missiles wait hidden in a pool,
+ * and each target can only be locked by a limited number of missiles at a time.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipMissileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Takes a missile from the pool or spawns one, then locks the shooter's target or the ship nearest its aim
+	AGuidedMissile* LaunchMissile(TSubclassOf<AGuidedMissile> MissileClass, const FTransform& LaunchTransform, const FActorSpawnParameters& SpawnParams, AShipPawn* Target = nullptr);
+
+	// Spent missiles go back to the pool, or are destroyed when pooling is off
+	void ReleaseMissile(AGuidedMissile* Missile);
+
+	int32 GetNumLocks(const AShipPawn* Target) const;
+	FORCEINLINE int32 GetNumActiveMissiles() const { return ActiveMissiles.Num(); }
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY()
+	TArray<AGuidedMissile*> ActiveMissiles;
+
+	TMap<UClass*, TArray<TWeakObjectPtr<AGuidedMissile>>> Pool;
+	TMap<TWeakObjectPtr<const AShipPawn>, int32> LockCounts;
+
+	// Guidance batch, rebuilt every frame with allocations kept
+	TArray<FVector> MissileLocations;
+	TArray<FVector> MissileVelocities;
+	TArray<FVector> NewVelocities;
+	// Navigation constant, acceleration limit and cosine of the seeker half angle
+	TArray<FVector3f> MissileGuidance;
+	TArray<int32> MissileTargets;
+	TArray<uint8> LostLocks;
+	TArray<FVector> TargetLocations;
+	TArray<FVector> TargetVelocities;
+	TMap<const AShipPawn*, int32> TargetSlots;
+	TArray<AGuidedMissile*> ExpiredMissiles;
+
+	int32 NumLaunched = 0;
+	int32 NumFromPool = 0;
+	int32 NumLocksDenied = 0;
+	int32 PeakActiveMissiles = 0;
+	int32 NumGuidanceFrames = 0;
+	int64 TotalGuidedMissiles = 0;
+	double TotalGuidanceSeconds = 0.0;
+
+	AGuidedMissile* TakeFromPool(UClass* MissileClass);
+	AShipPawn* FindLockTarget(const AGuidedMissile* Missile, AShipPawn* PreferredTarget) const;
+	bool CanLock(const AGuidedMissile* Missile, const AShipPawn* Target) const;
+	void SetLock(AGuidedMissile* Missile, AShipPawn* Target);
+	void UpdateGuidance(float DeltaTime);
+};
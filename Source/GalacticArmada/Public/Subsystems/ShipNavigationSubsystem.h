@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipNavigationSubsystem.generated.h"
+
+class FSparseVoxelOctree;
+
+/**
+ * 3D navigation around static level geometry for AI ships. A sparse voxel octree is built on a worker
+ * thread at level start, or loaded from Saved/Navigation when the level has not changed since it was baked.
+ * Path queries run on worker threads and are cached per pair of start and goal octree leaves.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipNavigationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	void BuildNavigation(bool bForceRebuild = false);
+
+	// Segments are free while navigation is not ready, ships then steer straight as before
+	bool IsSegmentFree(const FVector& Start, const FVector& End) const;
+
+	// Calls OnComplete on the game thread with smoothed waypoints ending at Goal, or none when no path was found
+	void RequestPath(const FVector& Start, const FVector& Goal, TFunction<void(const TArray<FVector>&)> OnComplete);
+
+	void LogReport() const;
+
+	FORCEINLINE bool IsReady() const { return Octree.IsValid(); }
+	FORCEINLINE TSharedPtr<const FSparseVoxelOctree> GetOctree() const { return Octree; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FCachedPath
+	{
+		TArray<FVector> Waypoints;
+		double Time = 0.0;
+		bool bFound = false;
+	};
+
+	TSharedPtr<const FSparseVoxelOctree> Octree;
+	TMap<uint64, FCachedPath> PathCache;
+	bool bBuildInProgress = false;
+
+	double BuildSeconds = 0.0;
+	bool bLoadedFromDisk = false;
+	int32 NumQueries = 0;
+	int32 NumCacheHits = 0;
+	int32 NumSearches = 0;
+	int32 NumFailedQueries = 0;
+	double TotalQuerySeconds = 0.0;
+	double MaxQuerySeconds = 0.0;
+
+	FString GetNavigationFilePath() const;
+	void OnBuildComplete(TSharedPtr<const FSparseVoxelOctree> NewOctree, double Seconds, bool bLoaded);
+	void OnPathComplete(uint64 CacheKey, const TArray<FVector>& Waypoints, double QuerySeconds);
+};
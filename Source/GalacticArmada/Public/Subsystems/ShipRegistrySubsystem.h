@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipRegistrySubsystem.generated.h"
+
+class AShipPawn;
+class UShipEventSubsystem;
+struct FShipDeathEvent;
+
+// Keeps track of every live ship in the world so gameplay code never has to scan actors
+UCLASS()
+class GALACTICARMADA_API UShipRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RegisterShip(AShipPawn* ShipPawn);
+	void UnregisterShip(AShipPawn* ShipPawn);
+
+	AShipPawn* FindPlayerShip() const;
+	AShipPawn* FindClosestHostileShip(const AShipPawn* ShipPawn) const;
+
+	FORCEINLINE const TArray<AShipPawn*>& GetShips() const { return Ships; }
+
+private:
+	UPROPERTY()
+	TArray<AShipPawn*> Ships;
+
+	UPROPERTY()
+	UShipEventSubsystem* EventSubsystem;
+
+	// Ships die on the frame's batch of death events
+	void HandleDeathEvents(TConstArrayView<FShipDeathEvent> Events);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Memory/FrameArena.h"
+#include "ShipRepresentationSubsystem.generated.h"
+
+class AShipPawn;
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Swaps AI ships far from every player view to a kinematic proxy (no skeletal pose, physics body or sockets)
+ * and draws all proxies of a ship type through one instanced static mesh. Proxies have no ship to ship
+ * collision, so without any view ships stay full unless ga.ShipProxy.Headless is set.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipRepresentationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void LogReport() const;
+
+	// Player view points of this frame
+	void GetViewLocations(TFrameArray<FVector>& OutViewLocations) const;
+
+	// Draws instances owned by other systems (e.g. Mass fleet entities) for the next update only
+	void AddExternalProxyInstances(UStaticMesh* StaticMesh, TConstArrayView<FTransform> Transforms);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY()
+	AActor* ProxyRendererActor;
+
+	UPROPERTY()
+	TMap<UStaticMesh*, UInstancedStaticMeshComponent*> ProxyMeshComponents;
+
+	TMap<UStaticMesh*, TArray<FTransform>> ProxyInstanceTransforms;
+	TMap<UStaticMesh*, TArray<FTransform>> ExternalProxyTransforms;
+
+	float TimeSinceEvaluation = 0.0f;
+	int32 NumProxyShips = 0;
+	int32 NumFullShips = 0;
+	double UpdateSecondsTotal = 0.0;
+	uint64 UpdateCount = 0;
+
+	// Sum of the proxy count over every update, each one a skeletal pose and physics body step skipped
+	uint64 ProxyShipUpdates = 0;
+
+	void EvaluateRepresentations();
+	void UpdateProxyInstances();
+	UInstancedStaticMeshComponent* FindOrCreateProxyMeshComponent(UStaticMesh* StaticMesh);
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/CannonComponent.h"
+#include "Flight/ShipFlightModel.h"
+#include "ShipSnapshotSubsystem.generated.h"
+
+class AShipPawn;
+class AProjectileBase;
+
+// File layout: header, class table, ship records, cannon fire states, projectile records. Every section starts
+// 16 byte aligned so a memory mapped file is read in place, records are plain data copied without reflection.
+struct FBattleSnapshotHeader
+{
+	uint32 Magic = 0;
+	int32 Version = 0;
+
+	// Record sizes reject files written by a build with a different layout
+	uint32 ShipRecordSize = 0;
+	uint32 CannonRecordSize = 0;
+	uint32 ProjectileRecordSize = 0;
+
+	int32 NumClasses = 0;
+	int32 NumShips = 0;
+	int32 NumCannons = 0;
+	int32 NumProjectiles = 0;
+
+	int64 ClassesOffset = 0;
+	int64 ShipsOffset = 0;
+	int64 CannonsOffset = 0;
+	int64 ProjectilesOffset = 0;
+	int64 FileSize = 0;
+
+	// World time the snapshot was taken at, timers in the records are relative to it. Reported when restoring.
+	double WorldTime = 0.0;
+};
+
+struct FBattleSnapshotClass
+{
+	ANSICHAR PathName[256] = {};
+};
+
+struct FBattleSnapshotShip
+{
+	FShipFlightInput FlightInput;
+	FShipFlightState FlightState;
+	FQuat Rotation = FQuat::Identity;
+	FVector Location = FVector::ZeroVector;
+	FVector LinearVelocity = FVector::ZeroVector;
+	FVector AngularVelocity = FVector::ZeroVector;
+	float Health = 0.0f;
+	int32 ClassIndex = INDEX_NONE;
+
+	// Range of this ship's cannons in the cannon section
+	int32 FirstCannon = 0;
+	int32 NumCannons = 0;
+
+	uint8 TeamId = 0;
+	uint8 bPlayerControlled = 0;
+};
+
+struct FBattleSnapshotProjectile
+{
+	FQuat Rotation = FQuat::Identity;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	float FlightAge = 0.0f;
+	int32 ClassIndex = INDEX_NONE;
+
+	// Indices into the ship records, none when the ship is gone
+	int32 InstigatorShip = INDEX_NONE;
+	int32 TargetShip = INDEX_NONE;
+};
+
+/**
+ * Saves the running battle to a flat binary snapshot and restores it: every ship's transform, physics velocity,
+ * flight state, health and cannon fire state, and every live projectile. Restoring moves ships and projectiles
+ * already in the world onto the saved records and only spawns or destroys the difference.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipSnapshotSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	bool SaveSnapshot(const FString& FilePath);
+	bool LoadSnapshot(const FString& FilePath);
+
+	// Saved/Snapshots/<Name>.gasnap
+	static FString GetSnapshotFilePath(const FString& Name);
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Capture buffers, allocations kept between saves
+	TArray<FBattleSnapshotClass> Classes;
+	TArray<FBattleSnapshotShip> ShipRecords;
+	TArray<FCannonFireState> CannonRecords;
+	TArray<FBattleSnapshotProjectile> ProjectileRecords;
+	TMap<UClass*, int32> ClassIndices;
+	TMap<const AActor*, int32> ShipIndices;
+
+	float TimeSinceAutosave = 0.0f;
+
+	int32 NumSaves = 0;
+	int32 NumLoads = 0;
+	int32 LastNumShips = 0;
+	int32 LastNumProjectiles = 0;
+	int64 LastFileSize = 0;
+	double LastCaptureSeconds = 0.0;
+	double LastWriteSeconds = 0.0;
+	double LastReadSeconds = 0.0;
+	double LastApplySeconds = 0.0;
+	int32 LastActorsReused = 0;
+	int32 LastActorsSpawned = 0;
+	double LastSnapshotWorldTime = 0.0;
+	bool bLastLoadMapped = false;
+
+	int32 GetClassIndex(UClass* Class);
+	void Capture();
+	bool Apply(const uint8* Data, int64 Size);
+};
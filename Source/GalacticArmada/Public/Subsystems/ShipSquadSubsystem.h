@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipSquadSubsystem.generated.h"
+
+class AShipPawn;
+class UShipFormationDataAsset;
+
+// What a wingman flies this frame, fanned out from its squad leader's queries
+struct FShipSquadOrders
+{
+	TWeakObjectPtr<AShipPawn> Target;
+	FVector SlotLocation = FVector::ZeroVector;
+
+	// Leader's closest obstacle, zero when nothing is in the way
+	FVector CollisionLocation = FVector::ZeroVector;
+
+	// Push away from nearby squad mates, already scaled to a steering offset
+	FVector Separation = FVector::ZeroVector;
+
+	float EngageRange = 0.0f;
+	bool bIsLeader = false;
+};
+
+struct FShipSquad
+{
+	TWeakObjectPtr<const UShipFormationDataAsset> Formation;
+
+	// The first member leads, the next one takes over when it dies
+	TArray<TWeakObjectPtr<AShipPawn>> Members;
+
+	// Leader whose obstacle queries currently skip the wingmen, and how many it skips
+	TWeakObjectPtr<AShipPawn> AvoidanceLeader;
+	int32 NumAvoidanceIgnored = INDEX_NONE;
+
+	int64 TargetSearches = 0;
+	int64 AvoidanceQueries = 0;
+	int64 AvoidanceTraces = 0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Groups AI ships into squads that share one target search and one obstacle query, run by the squad leader.
+ * Wingmen fly formation slots computed for the whole squad in one pass and only keep cheap local separation.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipSquadSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Splits the ships into squads of the formation's size, returns the number of squads formed
+	int32 FormSquads(const UShipFormationDataAsset* Formation, TConstArrayView<AShipPawn*> ShipPawns);
+
+	// Orders for a squad member, null for ships outside a squad or while squads are disabled
+	const FShipSquadOrders* FindOrders(const AShipPawn* ShipPawn) const;
+
+	void RecordTargetSearch(const AShipPawn* ShipPawn);
+	// Counts the query and the line traces it actually issued, wingmen riding on their leader issue none
+	void RecordAvoidanceQuery(const AShipPawn* ShipPawn, int32 NumTraces);
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TMap<int32, FShipSquad> Squads;
+	TMap<TWeakObjectPtr<const AShipPawn>, int32> ShipToSquad;
+	TMap<TWeakObjectPtr<const AShipPawn>, FShipSquadOrders> ShipOrders;
+	int32 NextSquadId = 0;
+
+	TArray<FVector> MemberLocations;
+
+	// Totals over every squad ever formed, so finished matches still count
+	int32 SquadsFormed = 0;
+	int32 ShipsInSquads = 0;
+	int64 TotalTargetSearches = 0;
+	int64 TotalAvoidanceQueries = 0;
+	int64 TotalAvoidanceTraces = 0;
+	double TotalSquadSeconds = 0.0;
+
+	FShipSquad* FindSquad(const AShipPawn* ShipPawn);
+	void UpdateSquad(FShipSquad& Squad);
+};
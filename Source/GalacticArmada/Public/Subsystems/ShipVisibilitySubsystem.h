@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "WorldCollision.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipVisibilitySubsystem.generated.h"
+
+class AShipPawn;
+
+enum class EShipLineOfSight : uint8
+{
+	// No trace has come back for the pair yet
+	Unknown,
+	Clear,
+	Blocked,
+};
+
+/**
+ * Line of sight service for AI fire decisions. Shooters ask for the last known line of sight to their target and
+ * get a cached answer straight away, stale pairs are queued and traced asynchronously in batches of
+ * ga.Visibility.TracesPerFrame, results stay valid for ga.Visibility.CacheTTL. Counts the shots fired while the
+ * line of sight was blocked.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipVisibilitySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Cached line of sight from the shooter to the target, queues a trace when the cached result has expired
+	EShipLineOfSight RequestLineOfSight(const AShipPawn* Shooter, const AActor* Target);
+
+	// AI hold fire while the line of sight to their target is blocked
+	static bool IsFireGateEnabled();
+
+	void NotifyFireHeld();
+	void NotifyShotFired(const APawn* Shooter);
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	using FPairKey = TPair<FObjectKey, FObjectKey>;
+
+	struct FLineOfSightEntry
+	{
+		TWeakObjectPtr<const AShipPawn> Shooter;
+		TWeakObjectPtr<const AActor> Target;
+		EShipLineOfSight Result = EShipLineOfSight::Unknown;
+		double ExpireTime = 0.0;
+		double LastRequestTime = 0.0;
+		bool bQueued = false;
+	};
+
+	TMap<FPairKey, FLineOfSightEntry> Entries;
+	TArray<FPairKey> PendingPairs;
+	TMap<uint32, FPairKey> TracesInFlight;
+	TMap<FObjectKey, FObjectKey> ShooterTargets;
+	uint32 NextTraceId = 0;
+	FTraceDelegate TraceDelegate;
+
+	int64 NumRequests = 0;
+	int64 NumCacheHits = 0;
+	int64 NumTraces = 0;
+	int64 NumBlockedResults = 0;
+	int64 NumFireHeld = 0;
+	int64 NumShotsClear = 0;
+	int64 NumShotsBlocked = 0;
+	int64 NumShotsUnknown = 0;
+	double GameThreadSeconds = 0.0;
+	double ActiveSeconds = 0.0;
+
+	void IssueTraces();
+	void EvictEntries();
+	void OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+};
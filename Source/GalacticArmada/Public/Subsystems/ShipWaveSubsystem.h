@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShipWaveSubsystem.generated.h"
+
+class AShipPawn;
+struct FStreamableHandle;
+
+struct FShipWave
+{
+	int32 WaveId = INDEX_NONE;
+	TSoftClassPtr<AShipPawn> ShipClass;
+	int32 Count = 0;
+	uint8 TeamId = 0;
+	FTransform Center = FTransform::Identity;
+	float Spacing = 4000.0f;
+
+	// Prewarm waves fill the pool with dormant ships instead of sending them into the fight
+	bool bPrewarm = false;
+
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	// Spawned but not yet finished, then finished but not yet possessed
+	TArray<TWeakObjectPtr<AShipPawn>> PendingFinish;
+	TArray<TWeakObjectPtr<AShipPawn>> PendingPossess;
+	int32 NumStarted = 0;
+	int32 NumCompleted = 0;
+	int32 NumFromPool = 0;
+
+	double QueueTime = 0.0;
+	double LoadSeconds = 0.0;
+	double WorkSeconds = 0.0;
+	double WorstFrameWorkSeconds = 0.0;
+	double WorstFrameSeconds = 0.0;
+	int32 Frames = 0;
+};
+
+/**
+ * Spawns waves of ships without a frame spike. Ship classes are loaded asynchronously, then spawning,
+ * finishing and possession are spread over frames under a millisecond budget, optionally from a pool
+ * of dormant ships spawned ahead of time.
+ */
+UCLASS()
+class GALACTICARMADA_API UShipWaveSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Ships are laid out in a grid facing along the center's rotation. Returns the wave id.
+	int32 QueueWave(TSoftClassPtr<AShipPawn> ShipClass, int32 Count, uint8 TeamId, const FTransform& Center, float Spacing = 4000.0f);
+
+	// Spawns dormant ships ahead of time, later waves of the same class activate them instead of spawning
+	int32 PrewarmPool(TSoftClassPtr<AShipPawn> ShipClass, int32 Count);
+
+	int32 GetNumPooled(TSubclassOf<AShipPawn> ShipClass) const;
+	FORCEINLINE bool IsIdle() const { return Waves.Num() == 0; }
+
+	void LogReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TArray<FShipWave> Waves;
+	TMap<UClass*, TArray<TWeakObjectPtr<AShipPawn>>> Pool;
+	int32 NextWaveId = 0;
+
+	double LastTickTime = 0.0;
+	double AverageIdleFrameSeconds = 0.0;
+
+	TArray<FString> CompletedWaveReports;
+
+	int32 AddWave(FShipWave&& Wave);
+	bool StepWave(FShipWave& Wave, UClass* ShipClass);
+	AShipPawn* TakeFromPool(UClass* ShipClass);
+	FTransform GetSpawnTransform(const FShipWave& Wave, int32 ShipIndex) const;
+	void CompleteWave(const FShipWave& Wave);
+};
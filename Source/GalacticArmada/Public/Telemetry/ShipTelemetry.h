@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+class AActor;
+class UWorld;
+
+enum class EShipTelemetryEventType : uint8
+{
+	// Subject spawned, Detail is its team
+	Spawn,
+	// Subject fired a projectile, Detail is the cannon group
+	Shot,
+	// Subject was hit by a projectile of Other, Value is the projectile's damage
+	Hit,
+	// Subject lost Value health to Other, Detail is an EShipTelemetryDamageSource
+	Damage,
+	// Subject was destroyed by Other, Detail is the subject's team
+	Kill,
+	// Subject opened fire on Other, Value is the range and Detail the cannon group
+	Engage,
+	// Match bookkeeping of the battle simulation, Value is the ships per team on start and the duration on end
+	MatchStart,
+	MatchJoin,
+	MatchEnd,
+};
+
+enum class EShipTelemetryDamageSource : uint8
+{
+	Projectile,
+	Collision,
+	Other,
+};
+
+// Fixed size record, actors are identified by their object index which is only unique while they are alive,
+// a new Spawn event starts a new life for a reused index
+struct FShipTelemetryEvent
+{
+	double Time = 0.0;
+	uint32 Subject = 0;
+	uint32 Other = 0;
+	float Value = 0.0f;
+	int16 Match = INDEX_NONE;
+	EShipTelemetryEventType Type = EShipTelemetryEventType::Spawn;
+	uint8 Detail = 0;
+};
+
+static_assert(sizeof(FShipTelemetryEvent) == 24, "Telemetry records are written to disk as is");
+
+/**
+ * Gameplay event stream for offline analysis. Every thread records into its own lock free ring of fixed size
+ * records, a thread pool task drains the rings, compresses the batch and appends it to a file in Saved/Telemetry.
+ * Recording costs a relaxed load while disabled and a copy into the ring while enabled, events are dropped
+ * rather than waited on when a ring is full. Started with ga.Telemetry.Start or -Telemetry.
+ */
+class GALACTICARMADA_API FShipTelemetry
+{
+public:
+	static FORCEINLINE bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+	// Stamps the subject's world time and the actors' ids
+	static FORCEINLINE void Record(EShipTelemetryEventType Type, const AActor* Subject, const AActor* Other = nullptr, float Value = 0.0f, uint8 Detail = 0)
+	{
+		if (IsEnabled() && Subject)
+		{
+			RecordActorEvent(Type, Subject, Other, Value, Detail);
+		}
+	}
+
+	static FORCEINLINE void RecordMatch(EShipTelemetryEventType Type, const UWorld* World, int32 Match, const AActor* Subject = nullptr, float Value = 0.0f, uint8 Detail = 0)
+	{
+		if (IsEnabled() && World)
+		{
+			RecordMatchEvent(Type, World, Match, Subject, Value, Detail);
+		}
+	}
+
+	static void Write(const FShipTelemetryEvent& Event);
+
+	// Opens a new telemetry file and starts recording, Stop writes what is left and closes it
+	static void Start();
+	static void Stop();
+
+	static void LogReport();
+
+	// Starts a flush once the flush interval has passed or a ring is half full, runs at the end of each frame
+	static void OnEndFrame();
+
+	// Decompresses every chunk of a telemetry file, false when it is not one
+	static bool ReadFile(const FString& FilePath, TArray<FShipTelemetryEvent>& OutEvents);
+
+	static FString GetTelemetryDir();
+
+private:
+	static std::atomic<bool> bEnabled;
+
+	static void RecordActorEvent(EShipTelemetryEventType Type, const AActor* Subject, const AActor* Other, float Value, uint8 Detail);
+	static void RecordMatchEvent(EShipTelemetryEventType Type, const UWorld* World, int32 Match, const AActor* Subject, float Value, uint8 Detail);
+	static void Flush();
+};
@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+[SupportedPlatforms("Linux", "LinuxArm64")]
+public class GalacticArmadaServerTarget : TargetRules
+{
+	public GalacticArmadaServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V4;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_3;
+		ExtraModuleNames.Add("GalacticArmada");
+
+		// Server only settings live in Config/Custom/Server, layered over the project defaults
+		BuildEnvironment = TargetBuildEnvironment.Unique;
+		CustomConfig = "Server";
+
+		// Dedicated servers are run headless and read through their logs
+		bUseLoggingInShipping = true;
+	}
+}